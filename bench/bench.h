@@ -0,0 +1,160 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file bench.h
+ * @brief Общие объявления набора бенчмарков AirConManagerBench.
+ *
+ * Каждый набор бенчмарков реализуется в отдельном файле bench_*.cpp и вызывается
+ * из benchmain.cpp. Бенчмарки работают без окон на платформе offscreen.
+ * Результаты reportThroughput(), reportLatency() и reportValue() дополнительно
+ * собираются в JSON-отчёт (параметр --json). Проверки корректности сообщают об ошибке
+ * через reportFailure(): AirConManagerBench тогда завершается с ненулевым кодом.
+ */
+
+/**
+ * @brief Выводит результат измерения пропускной способности.
+ * @param name Название измерения.
+ * @param items Количество обработанных элементов.
+ * @param elapsedNs Затраченное время в наносекундах.
+ * @param unit Единица элементов (например, "samples").
+ */
+void reportThroughput(const QString &name, quint64 items, qint64 elapsedNs, const QString &unit);
+
+/**
+ * @brief Выводит распределение длительностей отдельных операций (минимум, среднее, процентили).
+ * @param name Название измерения.
+ * @param samplesNs Длительности операций в наносекундах (порядок не важен).
+ */
+void reportLatency(const QString &name, QVector<qint64> samplesNs);
+
+/**
+ * @brief Выводит отдельную величину: длительность кадра, размер, коэффициент, счётчик.
+ * @param name Название измерения.
+ * @param value Значение.
+ * @param unit Единица значения (например, "ms/frame").
+ */
+void reportValue(const QString &name, double value, const QString &unit);
+
+/**
+ * @brief Сообщает о непройденной проверке корректности; запуск завершится с кодом 2.
+ * @param name Название проверки.
+ * @param reason Описание расхождения.
+ */
+void reportFailure(const QString &name, const QString &reason);
+
+/**
+ * @brief Бенчмарки конвейера приёма данных датчиков.
+ */
+void benchIngest();
+
+/**
+ * @brief Бенчмарки хранилища и списка блоков парка.
+ */
+void benchFleet();
+
+/**
+ * @brief Бенчмарки истории измерений и графика.
+ */
+void benchHistory();
+
+/**
+ * @brief Бенчмарки сохранения и загрузки состояния.
+ */
+void benchSnapshot();
+
+/**
+ * @brief Бенчмарки журнала изменений состояния.
+ */
+void benchJournal();
+
+/**
+ * @brief Бенчмарки смены темы оформления.
+ */
+void benchTheme();
+
+/**
+ * @brief Бенчмарки ядра пересчёта единиц измерения.
+ */
+void benchConversion();
+
+/**
+ * @brief Бенчмарки отрисовки приборной панели.
+ */
+void benchGauge();
+
+/**
+ * @brief Бенчмарки форматирования текстовых меток показаний.
+ */
+void benchLabels();
+
+/**
+ * @brief Бенчмарки объединения обновлений сцены по кадрам.
+ */
+void benchScheduler();
+
+/**
+ * @brief Бенчмарки горячих путей главного окна CoolWindow.
+ */
+void benchCoolWindow();
+
+/**
+ * @brief Бенчмарки теплового симулятора комнат.
+ */
+void benchThermal();
+
+/**
+ * @brief Бенчмарки регулятора температуры: стоимость шага и опоздание тактов под нагрузкой.
+ */
+void benchController();
+
+/**
+ * @brief Бенчмарки передачи измерений в поток GUI: сигналы между потоками против SampleRing.
+ */
+void benchRing();
+
+/**
+ * @brief Бенчмарки записи входных воздействий: размер события, кодирование и воспроизведение без пауз.
+ */
+void benchReplay();
+
+/**
+ * @brief Бенчмарки сжатого архива измерений: степень сжатия, кодирование, декодирование и позиционирование.
+ */
+void benchArchive();
+
+/**
+ * @brief Бенчмарки измерителей длительности: добавочная стоимость ACM_PROBE, запись и отчёт гистограмм.
+ */
+void benchProbe();
+
+/**
+ * @brief Бенчмарки трассировки событий: стоимость области и доставки события, выгрузка и обнаружение зависания.
+ */
+void benchTrace();
+
+/**
+ * @brief Бенчмарки сервера управления: пропускная способность конвейера и пакетов, задержка запроса.
+ */
+void benchControl();
+
+/**
+ * @brief Бенчмарки сервера Modbus-TCP: нагрузка множеством клиентов по локальному адресу.
+ */
+void benchModbus();
+
+/**
+ * @brief Бенчмарки шины изменений состояния: стоимость раздачи 1 и 50 подписчикам, окна объединения.
+ */
+void benchBus();
+
+/**
+ * @brief Бенчмарки недельного расписания: постановка и отмена 100 000 таймеров, срабатывания за неделю.
+ */
+void benchWeekly();
+
+#endif
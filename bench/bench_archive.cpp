@@ -0,0 +1,114 @@
+/**
+ * @file bench_archive.cpp
+ * @brief Бенчмарки сжатого архива измерений.
+ *
+ * Кодирует неделю измерений 1 Гц двух видов: показания реального датчика с конечной
+ * дискретностью (0.1 °C, 0.5 %, 1 Па), меняющиеся редко, и гладкие синусоиды полной
+ * точности — худший случай для исключающего ИЛИ. Для каждого набора выводятся
+ * скорость кодирования и декодирования (в байтах исходных измерений по 32 байта),
+ * степень сжатия и задержка позиционирования по времени.
+ */
+
+#include "bench.h"
+#include "../includes/historyarchive.h"
+
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+const int kWeek = 7 * 24 * 60 * 60; ///< Измерений за неделю при 1 Гц
+const qint64 kStartUs = 1700000000LL * 1000000; ///< Метка первого измерения
+
+/**
+ * @brief Генератор псевдослучайных чисел с фиксированным начальным значением.
+ */
+quint32 nextRandom(quint32 &state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * @brief Формирует неделю измерений.
+ * @param quantized true — показания датчика с конечной дискретностью, false — гладкие значения.
+ */
+QVector<SensorSample> makeWeek(bool quantized) {
+    QVector<SensorSample> samples(kWeek);
+    quint32 seed = 2024;
+    qint64 timestamp = kStartUs;
+    for (int i = 0; i < kWeek; ++i) {
+        const double day = (i % 86400) * (2 * M_PI / 86400);
+        const double noise = (nextRandom(seed) % 1000) / 1000.0 - 0.5;
+        double t = 22.0 + 3.0 * std::sin(day) + 0.05 * noise;
+        double h = 45.0 + 8.0 * std::cos(day) + 0.3 * noise;
+        double p = 101325.0 + 150.0 * std::sin(day / 7.0 + 1.0) + 0.8 * noise;
+        if (quantized) {
+            t = qRound(t * 10.0) / 10.0;
+            h = qRound(h * 2.0) / 2.0;
+            p = qRound(p);
+        }
+        // Опрос раз в секунду; изредка планировщик сдвигает метку на несколько миллисекунд
+        timestamp += 1000000 + (nextRandom(seed) % 64 == 0 ? qint64(nextRandom(seed) % 4000) - 2000 : 0);
+        samples[i] = SensorSample{ timestamp, t, h, p };
+    }
+    return samples;
+}
+
+/**
+ * @brief Кодирует, декодирует и позиционирует архив из заданных измерений.
+ */
+void benchDataset(const char *name, const QVector<SensorSample> &samples) {
+    const quint64 rawBytes = quint64(samples.size()) * sizeof(SensorSample);
+    HistoryArchive archive;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const SensorSample &s : samples) {
+        archive.append(s.timestampUs, s.temperature, s.humidity, s.pressure);
+    }
+    const qint64 encodeNs = timer.nsecsElapsed();
+    reportThroughput(QString("archive/%1 encode").arg(name), rawBytes, encodeNs, "bytes");
+
+    QVector<SensorSample> decoded(samples.size());
+    timer.start();
+    ArchiveCursor cursor(archive);
+    const int count = cursor.read(decoded.data(), decoded.size());
+    const qint64 decodeNs = timer.nsecsElapsed();
+    reportThroughput(QString("archive/%1 decode").arg(name), quint64(count) * sizeof(SensorSample), decodeNs, "bytes");
+
+    bool exact = count == samples.size();
+    for (int i = 0; exact && i < count; ++i) {
+        exact = decoded[i].timestampUs == samples[i].timestampUs && decoded[i].temperature == samples[i].temperature
+            && decoded[i].humidity == samples[i].humidity && decoded[i].pressure == samples[i].pressure;
+    }
+    reportValue(QString("archive/%1 size").arg(name), double(archive.sizeBytes()) / samples.size(), "bytes/sample");
+    reportValue(QString("archive/%1 compression ratio").arg(name),
+                double(rawBytes) / qMax<qint64>(1, archive.sizeBytes()), "x");
+    if (!exact) {
+        reportFailure(QString("archive/%1 decode").arg(name), "decoded samples differ from the encoded ones");
+    }
+
+    QVector<qint64> seekNs;
+    quint32 seed = 99;
+    SensorSample sample;
+    for (int i = 0; i < 2000; ++i) {
+        const qint64 target = samples[nextRandom(seed) % samples.size()].timestampUs;
+        timer.start();
+        ArchiveCursor seeker(archive);
+        seeker.seek(target);
+        seeker.next(sample);
+        seekNs.append(timer.nsecsElapsed());
+    }
+    reportLatency(QString("archive/%1 seek + read").arg(name), seekNs);
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки сжатого архива измерений.
+ */
+void benchArchive() {
+    benchDataset("sensor-week", makeWeek(true));
+    benchDataset("smooth-week", makeWeek(false));
+}
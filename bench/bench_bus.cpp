@@ -0,0 +1,105 @@
+/**
+ * @file bench_bus.cpp
+ * @brief Бенчмарки шины изменений состояния.
+ *
+ * Измеряет стоимость раздачи одного изменения 1 и 50 подписчикам на все поля,
+ * 50 подписчикам на разные поля (изменение нужно немногим), 50 подписчикам с окном
+ * объединения, а также полный путь от слота модели до подписчиков.
+ */
+
+#include "bench.h"
+#include "../includes/climatemodel.h"
+#include "../includes/statebus.h"
+
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace {
+
+const int kDeltas = 1000000; ///< Изменений на измерение раздачи
+const int kModelChanges = 200000; ///< Изменений уставки на измерение полного пути
+const int kManySubscribers = 50; ///< Подписчиков в измерении раздачи многим
+const int kWindowMs = 16; ///< Окно объединения подписчиков с окном, мс
+
+const quint32 kFields[] = { ClimateModel::TemperatureChanged, ClimateModel::HumidityChanged, ClimateModel::PressureChanged,
+                            ClimateModel::SetpointChanged, ClimateModel::HGateChanged, ClimateModel::PowerChanged }; ///< Поля, которые по очереди меняются в измерении раздачи
+const int kFieldCount = sizeof(kFields) / sizeof(kFields[0]); ///< Количество полей в kFields
+
+/**
+ * @brief Публикует kDeltas изменений по одному полю и выводит стоимость изменения и доставки.
+ * @param name Название результата.
+ * @param bus Шина с подписчиками.
+ */
+void publishRun(const char *name, StateBus &bus) {
+    StateDelta delta;
+    const quint64 deliveredBefore = bus.deliveredDeltas();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kDeltas; ++i) {
+        delta.fields = kFields[i % kFieldCount];
+        delta.temperature = 20.0 + (i & 7);
+        delta.setpoint = delta.temperature;
+        bus.publish(delta);
+    }
+    bus.flush();
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    const quint64 deliveries = bus.deliveredDeltas() - deliveredBefore;
+    reportThroughput(name, kDeltas, elapsedNs, "changes");
+    reportValue(QString("%1, cost").arg(name), static_cast<double>(elapsedNs) / kDeltas, "ns/change");
+    reportValue(QString("%1, deliveries").arg(name), static_cast<double>(deliveries), "deliveries");
+    reportValue(QString("%1, delivery cost").arg(name), deliveries != 0 ? static_cast<double>(elapsedNs) / deliveries : 0.0,
+                "ns/delivery");
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки шины изменений состояния.
+ */
+void benchBus() {
+    double sink = 0.0;
+    const StateBus::Handler handler = [&sink](const StateDelta &delta) { sink += delta.temperature; };
+    {
+        StateBus bus;
+        bus.subscribe(ClimateModel::AllChanged, nullptr, handler);
+        publishRun("bus/publish, 1 subscriber", bus);
+    }
+    {
+        StateBus bus;
+        for (int i = 0; i < kManySubscribers; ++i) {
+            bus.subscribe(ClimateModel::AllChanged, nullptr, handler);
+        }
+        publishRun("bus/publish, 50 subscribers", bus);
+    }
+    {
+        StateBus bus;
+        for (int i = 0; i < kManySubscribers; ++i) {
+            bus.subscribe(kFields[i % kFieldCount] | (i % 2 ? 0 : ClimateModel::ThemeChanged), nullptr, handler);
+        }
+        publishRun("bus/publish, 50 subscribers by field", bus);
+    }
+    {
+        StateBus bus;
+        for (int i = 0; i < kManySubscribers; ++i) {
+            bus.subscribe(ClimateModel::AllChanged, nullptr, handler, kWindowMs);
+        }
+        publishRun("bus/publish, 50 subscribers 16 ms window", bus);
+    }
+
+    for (int subscribers : { 0, 1, kManySubscribers }) {
+        ClimateModel model;
+        for (int i = 0; i < subscribers; ++i) {
+            model.stateBus()->subscribe(ClimateModel::SetpointChanged, nullptr, handler);
+        }
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kModelChanges; ++i) {
+            model.setSetpoint(20 + (i & 3));
+        }
+        reportThroughput(QString("bus/model setSetpoint, %1 subscribers").arg(subscribers), kModelChanges,
+                         timer.nsecsElapsed(), "changes");
+    }
+    if (sink < 0.0) {
+        std::printf("%f\n", sink);
+    }
+}
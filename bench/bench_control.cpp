@@ -0,0 +1,187 @@
+/**
+ * @file bench_control.cpp
+ * @brief Бенчмарки сервера управления по локальному сокету.
+ *
+ * Клиент в отдельном потоке отправляет запросы по локальному сокету, пока поток бенчмарка
+ * крутит цикл событий модели. Измеряются пропускная способность get и set_setpoint
+ * с конвейером запросов, пакетов по 100 команд, задержка одиночного запроса и время,
+ * которое порции команд занимают в потоке модели (ControlServer::execute).
+ */
+
+#include "bench.h"
+#include "../includes/climatemodel.h"
+#include "../includes/controlserver.h"
+#include "../includes/latencyprobe.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QLocalSocket>
+#include <thread>
+
+namespace {
+
+const int kRequests = 200000; ///< Запросов на измерение пропускной способности
+const int kWindow = 256; ///< Запросов в полёте при конвейере
+const int kBatchSize = 100; ///< Команд в пакете
+const int kRoundTrips = 5000; ///< Одиночных запросов на измерение задержки
+const int kTimeoutMs = 10000; ///< Наибольшее ожидание ответа
+
+/**
+ * @struct ClientRun
+ * @brief Итог прогона клиента.
+ */
+struct ClientRun
+{
+    qint64 elapsedNs = 0; ///< Время прогона
+    int responses = 0; ///< Получено строк ответа
+    int errors = 0; ///< Ответов с "ok":false
+    QVector<qint64> roundTrips; ///< Задержки одиночных запросов (при окне 1)
+};
+
+/**
+ * @brief Отправляет строки запросов с ограниченным числом ожидающих ответа и читает ответы.
+ * @param name Имя сервера.
+ * @param lines Строки запросов (с переводом строки).
+ * @param window Наибольшее число строк без ответа (1 — запрос-ответ).
+ */
+ClientRun runClient(const QString &name, const QVector<QByteArray> &lines, int window) {
+    ClientRun run;
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    if (!socket.waitForConnected(kTimeoutMs)) {
+        return run;
+    }
+    run.roundTrips.reserve(window == 1 ? lines.size() : 0);
+    QElapsedTimer timer;
+    QElapsedTimer roundTrip;
+    QByteArray tail;
+    int sent = 0;
+    timer.start();
+    while (run.responses < lines.size()) {
+        QByteArray out;
+        while (sent < lines.size() && sent - run.responses < window) {
+            out.append(lines[sent++]);
+        }
+        if (!out.isEmpty()) {
+            roundTrip.start();
+            socket.write(out);
+            socket.flush();
+        }
+        if (!socket.waitForReadyRead(kTimeoutMs)) {
+            break;
+        }
+        tail.append(socket.readAll());
+        int start = 0;
+        int newline;
+        while ((newline = tail.indexOf('\n', start)) >= 0) {
+            if (tail.indexOf("\"ok\":false", start) >= 0 && tail.indexOf("\"ok\":false", start) < newline) {
+                ++run.errors;
+            }
+            ++run.responses;
+            start = newline + 1;
+            if (window == 1) {
+                run.roundTrips.append(roundTrip.nsecsElapsed());
+            }
+        }
+        tail.remove(0, start);
+    }
+    run.elapsedNs = timer.nsecsElapsed();
+    return run;
+}
+
+/**
+ * @brief Запускает клиента в отдельном потоке и крутит цикл событий до его завершения.
+ * @param name Имя сервера.
+ * @param lines Строки запросов.
+ * @param window Наибольшее число строк без ответа.
+ */
+ClientRun drive(const QString &name, const QVector<QByteArray> &lines, int window) {
+    ClientRun run;
+    QEventLoop loop;
+    std::thread client([&]() {
+        run = runClient(name, lines, window);
+        QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    });
+    loop.exec();
+    client.join();
+    return run;
+}
+
+/**
+ * @brief Выводит пропускную способность прогона; потерянные ответы и ответы с ошибкой — непройденная проверка.
+ * @param name Название результата.
+ * @param run Итог прогона.
+ * @param requests Команд в прогоне.
+ * @param lines Строк запросов в прогоне.
+ */
+void reportRun(const char *name, const ClientRun &run, int requests, int lines) {
+    if (run.responses != lines) {
+        reportFailure(name, QString("%1 of %2 responses").arg(run.responses).arg(lines));
+        return;
+    }
+    reportThroughput(name, requests, run.elapsedNs, "requests");
+    if (run.errors != 0) {
+        reportFailure(name, QString("%1 error responses").arg(run.errors));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки сервера управления по локальному сокету.
+ */
+void benchControl() {
+    ClimateModel model;
+    ControlServer server(&model);
+    const QString name = QString("aircon-bench-control-%1").arg(QCoreApplication::applicationPid());
+    if (!server.listen(name)) {
+        reportFailure("control", QString("cannot listen on %1").arg(name));
+        return;
+    }
+
+    QVector<QByteArray> gets;
+    QVector<QByteArray> sets;
+    for (int i = 0; i < kRequests; ++i) {
+        gets.append(QByteArray("{\"id\":") + QByteArray::number(i) + ",\"op\":\"get\"}\n");
+        sets.append(QByteArray("{\"id\":") + QByteArray::number(i) + ",\"op\":\"set_setpoint\",\"value\":"
+                    + QByteArray::number(20 + i % 5) + "}\n");
+    }
+    QVector<QByteArray> batches;
+    for (int i = 0; i < kRequests / kBatchSize; ++i) {
+        QByteArray line("[");
+        for (int j = 0; j < kBatchSize; ++j) {
+            line.append(j % 2 ? "{\"op\":\"get\"}," : "{\"op\":\"set_gates\",\"h\":10,\"v\":5},");
+        }
+        line.chop(1);
+        batches.append(line.append("]\n"));
+    }
+
+    reportRun("control/get pipelined", drive(name, gets, kWindow), kRequests, kRequests);
+
+    LatencyHistogram *execute = LatencyProbes::histogram("ControlServer::execute");
+    execute->reset();
+    reportRun("control/set_setpoint pipelined", drive(name, sets, kWindow), kRequests, kRequests);
+    reportRun("control/batch of 100 (set_gates+get)", drive(name, batches, 4), kRequests, batches.size());
+    if (LatencyProbes::isEnabled() && execute->count() != 0) {
+        const double usPerTick = LatencyClock::nanosecondsPerTick() / 1000.0;
+        reportValue("control/model thread per hop, count", static_cast<double>(execute->count()), "hops");
+        reportValue("control/model thread per hop, p50", execute->percentile(50.0) * usPerTick, "us");
+        reportValue("control/model thread per hop, p99", execute->percentile(99.0) * usPerTick, "us");
+        reportValue("control/model thread per hop, max", execute->max() * usPerTick, "us");
+    }
+
+    const ClientRun getTrips = drive(name, gets.mid(0, kRoundTrips), 1);
+    if (getTrips.responses == kRoundTrips) {
+        reportLatency("control/get round trip", getTrips.roundTrips);
+    } else {
+        reportFailure("control/get round trip", QString("%1 of %2 responses").arg(getTrips.responses).arg(kRoundTrips));
+    }
+    const ClientRun setTrips = drive(name, sets.mid(0, kRoundTrips), 1);
+    if (setTrips.responses == kRoundTrips) {
+        reportLatency("control/set_setpoint round trip", setTrips.roundTrips);
+    } else {
+        reportFailure("control/set_setpoint round trip", QString("%1 of %2 responses").arg(setTrips.responses).arg(kRoundTrips));
+    }
+    server.close();
+}
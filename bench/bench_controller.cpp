@@ -0,0 +1,122 @@
+/**
+ * @file bench_controller.cpp
+ * @brief Бенчмарки регулятора температуры.
+ *
+ * Измеряет стоимость шага закона регулирования и опоздание тактов потока регулятора
+ * с периодом 1 мс: в простое, пока основной поток непрерывно перерисовывает сцену,
+ * и пока все ядра заняты тепловым симулятором. Цель — опоздание меньше 1 мс.
+ */
+
+#include "bench.h"
+#include "../includes/climatecontroller.h"
+#include "../includes/thermalsimulator.h"
+
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QThread>
+#include <cstdio>
+
+namespace {
+
+const qint64 kPeriodNs = 1000000; ///< Период регулятора в бенчмарке (1 мс)
+const qint64 kJitterBudgetNs = 1000000; ///< Допустимое опоздание такта
+const int kPhaseMs = 2000; ///< Длительность каждого режима нагрузки
+
+/**
+ * @brief Выводит статистику опоздания тактов и добавляет её в JSON-отчёт.
+ */
+void printJitter(const QString &name, const JitterStats &stats) {
+    reportValue(name + ", ticks", static_cast<double>(stats.ticks), "ticks");
+    reportValue(name + ", mean", stats.meanNs / 1e3, "us");
+    reportValue(name + ", p99", stats.p99Ns / 1e3, "us");
+    reportValue(name + ", max", stats.maxNs / 1e3, "us");
+    reportValue(name + ", overruns", static_cast<double>(stats.overruns),
+                stats.maxNs < kJitterBudgetNs && stats.overruns == 0 ? "overruns (ok)" : "overruns (over budget)");
+}
+
+/**
+ * @brief Запускает регулятор на время режима, выполняя в основном потоке заданную нагрузку.
+ */
+template <typename Load>
+void measureJitter(const QString &name, Load load) {
+    ClimateController controller;
+    ControllerSettings settings;
+    settings.mode = ControllerSettings::Pid;
+    settings.enabled = 1;
+    settings.measured = 25.0;
+    controller.setSettings(settings);
+    controller.start(kPeriodNs);
+
+    QThread::msleep(50); // Поток запущен, приоритет выставлен
+    controller.resetJitter();
+
+    QElapsedTimer timer;
+    timer.start();
+    int round = 0;
+    while (timer.elapsed() < kPhaseMs) {
+        load(round++);
+        settings.measured = 25.0 + (round % 100) * 0.01;
+        controller.setSettings(settings); // Поток интерфейса передаёт новые входы, не ожидая регулятор
+    }
+
+    const JitterStats stats = controller.jitter();
+    controller.stop();
+    printJitter(name, stats);
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки регулятора температуры.
+ */
+void benchController() {
+    // Стоимость одного шага закона регулирования
+    for (int mode : {ControllerSettings::Hysteresis, ControllerSettings::Pid}) {
+        ControllerSettings settings;
+        settings.mode = mode;
+        settings.enabled = 1;
+        ControllerState state;
+        const int steps = 10000000;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < steps; ++i) {
+            settings.measured = 21.0 + (i & 1023) * 0.002;
+            state = ClimateController::compute(settings, state, 0.1);
+        }
+        const qint64 elapsed = timer.nsecsElapsed();
+        reportThroughput(mode == ControllerSettings::Pid ? "controller/compute, pid" : "controller/compute, hysteresis",
+                         steps, elapsed, "steps");
+        if (state.tick == 0) {
+            std::printf("unexpected controller state\n"); // Результат используется, цикл не выбрасывается
+        }
+    }
+
+    // Опоздание тактов без нагрузки
+    measureJitter("controller/jitter, 1 ms period, idle", [](int) {
+        QThread::msleep(1);
+    });
+
+    // Опоздание тактов, пока основной поток перерисовывает сцену
+    QGraphicsScene scene(0, 0, 800, 600);
+    for (int i = 0; i < 2000; ++i) {
+        scene.addEllipse((i * 37) % 780, (i * 53) % 580, 20, 20, QPen(Qt::black), QBrush(QColor::fromHsv(i % 360, 200, 200)));
+    }
+    QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+    measureJitter("controller/jitter, 1 ms period, redraw", [&](int) {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        scene.render(&painter);
+    });
+
+    // Опоздание тактов, пока все ядра заняты тепловым симулятором
+    ThermalSimulator sim;
+    sim.resize(100000, 28.0, 55.0);
+    for (int room = 0; room < sim.size(); ++room) {
+        sim.setControl(room, true, 22.0, 0, 0);
+    }
+    measureJitter(QString("controller/jitter, 1 ms period, %1 busy threads").arg(sim.threadCount()), [&](int) {
+        sim.step(10);
+    });
+}
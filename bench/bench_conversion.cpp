@@ -0,0 +1,126 @@
+/**
+ * @file bench_conversion.cpp
+ * @brief Бенчмарки ядра пересчёта единиц измерения.
+ *
+ * Сравнивает векторный и скалярный пересчёт массивов с копированием памяти
+ * того же объёма и проверяет совпадение путей и точность пересчёта туда и обратно;
+ * расхождение считается непройденной проверкой (ненулевой код завершения).
+ */
+
+#include "bench.h"
+#include "../includes/unitconversion.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const double kVectorUlps = 4.0; ///< Допустимое расхождение NEON со скалярным путём, единиц последнего разряда
+
+/**
+ * @brief Проверяет пересчёт между всеми парами единиц величины.
+ *
+ * Векторный путь должен совпадать со скалярным бит в бит (на NEON, где умножение
+ * и сложение могут сливаться, — с точностью до kVectorUlps), а пересчёт туда и обратно —
+ * возвращать исходное значение с погрешностью не больше tolerance.
+ * @param name Название величины.
+ * @param units Количество единиц.
+ * @param table Функция выбора преобразования.
+ * @param values Исходные значения.
+ * @param tolerance Допустимая погрешность пересчёта туда и обратно в исходных единицах.
+ */
+void checkQuantity(const char *name, int units, UnitConversion::Affine (*table)(int, int), const QVector<double> &values,
+                   double tolerance) {
+    const bool bitExact = std::strcmp(UnitConversion::backend(), "neon") != 0;
+    int mismatches = 0;
+    double worstError = 0.0;
+    for (int from = 1; from <= units; ++from) {
+        for (int to = 1; to <= units; ++to) {
+            QVector<double> simd = values;
+            QVector<double> scalar = values;
+            UnitConversion::apply(table(from, to), simd.data(), simd.size());
+            UnitConversion::applyScalar(table(from, to), scalar.data(), scalar.size());
+            for (int i = 0; i < values.size(); ++i) {
+                const bool same = bitExact ? memcmp(&simd[i], &scalar[i], sizeof(double)) == 0
+                                           : std::fabs(simd[i] - scalar[i])
+                                                 <= kVectorUlps * DBL_EPSILON * qMax(1.0, std::fabs(scalar[i]));
+                mismatches += same ? 0 : 1;
+            }
+
+            UnitConversion::apply(table(to, from), simd.data(), simd.size());
+            for (int i = 0; i < values.size(); ++i) {
+                worstError = qMax(worstError, std::fabs(values[i] - simd[i]));
+            }
+        }
+    }
+    reportValue(QString("%1, round-trip max error").arg(name), worstError, "units");
+    if (mismatches != 0) {
+        reportFailure(QString("%1, vector == scalar").arg(name),
+                      QString("%1 values differ on %2").arg(mismatches).arg(UnitConversion::backend()));
+    }
+    if (!(worstError <= tolerance)) {
+        reportFailure(QString("%1, round-trip").arg(name),
+                      QString("max error %1 exceeds %2").arg(worstError).arg(tolerance));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки ядра пересчёта единиц измерения.
+ */
+void benchConversion() {
+    std::printf("%-48s backend: %s\n", "conversion", UnitConversion::backend());
+
+    // Проверка путей и точности на значениях из рабочих диапазонов
+    {
+        QVector<double> temperatures;
+        QVector<double> pressures;
+        for (int i = 0; i < 100003; ++i) {
+            temperatures.append(-60.0 + i * 0.0017);
+            pressures.append(80000.0 + i * 0.37);
+        }
+        checkQuantity("conversion/temperature C/F/K", 3, &UnitConversion::temperature, temperatures, 1e-9);
+        checkQuantity("conversion/pressure Pa/mmHg", 2, &UnitConversion::pressure, pressures, 1e-6);
+    }
+
+    // Пропускная способность: массив в кэше и массив много больше кэша
+    for (int count : {1 << 16, 1 << 24}) {
+        QVector<double> data(count, 21.5);
+        QVector<double> copy(count, 0.0);
+        const UnitConversion::Affine c2f = UnitConversion::temperature(1, 2);
+        const UnitConversion::Affine f2c = UnitConversion::temperature(2, 1);
+        const int passes = count > (1 << 20) ? 10 : 1000;
+        const quint64 items = quint64(count) * passes;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int pass = 0; pass < passes; ++pass) {
+            UnitConversion::apply(pass % 2 == 0 ? c2f : f2c, data.data(), count);
+        }
+        qint64 vectorNs = timer.nsecsElapsed();
+
+        timer.restart();
+        for (int pass = 0; pass < passes; ++pass) {
+            UnitConversion::applyScalar(pass % 2 == 0 ? c2f : f2c, data.data(), count);
+        }
+        qint64 scalarNs = timer.nsecsElapsed();
+
+        timer.restart();
+        for (int pass = 0; pass < passes; ++pass) {
+            memcpy(pass % 2 == 0 ? copy.data() : data.data(), pass % 2 == 0 ? data.constData() : copy.constData(),
+                   count * sizeof(double));
+        }
+        qint64 memcpyNs = timer.nsecsElapsed();
+
+        const double bytes = double(items) * sizeof(double) * 2; // Чтение и запись
+        const QString name = QString("conversion/in-place %1 values").arg(count);
+        reportValue(name + ", vector", bytes / vectorNs, "GB/s");
+        reportValue(name + ", scalar", bytes / scalarNs, "GB/s");
+        reportValue(name + ", memcpy", bytes / memcpyNs, "GB/s");
+    }
+}
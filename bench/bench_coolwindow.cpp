@@ -0,0 +1,236 @@
+/**
+ * @file bench_coolwindow.cpp
+ * @brief Бенчмарки горячих путей главного окна CoolWindow.
+ *
+ * Измеряет длительность отдельных вызовов на настоящем окне: приём измерения,
+ * применение изменений к сцене, обновление уровней и стрелок, смену темы, первое
+ * открытие окон настроек и ввода, процессорное время вращения вентилятора, сохранение и загрузку состояния при разных
+ * размерах парка и истории, холодный запуск окна. Окно работает во временном каталоге, чтобы не
+ * затрагивать файлы состояния пользователя.
+ */
+
+#include "bench.h"
+#include "../includes/coolwindow.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+const int kRuns = 2000; ///< Вызовов на измерение быстрых операций
+const int kDialogRuns = 50; ///< Открытий окон на измерение
+const int kPersistRuns = 20; ///< Сохранений и загрузок на измерение
+const int kFanIdleMs = 1000; ///< Длительность измерения вращения вентилятора
+const int kColdStartRuns = 20; ///< Запусков окна на измерение
+const qint64 kColdStartTimeoutMs = 5000; ///< Наибольшее ожидание окончания запуска
+
+} // namespace
+
+/**
+ * @class CoolWindowBench
+ * @brief Доступ бенчмарков к закрытым методам CoolWindow.
+ */
+class CoolWindowBench
+{
+public:
+    /**
+     * @brief Запускает бенчмарки на окне.
+     * @param window Окно.
+     */
+    static void run(CoolWindow &window) {
+        ClimateModel *model = window.model;
+        if (!model->isOn()) {
+            window.toggleIndicator();
+        }
+        window.sceneUpdates->flushNow();
+
+        QElapsedTimer timer;
+        QVector<qint64> samples;
+        samples.reserve(kRuns);
+
+        // Приём измерения: модель, журнал, пометка сцены
+        for (int i = 0; i < kRuns; ++i) {
+            timer.start();
+            window.acceptNewData(18.0 + (i % 100) * 0.1, 40.0 + i % 20, 87000.0 + i % 500);
+            samples.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/acceptNewData", samples);
+
+        // Применение всех изменений сцены за кадр
+        samples.resize(0);
+        for (int i = 0; i < kRuns; ++i) {
+            model->setReading(18.0 + (i % 100) * 0.1, 40.0 + i % 20, 87000.0 + i % 500);
+            window.sceneUpdates->markDirty(CoolWindow::ReadingFields | CoolWindow::TrendField);
+            timer.start();
+            window.sceneUpdates->flushNow();
+            samples.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/scene flush (readings)", samples);
+
+        // Уровни показаний
+        samples.resize(0);
+        for (int i = 0; i < kRuns; ++i) {
+            model->setReading(18.0 + (i % 100) * 0.1, 40.0 + i % 20, 87000.0 + i % 500);
+            timer.start();
+            window.setTemp();
+            window.setHum();
+            window.setPres();
+            samples.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/setTemp+setHum+setPres", samples);
+
+        // Стрелки жалюзи
+        samples.resize(0);
+        for (int i = 0; i < kRuns; ++i) {
+            model->setGates((i % 19) * 5, (i % 19) * 5 - 45);
+            timer.start();
+            window.updateHArrow();
+            window.updateVArrow();
+            samples.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/updateHArrow+updateVArrow", samples);
+        QApplication::processEvents();
+
+        // Смена темы с перерисовкой окна
+        samples.resize(0);
+        window.show();
+        QApplication::processEvents();
+        for (int i = 0; i < 100; ++i) {
+            timer.start();
+            if (i % 2 == 0) {
+                window.applyDarkTheme();
+            } else {
+                window.applyLightTheme();
+            }
+            window.repaint();
+            samples.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/theme switch", samples);
+
+        // Включённый блок без изменений: кадры и процессорное время вращения вентилятора
+        for (const bool visible : {true, false}) {
+            window.setVisible(visible);
+            QApplication::processEvents();
+            const quint64 framesBefore = window.frameClock->frameCount();
+            const std::clock_t cpuBefore = std::clock();
+            QEventLoop loop;
+            QTimer::singleShot(kFanIdleMs, &loop, &QEventLoop::quit);
+            timer.start();
+            loop.exec();
+            const qint64 elapsedNs = timer.nsecsElapsed();
+            const double cpuNs = double(std::clock() - cpuBefore) * 1e9 / CLOCKS_PER_SEC;
+            const QString name = visible ? "coolwindow/fan idle-on, visible" : "coolwindow/fan idle-on, hidden";
+            reportThroughput(name, window.frameClock->frameCount() - framesBefore, elapsedNs, "frames");
+            reportValue(name + ", CPU", 100.0 * cpuNs / qMax<qint64>(1, elapsedNs), "%");
+        }
+        window.show();
+        QApplication::processEvents();
+
+        // Первое открытие окон настроек и ввода
+        samples.resize(0);
+        for (int i = 0; i < kDialogRuns; ++i) {
+            timer.start();
+            window.openSettingsWindow();
+            QApplication::processEvents();
+            samples.append(timer.nsecsElapsed());
+            Settings *dialog = window.settingsWindow;
+            dialog->done(0);
+            delete dialog;
+        }
+        reportLatency("coolwindow/openSettingsWindow (first open)", samples);
+
+        samples.resize(0);
+        for (int i = 0; i < kDialogRuns; ++i) {
+            timer.start();
+            window.openInputWindow();
+            QApplication::processEvents();
+            samples.append(timer.nsecsElapsed());
+            CoolInput *dialog = window.inputWindow;
+            dialog->done(0);
+            delete dialog;
+        }
+        reportLatency("coolwindow/openInputWindow (first open)", samples);
+        window.hide();
+
+        // Сохранение и загрузка при разных размерах состояния
+        const struct {
+            int units;
+            int historySamples;
+            const char *label;
+        } sizes[] = {
+            {1, 0, "1 unit"},
+            {1000, 3600, "1k units, 1 h history"},
+            {100000, 86400, "100k units, 24 h history"},
+        };
+        for (const auto &size : sizes) {
+            window.setFleetSize(size.units);
+            model->clearHistory();
+            for (int i = 0; i < size.historySamples; ++i) {
+                model->recordHistory(qint64(i) * 1000000, 20.0 + (i % 50) * 0.1, 45.0, 87000.0 + i % 300);
+            }
+            const QString path = QString("bench_state_%1.bin").arg(size.units);
+
+            samples.resize(0);
+            for (int i = 0; i < kPersistRuns; ++i) {
+                timer.start();
+                model->save(path);
+                samples.append(timer.nsecsElapsed());
+            }
+            reportLatency(QString("coolwindow/save, %1").arg(size.label), samples);
+
+            samples.resize(0);
+            for (int i = 0; i < kPersistRuns; ++i) {
+                timer.start();
+                model->load(path);
+                samples.append(timer.nsecsElapsed());
+            }
+            reportLatency(QString("coolwindow/load, %1").arg(size.label), samples);
+        }
+        window.setFleetSize(1);
+    }
+
+    /**
+     * @brief Измеряет холодный запуск окна: конструктор, первый кадр и отложенную работу.
+     */
+    static void runColdStart() {
+        QElapsedTimer timer;
+        QVector<qint64> constructed, complete;
+        for (int i = 0; i < kColdStartRuns; ++i) {
+            timer.start();
+            CoolWindow window;
+            constructed.append(timer.nsecsElapsed());
+            window.show();
+            while (!window.isStartupFinished() && timer.elapsed() < kColdStartTimeoutMs) {
+                QApplication::processEvents();
+            }
+            complete.append(timer.nsecsElapsed());
+        }
+        reportLatency("coolwindow/cold start, constructor", constructed);
+        reportLatency("coolwindow/cold start, to deferred work done", complete);
+    }
+};
+
+/**
+ * @brief Бенчмарки горячих путей главного окна CoolWindow.
+ */
+void benchCoolWindow() {
+    QTemporaryDir dir;
+    const QString previous = QDir::currentPath();
+    if (!dir.isValid() || !QDir::setCurrent(dir.path())) {
+        std::printf("%-48s SKIPPED: no temporary directory\n", "coolwindow");
+        return;
+    }
+
+    {
+        CoolWindow window;
+        CoolWindowBench::run(window);
+    }
+    CoolWindowBench::runColdStart();
+    QDir::setCurrent(previous);
+}
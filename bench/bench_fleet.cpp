@@ -0,0 +1,74 @@
+/**
+ * @file bench_fleet.cpp
+ * @brief Бенчмарки хранилища и списка блоков парка.
+ *
+ * Измеряет расход памяти хранилища на блок, скорость прохода по колонке
+ * и время кадра при прокрутке виртуализированного списка из 10 000 блоков.
+ */
+
+#include "bench.h"
+#include "../includes/fleetstore.h"
+#include "../includes/fleetmodel.h"
+
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QTableView>
+#include <cstdio>
+
+/**
+ * @brief Бенчмарки хранилища и списка блоков парка.
+ */
+void benchFleet() {
+    for (int count : {1000, 10000, 100000}) {
+        FleetStore store;
+        store.resize(count, 22.0, 45.0, 101325.0);
+        reportValue(QString("fleet/memory, %1 units").arg(count), double(store.memoryUsage()) / count, "bytes/unit");
+    }
+
+    {
+        const int count = 100000;
+        FleetStore store;
+        store.resize(count, 22.0, 45.0, 101325.0);
+        const double *t = store.temperatureData();
+        QElapsedTimer timer;
+        timer.start();
+        double sum = 0;
+        const int passes = 100;
+        for (int pass = 0; pass < passes; ++pass) {
+            for (int id = 0; id < count; ++id) {
+                sum += t[id];
+            }
+        }
+        reportThroughput("fleet/column-scan", quint64(count) * passes, timer.nsecsElapsed(), "units");
+        if (sum < 0) {
+            std::printf("%f\n", sum);
+        }
+    }
+
+    {
+        const int count = 10000;
+        FleetStore store;
+        store.resize(count, 22.0, 45.0, 101325.0);
+        FleetModel model(&store);
+        model.setScales("C", "Pa");
+
+        QTableView view;
+        view.setModel(&model);
+        view.verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        view.verticalHeader()->setDefaultSectionSize(20);
+        view.resize(300, 600);
+        view.show();
+
+        QScrollBar *bar = view.verticalScrollBar();
+        const int frames = 600;
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            bar->setValue((bar->maximum() * frame) / frames);
+            view.viewport()->grab();
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+        reportValue("fleet/scroll-10k", elapsed / 1e6 / frames, "ms/frame");
+    }
+}
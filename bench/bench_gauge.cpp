@@ -0,0 +1,187 @@
+/**
+ * @file bench_gauge.cpp
+ * @brief Бенчмарки отрисовки приборной панели.
+ *
+ * Сравнивает прежнюю сцену (стандартные элементы прямоугольников и линий, настройки
+ * представления по умолчанию) со сценой из элементов gaugeitems.h и настроенным
+ * представлением. Для каждого кадра меняются уровни и углы стрелок; измеряются время
+ * кадра и площадь перерисованной области окна.
+ */
+
+#include "bench.h"
+#include "../includes/gaugeitems.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPaintEvent>
+#include <QtMath>
+
+namespace {
+
+/**
+ * @class PaintAreaCounter
+ * @brief Подсчитывает площадь областей, перерисованных в окне представления.
+ */
+class PaintAreaCounter : public QObject
+{
+public:
+    quint64 pixels = 0; ///< Суммарная площадь перерисовки
+    quint64 paints = 0; ///< Количество событий перерисовки
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::Paint) {
+            const QRegion region = static_cast<QPaintEvent *>(event)->region();
+            for (const QRect &rect : region) {
+                pixels += quint64(rect.width()) * rect.height();
+            }
+            ++paints;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+/**
+ * @brief Сцена приборной панели в прежнем виде.
+ */
+struct LegacyDashboard
+{
+    QGraphicsRectItem *levels[3];
+    QGraphicsLineItem *hArrow;
+    QGraphicsLineItem *vArrow;
+    QGraphicsPathItem *hAngleArc;
+
+    explicit LegacyDashboard(QGraphicsScene &scene) {
+        for (int i = 0; i < 3; ++i) {
+            scene.addRect(50 + 100 * i, 10, 30, 300);
+            levels[i] = scene.addRect(51 + 100 * i, 310, 28, 0, QPen(), QBrush(Qt::red));
+        }
+        hArrow = scene.addLine(0, 0, 0, -90, QPen(Qt::black, 3));
+        scene.addLine(450, 10, 450, 100, QPen(Qt::gray, 3));
+        scene.addLine(450, 10, 360, 10, QPen(Qt::gray, 3));
+        hAngleArc = scene.addPath(QPainterPath(), QPen(Qt::blue, 2));
+        vArrow = scene.addLine(0, 0, 0, -90, QPen(Qt::black, 3));
+        scene.addLine(405, 195, 360, 240, QPen(Qt::gray, 3));
+        scene.addLine(405, 195, 450, 240, QPen(Qt::gray, 3));
+    }
+
+    void set(int index, double level) {
+        levels[index]->setRect(51 + 100 * index, 310 - level, 28, level);
+    }
+
+    void setAngles(int h, int v) {
+        double radians = qDegreesToRadians(static_cast<double>(h + 90));
+        hArrow->setLine(450, 10, int(90 * qCos(radians)) + 450, int(90 * qSin(radians)) + 10);
+        QPainterPath path;
+        path.moveTo(450, 100);
+        path.arcTo(QRectF(360, -80, 180, 180), -90, -h);
+        hAngleArc->setPath(path);
+        radians = qDegreesToRadians(static_cast<double>(v + 90));
+        vArrow->setLine(405, 195, int(55 * qCos(radians)) + 405, int(55 * qSin(radians)) + 195);
+    }
+};
+
+/**
+ * @brief Сцена приборной панели из элементов gaugeitems.h.
+ */
+struct CachedDashboard
+{
+    LevelBarItem *levels[3];
+    GateArrowItem *hArrow;
+    GateArrowItem *vArrow;
+
+    explicit CachedDashboard(QGraphicsScene &scene) {
+        GaugeBackgroundItem *background = new GaugeBackgroundItem();
+        for (int i = 0; i < 3; ++i) {
+            background->addScale(QRectF(50 + 100 * i, 10, 30, 300));
+        }
+        background->addGuide(QLineF(450, 10, 450, 100));
+        background->addGuide(QLineF(450, 10, 360, 10));
+        background->addGuide(QLineF(405, 195, 360, 240));
+        background->addGuide(QLineF(405, 195, 450, 240));
+        background->setGuidePen(QPen(Qt::gray, 3));
+        scene.addItem(background);
+        for (int i = 0; i < 3; ++i) {
+            levels[i] = new LevelBarItem(QRectF(51 + 100 * i, 10, 28, 300), QBrush(Qt::red));
+            scene.addItem(levels[i]);
+        }
+        hArrow = new GateArrowItem(QPointF(450, 10), 90, QPen(Qt::black, 3));
+        hArrow->setArcPen(QPen(Qt::blue, 2));
+        scene.addItem(hArrow);
+        vArrow = new GateArrowItem(QPointF(405, 195), 55, QPen(Qt::black, 3));
+        scene.addItem(vArrow);
+    }
+
+    void set(int index, double level) {
+        levels[index]->setLevel(level);
+    }
+
+    void setAngles(int h, int v) {
+        hArrow->setAngle(h);
+        vArrow->setAngle(v);
+    }
+};
+
+/**
+ * @brief Прогоняет кадры обновления панели и выводит время кадра и площадь перерисовки.
+ * @param name Название измерения.
+ * @param tuned Настроить ли сцену и представление как в CoolWindow.
+ * @param onlyLevel Менять только один уровень (типичный кадр с новым измерением).
+ */
+template <typename Dashboard>
+void runFrames(const char *name, bool tuned, bool onlyLevel) {
+    QGraphicsScene scene;
+    Dashboard dashboard(scene);
+    dashboard.setAngles(0, 0);
+
+    QGraphicsView view(&scene);
+    if (tuned) {
+        scene.setItemIndexMethod(QGraphicsScene::NoIndex);
+        scene.setSceneRect(scene.itemsBoundingRect());
+        view.setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+        view.setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
+    }
+    view.resize(600, 450);
+    view.show();
+    QApplication::processEvents();
+    QApplication::processEvents();
+
+    PaintAreaCounter counter;
+    view.viewport()->installEventFilter(&counter);
+
+    const int frames = 2000;
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < frames; ++frame) {
+        const double level = 150 + 100 * qSin(frame * 0.05);
+        if (onlyLevel) {
+            dashboard.set(frame % 3, level);
+        } else {
+            for (int i = 0; i < 3; ++i) {
+                dashboard.set(i, level - 30 * i);
+            }
+            dashboard.setAngles(frame % 90, frame % 90 - 45);
+        }
+        QApplication::processEvents(); // Обработка изменённых элементов
+        QApplication::processEvents(); // Перерисовка окна
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    reportValue(QString("%1, frame").arg(name), elapsedNs / 1e6 / frames, "ms/frame");
+    reportValue(QString("%1, repainted").arg(name), counter.paints ? double(counter.pixels) / frames : 0.0, "px/frame");
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки отрисовки приборной панели.
+ */
+void benchGauge() {
+    runFrames<LegacyDashboard>("gauge/legacy items, one level", false, true);
+    runFrames<CachedDashboard>("gauge/cached items, one level", true, true);
+    runFrames<LegacyDashboard>("gauge/legacy items, all gauges", false, false);
+    runFrames<CachedDashboard>("gauge/cached items, all gauges", true, false);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file bench_history.cpp
+ * @brief Бенчмарки истории измерений и графика.
+ *
+ * Измеряет скорость добавления измерений в историю, прореживания суток данных
+ * с частотой 1 Гц и отрисовки графика в изображение.
+ */
+
+#include "bench.h"
+#include "../includes/samplehistory.h"
+#include "../includes/trendchart.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @brief Бенчмарки истории измерений и графика.
+ */
+void benchHistory() {
+    const int day = 24 * 60 * 60;
+    const qint64 start = 1700000000LL * 1000000;
+    SampleHistory history(day);
+
+    {
+        const int appends = day * 20;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < appends; ++i) {
+            double phase = (i % day) * (2 * M_PI / day);
+            history.append(start + qint64(i) * 1000000, 22.0 + 4.0 * std::sin(phase), 45.0, 101325.0);
+        }
+        reportThroughput("history/append", appends, timer.nsecsElapsed(), "samples");
+    }
+
+    const int width = 420;
+    const int height = 90;
+
+    {
+        QVector<MinMaxBucket> buckets;
+        const int passes = 100;
+        QElapsedTimer timer;
+        timer.start();
+        for (int pass = 0; pass < passes; ++pass) {
+            minMaxDecimate(history, SampleHistory::Temperature, history.firstTimestamp(),
+                           history.lastTimestamp() + 1, width, buckets);
+        }
+        reportValue("history/decimate-24h-1Hz", timer.nsecsElapsed() / 1e6 / passes, "ms/pass");
+    }
+
+    {
+        TrendChartItem chart(&history, width, height);
+        chart.setRange(SampleHistory::Temperature, -10.0, 30.0);
+        chart.setRange(SampleHistory::Humidity, 0.0, 100.0);
+        chart.setRange(SampleHistory::Pressure, 87000.0, 108500.0);
+        chart.setChannelColor(SampleHistory::Temperature, Qt::red);
+
+        QImage image(width + 2, height + 2, QImage::Format_ARGB32_Premultiplied);
+        QStyleOptionGraphicsItem option;
+        const int frames = 200;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            chart.paint(&painter, &option);
+        }
+        reportValue("history/render-24h-1Hz", timer.nsecsElapsed() / 1e6 / frames, "ms/frame");
+
+        SampleHistory small(width);
+        for (int i = 0; i < width; ++i) {
+            small.append(start + qint64(i) * 1000000, 22.0, 45.0, 101325.0);
+        }
+        TrendChartItem smallChart(&small, width, height);
+        timer.restart();
+        for (int frame = 0; frame < frames; ++frame) {
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            smallChart.paint(&painter, &option);
+        }
+        reportValue("history/render-width-samples", timer.nsecsElapsed() / 1e6 / frames, "ms/frame");
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file bench_ingest.cpp
+ * @brief Бенчмарки конвейера приёма данных датчиков.
+ *
+ * Измеряет скорость разбора текстовых строк, устойчивую пропускную способность
+ * чтения из файла через поток читателя и число пакетов, выдаваемых в GUI
+ * при источнике с частотой 10 кГц.
+ */
+
+#include "bench.h"
+#include "../includes/sensoringest.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Формирует текст с заданным количеством строк измерений.
+ * @param count Количество строк.
+ * @return Текст в формате источника.
+ */
+QByteArray makeSampleText(int count) {
+    QByteArray text;
+    text.reserve(count * 40);
+    for (int i = 0; i < count; ++i) {
+        text += QByteArray::number(qint64(1700000000000000) + i * 100);
+        text += ' ';
+        text += QByteArray::number(20.0 + (i % 100) * 0.05, 'f', 2);
+        text += ' ';
+        text += QByteArray::number(40.0 + (i % 37), 'f', 1);
+        text += ' ';
+        text += QByteArray::number(101325.0 + (i % 500) * 0.5, 'f', 1);
+        text += '\n';
+    }
+    return text;
+}
+
+/**
+ * @brief Крутит цикл событий, пока не выполнится условие или не истечёт время.
+ */
+template <typename Predicate>
+void spinUntil(Predicate done, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки конвейера приёма данных датчиков.
+ */
+void benchIngest() {
+    const int lines = 1000000;
+    QByteArray text = makeSampleText(lines);
+
+    // Разбор текста без ввода-вывода
+    {
+        QVector<SensorSample> out;
+        out.reserve(lines);
+        QElapsedTimer timer;
+        timer.start();
+        SensorIngest::parseChunk(text.constData(), text.size(), out);
+        reportThroughput("ingest/parse", static_cast<quint64>(out.size()), timer.nsecsElapsed(), "samples");
+    }
+
+    // Чтение файла потоком читателя и выдача пакетов по кадрам
+    {
+        QTemporaryFile file;
+        if (!file.open()) {
+            std::printf("ingest/file: cannot create temporary file\n");
+            return;
+        }
+        file.write(text);
+        file.flush();
+
+        SensorIngest ingest;
+        quint64 delivered = 0;
+        QObject::connect(&ingest, &SensorIngest::batchReady, [&](const QVector<SensorSample> &batch) {
+            delivered += static_cast<quint64>(batch.size());
+        });
+
+        QElapsedTimer timer;
+        timer.start();
+        ingest.openFile(file.fileName());
+        spinUntil([&]() { return delivered >= static_cast<quint64>(lines); }, 30000);
+        qint64 elapsed = timer.nsecsElapsed();
+        ingest.stop();
+
+        reportThroughput("ingest/file-sustained", delivered, elapsed, "samples");
+        reportValue("ingest/file-sustained, batches", static_cast<double>(ingest.deliveredBatches()), "batches");
+    }
+
+    // Источник 10 кГц в течение секунды: в GUI должно прийти не больше одного пакета за кадр
+    {
+        SensorIngest ingest;
+        quint64 delivered = 0;
+        QObject::connect(&ingest, &SensorIngest::batchReady, [&](const QVector<SensorSample> &batch) {
+            delivered += static_cast<quint64>(batch.size());
+        });
+
+        const int rateHz = 10000;
+        const int chunk = 10;
+        std::thread producer([&]() {
+            SensorSample samples[chunk];
+            auto next = std::chrono::steady_clock::now();
+            for (int i = 0; i < rateHz; i += chunk) {
+                for (int j = 0; j < chunk; ++j) {
+                    samples[j] = SensorSample{ i + j, 22.0, 45.0, 101325.0 };
+                }
+                ingest.pushSamples(samples, chunk);
+                next += std::chrono::microseconds(1000000 / rateHz * chunk);
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        QElapsedTimer timer;
+        timer.start();
+        spinUntil([&]() { return delivered >= static_cast<quint64>(rateHz); }, 5000);
+        qint64 elapsed = timer.nsecsElapsed();
+        producer.join();
+
+        reportThroughput("ingest/10kHz-source", delivered, elapsed, "samples");
+        reportValue("ingest/10kHz-source, batches", ingest.deliveredBatches() / (elapsed / 1e9), "batches/s");
+    }
+}
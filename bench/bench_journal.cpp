@@ -0,0 +1,189 @@
+/**
+ * @file bench_journal.cpp
+ * @brief Бенчмарки журнала изменений состояния.
+ *
+ * Измеряет скорость записи при разной частоте fsync, число коммитов и fsync при потоке
+ * показаний 100 Гц с редкими изменениями от пользователя, итоговый объём записи
+ * с учётом уплотнения в снимок и время восстановления журнала из 1 000 000 записей.
+ */
+
+#include "bench.h"
+#include "../includes/statejournal.h"
+#include "../includes/statesnapshot.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace {
+
+const int kStreamMs = 2000; ///< Длительность потока показаний
+const int kReadingPeriodMs = 10; ///< Период показаний (100 Гц)
+const int kChangePeriodMs = 500; ///< Период изменений от пользователя
+
+/**
+ * @brief Заполняет журнал показаниями блоков парка.
+ * @param journal Открытый журнал.
+ * @param records Количество записей.
+ * @param units Количество блоков.
+ */
+void fillJournal(StateJournal &journal, int records, int units) {
+    for (int i = 0; i < records; ++i) {
+        journal.append(StateJournal::Reading, static_cast<quint32>(i % units),
+                       18.0 + (i % 100) * 0.1, 30.0 + i % 50, 99000.0 + i % 3000);
+    }
+    journal.commit();
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки журнала изменений состояния.
+ */
+void benchJournal() {
+    QTemporaryDir dir;
+    const QString path = dir.filePath("state.journal");
+
+    // Скорость записи при разной частоте fsync (группа — 256 записей)
+    for (int syncEvery : {0, 16, 1}) {
+        QFile::remove(path);
+        JournalOptions options;
+        options.syncEveryCommits = syncEvery;
+        options.compactMinBytes = Q_INT64_C(1) << 40; // Без уплотнения
+        options.compactIntervalMs = 0;
+
+        StateJournal journal;
+        journal.setOptions(options);
+        journal.open(path, 0, StateJournal::ReplayHandler());
+
+        const int records = syncEvery == 0 ? 1000000 : 100000;
+        QElapsedTimer timer;
+        timer.start();
+        fillJournal(journal, records, 1000);
+        qint64 elapsed = timer.nsecsElapsed();
+        reportThroughput(QString("journal/append fsync every %1 commits").arg(syncEvery),
+                         records, elapsed, "records");
+        const QString name = QString("journal/append fsync every %1 commits").arg(syncEvery);
+        reportValue(name + ", commits", static_cast<double>(journal.commitCount()), "commits");
+        reportValue(name + ", fsyncs", static_cast<double>(journal.syncCount()), "fsyncs");
+    }
+
+    // Поток показаний 100 Гц и изменение уставки раз в 500 мс с параметрами по умолчанию:
+    // группы только из показаний коммитятся раз в readingCommitMs, изменения — за groupCommitMs
+    {
+        QFile::remove(path);
+        StateJournal journal;
+        journal.open(path, 0, StateJournal::ReplayHandler());
+
+        int readings = 0;
+        int changes = 0;
+        QTimer sensor;
+        QObject::connect(&sensor, &QTimer::timeout, [&]() {
+            journal.append(StateJournal::Reading, 0, 18.0 + readings % 100 * 0.1, 45.0, 101325.0);
+            ++readings;
+        });
+        QTimer user;
+        QObject::connect(&user, &QTimer::timeout, [&]() {
+            journal.append(StateJournal::Setpoint, 0, 20.0 + changes % 5);
+            ++changes;
+        });
+        QEventLoop loop;
+        sensor.start(kReadingPeriodMs);
+        user.start(kChangePeriodMs);
+        QTimer::singleShot(kStreamMs, &loop, &QEventLoop::quit);
+        loop.exec();
+        sensor.stop();
+        user.stop();
+
+        const QString name = "journal/sensor 100 Hz + setpoint every 500 ms, 2 s";
+        reportValue(name + ", records", readings + changes, "records");
+        reportValue(name + ", commits", static_cast<double>(journal.commitCount()), "commits");
+        reportValue(name + ", fsyncs", static_cast<double>(journal.syncCount()), "fsyncs");
+        // Каждое изменение — не больше одного коммита, показания между ними — не чаще readingCommitMs
+        const quint64 limit = changes + kStreamMs / journal.options().readingCommitMs + 1;
+        if (journal.commitCount() > limit) {
+            reportFailure(name, QString("%1 commits, at most %2 expected").arg(journal.commitCount()).arg(limit));
+        }
+    }
+
+    // Объём записи с уплотнением: парк 1000 блоков, порог — 4 размера снимка
+    {
+        QFile::remove(path);
+        const QString snapshotPath = dir.filePath("state.bin");
+        FleetStore fleet;
+        fleet.resize(1000, 22.0, 45.0, 101325.0);
+        SampleHistory history(1);
+        SnapshotSettings settings;
+
+        JournalOptions options;
+        options.syncEveryCommits = 0;
+        options.compactMinBytes = 0;
+        options.compactIntervalMs = 0;
+
+        StateSnapshot::write(snapshotPath, settings, fleet, history);
+        StateJournal journal;
+        journal.setOptions(options);
+        journal.setSnapshotSize(QFileInfo(snapshotPath).size());
+        journal.open(path, 0, StateJournal::ReplayHandler());
+
+        qint64 journalBytes = 0;
+        qint64 snapshotBytes = 0;
+        int compactions = 0;
+        QObject::connect(&journal, &StateJournal::compactionRequested, [&]() {
+            journalBytes += journal.sizeBytes();
+            settings.journalSequence = journal.lastSequence();
+            StateSnapshot::write(snapshotPath, settings, fleet, history);
+            const qint64 size = QFileInfo(snapshotPath).size();
+            snapshotBytes += size;
+            ++compactions;
+            journal.truncate();
+            journal.setSnapshotSize(size);
+        });
+
+        const int records = 1000000;
+        QElapsedTimer timer;
+        timer.start();
+        fillJournal(journal, records, fleet.size());
+        qint64 elapsed = timer.nsecsElapsed();
+        journalBytes += journal.sizeBytes();
+
+        reportThroughput("journal/append with compaction", records, elapsed, "records");
+        reportValue("journal/append with compaction, compactions", compactions, "compactions");
+        reportValue("journal/append with compaction, journal", static_cast<double>(journalBytes), "bytes");
+        reportValue("journal/append with compaction, snapshots", static_cast<double>(snapshotBytes), "bytes");
+        reportValue("journal/append with compaction, amplification",
+                    journalBytes > 0 ? double(journalBytes + snapshotBytes) / journalBytes : 0.0, "x");
+    }
+
+    // Время восстановления журнала из 1 000 000 записей
+    {
+        QFile::remove(path);
+        const int records = 1000000;
+        const int units = 1000;
+        {
+            JournalOptions options;
+            options.syncEveryCommits = 0;
+            options.maxBatchRecords = 4096;
+            options.compactMinBytes = Q_INT64_C(1) << 40;
+            options.compactIntervalMs = 0;
+            StateJournal journal;
+            journal.setOptions(options);
+            journal.open(path, 0, StateJournal::ReplayHandler());
+            fillJournal(journal, records, units);
+        }
+
+        FleetStore fleet;
+        fleet.resize(units, 0.0, 0.0, 0.0);
+        StateJournal journal;
+        QElapsedTimer timer;
+        timer.start();
+        journal.open(path, 0, [&fleet](const JournalRecord &record) {
+            fleet.setReading(static_cast<int>(record.unit), record.values[0], record.values[1], record.values[2]);
+        });
+        qint64 elapsed = timer.nsecsElapsed();
+        reportThroughput("journal/recover 1M records", journal.replayedRecords(), elapsed, "records");
+    }
+}
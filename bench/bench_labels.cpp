@@ -0,0 +1,104 @@
+/**
+ * @file bench_labels.cpp
+ * @brief Бенчмарки форматирования текстовых меток показаний.
+ *
+ * Сравнивает прежнее обновление меток (сборка строки из частей и setPlainText()
+ * текстового элемента с документом) с LabelFormatter и простым текстовым элементом,
+ * а также форматирование ячеек списка блоков.
+ */
+
+#include "bench.h"
+#include "../includes/labelformatter.h"
+
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QGraphicsSimpleTextItem>
+#include <QGraphicsTextItem>
+#include <QStringList>
+#include <QVector>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief Возвращает обозначение единицы температуры, как прежний CoolWindow.
+ */
+QString temperatureScale(int id) {
+    switch (id) {
+        case 1:
+            return "C";
+        case 2:
+            return "F";
+        case 3:
+            return "K";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Прогоняет обновления меток прежним способом и через LabelFormatter.
+ * @param name Название измерения.
+ * @param values Последовательность показаний.
+ */
+void runLabels(const char *name, const QVector<double> &values) {
+    QGraphicsScene scene;
+    QGraphicsTextItem *legacyText = scene.addText("Т: ");
+    QGraphicsSimpleTextItem *simpleText = scene.addSimpleText("Т: ");
+    LabelFormatter label("Т: ", {"", " C", " F", " K"}, 2, true);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (double value : values) {
+        legacyText->setPlainText("Т: " + QString::number(value) + " " + temperatureScale(1));
+    }
+    reportThroughput(QString("labels/legacy, %1").arg(name), values.size(), timer.nsecsElapsed(), "updates");
+
+    timer.restart();
+    quint64 changed = 0;
+    for (double value : values) {
+        if (label.format(value, 1)) {
+            simpleText->setText(label.text());
+            ++changed;
+        }
+    }
+    reportThroughput(QString("labels/formatter, %1").arg(name), values.size(), timer.nsecsElapsed(), "updates");
+    reportValue(QString("labels/formatter, %1, text changes").arg(name), static_cast<double>(changed),
+                QString("of %1 updates").arg(values.size()));
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки форматирования текстовых меток показаний.
+ */
+void benchLabels() {
+    const int count = 200000;
+    QVector<double> steady(count, 21.5);
+    QVector<double> moving;
+    moving.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        moving.append(15.0 + (i % 1500) * 0.01);
+    }
+    runLabels("same value", steady);
+    runLabels("changing value", moving);
+
+    // Ячейки списка блоков: температура, влажность и давление каждого блока
+    const int cells = 1000000;
+    const QString celsius = " C";
+    QElapsedTimer timer;
+    timer.start();
+    qint64 size = 0;
+    for (int i = 0; i < cells; ++i) {
+        size += (QString::number(moving[i % count], 'f', 1) + " " + QString("C")).size();
+    }
+    reportThroughput("labels/fleet cells, QString::number", cells, timer.nsecsElapsed(), "cells");
+
+    timer.restart();
+    for (int i = 0; i < cells; ++i) {
+        size -= LabelFormatter::fixed(moving[i % count], 1, celsius).size();
+    }
+    reportThroughput("labels/fleet cells, LabelFormatter::fixed", cells, timer.nsecsElapsed(), "cells");
+    if (size != 0) {
+        std::printf("%-48s MISMATCH in cell text length\n", "labels/fleet cells");
+    }
+}
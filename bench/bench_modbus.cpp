@@ -0,0 +1,223 @@
+/**
+ * @file bench_modbus.cpp
+ * @brief Бенчмарки сервера Modbus-TCP.
+ *
+ * Нагрузочный тест по локальному адресу: клиенты в отдельных потоках опрашивают
+ * регистры в режиме запрос-ответ (как система диспетчеризации), пока поток бенчмарка
+ * крутит цикл событий модели. Измеряются запросы в секунду для всех клиентов вместе
+ * и распределение задержки запроса; отдельно — конвейер запросов одного клиента.
+ */
+
+#include "bench.h"
+#include "../includes/climatemodel.h"
+#include "../includes/controlserver.h"
+#include "../includes/modbusprotocol.h"
+#include "../includes/modbusserver.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kClients = 32; ///< Одновременных клиентов
+const int kReadsPerClient = 5000; ///< Чтений на клиента
+const int kWritesPerClient = 500; ///< Записей на клиента
+const int kPipelined = 200000; ///< Запросов в конвейере одного клиента
+const int kWindow = 64; ///< Запросов в полёте при конвейере
+const int kTimeoutMs = 10000; ///< Наибольшее ожидание ответа
+
+/**
+ * @struct ClientRun
+ * @brief Итог прогона клиента.
+ */
+struct ClientRun
+{
+    int responses = 0; ///< Получено ответов
+    int exceptions = 0; ///< Ответов-исключений
+    QVector<qint64> roundTrips; ///< Задержки запросов (при окне 1)
+};
+
+/**
+ * @brief Возвращает кадр чтения всех входных регистров.
+ * @param transaction Идентификатор транзакции.
+ */
+QByteArray readFrame(quint16 transaction) {
+    const char frame[] = { char(transaction >> 8), char(transaction & 0xFF), 0, 0, 0, 6, 1,
+                           char(ModbusProtocol::ReadInputRegisters), 0, 0, 0, char(ModbusProtocol::InputRegisterCount) };
+    return QByteArray(frame, sizeof(frame));
+}
+
+/**
+ * @brief Возвращает кадр записи уставки.
+ * @param transaction Идентификатор транзакции.
+ * @param tenths Уставка ×10.
+ */
+QByteArray writeFrame(quint16 transaction, quint16 tenths) {
+    const char frame[] = { char(transaction >> 8), char(transaction & 0xFF), 0, 0, 0, 6, 1,
+                           char(ModbusProtocol::WriteSingleRegister), 0, char(ModbusProtocol::HoldingSetpoint),
+                           char(tenths >> 8), char(tenths & 0xFF) };
+    return QByteArray(frame, sizeof(frame));
+}
+
+/**
+ * @brief Отправляет кадры с ограниченным числом ожидающих ответа и читает ответы.
+ * @param port Порт сервера.
+ * @param frames Кадры запросов.
+ * @param window Наибольшее число кадров без ответа (1 — запрос-ответ).
+ */
+ClientRun runClient(quint16 port, const QVector<QByteArray> &frames, int window) {
+    ClientRun run;
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(kTimeoutMs)) {
+        return run;
+    }
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    run.roundTrips.reserve(window == 1 ? frames.size() : 0);
+    QElapsedTimer roundTrip;
+    QByteArray tail;
+    int sent = 0;
+    while (run.responses < frames.size()) {
+        QByteArray out;
+        while (sent < frames.size() && sent - run.responses < window) {
+            out.append(frames[sent++]);
+        }
+        if (!out.isEmpty()) {
+            roundTrip.start();
+            socket.write(out);
+            socket.flush();
+        }
+        if (!socket.waitForReadyRead(kTimeoutMs)) {
+            break;
+        }
+        tail.append(socket.readAll());
+        int start = 0;
+        ModbusRequest response;
+        int size;
+        while ((size = ModbusProtocol::parseFrame(tail.constData() + start, tail.size() - start, response)) > 0) {
+            if (response.function & 0x80) {
+                ++run.exceptions;
+            }
+            ++run.responses;
+            start += size;
+            if (window == 1) {
+                run.roundTrips.append(roundTrip.nsecsElapsed());
+            }
+        }
+        tail.remove(0, start);
+    }
+    return run;
+}
+
+/**
+ * @brief Запускает клиентов в отдельных потоках и крутит цикл событий до их завершения.
+ * @param port Порт сервера.
+ * @param frames Кадры запросов каждого клиента.
+ * @param clients Количество клиентов.
+ * @param window Наибольшее число кадров без ответа у клиента.
+ * @param elapsedNs Время от запуска первого до завершения последнего клиента.
+ */
+QVector<ClientRun> drive(quint16 port, const QVector<QByteArray> &frames, int clients, int window, qint64 &elapsedNs) {
+    QVector<ClientRun> runs(clients);
+    QEventLoop loop;
+    std::atomic<int> running{clients};
+    std::vector<std::thread> threads;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back([&, i]() {
+            runs[i] = runClient(port, frames, window);
+            if (running.fetch_sub(1) == 1) {
+                QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+            }
+        });
+    }
+    loop.exec();
+    elapsedNs = timer.nsecsElapsed();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    return runs;
+}
+
+/**
+ * @brief Выводит запросы в секунду и распределение задержки прогона.
+ *
+ * Все запросы прогонов обращаются к существующим регистрам с допустимыми значениями
+ * (уставки 20.0–24.9 °C), поэтому потерянный ответ или ответ-исключение — непройденная проверка.
+ * @param name Название результата.
+ * @param runs Итоги клиентов.
+ * @param expected Ожидаемое количество ответов каждому клиенту.
+ * @param elapsedNs Время прогона.
+ */
+void reportRuns(const QString &name, const QVector<ClientRun> &runs, int expected, qint64 elapsedNs) {
+    QVector<qint64> roundTrips;
+    quint64 responses = 0;
+    int exceptions = 0;
+    for (const ClientRun &run : runs) {
+        if (run.responses != expected) {
+            reportFailure(name, QString("%1 of %2 responses").arg(run.responses).arg(expected));
+            return;
+        }
+        responses += static_cast<quint64>(run.responses);
+        exceptions += run.exceptions;
+        roundTrips += run.roundTrips;
+    }
+    reportThroughput(name, responses, elapsedNs, "requests");
+    reportLatency(name + " round trip", roundTrips);
+    if (exceptions != 0) {
+        reportFailure(name, QString("%1 exception responses").arg(exceptions));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки сервера Modbus-TCP.
+ */
+void benchModbus() {
+    ClimateModel model;
+    ControlServer control(&model);
+    ModbusServer server(&control);
+    if (!server.listen(0)) {
+        reportFailure("modbus", "cannot listen on localhost");
+        return;
+    }
+
+    QVector<QByteArray> reads;
+    for (int i = 0; i < kReadsPerClient; ++i) {
+        reads.append(readFrame(static_cast<quint16>(i)));
+    }
+    QVector<QByteArray> writes;
+    for (int i = 0; i < kWritesPerClient; ++i) {
+        writes.append(writeFrame(static_cast<quint16>(i), static_cast<quint16>(200 + i % 50)));
+    }
+    QVector<QByteArray> pipelined;
+    for (int i = 0; i < kPipelined; ++i) {
+        pipelined.append(readFrame(static_cast<quint16>(i)));
+    }
+
+    qint64 elapsedNs = 0;
+    QVector<ClientRun> runs = drive(server.serverPort(), reads, 1, 1, elapsedNs);
+    reportRuns("modbus/read input x1 client", runs, kReadsPerClient, elapsedNs);
+    runs = drive(server.serverPort(), reads, kClients, 1, elapsedNs);
+    reportRuns(QString("modbus/read input x%1 clients").arg(kClients), runs, kReadsPerClient, elapsedNs);
+    runs = drive(server.serverPort(), writes, kClients, 1, elapsedNs);
+    reportRuns(QString("modbus/write setpoint x%1 clients").arg(kClients), runs, kWritesPerClient, elapsedNs);
+
+    runs = drive(server.serverPort(), pipelined, 1, kWindow, elapsedNs);
+    if (runs.constFirst().responses == kPipelined) {
+        reportThroughput("modbus/read input pipelined", kPipelined, elapsedNs, "requests");
+        if (runs.constFirst().exceptions != 0) {
+            reportFailure("modbus/read input pipelined", QString("%1 exception responses").arg(runs.constFirst().exceptions));
+        }
+    } else {
+        reportFailure("modbus/read input pipelined", QString("%1 of %2 responses").arg(runs.constFirst().responses).arg(kPipelined));
+    }
+    server.close();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file bench_probe.cpp
+ * @brief Бенчмарки измерителей длительности ACM_PROBE.
+ *
+ * Измеряет добавочную стоимость измерителя (цикл с ACM_PROBE минус такой же пустой цикл),
+ * отдельно запись в гистограмму и чтение часов, а также стоимость расчёта процентиля
+ * и выгрузки всех гистограмм в JSON.
+ */
+
+#include "bench.h"
+#include "../includes/latencyprobe.h"
+
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace {
+
+const int kIterations = 10000000; ///< Повторений на измерение стоимости измерителя
+const int kQueries = 10000; ///< Повторений расчёта процентиля
+
+volatile quint64 sink = 0; ///< Приёмник результатов, чтобы цикл не был удалён компилятором
+
+/**
+ * @brief Пустая операция, измеряемая ACM_PROBE.
+ */
+Q_DECL_NOINLINE void probedOperation(quint64 i) {
+    ACM_PROBE("bench probe");
+    sink = i;
+}
+
+/**
+ * @brief Та же операция без измерителя.
+ */
+Q_DECL_NOINLINE void plainOperation(quint64 i) {
+    sink = i;
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки измерителей длительности ACM_PROBE.
+ */
+void benchProbe() {
+    if (!LatencyProbes::isEnabled()) {
+        std::printf("%-48s SKIPPED: built without ACM_PROBES\n", "probe");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (quint64 i = 0; i < quint64(kIterations); ++i) {
+        plainOperation(i);
+    }
+    const qint64 plainNs = timer.nsecsElapsed();
+
+    timer.start();
+    for (quint64 i = 0; i < quint64(kIterations); ++i) {
+        probedOperation(i);
+    }
+    const qint64 probedNs = timer.nsecsElapsed();
+    reportThroughput("probe/ACM_PROBE call", kIterations, probedNs, "probes");
+    reportValue("probe/ACM_PROBE overhead", double(probedNs - plainNs) / kIterations, "ns/probe");
+
+    LatencyHistogram histogram("bench record");
+    timer.start();
+    for (quint64 i = 0; i < quint64(kIterations); ++i) {
+        histogram.record((i * 2654435761u) & 0xfffff);
+    }
+    reportThroughput("probe/LatencyHistogram::record", kIterations, timer.nsecsElapsed(), "records");
+
+    quint64 ticks = 0;
+    timer.start();
+    for (int i = 0; i < kIterations; ++i) {
+        ticks += LatencyClock::now();
+    }
+    sink = ticks;
+    reportThroughput("probe/LatencyClock::now", kIterations, timer.nsecsElapsed(), "reads");
+
+    QVector<qint64> samples;
+    samples.reserve(kQueries);
+    for (int i = 0; i < kQueries; ++i) {
+        timer.start();
+        sink = histogram.percentile(99.0);
+        samples.append(timer.nsecsElapsed());
+    }
+    reportLatency("probe/percentile(99)", samples);
+
+    samples.resize(0);
+    for (int i = 0; i < 100; ++i) {
+        timer.start();
+        sink = static_cast<quint64>(LatencyProbes::toJson().size());
+        samples.append(timer.nsecsElapsed());
+    }
+    reportLatency("probe/LatencyProbes::toJson", samples);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file bench_replay.cpp
+ * @brief Бенчмарки записи и воспроизведения входных воздействий.
+ *
+ * Формирует воспроизводимую запись: измерения 1 кГц с медленно меняющимися показаниями
+ * и шумом датчика, каждое тысячное событие — действие пользователя. Измеряет скорость
+ * кодирования и размер события, скорость декодирования и скорость воспроизведения
+ * без пауз в ClimateModel — нагрузочный тест модели на одинаковых для каждого запуска данных.
+ */
+
+#include "bench.h"
+#include "../includes/climatemodel.h"
+#include "../includes/inputtrace.h"
+#include "../includes/tracereplayer.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+const int kEvents = 1000000; ///< Событий в записи
+const int kActionEvery = 1000; ///< Каждое kActionEvery-е событие — действие пользователя
+const qint64 kSamplePeriodUs = 1000; ///< Период измерений в записи, мкс
+
+/**
+ * @brief Генератор псевдослучайных чисел с фиксированным начальным значением.
+ */
+quint32 nextRandom(quint32 &state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * @brief Формирует событие записи номер i.
+ */
+TraceEvent syntheticEvent(int i, quint32 &seed) {
+    TraceEvent event;
+    event.timeUs = i * kSamplePeriodUs;
+    if (i % kActionEvery == kActionEvery - 1) {
+        static const InputTraceWriter::EventType kActions[] = {
+            InputTraceWriter::TemperatureUp, InputTraceWriter::HGate, InputTraceWriter::TemperatureDown, InputTraceWriter::VGate
+        };
+        event.type = kActions[(i / kActionEvery) % 4];
+        event.a = event.type == InputTraceWriter::HGate || event.type == InputTraceWriter::VGate ? ClimateModel::kGateStep : 0;
+        return event;
+    }
+    // Показания с дискретностью датчика: 0.01 °C, 0.1 %, 1 Па
+    const double noise = (nextRandom(seed) % 5) - 2.0;
+    event.type = InputTraceWriter::Sample;
+    event.sample.timestampUs = 1700000000000000LL + i * kSamplePeriodUs;
+    event.sample.temperature = qRound((22.0 + (i % 60000) / 20000.0) * 100.0 + noise) / 100.0;
+    event.sample.humidity = qRound((45.0 + (i % 30000) / 3000.0) * 10.0 + noise) / 10.0;
+    event.sample.pressure = 101325.0 + noise;
+    return event;
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки записи и воспроизведения входных воздействий.
+ */
+void benchReplay() {
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.trace");
+
+    TraceInitialState initial;
+    initial.on = 1;
+    initial.setpoint = 22.0;
+
+    // Кодирование
+    {
+        InputTraceWriter writer;
+        writer.open(path, initial);
+        quint32 seed = 12345;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kEvents; ++i) {
+            writer.writeEvent(syntheticEvent(i, seed));
+        }
+        writer.close();
+        const qint64 elapsed = timer.nsecsElapsed();
+        reportThroughput("replay/encode", kEvents, elapsed, "events");
+        reportValue("replay/encoded size", double(writer.sizeBytes()) / kEvents,
+                    QString("bytes/event (raw sample %1 bytes)").arg(sizeof(SensorSample)));
+    }
+
+    // Декодирование
+    {
+        QFile file(path);
+        file.open(QIODevice::ReadOnly);
+        const QByteArray data = file.readAll();
+        InputTraceReader reader;
+        reader.openData(data);
+        TraceEvent event;
+        double checksum = 0.0;
+        quint64 decoded = 0;
+        QElapsedTimer timer;
+        timer.start();
+        while (reader.next(event)) {
+            checksum += event.sample.temperature;
+            ++decoded;
+        }
+        reportThroughput("replay/decode", decoded, timer.nsecsElapsed(), "events");
+        if (decoded != static_cast<quint64>(kEvents) || reader.isCorrupted() || checksum == 0.0) {
+            reportFailure("replay/decode", QString("decoded %1 of %2 events%3").arg(decoded).arg(kEvents)
+                                               .arg(reader.isCorrupted() ? ", trace corrupted" : ""));
+        }
+    }
+
+    // Воспроизведение без пауз в модель
+    {
+        ClimateModel model;
+        TraceReplayer replayer(&model);
+        replayer.open(path);
+        const quint64 events = replayer.runToEnd();
+        reportThroughput("replay/model, as fast as possible", events, replayer.elapsedNs(), "events");
+    }
+}
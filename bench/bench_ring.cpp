@@ -0,0 +1,218 @@
+/**
+ * @file bench_ring.cpp
+ * @brief Бенчмарки передачи измерений из потока источника в поток GUI.
+ *
+ * Сравнивает два способа доставки 100 000 событий в секунду: сигналы между потоками
+ * (по событию очереди на каждое измерение) и очередь без блокировок SampleRing,
+ * которую GUI забирает раз за кадр. Для каждого способа выводятся задержка доставки,
+ * процессорное время потока GUI и наибольший накопившийся хвост. Отдельно проверяется
+ * перегрузка: GUI занят 200 мс, а источник продолжает работать.
+ */
+
+#include "bench.h"
+#include "../includes/samplering.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#ifdef Q_OS_UNIX
+#include <time.h>
+#endif
+
+namespace {
+
+const int kRateHz = 100000; ///< Частота событий источника
+const int kEventsPerTick = 100; ///< Событий за такт источника (такт — 1 мс)
+const int kFrameMs = 16; ///< Период забора очереди потоком GUI
+
+/**
+ * @brief Возвращает монотонное время в микросекундах (общее для потоков).
+ */
+qint64 nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Возвращает процессорное время текущего потока в наносекундах (0, если недоступно).
+ */
+qint64 threadCpuNs() {
+#ifdef Q_OS_UNIX
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Источник событий с заданной частотой в отдельном потоке.
+ *
+ * Каждое событие передаётся функцией emitEvent по одному; раз в такт источник
+ * вызывает sampleBacklog, чтобы снять размер хвоста.
+ */
+template <typename Emit, typename Backlog>
+std::thread startSource(int events, Emit emitEvent, Backlog sampleBacklog) {
+    return std::thread([=]() {
+        auto next = std::chrono::steady_clock::now();
+        for (int i = 0; i < events; i += kEventsPerTick) {
+            for (int j = 0; j < kEventsPerTick; ++j) {
+                emitEvent(SensorSample{ nowUs(), 22.0 + (j % 10) * 0.1, 45.0, 101325.0 });
+            }
+            sampleBacklog();
+            next += std::chrono::microseconds(1000000 / kRateHz * kEventsPerTick);
+            std::this_thread::sleep_until(next);
+        }
+    });
+}
+
+/**
+ * @brief Выводит задержку доставки, процессорное время потока GUI и наибольший хвост.
+ */
+void report(const QString &name, const QVector<qint64> &latencyUs, qint64 guiCpuNs, qint64 elapsedNs, int peakBacklog) {
+    QVector<qint64> latencyNs;
+    latencyNs.reserve(latencyUs.size());
+    for (qint64 us : latencyUs) {
+        latencyNs.append(us * 1000);
+    }
+    reportLatency(name + ", delivery latency", latencyNs);
+    reportValue(name + ", GUI CPU", guiCpuNs / 1e6 / (elapsedNs / 1e9), "ms/s");
+    reportValue(name + ", peak backlog", peakBacklog, "events");
+}
+
+/**
+ * @brief Доставка сигналами между потоками: событие очереди на каждое измерение.
+ */
+void benchQueuedSignals(int events) {
+    QObject receiver;
+    QVector<qint64> latencyUs;
+    latencyUs.reserve(events);
+    std::atomic<int> sent{0};
+    std::atomic<int> received{0};
+    std::atomic<int> peak{0};
+
+    const qint64 cpuStart = threadCpuNs();
+    QElapsedTimer timer;
+    timer.start();
+    std::thread source = startSource(events, [&](const SensorSample &sample) {
+        // Так же, как сигнал с соединением Qt::QueuedConnection: QMetaCallEvent на каждый вызов
+        QMetaObject::invokeMethod(&receiver, [&, sample]() {
+            latencyUs.append(nowUs() - sample.timestampUs);
+            received.fetch_add(1, std::memory_order_relaxed);
+        }, Qt::QueuedConnection);
+        sent.fetch_add(1, std::memory_order_relaxed);
+    }, [&]() {
+        peak.store(qMax(peak.load(), sent.load() - received.load()));
+    });
+
+    while (received.load() < events && timer.elapsed() < 10000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, kFrameMs);
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    const qint64 cpu = threadCpuNs() - cpuStart;
+    source.join();
+    QCoreApplication::processEvents();
+
+    report("ring/queued-signals, 100k events/s", latencyUs, cpu, elapsed, peak.load());
+}
+
+/**
+ * @brief Доставка через SampleRing: GUI забирает накопленное раз за кадр.
+ */
+void benchSampleRing(int events) {
+    SampleRing ring(16384, SampleRing::OverflowPolicy::Block);
+    QVector<qint64> latencyUs;
+    latencyUs.reserve(events);
+    QVector<SensorSample> batch;
+    batch.reserve(ring.capacity());
+    std::atomic<int> peak{0};
+
+    const qint64 cpuStart = threadCpuNs();
+    QElapsedTimer timer;
+    timer.start();
+    std::thread source = startSource(events, [&](const SensorSample &sample) {
+        ring.push(&sample, 1);
+    }, [&]() {
+        peak.store(qMax(peak.load(), ring.size()));
+    });
+
+    int received = 0;
+    while (received < events && timer.elapsed() < 10000) {
+        QThread::msleep(kFrameMs); // Остальная работа кадра
+        batch.clear();
+        ring.drain(batch);
+        const qint64 now = nowUs();
+        for (const SensorSample &sample : batch) {
+            latencyUs.append(now - sample.timestampUs);
+        }
+        received += batch.size();
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    const qint64 cpu = threadCpuNs() - cpuStart;
+    source.join();
+
+    report("ring/sample-ring, 100k events/s", latencyUs, cpu, elapsed, peak.load());
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки передачи измерений из потока источника в поток GUI.
+ */
+void benchRing() {
+    const int events = kRateHz; // Одна секунда источника
+    benchQueuedSignals(events);
+    benchSampleRing(events);
+
+    // Пропускная способность очереди без ожидания потребителя
+    {
+        SampleRing ring(65536, SampleRing::OverflowPolicy::Block);
+        const int total = 20000000;
+        const int chunk = 64;
+        QElapsedTimer timer;
+        timer.start();
+        std::thread producer([&]() {
+            SensorSample samples[chunk] = {};
+            for (int i = 0; i < total; i += chunk) {
+                ring.push(samples, chunk);
+            }
+        });
+        QVector<SensorSample> batch;
+        batch.reserve(ring.capacity());
+        int drained = 0;
+        while (drained < total) {
+            batch.clear();
+            drained += ring.drain(batch);
+        }
+        producer.join();
+        reportThroughput("ring/spsc-throughput, 64-sample pushes", total, timer.nsecsElapsed(), "samples");
+    }
+
+    // Перегрузка: GUI занят 200 мс; очередь на 4096 событий вытесняет старые или останавливает источник
+    for (SampleRing::OverflowPolicy policy : {SampleRing::OverflowPolicy::DropOldest, SampleRing::OverflowPolicy::Block}) {
+        SampleRing ring(4096, policy);
+        std::thread source = startSource(kRateHz / 5, [&](const SensorSample &sample) {
+            ring.push(&sample, 1);
+        }, []() {});
+        QThread::msleep(200);
+        QVector<SensorSample> batch;
+        while (ring.pushedSamples() < static_cast<quint64>(kRateHz / 5)) {
+            ring.drain(batch);
+            QThread::msleep(1);
+        }
+        source.join();
+        ring.drain(batch);
+        const QString name = policy == SampleRing::OverflowPolicy::DropOldest ? "ring/overload 200 ms, drop-oldest"
+                                                                               : "ring/overload 200 ms, block";
+        reportValue(name + ", kept", batch.size(), "samples");
+        reportValue(name + ", dropped", static_cast<double>(ring.droppedSamples()), "samples");
+        reportValue(name + ", overflows", static_cast<double>(ring.overflowEvents()), "overflows");
+        reportValue(name + ", producer waits", static_cast<double>(ring.blockedWaits()), "waits");
+    }
+    std::fflush(stdout);
+}
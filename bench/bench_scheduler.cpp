@@ -0,0 +1,131 @@
+/**
+ * @file bench_scheduler.cpp
+ * @brief Бенчмарки объединения обновлений сцены по кадрам.
+ *
+ * Сравнивает синхронное обновление сцены на каждое изменение модели (как раньше
+ * в CoolWindow) с UpdateScheduler: пачка из 1 000 изменений и непрерывный поток
+ * изменений в течение полусекунды. Выводит счётчики запрошенных, объединённых
+ * и применённых обновлений.
+ */
+
+#include "bench.h"
+#include "../includes/frameclock.h"
+#include "../includes/gaugeitems.h"
+#include "../includes/labelformatter.h"
+#include "../includes/updatescheduler.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QGraphicsSimpleTextItem>
+#include <QGraphicsView>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief Сцена с уровнем и меткой температуры.
+ */
+struct TemperatureScene
+{
+    QGraphicsScene scene;
+    QGraphicsView view;
+    LevelBarItem *level;
+    QGraphicsSimpleTextItem *text;
+    LabelFormatter label{"Т: ", {"", " C"}, 2, true};
+    double value = 0.0;
+    quint64 mutations = 0; ///< Применений к сцене
+
+    TemperatureScene() : view(&scene) {
+        level = new LevelBarItem(QRectF(51, 10, 28, 300), QBrush(Qt::red));
+        scene.addItem(level);
+        text = scene.addSimpleText(label.text());
+        text->setPos(44, 324);
+        view.resize(200, 360);
+        view.show();
+        QApplication::processEvents();
+    }
+
+    void apply() {
+        level->setLevel((value + 60) * 2);
+        if (label.format(value, 1)) {
+            text->setText(label.text());
+        }
+        ++mutations;
+    }
+};
+
+/**
+ * @brief Обрабатывает события, пока планировщик не применит ожидающие изменения.
+ */
+void drain(UpdateScheduler &scheduler) {
+    while (scheduler.pendingFields() != 0) {
+        QApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    QApplication::processEvents(); // Перерисовка окна
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки объединения обновлений сцены по кадрам.
+ */
+void benchScheduler() {
+    const int burst = 1000;
+
+    // Пачка изменений, синхронное обновление на каждое
+    {
+        TemperatureScene target;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < burst; ++i) {
+            target.value = 20.0 + i * 0.01;
+            target.apply();
+        }
+        QApplication::processEvents();
+        reportValue("scheduler/burst, synchronous", timer.nsecsElapsed() / 1e6, QString("ms for %1 inputs").arg(burst));
+        reportValue("scheduler/burst, synchronous, scene updates", static_cast<double>(target.mutations), "updates");
+    }
+
+    // Та же пачка через планировщик
+    {
+        TemperatureScene target;
+        FrameClock clock;
+        UpdateScheduler scheduler(&clock);
+        QObject::connect(&scheduler, &UpdateScheduler::updatesReady, [&target](quint32) { target.apply(); });
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < burst; ++i) {
+            target.value = 20.0 + i * 0.01;
+            scheduler.markDirty(1);
+        }
+        drain(scheduler);
+        reportValue("scheduler/burst, frame-paced", timer.nsecsElapsed() / 1e6, QString("ms for %1 inputs").arg(burst));
+        reportValue("scheduler/burst, frame-paced, scene updates", static_cast<double>(scheduler.appliedUpdates()), "updates");
+        reportValue("scheduler/burst, frame-paced, coalesced", static_cast<double>(scheduler.coalescedUpdates()), "updates");
+    }
+
+    // Непрерывный поток изменений в течение 0,5 с
+    {
+        TemperatureScene target;
+        FrameClock clock;
+        UpdateScheduler scheduler(&clock);
+        QObject::connect(&scheduler, &UpdateScheduler::updatesReady, [&target](quint32) { target.apply(); });
+        QElapsedTimer timer;
+        timer.start();
+        quint64 inputs = 0;
+        while (timer.elapsed() < 500) {
+            target.value = 20.0 + (inputs % 1000) * 0.01;
+            scheduler.markDirty(1);
+            ++inputs;
+            QApplication::processEvents();
+        }
+        drain(scheduler);
+        reportValue("scheduler/stream 0.5 s, inputs", static_cast<double>(inputs), "inputs");
+        reportValue("scheduler/stream 0.5 s, requested", static_cast<double>(scheduler.requestedUpdates()), "updates");
+        reportValue("scheduler/stream 0.5 s, coalesced", static_cast<double>(scheduler.coalescedUpdates()), "updates");
+        reportValue("scheduler/stream 0.5 s, applied", static_cast<double>(scheduler.appliedUpdates()),
+                    QString("updates (frame %1 ms)").arg(clock.frameInterval() / 1e6, 0, 'f', 2));
+    }
+    std::fflush(stdout);
+}
@@ -0,0 +1,210 @@
+/**
+ * @file bench_snapshot.cpp
+ * @brief Бенчмарки сохранения и загрузки состояния.
+ *
+ * Сравнивает двоичный снимок StateSnapshot с сохранением того же состояния
+ * через QDomDocument для парков из 1, 1 000 и 100 000 блоков.
+ */
+
+#include "bench.h"
+#include "../includes/statesnapshot.h"
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Сохраняет состояние парка в XML через QDomDocument.
+ */
+void writeXml(const QString &path, const SnapshotSettings &settings, const FleetStore &fleet) {
+    QDomDocument doc;
+    QDomElement root = doc.createElement("Settings");
+    doc.appendChild(root);
+
+    QDomElement tempElem = doc.createElement("Temperature");
+    tempElem.setAttribute("value", QString::number(settings.temperature));
+    tempElem.setAttribute("scale", "C");
+    root.appendChild(tempElem);
+
+    QDomElement fleetElem = doc.createElement("Fleet");
+    for (int id = 0; id < fleet.size(); ++id) {
+        QDomElement unit = doc.createElement("Unit");
+        unit.setAttribute("t", QString::number(fleet.temperature(id)));
+        unit.setAttribute("h", QString::number(fleet.humidity(id)));
+        unit.setAttribute("p", QString::number(fleet.pressure(id)));
+        unit.setAttribute("hd", fleet.hGateDir(id));
+        unit.setAttribute("vd", fleet.vGateDir(id));
+        unit.setAttribute("on", fleet.isOn(id) ? 1 : 0);
+        fleetElem.appendChild(unit);
+    }
+    root.appendChild(fleetElem);
+
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    QTextStream stream(&file);
+    stream << doc.toString();
+}
+
+/**
+ * @brief Загружает состояние парка из XML через QDomDocument.
+ */
+void readXml(const QString &path, FleetStore &fleet) {
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    QDomDocument doc;
+    doc.setContent(&file);
+
+    QDomElement fleetElem = doc.documentElement().firstChildElement("Fleet");
+    fleet.resize(0, 0.0, 0.0, 0.0);
+    int id = 0;
+    for (QDomElement unit = fleetElem.firstChildElement("Unit"); !unit.isNull(); unit = unit.nextSiblingElement("Unit")) {
+        fleet.resize(id + 1, 0.0, 0.0, 0.0);
+        fleet.setReading(id, unit.attribute("t").toDouble(), unit.attribute("h").toDouble(), unit.attribute("p").toDouble());
+        fleet.setGates(id, unit.attribute("hd").toInt(), unit.attribute("vd").toInt());
+        fleet.setOn(id, unit.attribute("on").toInt() != 0);
+        ++id;
+    }
+}
+
+/**
+ * @brief Возвращает true, если count элементов двух колонок совпадают побайтно.
+ */
+template <typename T>
+bool sameColumn(const T *a, const T *b, int count) {
+    return count == 0 || memcmp(a, b, count * sizeof(T)) == 0;
+}
+
+/**
+ * @brief Сравнивает прочитанный двоичный снимок с записанным: настройки и все колонки парка.
+ * @return Описание первого расхождения или пустая строка.
+ */
+QString compareSnapshot(const SnapshotSettings &written, const FleetStore &fleet,
+                        const SnapshotSettings &read, const FleetStore &loaded) {
+    if (read.temperature != written.temperature || read.humidity != written.humidity
+        || read.pressure != written.pressure || read.temperatureUnit != written.temperatureUnit
+        || read.pressureUnit != written.pressureUnit || read.theme != written.theme
+        || read.currentUnit != written.currentUnit || read.fanSpeed != written.fanSpeed
+        || read.journalSequence != written.journalSequence) {
+        return "settings differ";
+    }
+    const int units = fleet.size();
+    if (loaded.size() != units) {
+        return QString("%1 units read, %2 written").arg(loaded.size()).arg(units);
+    }
+    if (!sameColumn(loaded.temperatureData(), fleet.temperatureData(), units)) {
+        return "temperature column differs";
+    }
+    if (!sameColumn(loaded.humidityData(), fleet.humidityData(), units)) {
+        return "humidity column differs";
+    }
+    if (!sameColumn(loaded.pressureData(), fleet.pressureData(), units)) {
+        return "pressure column differs";
+    }
+    if (!sameColumn(loaded.setpointData(), fleet.setpointData(), units)) {
+        return "setpoint column differs";
+    }
+    if (!sameColumn(loaded.hGateDirData(), fleet.hGateDirData(), units)
+        || !sameColumn(loaded.vGateDirData(), fleet.vGateDirData(), units)) {
+        return "gate columns differ";
+    }
+    if (!sameColumn(loaded.flagsData(), fleet.flagsData(), units)) {
+        return "flag column differs";
+    }
+    return QString();
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки сохранения и загрузки состояния.
+ *
+ * Перед замером загрузки двоичный снимок читается один раз и сравнивается с записанным.
+ */
+void benchSnapshot() {
+    QTemporaryDir dir;
+    SampleHistory history(1);
+
+    for (int units : {1, 1000, 100000}) {
+        FleetStore fleet;
+        fleet.resize(units, 22.0, 45.0, 101325.0);
+        for (int id = 0; id < units; ++id) {
+            fleet.setReading(id, 18.0 + (id % 100) * 0.1, 30.0 + id % 50, 99000.0 + id % 3000);
+            fleet.setSetpoint(id, 20.0 + (id % 50) * 0.1);
+            fleet.setGates(id, id % 19 * 5, id % 19 * 5 - 45);
+            fleet.setOn(id, id % 3 == 0);
+        }
+
+        // Значения не по умолчанию, чтобы проверка заметила непрочитанное поле
+        SnapshotSettings settings;
+        settings.temperature = 23.4;
+        settings.humidity = 51.5;
+        settings.pressure = 100123.0;
+        settings.temperatureUnit = 2;
+        settings.pressureUnit = 2;
+        settings.theme = 2;
+        settings.currentUnit = units - 1;
+        settings.fanSpeed = 3;
+        settings.journalSequence = 123456789;
+
+        const QString xmlPath = dir.filePath("state.xml");
+        const QString binPath = dir.filePath("state.bin");
+        const int rounds = units >= 100000 ? 3 : 20;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < rounds; ++i) {
+            writeXml(xmlPath, settings, fleet);
+        }
+        double xmlSave = timer.nsecsElapsed() / 1e6 / rounds;
+
+        timer.restart();
+        for (int i = 0; i < rounds; ++i) {
+            FleetStore loaded;
+            readXml(xmlPath, loaded);
+        }
+        double xmlLoad = timer.nsecsElapsed() / 1e6 / rounds;
+
+        timer.restart();
+        for (int i = 0; i < rounds; ++i) {
+            StateSnapshot::write(binPath, settings, fleet, history);
+        }
+        double binSave = timer.nsecsElapsed() / 1e6 / rounds;
+
+        const QString binName = QString("snapshot/binary, %1 units").arg(units);
+        {
+            SnapshotSettings loadedSettings;
+            FleetStore loaded;
+            if (!StateSnapshot::read(binPath, loadedSettings, loaded, nullptr)) {
+                reportFailure(binName + ", round trip", "read() failed");
+            } else {
+                const QString difference = compareSnapshot(settings, fleet, loadedSettings, loaded);
+                if (!difference.isEmpty()) {
+                    reportFailure(binName + ", round trip", difference);
+                }
+            }
+        }
+
+        timer.restart();
+        for (int i = 0; i < rounds; ++i) {
+            SnapshotSettings loadedSettings;
+            FleetStore loaded;
+            StateSnapshot::read(binPath, loadedSettings, loaded, nullptr);
+        }
+        double binLoad = timer.nsecsElapsed() / 1e6 / rounds;
+
+        const QString xmlName = QString("snapshot/xml, %1 units").arg(units);
+        reportValue(xmlName + ", save", xmlSave, "ms");
+        reportValue(xmlName + ", load", xmlLoad, "ms");
+        reportValue(xmlName + ", size", static_cast<double>(QFileInfo(xmlPath).size()), "bytes");
+        reportValue(binName + ", save", binSave, "ms");
+        reportValue(binName + ", load", binLoad, "ms");
+        reportValue(binName + ", size", static_cast<double>(QFileInfo(binPath).size()), "bytes");
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bench_theme.cpp
+ * @brief Бенчмарки смены темы оформления.
+ *
+ * Сравнивает смену темы отдельными вызовами setStyleSheet() на каждом виджете
+ * (как раньше в CoolWindow) с ThemeEngine для окна из 1 и 1 000 кнопок.
+ */
+
+#include "bench.h"
+#include "../includes/themeengine.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QVector>
+#include <QWidget>
+
+namespace {
+
+/**
+ * @brief Применяет тему прежним способом: отдельный стиль на каждом виджете.
+ */
+void applyPerWidget(QWidget *root, const QVector<QPushButton *> &buttons, bool dark) {
+    root->setStyleSheet(dark ? "background: black; color: white;" : "background: white; color: black;");
+    const QString border = dark ? "border: 1px solid white;" : "border: 1px solid black;";
+    for (QPushButton *button : buttons) {
+        button->setStyleSheet(border);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки смены темы оформления.
+ */
+void benchTheme() {
+    for (int count : {1, 1000}) {
+        QWidget root;
+        root.setObjectName("benchRoot");
+        QGridLayout *layout = new QGridLayout(&root);
+        QVector<QPushButton *> buttons;
+        buttons.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            QPushButton *button = new QPushButton(QString::number(i), &root);
+            layout->addWidget(button, i / 40, i % 40);
+            buttons.append(button);
+        }
+        root.resize(1600, 1000);
+        root.show();
+        QApplication::processEvents();
+
+        const int rounds = 20;
+
+        // Прежний способ
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < rounds; ++i) {
+            applyPerWidget(&root, buttons, i % 2 == 0);
+            root.repaint();
+        }
+        double perWidget = timer.nsecsElapsed() / 1e6 / rounds;
+
+        root.setStyleSheet(QString());
+        for (QPushButton *button : buttons) {
+            button->setStyleSheet(QString());
+        }
+
+        // Таблица стилей уровня приложения
+        ThemeEngine engine("benchRoot");
+        engine.styleSheet(1);
+        engine.styleSheet(2);
+        timer.restart();
+        for (int i = 0; i < rounds; ++i) {
+            engine.apply(i % 2 == 0 ? 2 : 1);
+            root.repaint();
+        }
+        double appLevel = timer.nsecsElapsed() / 1e6 / rounds;
+
+        // Блокировка восьми элементов управления через динамическое свойство
+        const int locked = qMin(8, count);
+        timer.restart();
+        for (int i = 0; i < rounds; ++i) {
+            for (int b = 0; b < locked; ++b) {
+                ThemeEngine::setLocked(buttons[b], i % 2 == 0);
+            }
+            root.repaint();
+        }
+        double lockToggle = timer.nsecsElapsed() / 1e6 / rounds;
+
+        const QString name = QString("theme/switch, %1 widgets").arg(count);
+        reportValue(name + ", per-widget", perWidget, "ms");
+        reportValue(name + ", engine", appLevel, "ms");
+        reportValue(name + ", lock", lockToggle, "ms");
+
+        qApp->setStyleSheet(QString());
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file bench_thermal.cpp
+ * @brief Бенчмарки теплового симулятора комнат.
+ *
+ * Измеряет скорость шагов симулятора (комнато-шагов в секунду) для 1 000, 10 000
+ * и 100 000 комнат и масштабирование по потокам на 100 000 комнат:
+ * от одного потока до числа ядер с удвоением.
+ */
+
+#include "bench.h"
+#include "../includes/thermalsimulator.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <cstdio>
+
+namespace {
+
+const int kStepsPerAdvance = 60; ///< Шагов на вызов (минута модельного времени)
+
+/**
+ * @brief Заполняет симулятор комнатами с разным управлением.
+ */
+void populate(ThermalSimulator &sim, int rooms) {
+    sim.resize(rooms, 28.0, 55.0);
+    for (int room = 0; room < rooms; ++room) {
+        sim.setControl(room, room % 4 != 0, 20.0 + room % 6, (room % 19) * 5, (room % 19) * 5 - 45);
+    }
+}
+
+/**
+ * @brief Измеряет скорость шагов и возвращает комнато-шаги в секунду.
+ */
+double measure(ThermalSimulator &sim, const QString &name) {
+    sim.step(kStepsPerAdvance); // Прогрев: потоки и страницы памяти
+    QElapsedTimer timer;
+    quint64 roomSteps = 0;
+    timer.start();
+    while (timer.elapsed() < 300) {
+        sim.step(kStepsPerAdvance);
+        roomSteps += quint64(sim.size()) * kStepsPerAdvance;
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    reportThroughput(name, roomSteps, elapsed, "room-steps");
+    return roomSteps / (elapsed / 1e9);
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки теплового симулятора комнат.
+ */
+void benchThermal() {
+    const int cores = qMax(1, QThread::idealThreadCount());
+
+    for (int rooms : {1000, 10000, 100000}) {
+        for (int threads : {1, cores}) {
+            ThermalSimulator sim(threads);
+            populate(sim, rooms);
+            measure(sim, QString("thermal/step, %1 rooms, %2 threads").arg(rooms).arg(threads));
+            if (cores == 1) {
+                break;
+            }
+        }
+    }
+
+    // Масштабирование по потокам
+    double single = 0.0;
+    for (int threads = 1; threads <= cores; threads = threads * 2 > cores && threads < cores ? cores : threads * 2) {
+        ThermalSimulator sim(threads);
+        populate(sim, 100000);
+        const double rate = measure(sim, QString("thermal/scaling, 100000 rooms, %1 threads").arg(threads));
+        if (threads == 1) {
+            single = rate;
+        }
+        reportValue(QString("thermal/scaling, %1 threads, speedup").arg(threads), rate / single, "x");
+        reportValue(QString("thermal/scaling, %1 threads, efficiency").arg(threads), 100.0 * rate / single / threads, "%");
+    }
+    std::fflush(stdout);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file bench_trace.cpp
+ * @brief Бенчмарки трассировки событий EventTrace и сторожа зависаний StallMonitor.
+ *
+ * Измеряет стоимость области трассировки и доставки события через TracedApplication
+ * при выключенной трассировке, в режиме отметки для сторожа и при записи; время выгрузки
+ * полного буфера в JSON; задержку обнаружения зависания цикла событий и обработчик,
+ * который сторож застал выполняющимся.
+ */
+
+#include "bench.h"
+#include "../includes/eventtrace.h"
+#include "../includes/stallmonitor.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QEventLoop>
+#include <QTimer>
+#include <cstdio>
+
+namespace {
+
+const int kIterations = 2000000; ///< Повторений на измерение стоимости области
+const int kEvents = 200000; ///< Доставок события на измерение
+const int kStallThresholdMs = 50; ///< Порог зависания в бенчмарке
+const int kStallMs = 200; ///< Длительность искусственного зависания
+
+volatile quint64 sink = 0; ///< Приёмник результатов, чтобы цикл не был удалён компилятором
+
+/**
+ * @brief Получатель событий, ничего не делающий с ними.
+ */
+class EventSink : public QObject
+{
+public:
+    bool event(QEvent *event) override {
+        sink = sink + event->type();
+        return true;
+    }
+};
+
+/**
+ * @brief Измеряет стоимость области трассировки в текущем режиме.
+ * @param name Название результата.
+ */
+void measureScope(const char *name) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kIterations; ++i) {
+        const TraceScope scope("bench", "scope", nullptr, EventTrace::now());
+        sink = i;
+    }
+    reportThroughput(name, kIterations, timer.nsecsElapsed(), "scopes");
+}
+
+/**
+ * @brief Измеряет стоимость доставки события через QCoreApplication::sendEvent в текущем режиме.
+ * @param name Название результата.
+ */
+void measureNotify(const char *name) {
+    EventSink receiver;
+    QEvent event(QEvent::User);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kEvents; ++i) {
+        QCoreApplication::sendEvent(&receiver, &event);
+    }
+    reportThroughput(name, kEvents, timer.nsecsElapsed(), "events");
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки трассировки событий и сторожа зависаний.
+ */
+void benchTrace() {
+    EventTrace::setRecording(false);
+    EventTrace::setTracking(false);
+    measureScope("trace/TraceScope off");
+    measureNotify("trace/notify off");
+
+    EventTrace::setTracking(true);
+    measureScope("trace/TraceScope tracking");
+    measureNotify("trace/notify tracking");
+
+    EventTrace::setRecording(true);
+    measureScope("trace/TraceScope recording");
+    measureNotify("trace/notify recording");
+    EventTrace::setTracking(false);
+
+    QVector<qint64> samples;
+    for (int i = 0; i < 10; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        sink = static_cast<quint64>(EventTrace::toChromeJson().size());
+        samples.append(timer.nsecsElapsed());
+    }
+    reportLatency("trace/toChromeJson (full buffer)", samples);
+    reportValue("trace/toChromeJson size", sink / 1048576.0, "MiB");
+    EventTrace::setRecording(false);
+    EventTrace::clear();
+
+    StallMonitor monitor;
+    StallRecord caught;
+    bool detected = false;
+    QEventLoop loop;
+    QObject::connect(&monitor, &StallMonitor::stallDetected, &loop, [&](const StallRecord &stall) {
+        caught = stall;
+        detected = true;
+        loop.quit();
+    });
+    monitor.start(kStallThresholdMs);
+    QTimer::singleShot(2 * kStallThresholdMs, &loop, [&]() {
+        const TraceScope scope("bench", "blocking handler", nullptr, EventTrace::now());
+        QElapsedTimer busy;
+        busy.start();
+        while (busy.elapsed() < kStallMs) {
+            sink = sink + 1;
+        }
+    });
+    QTimer::singleShot(10 * kStallMs, &loop, &QEventLoop::quit);
+    loop.exec();
+    monitor.stop();
+    if (!detected) {
+        std::printf("%-48s FAILED: %d ms stall not detected\n", "trace/stall detection", kStallMs);
+        return;
+    }
+    reportValue("trace/stall detection", caught.durationMs,
+                QString("ms (blocked %1 ms, threshold %2 ms) in \"%3\"").arg(kStallMs).arg(kStallThresholdMs).arg(caught.scope));
+}
@@ -0,0 +1,237 @@
+/**
+ * @file bench_weekly.cpp
+ * @brief Бенчмарки недельного расписания на колесе таймеров.
+ *
+ * Измеряет постановку и отмену 100 000 таймеров колеса (для сравнения — столько же
+ * QTimer), постановку 100 000 записей расписания по парку и пропускную способность
+ * срабатываний за смоделированную неделю: с пустым обработчиком и через модель.
+ */
+
+#include "bench.h"
+#include "../includes/climatemodel.h"
+#include "../includes/climatescheduler.h"
+#include "../includes/timerwheel.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QTime>
+#include <QTimer>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int kEntries = 100000; ///< Записей расписания (таймеров)
+const int kUnits = 1000; ///< Блоков парка
+const int kQTimers = 100000; ///< QTimer в сравнительном измерении
+const qint64 kWeekSeconds = 7 * 24 * 3600; ///< Секунд в неделе
+const int kStepSeconds = 60; ///< Шаг продвижения часов планировщика, с
+
+/**
+ * @brief Возвращает записи расписания: по 100 на блок, случайные дни, минуты и действия.
+ * @param count Количество записей.
+ */
+QVector<ScheduleEntry> makeEntries(int count) {
+    std::mt19937 random(25);
+    QVector<ScheduleEntry> entries(count);
+    for (int i = 0; i < count; ++i) {
+        ScheduleEntry &entry = entries[i];
+        entry.unit = i % kUnits;
+        entry.days = static_cast<quint8>(random() % ScheduleEntry::kAllDays + 1);
+        entry.minute = static_cast<quint16>(random() % (24 * 60));
+        entry.action = static_cast<quint8>(ScheduleEntry::SetSetpoint + random() % 3);
+        entry.setpoint = 18.0 + random() % 9;
+        entry.power = static_cast<qint8>(random() % 2);
+        entry.hGate = static_cast<qint8>(random() % 19 * 5);
+        entry.vGate = static_cast<qint8>(random() % 19 * 5 - 45);
+    }
+    return entries;
+}
+
+/**
+ * @brief Сверяет сработавшие за неделю таймеры колеса с поставленными.
+ * @param due Сработавшие таймеры в порядке срабатывания.
+ * @param steps Для каждой порции: конец порции в due и такт её срабатывания.
+ * @param ticks Такт, на который ставился таймер с payload i.
+ * @return Описание первого расхождения или пустая строка.
+ */
+QString checkExpired(const QVector<TimerWheel::Fired> &due, const QVector<QPair<int, qint64>> &steps,
+                     const QVector<qint64> &ticks) {
+    if (due.size() != ticks.size()) {
+        return QString("%1 of %2 timers fired").arg(due.size()).arg(ticks.size());
+    }
+    QVector<bool> seen(ticks.size(), false);
+    int begin = 0;
+    for (const QPair<int, qint64> &step : steps) {
+        for (int i = begin; i < step.first; ++i) {
+            const quint32 payload = due[i].payload;
+            if (payload >= static_cast<quint32>(ticks.size()) || seen[payload]) {
+                return QString("timer %1 fired twice or was never scheduled").arg(payload);
+            }
+            seen[payload] = true;
+            if (ticks[payload] != step.second) {
+                return QString("timer %1 fired at tick %2 instead of %3").arg(payload).arg(step.second).arg(ticks[payload]);
+            }
+        }
+        begin = step.first;
+    }
+    return QString();
+}
+
+/**
+ * @brief Возвращает число срабатываний записей за неделю: по одному на каждый выбранный день.
+ *
+ * Неделя берётся полуоткрытой (начало, начало + 7 суток]: запись на понедельник 00:00
+ * срабатывает в её конце, поэтому каждый день недели попадает в неё ровно один раз.
+ * @param entries Записи расписания (без праздников).
+ */
+quint64 expectedFirings(const QVector<ScheduleEntry> &entries) {
+    quint64 expected = 0;
+    for (const ScheduleEntry &entry : entries) {
+        expected += qPopulationCount(static_cast<quint32>(entry.days & ScheduleEntry::kAllDays));
+    }
+    return expected;
+}
+
+/**
+ * @brief Продвигает часы планировщика на неделю и выводит пропускную способность срабатываний.
+ *
+ * Число срабатываний, отличное от ожидаемого, — непройденная проверка.
+ * @param name Название результата.
+ * @param scheduler Планировщик.
+ * @param start Начало недели, секунды от начала эпохи.
+ * @param expected Ожидаемое число срабатываний.
+ */
+void runWeek(const QString &name, ClimateScheduler &scheduler, qint64 start, quint64 expected) {
+    const quint64 firedBefore = scheduler.firedEntries();
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 now = start + kStepSeconds; now <= start + kWeekSeconds; now += kStepSeconds) {
+        scheduler.advanceTo(now);
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    const quint64 fired = scheduler.firedEntries() - firedBefore;
+    reportThroughput(name, fired, elapsedNs, "firings");
+    reportValue(name + ", cost", fired != 0 ? static_cast<double>(elapsedNs) / fired : 0.0, "ns/firing");
+    if (fired != expected) {
+        reportFailure(name, QString("%1 of %2 expected firings").arg(fired).arg(expected));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Бенчмарки недельного расписания на колесе таймеров.
+ */
+void benchWeekly() {
+    std::mt19937 random(7);
+    QVector<TimerWheel::Handle> handles(kEntries);
+    QVector<qint64> ticks(kEntries);
+    for (qint64 &tick : ticks) {
+        tick = 1 + static_cast<qint64>(random() % kWeekSeconds);
+    }
+
+    {
+        TimerWheel wheel(0);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kEntries; ++i) {
+            handles[i] = wheel.schedule(ticks[i], static_cast<quint32>(i));
+        }
+        reportThroughput("weekly/wheel schedule x100k", kEntries, timer.nsecsElapsed(), "timers");
+        timer.restart();
+        for (int i = 0; i < kEntries; ++i) {
+            wheel.cancel(handles[i]);
+        }
+        reportThroughput("weekly/wheel cancel x100k", kEntries, timer.nsecsElapsed(), "timers");
+
+        for (int i = 0; i < kEntries; ++i) {
+            wheel.schedule(ticks[i], static_cast<quint32>(i));
+        }
+        // Сработавшие таймеры копятся в due, такт каждой порции — в steps; проверка после замера
+        QVector<TimerWheel::Fired> due;
+        QVector<QPair<int, qint64>> steps;
+        due.reserve(kEntries);
+        steps.reserve(kEntries);
+        int fired = 0;
+        timer.restart();
+        for (int count; (count = wheel.expire(kWeekSeconds, due)) > 0;) {
+            fired += count;
+            steps.append(qMakePair(due.size(), wheel.now()));
+        }
+        reportThroughput("weekly/wheel expire week x100k", fired, timer.nsecsElapsed(), "timers");
+        const QString failure = checkExpired(due, steps, ticks);
+        if (!failure.isEmpty()) {
+            reportFailure("weekly/wheel expire week x100k", failure);
+        }
+    }
+
+    {
+        std::vector<std::unique_ptr<QTimer>> timers;
+        timers.reserve(kQTimers);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kQTimers; ++i) {
+            timers.emplace_back(new QTimer);
+            timers.back()->setSingleShot(true);
+            timers.back()->start(static_cast<int>(ticks[i] % 1000000) + 1000);
+        }
+        reportThroughput("weekly/QTimer start x100k (baseline)", kQTimers, timer.nsecsElapsed(), "timers");
+        timer.restart();
+        for (std::unique_ptr<QTimer> &qtimer : timers) {
+            qtimer->stop();
+        }
+        reportThroughput("weekly/QTimer stop x100k (baseline)", kQTimers, timer.nsecsElapsed(), "timers");
+    }
+
+    const qint64 monday = QDateTime(QDate(2024, 1, 1), QTime(0, 0)).toSecsSinceEpoch();
+    const QVector<ScheduleEntry> entries = makeEntries(kEntries);
+    const quint64 expected = expectedFirings(entries);
+    {
+        ClimateScheduler scheduler;
+        quint64 sink = 0;
+        scheduler.setHandler([&sink](const ScheduleEntry &entry) { sink += entry.unit; });
+        scheduler.resetClock(monday);
+        QElapsedTimer timer;
+        timer.start();
+        for (const ScheduleEntry &entry : entries) {
+            scheduler.add(entry);
+        }
+        reportThroughput("weekly/scheduler add x100k", kEntries, timer.nsecsElapsed(), "entries");
+        runWeek("weekly/scheduler week x100k, empty handler", scheduler, monday, expected);
+
+        HolidayOverride holiday;
+        holiday.day = QDate(2024, 1, 10).toJulianDay();
+        holiday.profile = 7;
+        timer.restart();
+        scheduler.setHoliday(holiday);
+        const qint64 holidayNs = timer.nsecsElapsed();
+        reportValue("weekly/scheduler set holiday x100k", holidayNs / 1e6,
+                    QString("ms (rearms %1 entries)").arg(scheduler.size()));
+
+        timer.restart();
+        for (quint32 id = 1; id <= static_cast<quint32>(kEntries); ++id) {
+            scheduler.remove(id);
+        }
+        reportThroughput("weekly/scheduler remove x100k", kEntries, timer.nsecsElapsed(), "entries");
+        if (sink == 0) {
+            std::printf("%llu\n", static_cast<unsigned long long>(sink));
+        }
+    }
+    {
+        ClimateModel model;
+        model.setFleetSize(kUnits);
+        model.scheduler()->resetClock(monday);
+        QElapsedTimer timer;
+        timer.start();
+        for (const ScheduleEntry &entry : entries) {
+            model.addSchedule(entry);
+        }
+        reportThroughput("weekly/model addSchedule x100k", kEntries, timer.nsecsElapsed(), "entries");
+        runWeek("weekly/model week x100k", *model.scheduler(), monday, expected);
+    }
+}
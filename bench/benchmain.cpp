@@ -0,0 +1,235 @@
+/**
+ * @file benchmain.cpp
+ * @brief Точка входа набора бенчмарков AirConManagerBench.
+ *
+ * Запускает наборы бенчмарков на платформе offscreen и выводит результаты
+ * в стандартный вывод, а при указании --json — также в JSON-отчёт.
+ *
+ * Пример: AirConManagerBench --json results.json coolwindow scheduler
+ */
+
+#include "bench.h"
+#include "../includes/tracedapplication.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+QJsonArray results; ///< Результаты для JSON-отчёта
+int failures = 0; ///< Непройденные проверки корректности
+
+/**
+ * @brief Набор бенчмарков.
+ */
+struct Suite
+{
+    const char *name; ///< Название набора для выбора в командной строке
+    void (*run)(); ///< Функция запуска
+};
+
+const Suite kSuites[] = {
+    {"ingest", benchIngest},
+    {"fleet", benchFleet},
+    {"history", benchHistory},
+    {"snapshot", benchSnapshot},
+    {"journal", benchJournal},
+    {"theme", benchTheme},
+    {"conversion", benchConversion},
+    {"gauge", benchGauge},
+    {"labels", benchLabels},
+    {"scheduler", benchScheduler},
+    {"coolwindow", benchCoolWindow},
+    {"thermal", benchThermal},
+    {"controller", benchController},
+    {"ring", benchRing},
+    {"replay", benchReplay},
+    {"archive", benchArchive},
+    {"probe", benchProbe},
+    {"trace", benchTrace},
+    {"control", benchControl},
+    {"modbus", benchModbus},
+    {"bus", benchBus},
+    {"weekly", benchWeekly},
+};
+
+/**
+ * @brief Возвращает процентиль отсортированной выборки (метод ближайшего ранга).
+ */
+qint64 percentile(const QVector<qint64> &sorted, double p) {
+    int rank = static_cast<int>(p / 100.0 * sorted.size() + 0.999999);
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+} // namespace
+
+/**
+ * @brief Выводит результат измерения пропускной способности.
+ * @param name Название измерения.
+ * @param items Количество обработанных элементов.
+ * @param elapsedNs Затраченное время в наносекундах.
+ * @param unit Единица элементов.
+ */
+void reportThroughput(const QString &name, quint64 items, qint64 elapsedNs, const QString &unit) {
+    double seconds = elapsedNs / 1e9;
+    double rate = seconds > 0 ? items / seconds : 0.0;
+    std::printf("%-48s %12llu %s in %9.3f ms  -> %14.0f %s/s\n",
+                qPrintable(name), static_cast<unsigned long long>(items), qPrintable(unit),
+                elapsedNs / 1e6, rate, qPrintable(unit));
+    std::fflush(stdout);
+
+    QJsonObject result;
+    result["name"] = name;
+    result["kind"] = "throughput";
+    result["items"] = static_cast<double>(items);
+    result["unit"] = unit;
+    result["elapsed_ns"] = static_cast<double>(elapsedNs);
+    result["per_second"] = rate;
+    results.append(result);
+}
+
+/**
+ * @brief Выводит распределение длительностей отдельных операций.
+ * @param name Название измерения.
+ * @param samplesNs Длительности операций в наносекундах.
+ */
+void reportLatency(const QString &name, QVector<qint64> samplesNs) {
+    if (samplesNs.isEmpty()) {
+        return;
+    }
+    std::sort(samplesNs.begin(), samplesNs.end());
+    double sum = 0.0;
+    for (qint64 sample : samplesNs) {
+        sum += sample;
+    }
+    const double mean = sum / samplesNs.size();
+    const qint64 p50 = percentile(samplesNs, 50);
+    const qint64 p90 = percentile(samplesNs, 90);
+    const qint64 p99 = percentile(samplesNs, 99);
+
+    std::printf("%-48s %7d runs  p50 %10.2f us  p90 %10.2f us  p99 %10.2f us  max %10.2f us\n",
+                qPrintable(name), samplesNs.size(), p50 / 1e3, p90 / 1e3, p99 / 1e3, samplesNs.constLast() / 1e3);
+    std::fflush(stdout);
+
+    QJsonObject result;
+    result["name"] = name;
+    result["kind"] = "latency";
+    result["unit"] = "ns";
+    result["count"] = samplesNs.size();
+    result["min"] = static_cast<double>(samplesNs.constFirst());
+    result["mean"] = mean;
+    result["p50"] = static_cast<double>(p50);
+    result["p90"] = static_cast<double>(p90);
+    result["p99"] = static_cast<double>(p99);
+    result["max"] = static_cast<double>(samplesNs.constLast());
+    results.append(result);
+}
+
+/**
+ * @brief Выводит отдельную величину.
+ * @param name Название измерения.
+ * @param value Значение.
+ * @param unit Единица значения.
+ */
+void reportValue(const QString &name, double value, const QString &unit) {
+    std::printf("%-48s %14.3f %s\n", qPrintable(name), value, qPrintable(unit));
+    std::fflush(stdout);
+
+    QJsonObject result;
+    result["name"] = name;
+    result["kind"] = "value";
+    result["value"] = value;
+    result["unit"] = unit;
+    results.append(result);
+}
+
+/**
+ * @brief Сообщает о непройденной проверке корректности.
+ * @param name Название проверки.
+ * @param reason Описание расхождения.
+ */
+void reportFailure(const QString &name, const QString &reason) {
+    std::printf("%-48s FAILED: %s\n", qPrintable(name), qPrintable(reason));
+    std::fflush(stdout);
+    ++failures;
+
+    QJsonObject result;
+    result["name"] = name;
+    result["kind"] = "failure";
+    result["reason"] = reason;
+    results.append(result);
+}
+
+/**
+ * @brief Главная функция набора бенчмарков.
+ *
+ * --json <путь> — записать результаты в JSON-отчёт;
+ * позиционные аргументы — названия запускаемых наборов (по умолчанию все).
+ *
+ * @param argc Количество аргументов командной строки.
+ * @param argv Массив аргументов командной строки.
+ * @return int Код завершения: 0 — успех, 1 — неизвестный набор или ошибка записи отчёта,
+ *             2 — не пройдена проверка корректности (отчёт при этом записывается).
+ */
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    TracedApplication<QApplication> a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Бенчмарки AirConManager.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "Записать результаты в JSON-отчёт.", "path");
+    parser.addOption(jsonOption);
+    parser.addPositionalArgument("suites", "Запускаемые наборы (по умолчанию все).", "[suite...]");
+    parser.process(a);
+
+    const QStringList selected = parser.positionalArguments();
+    for (const QString &name : selected) {
+        bool known = false;
+        for (const Suite &suite : kSuites) {
+            known = known || name == suite.name;
+        }
+        if (!known) {
+            std::fprintf(stderr, "Неизвестный набор бенчмарков: %s\n", qPrintable(name));
+            return 1;
+        }
+    }
+
+    for (const Suite &suite : kSuites) {
+        if (selected.isEmpty() || selected.contains(suite.name)) {
+            suite.run();
+        }
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject report;
+        report["suite"] = "AirConManagerBench";
+        report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        report["qt_version"] = qVersion();
+        report["cpu"] = QSysInfo::currentCpuArchitecture();
+        report["os"] = QSysInfo::prettyProductName();
+        report["failures"] = failures;
+        report["results"] = results;
+
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || file.write(QJsonDocument(report).toJson()) < 0) {
+            std::fprintf(stderr, "Не удалось записать отчёт %s: %s\n",
+                         qPrintable(file.fileName()), qPrintable(file.errorString()));
+            return 1;
+        }
+    }
+
+    return failures == 0 ? 0 : 2;
+}
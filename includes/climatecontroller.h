@@ -0,0 +1,180 @@
+#ifndef CLIMATECONTROLLER_H
+#define CLIMATECONTROLLER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "seqlock.h"
+
+/**
+ * @file climatecontroller.h
+ * @brief Заголовочный файл для регулятора температуры.
+ *
+ * Этот файл содержит объявление класса ClimateController — регулятора с фиксированным
+ * периодом, работающего в отдельном потоке, — и структур его настроек, состояния
+ * и статистики дрожания периода.
+ */
+
+/**
+ * @struct ControllerSettings
+ * @brief Настройки регулятора, передаваемые в поток регулятора.
+ */
+struct ControllerSettings
+{
+    /**
+     * @enum Mode
+     * @brief Закон регулирования.
+     */
+    enum Mode : qint32 {
+        Hysteresis = 1, ///< Двухпозиционный с гистерезисом: компрессор включён или выключен
+        Pid ///< ПИД: плавная мощность 0..1
+    };
+
+    qint32 mode = Hysteresis; ///< Закон регулирования
+    qint32 enabled = 0; ///< Блок включён (у выключенного блока мощность 0)
+    double setpoint = 22.0; ///< Уставка, °C
+    double measured = 22.0; ///< Измеренная температура, °C
+    double band = 0.5; ///< Половина зоны гистерезиса, °C
+    double kp = 0.5; ///< Пропорциональный коэффициент, 1/°C
+    double ki = 0.002; ///< Интегральный коэффициент, 1/(°C·с)
+    double kd = 0.0; ///< Дифференциальный коэффициент, с/°C
+};
+
+/**
+ * @struct ControllerState
+ * @brief Состояние регулятора после такта.
+ */
+struct ControllerState
+{
+    quint64 tick = 0; ///< Номер такта
+    double setpoint = 0.0; ///< Уставка, °C
+    double measured = 0.0; ///< Измеренная температура, °C
+    double error = 0.0; ///< Рассогласование (измеренная − уставка), °C
+    double output = 0.0; ///< Мощность охлаждения 0..1
+    double integral = 0.0; ///< Интегральная составляющая ПИД
+    qint32 compressorOn = 0; ///< Компрессор включён
+    qint32 mode = ControllerSettings::Hysteresis; ///< Закон регулирования
+};
+
+/**
+ * @struct JitterStats
+ * @brief Статистика опоздания тактов относительно расписания.
+ */
+struct JitterStats
+{
+    quint64 ticks = 0; ///< Выполнено тактов
+    quint64 overruns = 0; ///< Пропущено тактов из-за опоздания больше периода
+    qint64 minNs = 0; ///< Минимальное опоздание, нс
+    qint64 maxNs = 0; ///< Максимальное опоздание, нс
+    double meanNs = 0.0; ///< Среднее опоздание, нс
+    qint64 p99Ns = 0; ///< 99-й процентиль опоздания (с точностью корзины), нс
+};
+
+/**
+ * @class ClimateController
+ * @brief Регулятор температуры с фиксированным периодом в отдельном потоке.
+ *
+ * Такты идут по абсолютному расписанию (начало + n·период), поэтому период не накапливает
+ * ошибку; если такт опоздал больше чем на период, пропущенные такты не навёрстываются,
+ * а считаются. Закон регулирования использует номинальный период, а не измеренный,
+ * поэтому при одинаковых входах выход одинаков независимо от загрузки системы.
+ *
+ * Обмен с потоком регулятора не блокирует его: настройки и входы передаются
+ * через SeqLock от потока интерфейса, а состояние и статистика — через SeqLock
+ * от потока регулятора; читатели забирают последнее значение (например, раз за кадр).
+ */
+class ClimateController
+{
+public:
+    static const int kHistogramBuckets = 512; ///< Корзин гистограммы опозданий
+    static const qint64 kBucketNs = 10000; ///< Ширина корзины, нс (гистограмма до 5,12 мс)
+
+    /**
+     * @brief Конструктор класса ClimateController. Поток запускается вызовом start().
+     */
+    ClimateController();
+
+    /**
+     * @brief Деструктор класса ClimateController. Останавливает поток регулятора.
+     */
+    ~ClimateController();
+
+    ClimateController(const ClimateController &) = delete;
+    ClimateController &operator=(const ClimateController &) = delete;
+
+    /**
+     * @brief Запускает поток регулятора.
+     * @param periodNs Период тактов, нс.
+     */
+    void start(qint64 periodNs = 100000000);
+
+    /**
+     * @brief Останавливает поток регулятора.
+     */
+    void stop();
+
+    /**
+     * @brief Возвращает true, если поток регулятора работает.
+     */
+    bool isRunning() const { return thread.joinable(); }
+
+    /**
+     * @brief Возвращает период тактов, нс.
+     */
+    qint64 period() const { return periodNs; }
+
+    /**
+     * @brief Передаёт регулятору новые настройки и входы.
+     * @param settings Настройки.
+     */
+    void setSettings(const ControllerSettings &settings);
+
+    /**
+     * @brief Возвращает последние переданные настройки.
+     */
+    ControllerSettings settings() const { return pendingSettings; }
+
+    /**
+     * @brief Возвращает состояние после последнего такта. Не блокирует поток регулятора.
+     */
+    ControllerState state() const { return published.load(); }
+
+    /**
+     * @brief Возвращает статистику опоздания тактов. Не блокирует поток регулятора.
+     */
+    JitterStats jitter() const { return publishedJitter.load(); }
+
+    /**
+     * @brief Сбрасывает статистику опоздания тактов.
+     */
+    void resetJitter() { resetRequested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Выполняет один шаг закона регулирования.
+     *
+     * Используется потоком регулятора; открыт для проверки закона без потока.
+     * @param settings Настройки и входы.
+     * @param previous Состояние после прошлого такта.
+     * @param dt Период, с.
+     * @return Новое состояние.
+     */
+    static ControllerState compute(const ControllerSettings &settings, const ControllerState &previous, double dt);
+
+private:
+    void run();
+
+    std::thread thread; ///< Поток регулятора
+    std::mutex stopMutex; ///< Защита флага завершения при ожидании такта
+    std::condition_variable stopSignal; ///< Пробуждение потока при остановке
+    bool stopping = false; ///< Поток завершается
+    std::atomic<bool> resetRequested{false}; ///< Запрошен сброс статистики
+    qint64 periodNs = 100000000; ///< Период тактов, нс
+    ControllerSettings pendingSettings; ///< Последние настройки (поток интерфейса)
+    SeqLock<ControllerSettings> input; ///< Настройки для потока регулятора
+    SeqLock<ControllerState> published; ///< Состояние для потока интерфейса
+    SeqLock<JitterStats> publishedJitter; ///< Статистика для потока интерфейса
+};
+
+#endif
@@ -0,0 +1,463 @@
+#ifndef CLIMATEMODEL_H
+#define CLIMATEMODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "climatecontroller.h"
+#include "climatescheduler.h"
+#include "fleetstore.h"
+#include "historyarchive.h"
+#include "inputtrace.h"
+#include "samplehistory.h"
+#include "sensoringest.h"
+#include "statebus.h"
+#include "statejournal.h"
+
+/**
+ * @file climatemodel.h
+ * @brief Заголовочный файл для модели состояния системы кондиционирования.
+ *
+ * Этот файл содержит объявление класса ClimateModel — ядра приложения без виджетов:
+ * состояние парка блоков, единицы измерения, допустимые диапазоны, история измерений,
+ * сохранение в снимок и журнал изменений.
+ */
+
+/**
+ * @class ClimateModel
+ * @brief Состояние и управление парком кондиционеров без графического интерфейса.
+ *
+ * Модель хранит парк блоков (значения текущего блока берутся прямо из парка),
+ * проверяет диапазоны, пересчитывает единицы измерения и записывает каждое изменение
+ * в журнал. Об изменениях сообщает сигналом changed() с битами изменившихся частей
+ * и публикует их же со значениями полей в шину изменений (stateBus()), поэтому
+ * графический интерфейс (CoolWindow) и любые другие потребители только отображают состояние.
+ *
+ * Уставка температуры хранится отдельно от измеренной температуры; регулятор
+ * (ClimateController) в своём потоке сравнивает их с фиксированным периодом и выдаёт
+ * мощность охлаждения текущего блока, а модель передаёт ему новые входы при каждом изменении.
+ *
+ * Недельное расписание парка (scheduler()) выполняется в потоке модели: сработавшая запись
+ * меняет уставку, питание или жалюзи своего блока так же, как действие пользователя, и
+ * попадает в журнал. Записи и замены дат добавляются через addSchedule() и setHoliday(),
+ * записываются в журнал и сохраняются в снимке вместе с настройками.
+ *
+ * Если задана запись входных воздействий (setRecorder()), модель дописывает в неё каждое
+ * принятое измерение и каждое действие пользователя, чтобы TraceReplayer мог повторить сеанс.
+ *
+ * Модель не потокобезопасна и работает в потоке, которому принадлежит: из других
+ * потоков её слоты вызываются через очереди событий (сигналы или QMetaObject::invokeMethod).
+ */
+class ClimateModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum TemperatureUnit
+     * @brief Перечисление возможных единиц измерения температуры.
+     */
+    enum class TemperatureUnit {
+        Celsius = 1,
+        Fahrenheit,
+        Kelvin
+    };
+
+    /**
+     * @enum PressureUnit
+     * @brief Перечисление возможных единиц измерения давления.
+     */
+    enum class PressureUnit {
+        Pascal = 1,
+        Mmhg
+    };
+
+    /**
+     * @enum Theme
+     * @brief Перечисление возможных тем интерфейса (сохраняется вместе с состоянием).
+     */
+    enum class Theme {
+        Light = 1,
+        Dark
+    };
+
+    /**
+     * @enum FanSpeed
+     * @brief Перечисление скоростей вентилятора (сохраняется вместе с состоянием).
+     */
+    enum class FanSpeed {
+        Low = 1,
+        Medium,
+        High
+    };
+
+    /**
+     * @enum Change
+     * @brief Биты изменившихся частей состояния в сигнале changed().
+     */
+    enum Change : quint32 {
+        TemperatureChanged = 1u << 0, ///< Температура текущего блока
+        HumidityChanged = 1u << 1, ///< Влажность текущего блока
+        PressureChanged = 1u << 2, ///< Давление текущего блока
+        HGateChanged = 1u << 3, ///< Горизонтальные жалюзи текущего блока
+        VGateChanged = 1u << 4, ///< Вертикальные жалюзи текущего блока
+        PowerChanged = 1u << 5, ///< Питание текущего блока
+        UnitsChanged = 1u << 6, ///< Единицы измерения
+        ThemeChanged = 1u << 7, ///< Тема интерфейса
+        CurrentUnitChanged = 1u << 8, ///< Выбран другой блок
+        HistoryChanged = 1u << 9, ///< История измерений
+        SetpointChanged = 1u << 10, ///< Уставка температуры текущего блока
+        FanSpeedChanged = 1u << 11, ///< Скорость вентилятора
+        ReadingChanged = TemperatureChanged | HumidityChanged | PressureChanged, ///< Все показания
+        AllChanged = (1u << 12) - 1 ///< Всё состояние
+    };
+
+    static const int kGateStep = 5; ///< Шаг поворота жалюзи кнопками, градусы
+
+    /**
+     * @brief Конструктор класса ClimateModel. До вызова load() парк состоит из одного блока с базовыми настройками.
+     * @param parent Родительский объект.
+     */
+    explicit ClimateModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса ClimateModel. Уплотняет журнал в снимок и закрывает журнал.
+     */
+    ~ClimateModel();
+
+    /**
+     * @brief Возвращает путь к снимку состояния по умолчанию.
+     */
+    static QString defaultSnapshotPath();
+
+    /**
+     * @brief Загружает состояние из снимка и восстанавливает изменения по журналу.
+     *
+     * Журнал и XML-файл прежнего формата ищутся рядом со снимком под тем же именем
+     * с расширениями .journal и .xml.
+     * @param snapshotPath Путь к файлу снимка.
+     * @param deferHistory true — историю измерений не читать до вызова loadHistory()
+     *        (окно загружает её после первого кадра).
+     */
+    void load(const QString &snapshotPath, bool deferHistory = false);
+
+    /**
+     * @brief Читает историю измерений, отложенную при load().
+     *
+     * Измерения, принятые после загрузки, сохраняются после прочитанных. Если после
+     * загрузки был выбран другой блок, отложенная история больше не нужна и не читается.
+     */
+    void loadHistory();
+
+    /**
+     * @brief Сохраняет состояние в двоичный снимок.
+     * @param snapshotPath Путь к файлу снимка.
+     * @return true, если снимок записан.
+     */
+    bool save(const QString &snapshotPath);
+
+    /**
+     * @brief Уплотняет журнал изменений в снимок, загруженный последним.
+     */
+    void compact();
+
+    double temperature() const { return fleetStore.temperature(current); } ///< Температура текущего блока
+    double setpoint() const { return fleetStore.setpoint(current); } ///< Уставка температуры текущего блока
+    double humidity() const { return fleetStore.humidity(current); } ///< Влажность текущего блока
+    double pressure() const { return fleetStore.pressure(current); } ///< Давление текущего блока
+    int hGateDir() const { return fleetStore.hGateDir(current); } ///< Горизонтальные жалюзи текущего блока
+    int vGateDir() const { return fleetStore.vGateDir(current); } ///< Вертикальные жалюзи текущего блока
+    bool isOn() const { return fleetStore.isOn(current); } ///< Питание текущего блока
+    TemperatureUnit temperatureUnit() const { return tempUnit; } ///< Единица температуры
+    PressureUnit pressureUnit() const { return presUnit; } ///< Единица давления
+    Theme theme() const { return currentTheme; } ///< Тема интерфейса
+    FanSpeed fanSpeed() const { return currentFanSpeed; } ///< Скорость вентилятора
+    int currentUnit() const { return current; } ///< Номер текущего блока
+    int fleetSize() const { return fleetStore.size(); } ///< Количество блоков
+    const FleetStore &fleet() const { return fleetStore; } ///< Состояние всех блоков
+    const SampleHistory &history() const { return samples; } ///< История измерений текущего блока
+    const HistoryArchive &archive() const { return longTerm; } ///< Сжатая долговременная история текущего блока (°C, Па)
+    const StateJournal *journal() const { return stateJournal; } ///< Журнал изменений
+    StateBus *stateBus() const { return bus; } ///< Шина изменений состояния текущего блока
+    ClimateController *controller() { return &climateController; } ///< Регулятор температуры текущего блока
+    ClimateScheduler *scheduler() const { return climateScheduler; } ///< Недельное расписание парка
+
+    /**
+     * @brief Задаёт запись входных воздействий.
+     * @param writer Открытая запись или nullptr, чтобы прекратить запись. Модель не владеет записью.
+     */
+    void setRecorder(InputTraceWriter *writer) { recorder = writer; }
+
+    /**
+     * @brief Возвращает начальное состояние для новой записи входных воздействий.
+     */
+    TraceInitialState traceState() const;
+
+    /**
+     * @brief Добавляет запись недельного расписания и записывает её в журнал.
+     * @param entry Запись (id 0 — назначить новый номер; уставка в °C).
+     * @return Номер записи или 0, если запись неверна, блока нет или значения вне диапазонов.
+     */
+    quint32 addSchedule(const ScheduleEntry &entry);
+
+    /**
+     * @brief Удаляет запись недельного расписания.
+     * @param id Номер записи.
+     * @return true, если запись была.
+     */
+    bool removeSchedule(quint32 id);
+
+    /**
+     * @brief Задаёт замену даты в расписании и записывает её в журнал.
+     * @param holiday Замена.
+     * @return true, если замена верна.
+     */
+    bool setHoliday(const HolidayOverride &holiday);
+
+    /**
+     * @brief Удаляет замену даты в расписании.
+     * @param day Дата (юлианский день).
+     * @param unit Номер блока (-1 — весь парк).
+     * @return true, если замена была.
+     */
+    bool removeHoliday(qint64 day, qint32 unit);
+
+    double minTemperature() const; ///< Минимальная температура в текущей единице
+    double maxTemperature() const; ///< Максимальная температура в текущей единице
+    double minPressure() const; ///< Минимальное давление в текущей единице
+    double maxPressure() const; ///< Максимальное давление в текущей единице
+    static double minHumidity() { return 0.0; } ///< Минимальная влажность, %
+    static double maxHumidity() { return 100.0; } ///< Максимальная влажность, %
+    static int minHGate() { return 0; } ///< Минимальный угол горизонтальных жалюзи
+    static int maxHGate() { return 90; } ///< Максимальный угол горизонтальных жалюзи
+    static int minVGate() { return -45; } ///< Минимальный угол вертикальных жалюзи
+    static int maxVGate() { return 45; } ///< Максимальный угол вертикальных жалюзи
+
+    /**
+     * @brief Возвращает шаг изменения температуры кнопками (1 градус Цельсия в текущей единице).
+     */
+    double temperatureStep() const;
+
+    /**
+     * @brief Возвращает обозначение единицы температуры (C, F, K).
+     * @param id Единица.
+     */
+    static QString temperatureScale(TemperatureUnit id);
+
+    /**
+     * @brief Возвращает обозначение единицы давления (Pa, mm.h.g.).
+     * @param id Единица.
+     */
+    static QString pressureScale(PressureUnit id);
+
+    /**
+     * @brief Переводит значение температуры из одной единицы измерения в другую.
+     * @param value Значение.
+     * @param from Исходная единица.
+     * @param to Целевая единица.
+     */
+    static double convertTemperature(double value, TemperatureUnit from, TemperatureUnit to);
+
+    /**
+     * @brief Переводит значение давления из одной единицы измерения в другую.
+     * @param value Значение.
+     * @param from Исходная единица.
+     * @param to Целевая единица.
+     */
+    static double convertPressure(double value, PressureUnit from, PressureUnit to);
+
+public slots:
+    /**
+     * @brief Принимает измерение: записывает его в историю с текущим временем и делает показаниями текущего блока.
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void acceptReading(double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Принимает пакет измерений: все записываются в историю, последнее становится показаниями.
+     * @param batch Измерения в порядке поступления.
+     */
+    void acceptBatch(const QVector<SensorSample> &batch);
+
+    /**
+     * @brief Задаёт показания текущего блока без записи в историю.
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void setReading(double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Задаёт температуру и влажность первых count блоков парка одним проходом.
+     *
+     * Предназначено для источников, обновляющих весь парк сразу (симулятор комнат):
+     * значения не записываются в журнал и сохраняются со следующим снимком.
+     * Показания текущего блока передаются отдельно через acceptReading().
+     * @param temperatures Температуры в текущей единице.
+     * @param humidities Влажность.
+     * @param count Количество блоков.
+     */
+    void acceptFleetReadings(const double *temperatures, const double *humidities, int count);
+
+    /**
+     * @brief Добавляет измерение в историю не чаще одного раза за шаг истории.
+     * @param timestampUs Метка времени в микросекундах.
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void recordHistory(qint64 timestampUs, double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Очищает историю измерений текущего блока.
+     */
+    void clearHistory();
+
+    /**
+     * @brief Задаёт температуру текущего блока, если она в допустимом диапазоне.
+     * @param value Температура в текущей единице.
+     * @return true, если значение принято.
+     */
+    bool setTemperature(double value);
+
+    /**
+     * @brief Задаёт уставку температуры текущего блока, если она в допустимом диапазоне.
+     * @param value Уставка в текущей единице.
+     * @return true, если значение принято.
+     */
+    bool setSetpoint(double value);
+
+    /**
+     * @brief Увеличивает уставку температуры на шаг, не выходя за диапазон.
+     */
+    void temperatureUp();
+
+    /**
+     * @brief Уменьшает уставку температуры на шаг, не выходя за диапазон.
+     */
+    void temperatureDown();
+
+    /**
+     * @brief Задаёт положение жалюзи текущего блока, если оно в допустимом диапазоне.
+     * @param hDir Угол горизонтальных жалюзи.
+     * @param vDir Угол вертикальных жалюзи.
+     * @return true, если положение принято.
+     */
+    bool setGates(int hDir, int vDir);
+
+    /**
+     * @brief Поворачивает горизонтальные жалюзи, не выходя за диапазон.
+     * @param delta Изменение угла.
+     */
+    void moveHGate(int delta);
+
+    /**
+     * @brief Поворачивает вертикальные жалюзи, не выходя за диапазон.
+     * @param delta Изменение угла.
+     */
+    void moveVGate(int delta);
+
+    /**
+     * @brief Включает или выключает текущий блок. Выключение возвращает жалюзи в стартовую позицию.
+     * @param on Новое состояние.
+     */
+    void setPower(bool on);
+
+    /**
+     * @brief Переключает питание текущего блока.
+     */
+    void togglePower();
+
+    /**
+     * @brief Переводит все значения в новые единицы измерения.
+     * @param tempId Идентификатор единицы температуры.
+     * @param presId Идентификатор единицы давления.
+     */
+    void setUnits(int tempId, int presId);
+
+    /**
+     * @brief Задаёт тему интерфейса.
+     * @param themeId Идентификатор темы.
+     */
+    void setTheme(int themeId);
+
+    /**
+     * @brief Задаёт скорость вентилятора.
+     * @param speedId Идентификатор скорости.
+     */
+    void setFanSpeed(int speedId);
+
+    /**
+     * @brief Делает блок текущим.
+     * @param id Номер блока.
+     */
+    void selectUnit(int id);
+
+    /**
+     * @brief Задаёт количество блоков в парке. Новые блоки выключены и получают показания текущего блока.
+     * @param count Количество блоков.
+     */
+    void setFleetSize(int count);
+
+signals:
+    /**
+     * @brief Сигнал об изменении состояния.
+     * @param fields Биты Change изменившихся частей.
+     */
+    void changed(quint32 fields);
+
+    /**
+     * @brief Сигнал об изменении состояния одного блока парка.
+     * @param id Номер блока.
+     */
+    void unitStateChanged(int id);
+
+    /**
+     * @brief Сигнал об изменении значений многих блоков парка сразу.
+     */
+    void fleetReadingsChanged();
+
+    /**
+     * @brief Сигнал перед изменением количества блоков парка.
+     */
+    void fleetAboutToResize();
+
+    /**
+     * @brief Сигнал после изменения количества блоков парка.
+     */
+    void fleetResized();
+
+private:
+    void resetToDefaults();
+    void convertUnits(TemperatureUnit tid, PressureUnit pid);
+    void applyJournalRecord(const JournalRecord &record);
+    void notifyUnit(int id, quint32 fields);
+    void syncController();
+    void publishDelta(quint32 fields);
+    void resetHistory();
+    void restoreArchive(const QVector<HistoryArchive::Block> &saved);
+    bool applySetpoint(int id, double value);
+    bool applyGates(int id, int hDir, int vDir);
+    void applyPower(int id, bool on);
+    void applyScheduleEntry(const ScheduleEntry &entry);
+
+    FleetStore fleetStore; ///< Состояние всех блоков парка
+    SampleHistory samples; ///< История измерений текущего блока (1 Гц, сутки)
+    HistoryArchive longTerm; ///< Сжатая история измерений текущего блока без ограничения срока (°C, Па)
+    StateJournal *stateJournal; ///< Журнал изменений состояния после последнего снимка
+    StateBus *bus; ///< Шина изменений состояния
+    ClimateScheduler *climateScheduler; ///< Недельное расписание парка
+    QString snapshotPath; ///< Снимок, загруженный последним
+    bool historyDeferred = false; ///< История снимка ещё не прочитана (load() с deferHistory)
+    int current = 0; ///< Номер текущего блока
+    TemperatureUnit tempUnit = TemperatureUnit::Celsius; ///< Единица температуры
+    PressureUnit presUnit = PressureUnit::Pascal; ///< Единица давления
+    Theme currentTheme = Theme::Light; ///< Тема интерфейса
+    FanSpeed currentFanSpeed = FanSpeed::Medium; ///< Скорость вентилятора
+    ClimateController climateController; ///< Регулятор температуры текущего блока
+    InputTraceWriter *recorder = nullptr; ///< Запись входных воздействий (не владеет)
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef CLIMATESCHEDULER_H
+#define CLIMATESCHEDULER_H
+
+#include <QHash>
+#include <QObject>
+#include <QVector>
+#include <functional>
+#include "scheduleentry.h"
+#include "timerwheel.h"
+
+class QTimer;
+
+/**
+ * @file climatescheduler.h
+ * @brief Заголовочный файл для планировщика недельного расписания.
+ *
+ * Этот файл содержит объявление класса ClimateScheduler, который выполняет записи
+ * расписания парка в их время с учётом замен дат.
+ */
+
+/**
+ * @class ClimateScheduler
+ * @brief Недельное расписание уставок, питания и жалюзи парка на колесе таймеров.
+ *
+ * Каждая запись ожидает ближайшего своего срабатывания в колесе таймеров (TimerWheel)
+ * с тактом в одну секунду, поэтому добавление и удаление записи не зависят от размера
+ * расписания, а на все записи приходится один QTimer. Таймер раз в секунду продвигает
+ * колесо до текущего времени; сработавшая запись передаётся обработчику и сразу ставится
+ * на следующее срабатывание. Замены дат пересчитывают срабатывания всех записей.
+ *
+ * Если часы ушли назад или вперёд больше чем на kMaxCatchUpSeconds (сон, перевод часов),
+ * пропущенные срабатывания не выполняются: расписание пересчитывается от нового времени.
+ * Время на колесе — секунды от начала эпохи; местное время пересчитывается через начала
+ * суток, переходы на летнее время учитываются.
+ *
+ * Планировщик не потокобезопасен и работает в потоке модели.
+ */
+class ClimateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Обработчик сработавшей записи.
+     */
+    using Handler = std::function<void(const ScheduleEntry &)>;
+
+    static const int kMaxCatchUpSeconds = 3600; ///< Наибольший разрыв часов, срабатывания в котором выполняются, с
+    static const int kMaxScanDays = 400; ///< Сколько дней вперёд ищется срабатывание записи
+
+    /**
+     * @brief Конструктор класса ClimateScheduler. Часы планировщика — текущее время.
+     * @param parent Родительский объект.
+     */
+    explicit ClimateScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Задаёт обработчик сработавших записей.
+     * @param handler Обработчик.
+     */
+    void setHandler(Handler handler) { fire = std::move(handler); }
+
+    /**
+     * @brief Проверяет запись: дни, минута и действие.
+     * @param entry Запись.
+     */
+    static bool isValid(const ScheduleEntry &entry);
+
+    /**
+     * @brief Добавляет запись и ставит её на ближайшее срабатывание.
+     * @param entry Запись (id 0 — назначить новый номер).
+     * @return Номер записи или 0, если запись неверна или номер занят.
+     */
+    quint32 add(const ScheduleEntry &entry);
+
+    /**
+     * @brief Удаляет запись.
+     * @param id Номер записи.
+     * @return true, если запись была.
+     */
+    bool remove(quint32 id);
+
+    /**
+     * @brief Задаёт замену даты (заменяет прежнюю замену той же даты и блока).
+     * @param holiday Замена.
+     * @return true, если замена верна.
+     */
+    bool setHoliday(const HolidayOverride &holiday);
+
+    /**
+     * @brief Удаляет замену даты.
+     * @param day Дата (юлианский день).
+     * @param unit Номер блока (-1 — весь парк).
+     * @return true, если замена была.
+     */
+    bool removeHoliday(qint64 day, qint32 unit);
+
+    /**
+     * @brief Удаляет все записи и замены.
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает всё расписание (записи по возрастанию номеров).
+     */
+    ScheduleData data() const;
+
+    /**
+     * @brief Заменяет расписание.
+     * @param data Расписание (неверные записи пропускаются).
+     */
+    void assign(const ScheduleData &data);
+
+    /**
+     * @brief Возвращает запись по номеру.
+     * @param id Номер записи.
+     * @return Указатель на запись или nullptr.
+     */
+    const ScheduleEntry *entry(quint32 id) const;
+
+    /**
+     * @brief Возвращает время ближайшего срабатывания записи.
+     * @param id Номер записи.
+     * @return Секунды от начала эпохи или -1, если записи нет или она не срабатывает.
+     */
+    qint64 nextFire(quint32 id) const;
+
+    /**
+     * @brief Возвращает количество записей.
+     */
+    int size() const { return ids.size(); }
+
+    /**
+     * @brief Возвращает количество замен дат.
+     */
+    int holidayCount() const;
+
+    /**
+     * @brief Запускает выполнение записей по часам системы.
+     */
+    void start();
+
+    /**
+     * @brief Останавливает выполнение записей.
+     */
+    void stop();
+
+    /**
+     * @brief Переводит часы планировщика без выполнения пропущенного и пересчитывает срабатывания.
+     * @param secs Секунды от начала эпохи.
+     */
+    void resetClock(qint64 secs);
+
+    /**
+     * @brief Продвигает часы планировщика и выполняет наступившие записи по порядку времени.
+     * @param secs Секунды от начала эпохи.
+     */
+    void advanceTo(qint64 secs);
+
+    /**
+     * @brief Возвращает количество выполненных срабатываний.
+     */
+    quint64 firedEntries() const { return fired; }
+
+private:
+    /**
+     * @struct Item
+     * @brief Запись и её таймер.
+     */
+    struct Item
+    {
+        ScheduleEntry entry; ///< Запись (id 0 — элемент свободен)
+        TimerWheel::Handle timer = 0; ///< Таймер ближайшего срабатывания (0 — не стоит)
+        qint64 due = -1; ///< Время ближайшего срабатывания (-1 — нет)
+    };
+
+    void arm(int index, qint64 after);
+    void rearmAll();
+    qint64 nextOccurrence(const ScheduleEntry &entry, qint64 after) const;
+    int weekdayOf(qint64 day, qint32 unit) const;
+    qint64 localDay(qint64 secs) const;
+    qint64 dayStart(qint64 day) const;
+
+    QVector<Item> items; ///< Записи (номер элемента — значение таймера колеса)
+    QVector<int> freeItems; ///< Свободные элементы items
+    QHash<quint32, int> ids; ///< Элемент items по номеру записи
+    QHash<qint64, QVector<HolidayOverride>> holidays; ///< Замены по дате
+    TimerWheel wheel; ///< Колесо таймеров (такт — секунда)
+    QVector<TimerWheel::Fired> due; ///< Сработавшие таймеры (переиспользуемый буфер)
+    QTimer *tick; ///< Таймер продвижения часов
+    Handler fire; ///< Обработчик сработавших записей
+    quint32 nextId = 1; ///< Следующий свободный номер записи
+    quint64 fired = 0; ///< Выполнено срабатываний
+    mutable QHash<qint64, qint64> dayStarts; ///< Начала местных суток по дате (кэш)
+    mutable qint64 cachedDay = 0; ///< Дата местных суток, содержащих последнее переведённое время
+    mutable qint64 cachedBegin = 0; ///< Начало этих суток
+    mutable qint64 cachedEnd = 0; ///< Конец этих суток (0 — кэш пуст)
+};
+
+#endif
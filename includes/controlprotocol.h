@@ -0,0 +1,172 @@
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+#include "scheduleentry.h"
+
+/**
+ * @file controlprotocol.h
+ * @brief Заголовочный файл для протокола управления по локальному сокету.
+ *
+ * Этот файл содержит объявление команд ControlCommand, их результатов ControlResult,
+ * снимка состояния ControlState и функций разбора запросов и записи ответов ControlProtocol.
+ */
+
+/**
+ * @struct ControlState
+ * @brief Состояние текущего блока для ответа на запрос get (значения в текущих единицах).
+ */
+struct ControlState
+{
+    qint32 unit = 0; ///< Номер текущего блока
+    qint32 fleetSize = 1; ///< Количество блоков
+    qint32 power = 0; ///< Питание (0 или 1)
+    qint32 hGate = 0; ///< Горизонтальные жалюзи, градусы
+    qint32 vGate = 0; ///< Вертикальные жалюзи, градусы
+    qint32 temperatureUnit = 1; ///< Единица температуры (ClimateModel::TemperatureUnit)
+    qint32 pressureUnit = 1; ///< Единица давления (ClimateModel::PressureUnit)
+    qint32 fanSpeed = 2; ///< Скорость вентилятора (ClimateModel::FanSpeed)
+    double temperature = 0.0; ///< Температура
+    double setpoint = 0.0; ///< Уставка температуры
+    double humidity = 0.0; ///< Влажность, %
+    double pressure = 0.0; ///< Давление
+};
+
+/**
+ * @struct ControlCommand
+ * @brief Разобранная команда запроса.
+ */
+struct ControlCommand
+{
+    /**
+     * @enum Op
+     * @brief Операция команды.
+     */
+    enum Op : quint8 {
+        Invalid = 0, ///< Ошибка разбора (текст в error)
+        Empty, ///< Пустой пакет "[]"
+        Ping, ///< Проверка связи
+        Get, ///< Состояние текущего блока
+        SetSetpoint, ///< Уставка температуры: value (в единице unit или текущей)
+        StepSetpoint, ///< Уставка на steps шагов кнопок вверх или вниз
+        SetGates, ///< Жалюзи: h, v (отсутствующие не меняются)
+        SetPower, ///< Питание: on
+        TogglePower, ///< Переключение питания
+        SelectUnit, ///< Текущий блок: unit
+        SetUnits, ///< Единицы измерения: temperature, pressure (отсутствующие не меняются)
+        AddSchedule, ///< Запись расписания: schedule; уставка — value (в единице first или текущей)
+        RemoveSchedule, ///< Удаление записи расписания: schedule.id
+        SetHoliday, ///< Замена даты: holiday
+        RemoveHoliday ///< Удаление замены даты: holiday.day, holiday.unit
+    };
+
+    /**
+     * @enum Framing
+     * @brief Биты положения команды в пакете (массиве JSON в одной строке).
+     */
+    enum Framing : quint8 {
+        InBatch = 1 << 0, ///< Команда из пакета
+        OpensBatch = 1 << 1, ///< Первая команда пакета
+        ClosesBatch = 1 << 2 ///< Последняя команда пакета
+    };
+
+    Op op = Invalid; ///< Операция
+    quint8 framing = 0; ///< Биты Framing
+    bool hasFirst = false; ///< Задан первый целый аргумент
+    bool hasSecond = false; ///< Задан второй целый аргумент
+    qint32 first = 0; ///< Первый целый аргумент: h, on, unit, steps, единица температуры или единица уставки
+    qint32 second = 0; ///< Второй целый аргумент: v или единица давления
+    double value = 0.0; ///< Значение уставки
+    ScheduleEntry schedule; ///< Запись расписания (add_schedule, remove_schedule)
+    HolidayOverride holiday; ///< Замена даты (set_holiday, remove_holiday)
+    QByteArray id; ///< Идентификатор запроса в виде JSON (пусто — не задан)
+    const char *error = nullptr; ///< Ошибка разбора
+
+    /**
+     * @brief Возвращает true, если команда меняет состояние и выполняется в потоке модели.
+     */
+    bool isMutating() const { return op >= SetSetpoint; }
+};
+
+/**
+ * @struct ControlResult
+ * @brief Результат выполнения команды.
+ */
+struct ControlResult
+{
+    const char *error = nullptr; ///< Ошибка выполнения (nullptr — успех)
+    bool hasState = false; ///< Ответ содержит состояние
+    quint32 schedule = 0; ///< Номер добавленной записи расписания (0 — нет)
+    ControlState state; ///< Состояние (для get)
+};
+
+/**
+ * @class ControlProtocol
+ * @brief Разбор запросов и запись ответов протокола управления.
+ *
+ * Запрос — объект JSON в одной строке: {"id":1,"op":"set_setpoint","value":22.5}.
+ * Ответ — тоже строка: {"id":1,"ok":true} или {"id":1,"ok":false,"error":"..."}; "get"
+ * возвращает "state". Массив объектов в одной строке — пакет: ответ на него массив в той же
+ * строке. Запросы можно отправлять, не дожидаясь ответов: ответы приходят в порядке запросов.
+ *
+ * Операции: ping; get; set_setpoint {value, unit?: "C"|"F"|"K"}; step_setpoint {steps};
+ * set_gates {h?, v?}; set_power {on}; toggle_power; select_unit {unit};
+ * set_units {temperature?: "C"|"F"|"K", pressure?: "Pa"|"mmHg"};
+ * add_schedule {unit, days: "mon-fri"|"sat,sun"|"all"|[1, 7], time: "HH:MM" и одно из: setpoint
+ * (с temperature_unit?: "C"|"F"|"K"), power, h и v} — ответ содержит номер записи "schedule";
+ * remove_schedule {schedule}; set_holiday {date: "YYYY-MM-DD", unit?, as?: "sun"|7} — дата живёт
+ * по расписанию дня as (без as записи в эту дату не выполняются; без unit — для всего парка);
+ * remove_holiday {date, unit?}.
+ */
+class ControlProtocol
+{
+public:
+    static const int kMaxLineLength = 1 << 20; ///< Наибольшая длина строки запроса, байт
+
+    /**
+     * @brief Разбирает все завершённые строки в буфере.
+     * @param data Буфер с текстом.
+     * @param size Размер буфера.
+     * @param out Вектор, в который добавляются команды.
+     * @return Количество обработанных байт (до начала незавершённой строки).
+     */
+    static qint64 parseChunk(const char *data, qint64 size, QVector<ControlCommand> &out);
+
+    /**
+     * @brief Разбирает одну строку запроса (объект или пакет).
+     * @param begin Начало строки.
+     * @param end Конец строки (без символа перевода строки).
+     * @param out Вектор, в который добавляются команды.
+     */
+    static void parseLine(const char *begin, const char *end, QVector<ControlCommand> &out);
+
+    /**
+     * @brief Дописывает ответ на команду с учётом её положения в пакете.
+     * @param command Команда.
+     * @param result Результат выполнения.
+     * @param out Выходной буфер.
+     */
+    static void appendResponse(const ControlCommand &command, const ControlResult &result, QByteArray &out);
+
+    /**
+     * @brief Возвращает команду-ошибку, на которую отвечают текстом ошибки.
+     * @param error Текст ошибки (строковый литерал).
+     */
+    static ControlCommand invalidCommand(const char *error);
+
+    /**
+     * @brief Возвращает обозначение единицы температуры в протоколе ("C", "F", "K").
+     * @param id Единица (ClimateModel::TemperatureUnit).
+     */
+    static const char *temperatureUnitName(int id);
+
+    /**
+     * @brief Возвращает обозначение единицы давления в протоколе ("Pa", "mmHg").
+     * @param id Единица (ClimateModel::PressureUnit).
+     */
+    static const char *pressureUnitName(int id);
+};
+
+#endif
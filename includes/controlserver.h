@@ -0,0 +1,181 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include "controlprotocol.h"
+#include "seqlock.h"
+
+class ClimateModel;
+class ControlServer;
+class QLocalServer;
+class QLocalSocket;
+struct StateDelta;
+
+/**
+ * @file controlserver.h
+ * @brief Заголовочный файл для сервера управления по локальному сокету.
+ *
+ * Этот файл содержит объявление классов ControlServer и ControlServerWorker: приём
+ * соединений, разбор запросов и запись ответов идут в отдельном потоке, а команды,
+ * меняющие состояние, выполняются моделью в её потоке.
+ */
+
+/**
+ * @class ControlServerWorker
+ * @brief Сетевая часть сервера управления, работающая в отдельном потоке.
+ *
+ * Принимает соединения, читает строки запросов, отвечает на ping и get по снимку
+ * состояния без обращения к потоку модели, а команды, меняющие состояние, передаёт
+ * в ControlServer порциями: по одной порции на соединение одновременно, так что ответы
+ * идут в порядке запросов, а get после команды видит её результат.
+ */
+class ControlServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса ControlServerWorker.
+     * @param owner Сервер, выполняющий команды.
+     */
+    explicit ControlServerWorker(ControlServer *owner);
+
+    /**
+     * @brief Начинает приём соединений. Вызывается в потоке сервера.
+     * @param name Имя сервера или путь к UNIX-сокету.
+     * @return true, если сокет открыт.
+     */
+    bool listen(const QString &name);
+
+    /**
+     * @brief Принимает результаты порции команд и отвечает на них. Вызывается в потоке сервера.
+     * @param connection Номер соединения.
+     * @param commands Команды порции.
+     * @param results Результаты команд.
+     */
+    void complete(quint64 connection, const QVector<ControlCommand> &commands, const QVector<ControlResult> &results);
+
+private:
+    /**
+     * @struct Connection
+     * @brief Соединение клиента: незавершённая строка и очередь разобранных команд.
+     */
+    struct Connection
+    {
+        QLocalSocket *socket = nullptr; ///< Сокет клиента
+        QByteArray tail; ///< Незавершённая строка с прошлого чтения
+        QVector<ControlCommand> pending; ///< Команды, ожидающие ответа
+        int next = 0; ///< Первая команда без ответа в pending
+        bool inFlight = false; ///< Порция команд выполняется в потоке модели
+        bool discarding = false; ///< Пропуск остатка слишком длинной строки
+    };
+
+    void accept();
+    void readAvailable(quint64 id);
+    void pump(quint64 id, Connection &connection);
+
+    ControlServer *owner; ///< Сервер, выполняющий команды
+    QLocalServer *server = nullptr; ///< Локальный сервер
+    QHash<quint64, Connection> connections; ///< Соединения по номеру
+    quint64 nextConnection = 1; ///< Номер следующего соединения
+};
+
+/**
+ * @class ControlServer
+ * @brief Сервер управления моделью по локальному сокету (NDJSON, см. ControlProtocol).
+ *
+ * Живёт в потоке модели. Сетевая часть (ControlServerWorker) работает в своём потоке:
+ * разбор JSON, запись ответов и запросы состояния не занимают поток модели. Состояние
+ * текущего блока публикуется через SeqLock по изменениям нужных полей из шины StateBus. Команды, меняющие
+ * состояние, приходят в поток модели порциями не больше kMaxCommandsPerHop, по одному
+ * событию на порцию, поэтому длинный пакет или конвейер запросов не задерживает
+ * кадр дольше одной порции. Изменения модели отображаются обычным путём (changed()).
+ */
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kMaxCommandsPerHop = 256; ///< Наибольшая порция команд за одно событие потока модели
+    static const int kMaxPending = 65536; ///< Команд без ответа в соединении, после которых чтение приостанавливается
+
+    /**
+     * @brief Конструктор класса ControlServer.
+     * @param model Модель состояния (в том же потоке, что и сервер).
+     * @param parent Родительский объект.
+     */
+    explicit ControlServer(ClimateModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса ControlServer. Закрывает сокет и останавливает поток сервера.
+     */
+    ~ControlServer();
+
+    /**
+     * @brief Открывает локальный сокет и запускает поток сервера.
+     * @param name Имя сервера или путь к UNIX-сокету.
+     * @return true, если сокет открыт.
+     */
+    bool listen(const QString &name);
+
+    /**
+     * @brief Закрывает сокет и останавливает поток сервера.
+     */
+    void close();
+
+    /**
+     * @brief Возвращает true, если сервер принимает соединения.
+     */
+    bool isListening() const { return serverThread.isRunning(); }
+
+    /**
+     * @brief Выполняет порцию команд над моделью.
+     * @param commands Команды.
+     * @return Результаты в порядке команд.
+     */
+    QVector<ControlResult> execute(const QVector<ControlCommand> &commands);
+
+    /**
+     * @brief Отвечает на команду, не меняющую состояние, по снимку состояния (из любого потока).
+     * @param command Команда.
+     */
+    ControlResult answer(const ControlCommand &command) const;
+
+    /**
+     * @brief Возвращает последнее опубликованное состояние текущего блока (из любого потока).
+     */
+    ControlState state() const { return published.load(); }
+
+    /**
+     * @brief Возвращает количество обработанных запросов.
+     */
+    quint64 handledRequests() const { return handled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает количество порций команд, выполненных в потоке модели.
+     */
+    quint64 executedHops() const { return hops.load(std::memory_order_relaxed); }
+
+private:
+    friend class ControlServerWorker;
+
+    void publishState();
+    void applyDelta(const StateDelta &delta);
+    ControlResult apply(const ControlCommand &command);
+
+    ClimateModel *model; ///< Модель состояния
+    QThread serverThread; ///< Поток сетевой части
+    ControlServerWorker *worker = nullptr; ///< Сетевая часть
+    ControlState current; ///< Состояние текущего блока в потоке модели
+    SeqLock<ControlState> published; ///< Состояние текущего блока для потока сервера
+    std::atomic<quint64> handled{0}; ///< Обработано запросов
+    std::atomic<quint64> hops{0}; ///< Выполнено порций в потоке модели
+};
+
+#endif
@@ -10,9 +10,22 @@
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QGraphicsRectItem>
-#include <QMovie>
+#include <QTableView>
+#include <QTimer>
 #include "settings.h"
 #include "coolinputwindow.h"
+#include "sensoringest.h"
+#include "climatemodel.h"
+#include "fleetmodel.h"
+#include "trendchart.h"
+#include "themeengine.h"
+#include "gaugeitems.h"
+#include "labelformatter.h"
+#include "frameclock.h"
+#include "updatescheduler.h"
+#include "fanwidget.h"
+#include "latencyoverlay.h"
+#include <initializer_list>
 
 /**
  * @file coolwindow.h
@@ -28,11 +41,15 @@
  * 
  * Обеспечивает функциональность отображения и управления параметрами системы кондиционирования, такими как
  * температура, влажность, давление и направления воздушного потока. Поддерживает изменение настроек и выбор тем.
+ * Состояние, диапазоны и сохранение находятся в модели ClimateModel: окно передаёт ей действия
+ * пользователя и отображает изменения, о которых модель сообщает сигналом changed().
  */
 class CoolWindow : public QMainWindow
 {
     Q_OBJECT
 
+    friend class CoolWindowBench; ///< Бенчмарки горячих путей окна (AirConManagerBench)
+
 public:
     /**
      * @brief Конструктор класса CoolWindow.
@@ -44,33 +61,55 @@ public:
      */
     ~CoolWindow();
 
+    using TemperatureUnit = ClimateModel::TemperatureUnit; ///< Единицы измерения температуры
+    using PressureUnit = ClimateModel::PressureUnit; ///< Единицы измерения давления
+    using Theme = ClimateModel::Theme; ///< Темы интерфейса
+
     /**
-     * @enum TemperatureUnit
-     * @brief Перечисление возможных единиц измерения температуры.
+     * @enum SceneField
+     * @brief Биты частей сцены, обновляемых планировщиком обновлений.
      */
-    enum class TemperatureUnit {
-        Celsius = 1,
-        Fahrenheit,
-        Kelvin
+    enum SceneField : quint32 {
+        TemperatureField = 1u << 0, ///< Уровень и метка температуры
+        HumidityField = 1u << 1, ///< Уровень и метка влажности
+        PressureField = 1u << 2, ///< Уровень и метка давления
+        HGateField = 1u << 3, ///< Стрелка горизонтальных жалюзи
+        VGateField = 1u << 4, ///< Стрелка вертикальных жалюзи
+        TrendField = 1u << 5, ///< График истории
+        SetpointField = 1u << 6, ///< Отметка и метка уставки температуры
+        ControlField = 1u << 7, ///< Метка мощности охлаждения от регулятора
+        ReadingFields = TemperatureField | HumidityField | PressureField ///< Все показания
     };
 
     /**
-     * @enum PressureUnit
-     * @brief Перечисление возможных единиц измерения давления.
+     * @brief Возвращает планировщик обновлений сцены (для счётчиков объединения обновлений).
      */
-    enum class PressureUnit {
-        Pascal = 1,
-        Mmhg
-    };
+    const UpdateScheduler *sceneScheduler() const { return sceneUpdates; }
 
     /**
-     * @enum Theme
-     * @brief Перечисление возможных тем интерфейса.
+     * @brief Возвращает модель состояния, которую отображает окно.
      */
-    enum class Theme {
-        Light = 1,
-        Dark
-    };
+    ClimateModel *climateModel() const { return model; }
+
+    /**
+     * @brief Возвращает true, если первый кадр показан и отложенная работа запуска выполнена.
+     */
+    bool isStartupFinished() const { return startupFinished; }
+
+signals:
+    /**
+     * @brief Сигнал о завершении запуска: первый кадр показан, отложенная работа выполнена.
+     */
+    void startupComplete();
+
+protected:
+    /**
+     * @brief Отслеживает первую отрисовку окна, чтобы после неё выполнить отложенную работу запуска.
+     * @param watched Объект, которому адресовано событие.
+     * @param event Событие.
+     * @return false — событие обрабатывается дальше как обычно.
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
     /**
@@ -102,51 +141,113 @@ public slots:
      * @param pData Новое значение давления.
      */
     void acceptNewData(double tData, double hData, double pData);
+    /**
+     * @brief Принимает пакет измерений от конвейера приёма данных.
+     *
+     * На экран выводится только последнее измерение пакета, поэтому за кадр
+     * выполняется не более одного обновления сцены.
+     * @param batch Измерения в порядке поступления.
+     */
+    void acceptNewDataBatch(const QVector<SensorSample> &batch);
+    /**
+     * @brief Задаёт количество блоков в парке.
+     *
+     * При количестве больше одного слева от сцены показывается список блоков,
+     * а сцена отображает выбранный блок.
+     * @param count Количество блоков.
+     */
+    void setFleetSize(int count);
+    /**
+     * @brief Делает блок текущим и отображает его на сцене.
+     * @param id Номер блока.
+     */
+    void selectUnit(int id);
     /**
      * @brief Принимает настройки для температуры и давления.
      * @param tempId Идентификатор единицы измерения температуры.
      * @param presId Идентификатор единицы измерения давления.
      */
     void acceptSettings(int tempId, int presId);
+    /**
+     * @brief Показывает или скрывает таблицу длительностей операций поверх сцены (F12).
+     */
+    void toggleLatencyOverlay();
+    /**
+     * @brief Выгружает гистограммы длительностей операций в JSON (Ctrl+Shift+D).
+     * @param path Путь к файлу.
+     * @return true, если файл записан.
+     */
+    bool dumpLatency(const QString &path = QStringLiteral("latency.json"));
+    /**
+     * @brief Включает трассировку событий или выключает её и выгружает в формате Chrome Trace Event (Ctrl+Shift+T).
+     * @param path Путь к файлу выгрузки.
+     * @return true, если трассировка включена или успешно выгружена.
+     */
+    bool toggleTrace(const QString &path = QStringLiteral("trace.json"));
+
+private slots:
+    /**
+     * @brief Отображает изменения модели: помечает части сцены и обновляет элементы управления.
+     * @param fields Биты ClimateModel::Change изменившихся частей.
+     */
+    void onModelChanged(quint32 fields);
+
+    /**
+     * @brief Забирает последнее состояние регулятора и помечает метку мощности, если был новый такт.
+     */
+    void pollController();
+
+    /**
+     * @brief Выполняет работу, отложенную до первого кадра: чтение истории измерений.
+     */
+    void finishStartup();
 
 private:
     QWidget *centralWidget; ///< Основной виджет окна
 
     QVBoxLayout *mainLayout; ///< Главная компоновка элементов
     QHBoxLayout *dataLayout; ///< Компоновка данных температуры, влажности и давления
-    double *temperature; ///< Указатель на значение температуры
-    double *humidity; ///< Указатель на значение влажности
-    double *pressure; ///< Указатель на значение давления
-    int *hGateDir; ///< Горизонтальное направление воздушного потока
-    int *vGateDir; ///< Вертикальное направление воздушного потока
-    TemperatureUnit currentTempUnit; ///< Текущая единица измерения температуры
-    PressureUnit currentPresUnit; ///< Текущая единица измерения давления
-    Theme currentTheme; ///< Текущая тема интерфейса
+    ClimateModel *model; ///< Состояние парка, единицы измерения и сохранение
+    ThemeEngine themes; ///< Таблицы стилей и палитры тем
+
+    FleetModel *fleetModel; ///< Модель списка блоков
+    QTableView *fleetView; ///< Виртуализированный список блоков
+    FrameClock *frameClock; ///< Часы кадров окна
+    UpdateScheduler *sceneUpdates; ///< Объединение изменений сцены в одно обновление за кадр
 
     // Графические элементы
     QGraphicsScene *scene;
     QGraphicsView *view;
-    QGraphicsRectItem *thermometer;
-    QGraphicsRectItem *humidityScale;
-    QGraphicsRectItem *pressureScale;
-    QGraphicsRectItem *mercuryLevel;
-    QGraphicsRectItem *humidityLevel;
-    QGraphicsRectItem *pressureLevel;
-    QGraphicsTextItem *temperatureText;
-    QGraphicsTextItem *humidityText;
-    QGraphicsTextItem *pressureText;
-
-    QGraphicsLineItem *hArrow; ///< Горизонтальное направление воздушного потока визуализация
-    QGraphicsLineItem *hStaticArrow; ///< Горизонтальное направление воздушного потока визуализация
-    QGraphicsLineItem *hStaticArrow2; ///< Горизонтальное направление воздушного потока визуализация
-    QGraphicsPathItem *hAngleArc; ///< Горизонтальное направление воздушного потока угол
-    QGraphicsLineItem *vArrow; ///< Вертикальное направление воздушного потока визуализация
-    QGraphicsLineItem *vStaticArrow; ///< Вертикальное направление воздушного потока визуализация
-    QGraphicsLineItem *vStaticArrow2; ///< Вертикальное направление воздушного потока визуализация
+    GaugeBackgroundItem *gaugeBackground; ///< Контуры шкал и крайние положения жалюзи
+    LevelBarItem *mercuryLevel;
+    LevelBarItem *humidityLevel;
+    LevelBarItem *pressureLevel;
+    QGraphicsSimpleTextItem *temperatureText;
+    QGraphicsSimpleTextItem *humidityText;
+    QGraphicsSimpleTextItem *pressureText;
+    LabelFormatter temperatureLabel; ///< Текст метки температуры
+    LabelFormatter humidityLabel; ///< Текст метки влажности
+    LabelFormatter pressureLabel; ///< Текст метки давления
+    QGraphicsLineItem *setpointMarker; ///< Отметка уставки на шкале температуры
+    QGraphicsSimpleTextItem *setpointText; ///< Метка уставки температуры
+    QGraphicsSimpleTextItem *outputText; ///< Метка мощности охлаждения
+    LabelFormatter setpointLabel; ///< Текст метки уставки
+    LabelFormatter outputLabel; ///< Текст метки мощности
+    QTimer *controllerPoll; ///< Опрос состояния регулятора
+    quint64 controllerTick = 0; ///< Такт регулятора, показанный последним
+
+    GateArrowItem *hArrow; ///< Горизонтальное направление воздушного потока визуализация с углом
+    GateArrowItem *vArrow; ///< Вертикальное направление воздушного потока визуализация
     QGraphicsTextItem *hAirText;
     QGraphicsTextItem *vAirText;
+    TrendChartItem *trendChart; ///< График истории измерений
+    LatencyOverlayItem *latencyOverlay = nullptr; ///< Таблица длительностей операций (создаётся при первом показе)
+    QTimer *latencyRefresh = nullptr; ///< Обновление таблицы длительностей, пока она показана
+
+    void updateTrendRanges();
 
     void setTemp();
+    void setSetpoint();
     void setHum();
     void setPres();
 
@@ -170,51 +271,24 @@ private:
     Settings *settingsWindow = nullptr;
     CoolInput *inputWindow = nullptr;
 
-    QLabel *onOffLabel;
-    QMovie *airBlades;
-    bool isOn = false;
-
-    QString getTemperatureScaleByUnitId(TemperatureUnit id);
-    TemperatureUnit getTemperatureUnitByScale(QString scale);
-    void temperatureUp();
-    void temperatureDown();
-
-    void offSystem();
-
-    PressureUnit getPressureUnitByScale(QString scale);
-    QString getPressureScaleByUnitId(PressureUnit id);
-
-    QString getThemeById(Theme id);
-    Theme getThemeUnitByName(QString theme);
-    void setCurrentTheme();
-
-    void recalculateTemp(TemperatureUnit from, TemperatureUnit to);
-    void recalculatePres(PressureUnit from, PressureUnit to);
-
-    void addAirUp();
-    void addAirDown();
-    void addAirLeft();
-    void addAirRight();
-    int getMinHDir();
-    int getMaxHDir();
-    int getMinVDir();
-    int getMaxVDir();
+    FanWidget *fan; ///< Вентилятор, вращающийся по часам кадров
+    bool startupFinished = false; ///< Первый кадр показан, отложенная работа выполнена
 
-    void saveSettings(const QString &filePath);
-    void loadSettings(const QString &filePath);
-    void setBaseSettings();
+    void applyPowerState();
+    void applyTheme(Theme id);
+    void applyFanSpeed();
+    void setControlsEnabled(std::initializer_list<QWidget *> widgets, bool enabled);
 
-    double getMinTempForCurrentUnit();
-    double getMaxTempForCurrentUnit();
-    double getMinPresForCurrentUnit();
-    double getMaxPresForCurrentUnit();
+    void applySceneUpdates(quint32 fields);
+    void updateTemperatureText();
+    void updateInputWindow();
+    void updateFleetView();
 
     void setHumRange();
 
     void updateHArrow();
     void updateVArrow();
 
-    QString getLockStyle();
 };
 
 #endif
\ No newline at end of file
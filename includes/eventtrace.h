@@ -0,0 +1,197 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include <QByteArray>
+#include <QEvent>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @file eventtrace.h
+ * @brief Заголовочный файл для трассировки событий в формате Chrome Trace Event.
+ *
+ * Этот файл содержит объявление журнала трассировки EventTrace с буфером на каждый поток
+ * и области трассировки TraceScope, которой отмечаются обработчики событий (TracedApplication)
+ * и измерители ACM_PROBE.
+ */
+
+/**
+ * @class EventTrace
+ * @brief Журнал интервалов выполнения (начало и конец) в буферах потоков с выгрузкой в JSON для chrome://tracing и Perfetto.
+ *
+ * Каждый поток пишет в свой кольцевой буфер без блокировок: запись интервала — несколько
+ * атомарных сохранений без упорядочения и увеличение счётчика записей. Буфер создаётся
+ * при первой записи в потоке и живёт до завершения программы, чтобы интервалы завершившихся
+ * потоков попадали в выгрузку. При переполнении старые интервалы вытесняются новыми.
+ *
+ * Режимы независимы: Recording — запись интервалов, Tracking — только отметка текущего
+ * обработчика в потоке для StallMonitor. Когда оба выключены, область трассировки стоит
+ * одно чтение атомарной переменной.
+ */
+class EventTrace
+{
+public:
+    /**
+     * @enum Mode
+     * @brief Биты режимов трассировки.
+     */
+    enum Mode {
+        Recording = 1 << 0, ///< Запись интервалов в буферы потоков
+        Tracking = 1 << 1   ///< Отметка текущего обработчика для StallMonitor
+    };
+
+    static const int kBufferCapacity = 1 << 15; ///< Интервалов в буфере потока (степень двойки)
+
+    struct Buffer; ///< Буфер потока (определён в eventtrace.cpp)
+
+    /**
+     * @struct Activity
+     * @brief Что выполняет поток: внешний обработчик события и самая вложенная область.
+     */
+    struct Activity
+    {
+        const char *event = nullptr; ///< Название внешней области (nullptr — поток ждёт событий)
+        const char *receiver = nullptr; ///< Класс получателя внешнего события
+        const char *scope = nullptr; ///< Название самой вложенной области
+        quint64 startTicks = 0; ///< Начало внешней области, тактов LatencyClock
+    };
+
+    /**
+     * @brief Возвращает биты включённых режимов.
+     */
+    static int mode() { return modeBits.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Включает или выключает запись интервалов.
+     * @param enabled true — записывать.
+     */
+    static void setRecording(bool enabled);
+
+    /**
+     * @brief Возвращает true, если интервалы записываются.
+     */
+    static bool isRecording() { return (mode() & Recording) != 0; }
+
+    /**
+     * @brief Включает или выключает отметку текущего обработчика в потоках.
+     * @param enabled true — отмечать.
+     */
+    static void setTracking(bool enabled);
+
+    /**
+     * @brief Возвращает текущее время в тактах LatencyClock.
+     */
+    static quint64 now();
+
+    /**
+     * @brief Возвращает буфер текущего потока, создавая его при первом обращении.
+     */
+    static Buffer *currentBuffer();
+
+    /**
+     * @brief Задаёт название текущего потока в выгрузке.
+     * @param name Название потока.
+     */
+    static void setThreadName(const QByteArray &name);
+
+    /**
+     * @brief Возвращает, что выполняет поток буфера (читается из любого потока).
+     * @param buffer Буфер потока.
+     */
+    static Activity activity(const Buffer *buffer);
+
+    /**
+     * @brief Записывает интервал в буфер текущего потока (если запись включена).
+     * @param category Категория интервала (строковый литерал).
+     * @param name Название интервала (строка, живущая до завершения программы).
+     * @param detail Уточнение, например класс получателя события, или nullptr.
+     * @param startTicks Начало интервала, тактов LatencyClock.
+     * @param endTicks Конец интервала, тактов LatencyClock.
+     */
+    static void record(const char *category, const char *name, const char *detail, quint64 startTicks, quint64 endTicks);
+
+    /**
+     * @brief Забывает записанные интервалы всех потоков.
+     */
+    static void clear();
+
+    /**
+     * @brief Возвращает записанные интервалы в формате Chrome Trace Event (JSON).
+     */
+    static QByteArray toChromeJson();
+
+    /**
+     * @brief Записывает toChromeJson() в файл атомарно.
+     * @param path Путь к файлу.
+     * @return true, если файл записан.
+     */
+    static bool exportChrome(const QString &path);
+
+    /**
+     * @brief Возвращает название типа события Qt, например "Timer" или "Paint".
+     * @param type Тип события.
+     */
+    static const char *eventName(QEvent::Type type);
+
+private:
+    static std::atomic<int> modeBits; ///< Биты включённых режимов
+};
+
+/**
+ * @class TraceScope
+ * @brief Область трассировки: интервал от создания до конца области видимости.
+ *
+ * Если при создании все режимы EventTrace выключены, область ничего не делает и при выходе.
+ */
+class TraceScope
+{
+public:
+    /**
+     * @brief Конструктор класса TraceScope. Открывает область, если трассировка включена.
+     * @param category Категория интервала (строковый литерал).
+     * @param name Название интервала.
+     * @param detail Уточнение или nullptr.
+     * @param startTicks Начало интервала, тактов LatencyClock.
+     */
+    TraceScope(const char *category, const char *name, const char *detail, quint64 startTicks) {
+        if (EventTrace::mode() != 0) {
+            enter(category, name, detail, startTicks);
+        }
+    }
+
+    /**
+     * @brief Деструктор класса TraceScope. Закрывает область, если она не закрыта finish().
+     */
+    ~TraceScope() {
+        if (buffer) {
+            leave(EventTrace::now());
+        }
+    }
+
+    /**
+     * @brief Закрывает область с заданным временем конца (чтобы не читать часы повторно).
+     * @param endTicks Конец интервала, тактов LatencyClock.
+     */
+    void finish(quint64 endTicks) {
+        if (buffer) {
+            leave(endTicks);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    void enter(const char *category, const char *name, const char *detail, quint64 startTicks);
+    void leave(quint64 endTicks);
+
+    EventTrace::Buffer *buffer = nullptr; ///< Буфер потока (nullptr — область не открыта)
+    const char *category = nullptr; ///< Категория интервала
+    const char *name = nullptr; ///< Название интервала
+    const char *detail = nullptr; ///< Уточнение
+    const char *enclosing = nullptr; ///< Самая вложенная область до открытия этой
+    quint64 start = 0; ///< Начало интервала, тактов
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef FANWIDGET_H
+#define FANWIDGET_H
+
+#include <QPixmap>
+#include <QString>
+#include <QWidget>
+
+class FrameClock;
+
+/**
+ * @file fanwidget.h
+ * @brief Заголовочный файл для виджета вентилятора.
+ *
+ * Этот файл содержит объявление класса FanWidget, который вращает изображение
+ * лопастей вентилятора по тактам общих часов кадров.
+ */
+
+/**
+ * @class FanWidget
+ * @brief Вентилятор: одно кэшированное изображение лопастей, повёрнутое на угол вращения.
+ *
+ * Изображение декодируется и уменьшается до размера виджета один раз; кадр анимации —
+ * это только поворот при отрисовке. Угол зависит от времени кадра, а не от количества
+ * кадров, поэтому скорость вращения не меняется при пропуске кадров.
+ *
+ * Вращающийся вентилятор запрашивает кадры у FrameClock, пока виджет показан на экране.
+ * Если окно скрыто, свёрнуто или перекрыто (окно не открыто для отрисовки), запросы
+ * прекращаются и часы не тратят процессорное время; вращение продолжается со следующей
+ * отрисовки виджета.
+ */
+class FanWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса FanWidget.
+     * @param clock Часы кадров.
+     * @param parent Родительский виджет.
+     */
+    explicit FanWidget(FrameClock *clock, QWidget *parent = nullptr);
+
+    /**
+     * @brief Загружает изображение лопастей (первый кадр файла), уменьшенное до размера виджета.
+     * @param path Путь к изображению (обычно ресурс ":/fan.gif").
+     * @return true, если изображение прочитано.
+     */
+    bool loadBlades(const QString &path);
+
+    /**
+     * @brief Включает или останавливает вращение. Остановленный вентилятор сохраняет угол.
+     * @param running true — вращать.
+     */
+    void setRunning(bool running);
+
+    /**
+     * @brief Задаёт скорость вращения.
+     * @param revolutionsPerSecond Оборотов в секунду.
+     */
+    void setSpeed(double revolutionsPerSecond);
+
+    bool isRunning() const { return running; } ///< Вентилятор включён
+    bool isAnimating() const { return animating; } ///< Вентилятор запрашивает кадры
+    double speed() const { return revolutionsPerSecond; } ///< Оборотов в секунду
+    qreal angle() const { return degrees; } ///< Текущий угол, градусы
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void onFrame(qint64 timestampNs);
+
+private:
+    bool isOnScreen() const;
+    void resume();
+
+    FrameClock *clock; ///< Часы кадров
+    QPixmap blades; ///< Изображение лопастей в размере виджета
+    double revolutionsPerSecond = 1.0; ///< Скорость вращения
+    qreal degrees = 0.0; ///< Угол поворота
+    qint64 lastFrameNs = -1; ///< Время предыдущего кадра вращения (-1 — вращение начинается)
+    bool running = false; ///< Вентилятор включён
+    bool animating = false; ///< Кадры запрошены у часов
+};
+
+#endif
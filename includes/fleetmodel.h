@@ -0,0 +1,89 @@
+#ifndef FLEETMODEL_H
+#define FLEETMODEL_H
+
+#include <QAbstractTableModel>
+#include "fleetstore.h"
+
+/**
+ * @file fleetmodel.h
+ * @brief Заголовочный файл для класса FleetModel.
+ *
+ * Этот файл содержит объявление модели Qt, отображающей хранилище FleetStore
+ * в виртуализированном списке блоков.
+ */
+
+/**
+ * @class FleetModel
+ * @brief Табличная модель поверх колоночного хранилища парка кондиционеров.
+ *
+ * Модель не копирует данные: текст ячеек формируется по запросу представления,
+ * которое запрашивает только видимые строки. Поэтому стоимость прокрутки не зависит
+ * от размера парка.
+ */
+class FleetModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Column
+     * @brief Колонки модели.
+     */
+    enum Column {
+        UnitColumn = 0, ///< Номер блока
+        PowerColumn, ///< Состояние питания
+        TemperatureColumn, ///< Температура
+        HumidityColumn, ///< Влажность
+        PressureColumn, ///< Давление
+        ColumnCount
+    };
+
+    /**
+     * @brief Конструктор класса FleetModel.
+     * @param store Хранилище состояния парка.
+     * @param parent Родительский объект.
+     */
+    explicit FleetModel(const FleetStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Задаёт обозначения единиц измерения для колонок температуры и давления.
+     * @param temperatureScale Обозначение единицы температуры.
+     * @param pressureScale Обозначение единицы давления.
+     */
+    void setScales(const QString &temperatureScale, const QString &pressureScale);
+
+    /**
+     * @brief Сообщает представлению об изменении одного блока.
+     * @param id Номер блока.
+     */
+    void unitChanged(int id);
+
+    /**
+     * @brief Сообщает представлению об изменении значений всех блоков.
+     */
+    void allUnitsChanged();
+
+    /**
+     * @brief Сообщает представлению об изменении количества блоков.
+     *
+     * Вызывается парой: beginResize() до изменения хранилища и endResize() после.
+     */
+    void beginResize();
+
+    /**
+     * @brief Завершает изменение количества блоков.
+     */
+    void endResize();
+
+private:
+    const FleetStore *store; ///< Хранилище состояния парка
+    QString temperatureScale; ///< Обозначение единицы температуры с ведущим пробелом
+    QString pressureScale; ///< Обозначение единицы давления с ведущим пробелом
+};
+
+#endif
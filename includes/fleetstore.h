@@ -0,0 +1,217 @@
+#ifndef FLEETSTORE_H
+#define FLEETSTORE_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file fleetstore.h
+ * @brief Заголовочный файл для класса FleetStore.
+ *
+ * Этот файл содержит объявление класса FleetStore — колоночного хранилища
+ * состояния парка кондиционеров.
+ */
+
+/**
+ * @class FleetStore
+ * @brief Хранилище состояния множества кондиционеров в виде структуры массивов.
+ *
+ * Каждое поле хранится отдельным непрерывным массивом, индексируемым номером блока,
+ * поэтому проход по одному полю всего парка читает память последовательно.
+ * Значения температуры и давления хранятся в текущих единицах измерения окна.
+ * На один блок приходится bytesPerUnit() байт.
+ */
+class FleetStore
+{
+public:
+    /**
+     * @brief Флаги состояния блока.
+     */
+    enum Flag : quint8 {
+        PowerOn = 0x01 ///< Блок включён
+    };
+
+    /**
+     * @brief Возвращает количество блоков.
+     */
+    int size() const { return temperatures.size(); }
+
+    /**
+     * @brief Изменяет количество блоков.
+     *
+     * Новые блоки получают значения по умолчанию, переданные в параметрах;
+     * уставка новых блоков равна начальной температуре.
+     * @param count Новое количество блоков.
+     * @param temperature Начальная температура новых блоков.
+     * @param humidity Начальная влажность новых блоков.
+     * @param pressure Начальное давление новых блоков.
+     */
+    void resize(int count, double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Возвращает температуру блока.
+     * @param id Номер блока.
+     */
+    double temperature(int id) const { return temperatures[id]; }
+
+    /**
+     * @brief Возвращает уставку температуры блока.
+     * @param id Номер блока.
+     */
+    double setpoint(int id) const { return setpoints[id]; }
+
+    /**
+     * @brief Возвращает влажность блока.
+     * @param id Номер блока.
+     */
+    double humidity(int id) const { return humidities[id]; }
+
+    /**
+     * @brief Возвращает давление блока.
+     * @param id Номер блока.
+     */
+    double pressure(int id) const { return pressures[id]; }
+
+    /**
+     * @brief Возвращает положение горизонтальных жалюзи блока.
+     * @param id Номер блока.
+     */
+    int hGateDir(int id) const { return hGateDirs[id]; }
+
+    /**
+     * @brief Возвращает положение вертикальных жалюзи блока.
+     * @param id Номер блока.
+     */
+    int vGateDir(int id) const { return vGateDirs[id]; }
+
+    /**
+     * @brief Возвращает true, если блок включён.
+     * @param id Номер блока.
+     */
+    bool isOn(int id) const { return flags[id] & PowerOn; }
+
+    /**
+     * @brief Записывает измерения блока.
+     * @param id Номер блока.
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void setReading(int id, double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Записывает положение жалюзи блока.
+     * @param id Номер блока.
+     * @param hDir Положение горизонтальных жалюзи.
+     * @param vDir Положение вертикальных жалюзи.
+     */
+    void setGates(int id, int hDir, int vDir);
+
+    /**
+     * @brief Записывает уставку температуры блока.
+     * @param id Номер блока.
+     * @param value Уставка.
+     */
+    void setSetpoint(int id, double value) { setpoints[id] = value; }
+
+    /**
+     * @brief Включает или выключает блок.
+     * @param id Номер блока.
+     * @param on Новое состояние.
+     */
+    void setOn(int id, bool on);
+
+    /**
+     * @brief Возвращает указатель на колонку температур для пакетной обработки.
+     */
+    double *temperatureData() { return temperatures.data(); }
+
+    /**
+     * @brief Возвращает указатель на колонку влажности для пакетной обработки.
+     */
+    double *humidityData() { return humidities.data(); }
+
+    /**
+     * @brief Возвращает указатель на колонку давления для пакетной обработки.
+     */
+    double *pressureData() { return pressures.data(); }
+
+    /**
+     * @brief Возвращает указатель на колонку уставок для пакетной обработки.
+     */
+    double *setpointData() { return setpoints.data(); }
+
+    /**
+     * @brief Возвращает колонку температур только для чтения.
+     */
+    const double *temperatureData() const { return temperatures.constData(); }
+
+    /**
+     * @brief Возвращает колонку влажности только для чтения.
+     */
+    const double *humidityData() const { return humidities.constData(); }
+
+    /**
+     * @brief Возвращает колонку давления только для чтения.
+     */
+    const double *pressureData() const { return pressures.constData(); }
+
+    /**
+     * @brief Возвращает колонку уставок только для чтения.
+     */
+    const double *setpointData() const { return setpoints.constData(); }
+
+    /**
+     * @brief Возвращает колонку положений горизонтальных жалюзи только для чтения.
+     */
+    const qint8 *hGateDirData() const { return hGateDirs.constData(); }
+
+    /**
+     * @brief Возвращает колонку положений вертикальных жалюзи только для чтения.
+     */
+    const qint8 *vGateDirData() const { return vGateDirs.constData(); }
+
+    /**
+     * @brief Возвращает колонку флагов только для чтения.
+     */
+    const quint8 *flagsData() const { return flags.constData(); }
+
+    /**
+     * @brief Заменяет содержимое хранилища колонками из внешнего буфера.
+     *
+     * Каждая колонка копируется одним блоком памяти. Уставки принимают значения температур
+     * (снимки без колонки уставок); колонка уставок затем заполняется через setpointData().
+     * @param count Количество блоков.
+     * @param temperature Колонка температур.
+     * @param humidity Колонка влажности.
+     * @param pressure Колонка давления.
+     * @param hDir Колонка положений горизонтальных жалюзи.
+     * @param vDir Колонка положений вертикальных жалюзи.
+     * @param flagColumn Колонка флагов.
+     */
+    void assign(int count, const double *temperature, const double *humidity, const double *pressure,
+                const qint8 *hDir, const qint8 *vDir, const quint8 *flagColumn);
+
+    /**
+     * @brief Возвращает количество байт, занимаемых одним блоком.
+     */
+    static constexpr int bytesPerUnit() {
+        return 4 * sizeof(double) + 2 * sizeof(qint8) + sizeof(quint8);
+    }
+
+    /**
+     * @brief Возвращает объём памяти, занятый колонками (с учётом резерва).
+     */
+    qint64 memoryUsage() const;
+
+private:
+    QVector<double> temperatures; ///< Температура блоков
+    QVector<double> humidities; ///< Влажность блоков
+    QVector<double> pressures; ///< Давление блоков
+    QVector<double> setpoints; ///< Уставка температуры блоков
+    QVector<qint8> hGateDirs; ///< Положение горизонтальных жалюзи блоков
+    QVector<qint8> vGateDirs; ///< Положение вертикальных жалюзи блоков
+    QVector<quint8> flags; ///< Флаги состояния блоков
+};
+
+#endif
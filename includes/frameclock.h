@@ -0,0 +1,78 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QTimer;
+
+/**
+ * @file frameclock.h
+ * @brief Заголовочный файл для часов кадров.
+ *
+ * Этот файл содержит объявление класса FrameClock — общего источника тактов кадров,
+ * по которому синхронизируются обновления сцены и анимации окна.
+ */
+
+/**
+ * @class FrameClock
+ * @brief Часы кадров с периодом, равным периоду обновления экрана.
+ *
+ * Кадр выдаётся только по запросу (requestFrame()) и не чаще одного раза за период:
+ * сколько бы запросов ни пришло между кадрами, сигнал frame() будет один. Если запросов
+ * нет, часы не тратят процессорное время.
+ */
+class FrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса FrameClock.
+     *
+     * Период кадра берётся из частоты обновления основного экрана (60 Гц, если она неизвестна).
+     * @param parent Родительский объект.
+     */
+    explicit FrameClock(QObject *parent = nullptr);
+
+    /**
+     * @brief Запрашивает кадр. Повторные запросы до выдачи кадра объединяются.
+     */
+    void requestFrame();
+
+    /**
+     * @brief Задаёт период кадра.
+     * @param ns Период в наносекундах.
+     */
+    void setFrameInterval(qint64 ns);
+
+    /**
+     * @brief Возвращает период кадра в наносекундах.
+     */
+    qint64 frameInterval() const { return intervalNs; }
+
+    /**
+     * @brief Возвращает количество выданных кадров.
+     */
+    quint64 frameCount() const { return frames; }
+
+signals:
+    /**
+     * @brief Сигнал кадра.
+     * @param timestampNs Время кадра в наносекундах от создания часов.
+     */
+    void frame(qint64 timestampNs);
+
+private slots:
+    void tick();
+
+private:
+    QTimer *timer; ///< Таймер до следующего кадра
+    QElapsedTimer clock; ///< Монотонное время
+    qint64 intervalNs; ///< Период кадра
+    qint64 lastFrameNs = -1; ///< Время последнего кадра (-1 — кадров не было)
+    bool requested = false; ///< Кадр запрошен и ещё не выдан
+    quint64 frames = 0; ///< Выдано кадров
+};
+
+#endif
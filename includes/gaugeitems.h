@@ -0,0 +1,167 @@
+#ifndef GAUGEITEMS_H
+#define GAUGEITEMS_H
+
+#include <QGraphicsItem>
+#include <QPainterPath>
+#include <QPen>
+#include <QBrush>
+#include <QVector>
+
+/**
+ * @file gaugeitems.h
+ * @brief Заголовочный файл для элементов сцены приборной панели.
+ *
+ * Этот файл содержит объявление классов GaugeBackgroundItem, LevelBarItem и GateArrowItem,
+ * из которых строятся шкалы и указатели направления воздушного потока.
+ */
+
+/**
+ * @class GaugeBackgroundItem
+ * @brief Неподвижная часть приборной панели: контуры шкал и крайние положения жалюзи.
+ *
+ * Элемент кэшируется в растр в координатах устройства (DeviceCoordinateCache), поэтому
+ * отрисовывается один раз и перерисовывается только при смене перьев (смене темы).
+ */
+class GaugeBackgroundItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Конструктор класса GaugeBackgroundItem.
+     * @param parent Родительский элемент.
+     */
+    explicit GaugeBackgroundItem(QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Добавляет контур шкалы.
+     * @param rect Прямоугольник шкалы.
+     */
+    void addScale(const QRectF &rect);
+
+    /**
+     * @brief Добавляет неподвижную направляющую.
+     * @param line Отрезок.
+     */
+    void addGuide(const QLineF &line);
+
+    /**
+     * @brief Задаёт перо контуров шкал.
+     * @param pen Перо.
+     */
+    void setFramePen(const QPen &pen);
+
+    /**
+     * @brief Задаёт перо направляющих.
+     * @param pen Перо.
+     */
+    void setGuidePen(const QPen &pen);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    void updateBounds();
+
+    QVector<QRectF> scales; ///< Контуры шкал
+    QVector<QLineF> guides; ///< Направляющие
+    QPen framePen; ///< Перо контуров
+    QPen guidePen; ///< Перо направляющих
+    QRectF bounds; ///< Границы элемента
+};
+
+/**
+ * @class LevelBarItem
+ * @brief Столбик уровня, растущий от нижнего края дорожки.
+ *
+ * Границы элемента совпадают с текущим столбиком (с учётом пера), поэтому при изменении
+ * уровня перерисовывается только объединение старого и нового столбика.
+ * Неизменившийся уровень не вызывает перерисовки.
+ */
+class LevelBarItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Конструктор класса LevelBarItem.
+     * @param track Область, которую может занять столбик.
+     * @param brush Заливка столбика.
+     * @param parent Родительский элемент.
+     */
+    LevelBarItem(const QRectF &track, const QBrush &brush, QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Задаёт высоту столбика.
+     * @param value Высота в пикселях (ограничивается высотой дорожки).
+     */
+    void setLevel(double value);
+
+    /**
+     * @brief Возвращает высоту столбика.
+     */
+    double level() const { return height; }
+
+    /**
+     * @brief Задаёт перо контура столбика.
+     * @param value Перо.
+     */
+    void setPen(const QPen &value);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    QRectF barRect() const;
+
+    QRectF track; ///< Область столбика
+    QBrush brush; ///< Заливка
+    QPen pen; ///< Перо контура
+    double height = 0.0; ///< Текущая высота
+};
+
+/**
+ * @class GateArrowItem
+ * @brief Стрелка направления воздушного потока с необязательной дугой угла.
+ *
+ * Стрелка выходит из начальной точки под углом (угол 0 — вертикально вниз).
+ * Границы элемента охватывают только стрелку и дугу.
+ */
+class GateArrowItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Конструктор класса GateArrowItem.
+     * @param origin Начальная точка стрелки.
+     * @param length Длина стрелки.
+     * @param pen Перо стрелки.
+     * @param parent Родительский элемент.
+     */
+    GateArrowItem(const QPointF &origin, double length, const QPen &pen, QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Включает отрисовку дуги угла от нижней точки окружности радиуса длины стрелки.
+     * @param value Перо дуги.
+     */
+    void setArcPen(const QPen &value);
+
+    /**
+     * @brief Задаёт угол стрелки.
+     * @param degrees Угол в градусах.
+     */
+    void setAngle(double degrees);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    void updateGeometry();
+
+    QPointF origin; ///< Начальная точка
+    double length; ///< Длина стрелки
+    QPen pen; ///< Перо стрелки
+    QPen arcPen; ///< Перо дуги
+    bool hasArc = false; ///< Рисовать ли дугу
+    double angle = 0.0; ///< Текущий угол
+    QLineF line; ///< Текущий отрезок стрелки
+    QPainterPath arc; ///< Текущая дуга
+    QRectF bounds; ///< Границы элемента
+};
+
+#endif
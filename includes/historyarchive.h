@@ -0,0 +1,220 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+#include "sensorsample.h"
+
+/**
+ * @file historyarchive.h
+ * @brief Заголовочный файл для сжатого долговременного архива измерений.
+ *
+ * Этот файл содержит объявление классов HistoryArchive — архива измерений из сжатых блоков
+ * (разности разностей меток времени и исключающее ИЛИ значений, как в Gorilla) —
+ * и ArchiveCursor для последовательного чтения архива с позиционированием по времени.
+ */
+
+/**
+ * @class HistoryArchive
+ * @brief Долговременный архив измерений в сжатых блоках.
+ *
+ * Измерения кодируются потоком бит по блокам фиксированного размера. Первое измерение
+ * блока хранится целиком, у следующих метка времени кодируется разностью соседних
+ * интервалов (при равномерном опросе — один бит), а каждое значение — исключающим ИЛИ
+ * с предыдущим значением канала: неизменившееся значение занимает один бит, изменившееся —
+ * только значащие биты между ведущими и завершающими нулями. Для медленно меняющихся
+ * показаний климата это 1–2 байта на измерение всех трёх каналов против 32 байт без сжатия.
+ *
+ * Индекс блоков (первая и последняя метка, количество измерений) позволяет найти блок
+ * по времени двоичным поиском и декодировать только его. Закрытые блоки не изменяются;
+ * при заданном ограничении самые старые блоки удаляются целиком.
+ *
+ * Значения хранятся как есть; модель состояния записывает их в градусах Цельсия
+ * и Паскалях, чтобы смена единиц отображения не требовала перекодирования архива.
+ */
+class HistoryArchive
+{
+public:
+    /**
+     * @struct Block
+     * @brief Сжатый блок измерений с записью индекса.
+     */
+    struct Block
+    {
+        qint64 firstTimestampUs = 0; ///< Метка времени первого измерения
+        qint64 lastTimestampUs = 0; ///< Метка времени последнего измерения
+        int count = 0; ///< Количество измерений
+        QByteArray bits; ///< Поток бит (старший бит байта — первый)
+    };
+
+    /**
+     * @brief Конструктор класса HistoryArchive.
+     * @param blockSamples Количество измерений в блоке.
+     * @param maxBlocks Наибольшее количество блоков (0 — без ограничения).
+     */
+    explicit HistoryArchive(int blockSamples = 4096, int maxBlocks = 0);
+
+    /**
+     * @brief Добавляет измерение в текущий блок; заполненный блок закрывается.
+     * @param timestampUs Метка времени в микросекундах (не убывает).
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void append(qint64 timestampUs, double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Очищает архив.
+     */
+    void clear();
+
+    /**
+     * @brief Заменяет содержимое архива сохранёнными блоками.
+     *
+     * Блоки, кроме последнего, принимаются как есть; последний декодируется и кодируется
+     * заново, чтобы восстановить состояние кодирования и продолжить запись в него.
+     * @param saved Блоки в порядке записи (метки не убывают).
+     */
+    void restore(const QVector<Block> &saved);
+
+    /**
+     * @brief Задаёт наибольшее количество блоков; лишние самые старые блоки удаляются.
+     * @param count Количество блоков (0 — без ограничения).
+     */
+    void setMaxBlocks(int count);
+
+    /**
+     * @brief Возвращает количество измерений в архиве.
+     */
+    qint64 size() const { return total; }
+
+    /**
+     * @brief Возвращает true, если архив пуст.
+     */
+    bool isEmpty() const { return total == 0; }
+
+    /**
+     * @brief Возвращает количество блоков, включая незаполненный последний.
+     */
+    int blockCount() const { return blocks.size(); }
+
+    /**
+     * @brief Возвращает блок.
+     * @param i Номер блока (0 — самый старый).
+     */
+    const Block &block(int i) const { return blocks.at(i); }
+
+    /**
+     * @brief Возвращает размер сжатых данных в байтах.
+     */
+    qint64 sizeBytes() const;
+
+    /**
+     * @brief Возвращает номер блока, содержащего первое измерение с меткой не меньше заданной.
+     * @param timestampUs Метка времени.
+     * @return Номер блока или blockCount(), если таких измерений нет.
+     */
+    int findBlock(qint64 timestampUs) const;
+
+    /**
+     * @brief Декодирует блок.
+     * @param i Номер блока.
+     * @param out Вектор, в который добавляются измерения.
+     * @return Количество декодированных измерений.
+     */
+    int decodeBlock(int i, QVector<SensorSample> &out) const;
+
+private:
+    /**
+     * @struct ChannelState
+     * @brief Состояние кодирования канала: предыдущее значение и окно значащих бит.
+     */
+    struct ChannelState
+    {
+        quint64 bits = 0; ///< Биты предыдущего значения
+        int leading = 0; ///< Ведущие нули окна
+        int trailing = 0; ///< Завершающие нули окна
+    };
+
+    void writeBits(quint64 value, int count);
+    void writeValue(ChannelState &state, double value);
+    void trimBlocks();
+
+    QVector<Block> blocks; ///< Блоки (последний — открытый для записи)
+    int blockSamples; ///< Измерений в блоке
+    int maxBlocks; ///< Наибольшее количество блоков (0 — без ограничения)
+    qint64 total = 0; ///< Количество измерений
+    bool blockOpen = false; ///< Последний блок закодирован этим архивом и продолжается при записи
+    int freeBits = 0; ///< Свободные биты последнего байта открытого блока
+    qint64 prevTimestampUs = 0; ///< Метка предыдущего измерения
+    qint64 prevDeltaUs = 0; ///< Предыдущий интервал между метками
+    ChannelState channels[3]; ///< Состояние каналов: температура, влажность, давление
+
+    friend class ArchiveCursor;
+};
+
+/**
+ * @class ArchiveCursor
+ * @brief Последовательное чтение архива с позиционированием по времени.
+ *
+ * Декодирует блоки по одному прямо из потока бит, не создавая промежуточных массивов.
+ * Курсор действителен, пока архив не изменяется.
+ */
+class ArchiveCursor
+{
+public:
+    /**
+     * @brief Конструктор класса ArchiveCursor. Курсор установлен на самое старое измерение.
+     * @param archive Архив.
+     */
+    explicit ArchiveCursor(const HistoryArchive &archive);
+
+    /**
+     * @brief Устанавливает курсор на первое измерение с меткой не меньше заданной.
+     * @param timestampUs Метка времени.
+     */
+    void seek(qint64 timestampUs);
+
+    /**
+     * @brief Читает следующее измерение.
+     * @param sample Измерение.
+     * @return false, если измерения закончились.
+     */
+    bool next(SensorSample &sample);
+
+    /**
+     * @brief Читает до count следующих измерений.
+     * @param out Массив измерений.
+     * @param count Размер массива.
+     * @return Количество прочитанных измерений.
+     */
+    int read(SensorSample *out, int count);
+
+private:
+    void openBlock(int i);
+    void decodeNext(SensorSample &sample);
+    quint64 readBits(int count);
+    double readValue(int channel);
+
+    const HistoryArchive &archive; ///< Архив
+    int blockIndex = 0; ///< Текущий блок
+    int remaining = 0; ///< Непрочитанные измерения блока
+    int decoded = 0; ///< Прочитанные измерения блока
+    const uchar *data = nullptr; ///< Поток бит блока
+    int dataSize = 0; ///< Размер потока бит, байт
+    int bytePos = 0; ///< Следующий байт для буфера
+    quint64 buffer = 0; ///< Буфер бит (старшие — первые)
+    int bufferBits = 0; ///< Количество бит в буфере
+    SensorSample last = {}; ///< Предыдущее измерение
+    SensorSample pending = {}; ///< Измерение, найденное seek() и ещё не выданное
+    bool hasPending = false; ///< Измерение pending не выдано
+    qint64 lastDeltaUs = 0; ///< Предыдущий интервал между метками
+    quint64 valueBits[3] = {}; ///< Биты предыдущих значений
+    int leading[3] = {}; ///< Ведущие нули окна каналов
+    int trailing[3] = {}; ///< Завершающие нули окна каналов
+
+    friend class HistoryArchive;
+};
+
+#endif
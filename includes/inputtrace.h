@@ -0,0 +1,217 @@
+#ifndef INPUTTRACE_H
+#define INPUTTRACE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include "sensorsample.h"
+
+/**
+ * @file inputtrace.h
+ * @brief Заголовочный файл для записи входных воздействий.
+ *
+ * Этот файл содержит объявление структур TraceEvent и TraceInitialState и классов
+ * InputTraceWriter и InputTraceReader — компактного двоичного формата записи
+ * измерений датчиков и действий пользователя для точного воспроизведения.
+ */
+
+/**
+ * @struct TraceInitialState
+ * @brief Состояние текущего блока на момент начала записи.
+ */
+struct TraceInitialState
+{
+    qint32 fleetSize = 1; ///< Количество блоков
+    qint32 currentUnit = 0; ///< Номер текущего блока
+    qint32 temperatureUnit = 1; ///< Единица температуры
+    qint32 pressureUnit = 1; ///< Единица давления
+    qint32 on = 0; ///< Питание текущего блока
+    qint32 hGateDir = 0; ///< Горизонтальные жалюзи текущего блока
+    qint32 vGateDir = 0; ///< Вертикальные жалюзи текущего блока
+    qint32 reserved = 0; ///< Зарезервировано (0)
+    double setpoint = 22.0; ///< Уставка текущего блока
+};
+
+/**
+ * @struct TraceEvent
+ * @brief Событие записи: измерение или действие пользователя.
+ *
+ * Смысл значений a и b зависит от типа события (см. InputTraceWriter::EventType).
+ */
+struct TraceEvent
+{
+    qint64 timeUs = 0; ///< Время от начала записи, мкс
+    quint8 type = 0; ///< Тип события
+    qint32 a = 0; ///< Первое значение действия
+    qint32 b = 0; ///< Второе значение действия
+    SensorSample sample = {}; ///< Измерение (для InputTraceWriter::Sample)
+};
+
+/**
+ * @class InputTraceWriter
+ * @brief Запись измерений и действий пользователя в компактный двоичный файл.
+ *
+ * После заголовка с начальным состоянием идут события переменной длины. Каждое событие
+ * начинается байтом типа и приращением времени от предыдущего события (varint, мкс).
+ * Метка времени измерения хранится приращением к метке предыдущего измерения (zigzag varint),
+ * а значения — исключающим ИЛИ с предыдущим значением того же канала: у медленно
+ * меняющихся показаний совпадают знак, порядок и старшие биты мантиссы, поэтому
+ * записываются только младшие ненулевые байты (их количество — в полубайте).
+ * Кодирование без потерь: воспроизведение получает в точности те же значения.
+ *
+ * События копятся в памяти и записываются в файл блоками.
+ */
+class InputTraceWriter
+{
+public:
+    /**
+     * @enum EventType
+     * @brief Типы событий записи.
+     */
+    enum EventType : quint8 {
+        Sample = 1, ///< Измерение датчика
+        Power, ///< Питание: a — 1 включить, 0 выключить
+        TemperatureUp, ///< Уставка на шаг вверх
+        TemperatureDown, ///< Уставка на шаг вниз
+        Setpoint, ///< Уставка: a и b — младшие и старшие 32 бита значения double
+        HGate, ///< Поворот горизонтальных жалюзи: a — изменение угла
+        VGate, ///< Поворот вертикальных жалюзи: a — изменение угла
+        Gates, ///< Положение жалюзи: a — горизонтальных, b — вертикальных
+        Units, ///< Единицы измерения: a — температуры, b — давления
+        SelectUnit, ///< Выбор блока: a — номер блока
+        FleetSize ///< Количество блоков: a
+    };
+
+    static const quint32 kMagic = 0x52544341; ///< Сигнатура файла ("ACTR")
+    static const quint32 kVersion = 1; ///< Версия формата
+
+    /**
+     * @brief Конструктор класса InputTraceWriter.
+     */
+    InputTraceWriter() = default;
+
+    /**
+     * @brief Деструктор класса InputTraceWriter. Записывает накопленные события и закрывает файл.
+     */
+    ~InputTraceWriter();
+
+    InputTraceWriter(const InputTraceWriter &) = delete;
+    InputTraceWriter &operator=(const InputTraceWriter &) = delete;
+
+    /**
+     * @brief Создаёт файл записи и записывает заголовок.
+     * @param path Путь к файлу.
+     * @param initial Начальное состояние.
+     * @return true, если файл создан.
+     */
+    bool open(const QString &path, const TraceInitialState &initial);
+
+    /**
+     * @brief Записывает накопленные события и закрывает файл.
+     */
+    void close();
+
+    /**
+     * @brief Возвращает true, если запись идёт.
+     */
+    bool isOpen() const { return file.isOpen(); }
+
+    /**
+     * @brief Добавляет измерения.
+     * @param samples Массив измерений.
+     * @param count Количество измерений.
+     */
+    void writeSamples(const SensorSample *samples, int count);
+
+    /**
+     * @brief Добавляет действие пользователя.
+     * @param type Тип действия.
+     * @param a Первое значение.
+     * @param b Второе значение.
+     */
+    void writeAction(EventType type, qint32 a = 0, qint32 b = 0);
+
+    /**
+     * @brief Добавляет событие с заданным временем (для формирования записей без часов).
+     * @param event Событие.
+     */
+    void writeEvent(const TraceEvent &event);
+
+    /**
+     * @brief Записывает накопленные события в файл.
+     * @return true, если запись прошла успешно.
+     */
+    bool flush();
+
+    quint64 eventCount() const { return events; } ///< Записано событий
+    qint64 sizeBytes() const { return fileBytes + buffer.size(); } ///< Размер записи с учётом буфера
+
+private:
+    void encode(const TraceEvent &event);
+
+    QFile file; ///< Файл записи
+    QByteArray buffer; ///< Накопленные события
+    QElapsedTimer clock; ///< Время от начала записи
+    qint64 lastTimeUs = 0; ///< Время предыдущего события
+    SensorSample lastSample = {}; ///< Предыдущее измерение
+    quint64 events = 0; ///< Записано событий
+    qint64 fileBytes = 0; ///< Записано байт в файл
+};
+
+/**
+ * @class InputTraceReader
+ * @brief Последовательное чтение файла записи.
+ */
+class InputTraceReader
+{
+public:
+    /**
+     * @brief Открывает файл записи и читает заголовок.
+     * @param path Путь к файлу.
+     * @return true, если файл прочитан и заголовок корректен.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Открывает запись из буфера в памяти.
+     * @param data Содержимое файла записи.
+     * @return true, если заголовок корректен.
+     */
+    bool openData(const QByteArray &data);
+
+    /**
+     * @brief Возвращает начальное состояние.
+     */
+    const TraceInitialState &initialState() const { return initial; }
+
+    /**
+     * @brief Читает следующее событие.
+     * @param event Событие.
+     * @return false в конце записи или на повреждённом событии.
+     */
+    bool next(TraceEvent &event);
+
+    /**
+     * @brief Возвращает чтение к первому событию.
+     */
+    void rewind();
+
+    /**
+     * @brief Возвращает true, если событие оборвано или имеет неизвестный тип.
+     */
+    bool isCorrupted() const { return corrupted; }
+
+private:
+    QByteArray data; ///< Содержимое файла
+    const uchar *begin = nullptr; ///< Начало событий
+    const uchar *pos = nullptr; ///< Текущее событие
+    const uchar *end = nullptr; ///< Конец данных
+    TraceInitialState initial; ///< Начальное состояние
+    qint64 lastTimeUs = 0; ///< Время предыдущего события
+    SensorSample lastSample = {}; ///< Предыдущее измерение
+    bool corrupted = false; ///< Чтение остановлено на повреждённом событии
+};
+
+#endif
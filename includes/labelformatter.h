@@ -0,0 +1,90 @@
+#ifndef LABELFORMATTER_H
+#define LABELFORMATTER_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @file labelformatter.h
+ * @brief Заголовочный файл для форматирования текстовых меток показаний.
+ *
+ * Этот файл содержит объявление класса LabelFormatter, который формирует строки вида
+ * "Т: 21.5 C" без промежуточных строк и сообщает, изменился ли текст метки.
+ */
+
+/**
+ * @class LabelFormatter
+ * @brief Форматирование показания в метку с префиксом и обозначением единицы.
+ *
+ * Число переводится в текст с фиксированным количеством знаков после точки во
+ * встроенный буфер без выделения памяти и сравнивается с предыдущим результатом.
+ * Строка метки собирается заново только если изменились цифры или единица, поэтому
+ * повторное показание того же значения не перерисовывает текстовый элемент сцены.
+ */
+class LabelFormatter
+{
+public:
+    static const int kMaxChars = 32; ///< Размер буфера цифр
+
+    /**
+     * @brief Конструктор класса LabelFormatter.
+     * @param prefix Префикс метки (например, "Т: ").
+     * @param suffixes Обозначения единиц по идентификатору единицы (например, {"", " C", " F", " K"}).
+     * @param decimals Количество знаков после точки (0–9).
+     * @param trimZeros Отбрасывать ли незначащие нули дробной части.
+     */
+    LabelFormatter(const QString &prefix, const QStringList &suffixes, int decimals, bool trimZeros);
+
+    /**
+     * @brief Форматирует показание.
+     * @param value Значение.
+     * @param unit Идентификатор единицы (индекс в списке обозначений).
+     * @return true, если текст метки изменился.
+     */
+    bool format(double value, int unit = 0);
+
+    /**
+     * @brief Оставляет в метке только префикс.
+     * @return true, если текст метки изменился.
+     */
+    bool clear();
+
+    /**
+     * @brief Возвращает текущий текст метки.
+     */
+    const QString &text() const { return rendered; }
+
+    /**
+     * @brief Записывает число с фиксированным количеством знаков после точки.
+     *
+     * Результат совпадает с QString::number(value, 'f', decimals), кроме значений на самой
+     * границе округления; при trimZeros отбрасываются нули в конце дробной части и точка.
+     * Отрицательный ноль выводится без знака.
+     * @param value Значение.
+     * @param decimals Количество знаков после точки (0–9).
+     * @param trimZeros Отбрасывать ли незначащие нули.
+     * @param out Буфер не короче kMaxChars.
+     * @return Количество записанных символов.
+     */
+    static int formatFixed(double value, int decimals, bool trimZeros, char *out);
+
+    /**
+     * @brief Возвращает число с фиксированным количеством знаков и обозначением единицы одной строкой.
+     * @param value Значение.
+     * @param decimals Количество знаков после точки.
+     * @param suffix Обозначение единицы.
+     */
+    static QString fixed(double value, int decimals, const QString &suffix);
+
+private:
+    QString prefix; ///< Префикс метки
+    QStringList suffixes; ///< Обозначения единиц
+    int decimals; ///< Знаков после точки
+    bool trimZeros; ///< Отбрасывать незначащие нули
+    char digits[kMaxChars]; ///< Цифры последнего показания
+    int length = -1; ///< Длина цифр последнего показания (-1 — метка пуста)
+    int unit = -1; ///< Единица последнего показания
+    QString rendered; ///< Текст метки
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef LATENCYOVERLAY_H
+#define LATENCYOVERLAY_H
+
+#include <QGraphicsItem>
+#include <QGraphicsView>
+#include <QStringList>
+
+/**
+ * @file latencyoverlay.h
+ * @brief Заголовочный файл для отладочного показа длительностей операций.
+ *
+ * Этот файл содержит объявление элемента сцены LatencyOverlayItem с таблицей гистограмм
+ * LatencyProbes и вида ProbedGraphicsView, который измеряет длительность отрисовки сцены.
+ */
+
+/**
+ * @class LatencyOverlayItem
+ * @brief Таблица длительностей операций поверх сцены: количество, p50, p99 и максимум.
+ *
+ * Строки таблицы формируются в refresh(), а не при каждой отрисовке, чтобы показ
+ * не влиял на измеряемую длительность отрисовки сцены. До первого refresh() таблица пуста.
+ */
+class LatencyOverlayItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Конструктор класса LatencyOverlayItem.
+     * @param parent Родительский элемент.
+     */
+    explicit LatencyOverlayItem(QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief Перечитывает гистограммы и перерисовывает таблицу.
+     */
+    void refresh();
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    QStringList rows; ///< Строки таблицы
+    QRectF bounds; ///< Границы элемента
+};
+
+/**
+ * @class ProbedGraphicsView
+ * @brief Вид сцены, отрисовка которого измеряется как операция "paint".
+ */
+class ProbedGraphicsView : public QGraphicsView
+{
+public:
+    /**
+     * @brief Конструктор класса ProbedGraphicsView.
+     * @param scene Сцена.
+     * @param parent Родительский виджет.
+     */
+    explicit ProbedGraphicsView(QGraphicsScene *scene, QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+};
+
+#endif
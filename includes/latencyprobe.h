@@ -0,0 +1,259 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include "eventtrace.h"
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <chrono>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ACM_PROBE_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ACM_PROBE_TSC
+#endif
+
+/**
+ * @file latencyprobe.h
+ * @brief Заголовочный файл для измерителей длительности операций.
+ *
+ * Этот файл содержит объявление часов LatencyClock, гистограммы длительностей
+ * LatencyHistogram, реестра гистограмм LatencyProbes, измерителя области видимости
+ * ScopedLatencyProbe и макроса ACM_PROBE, который при сборке без ACM_PROBES не порождает
+ * никакого кода. Измеритель также открывает область трассировки EventTrace.
+ */
+
+/**
+ * @class LatencyClock
+ * @brief Часы измерителей: счётчик тактов процессора с переводом в наносекунды при отчёте.
+ *
+ * На x86 время читается инструкцией RDTSC — вдвое дешевле, чем steady_clock, который
+ * сам читает тот же счётчик и переводит его в наносекунды. Перевод делается только при
+ * отчёте: частота счётчика определяется по паре отметок (такты, steady_clock), взятых
+ * при регистрации первой гистограммы и в момент отчёта, поэтому калибровка не задерживает
+ * запуск. На других архитектурах такт равен наносекунде steady_clock.
+ */
+class LatencyClock
+{
+public:
+    /**
+     * @brief Возвращает текущее время в тактах.
+     */
+    static quint64 now() {
+#ifdef ACM_PROBE_TSC
+        return __rdtsc();
+#else
+        return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Запоминает начальную пару отметок для калибровки (повторные вызовы ничего не делают).
+     */
+    static void start();
+
+    /**
+     * @brief Возвращает длительность такта в наносекундах.
+     */
+    static double nanosecondsPerTick();
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Гистограмма длительностей с постоянной относительной точностью (как HdrHistogram).
+ *
+ * Длительности хранятся в тактах LatencyClock. Значения до 64 тактов хранятся точно,
+ * дальше каждый интервал [2^e, 2^(e+1)) делится на 32 равных корзины, то есть погрешность
+ * значения не превышает 1/32 (3%) во всём диапазоне от наносекунд до часов. Запись —
+ * вычисление номера корзины по старшему биту и увеличение счётчика, без выделения памяти
+ * и ветвлений по диапазонам.
+ *
+ * Гистограмма не потокобезопасна: в неё пишет один поток (измерители стоят в слотах
+ * потока GUI), читать её следует из того же потока.
+ */
+class LatencyHistogram
+{
+public:
+    static const int kSubBucketBits = 5; ///< Двоичный логарифм количества корзин на интервал
+    static const int kSubBuckets = 1 << kSubBucketBits; ///< Корзин на интервал [2^e, 2^(e+1))
+    static const int kMaxExponent = 47; ///< Старший учитываемый бит (около 10 часов при 4 ГГц)
+    static const int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets; ///< Количество корзин
+
+    /**
+     * @brief Конструктор класса LatencyHistogram.
+     * @param name Название операции (строковый литерал).
+     */
+    explicit LatencyHistogram(const char *name);
+
+    /**
+     * @brief Добавляет длительность.
+     * @param ticks Длительность в тактах.
+     */
+    void record(quint64 ticks) {
+        const quint64 value = ticks < (quint64(1) << 63) ? ticks : 0; // Счётчик на другом ядре мог отстать
+        ++counts[bucketIndex(value)];
+        ++total;
+        sum += value;
+        if (value > maxValue) {
+            maxValue = value;
+        }
+    }
+
+    /**
+     * @brief Очищает гистограмму.
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает значение, не превышаемое заданной долей измерений.
+     *
+     * Возвращается верхняя граница корзины, но не больше наибольшего значения.
+     * @param percentile Процентиль от 0 до 100.
+     * @return Длительность в тактах (0, если измерений нет).
+     */
+    quint64 percentile(double percentile) const;
+
+    const char *name() const { return label; } ///< Название операции
+    quint64 count() const { return total; } ///< Количество измерений
+    quint64 max() const { return maxValue; } ///< Наибольшая длительность, тактов
+    double mean() const { return total ? double(sum) / total : 0.0; } ///< Средняя длительность, тактов
+    quint64 bucketCount(int i) const { return counts[i]; } ///< Счётчик корзины
+
+    /**
+     * @brief Возвращает номер корзины для значения.
+     * @param value Длительность в тактах.
+     */
+    static int bucketIndex(quint64 value) {
+        if (value < 2 * kSubBuckets) {
+            return static_cast<int>(value);
+        }
+        const int exponent = 63 - qCountLeadingZeroBits(value);
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const int shift = exponent - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<int>(value >> shift) - kSubBuckets;
+    }
+
+    /**
+     * @brief Возвращает нижнюю границу корзины.
+     * @param i Номер корзины.
+     */
+    static quint64 bucketLow(int i);
+
+    /**
+     * @brief Возвращает ширину корзины.
+     * @param i Номер корзины.
+     */
+    static quint64 bucketWidth(int i);
+
+private:
+    const char *label; ///< Название операции
+    quint64 counts[kBucketCount] = {}; ///< Счётчики корзин
+    quint64 total = 0; ///< Количество измерений
+    quint64 sum = 0; ///< Сумма длительностей
+    quint64 maxValue = 0; ///< Наибольшая длительность
+};
+
+/**
+ * @class LatencyProbes
+ * @brief Реестр гистограмм измерителей.
+ *
+ * Гистограмма создаётся при первом обращении по имени и живёт до завершения программы,
+ * поэтому место измерения получает указатель на неё один раз (статическая переменная
+ * в ACM_PROBE) и дальше обращается к реестру только через этот указатель.
+ */
+class LatencyProbes
+{
+public:
+    /**
+     * @brief Возвращает гистограмму операции, создавая её при первом обращении.
+     * @param name Название операции (строковый литерал).
+     */
+    static LatencyHistogram *histogram(const char *name);
+
+    /**
+     * @brief Возвращает все гистограммы в порядке создания.
+     */
+    static QVector<LatencyHistogram *> all();
+
+    /**
+     * @brief Очищает все гистограммы.
+     */
+    static void resetAll();
+
+    /**
+     * @brief Возвращает гистограммы в формате JSON: процентили и непустые корзины каждой операции.
+     */
+    static QByteArray toJson();
+
+    /**
+     * @brief Записывает toJson() в файл атомарно.
+     * @param path Путь к файлу.
+     * @return true, если файл записан.
+     */
+    static bool dump(const QString &path);
+
+    /**
+     * @brief Возвращает true, если измерители включены при сборке (ACM_PROBES).
+     */
+    static bool isEnabled();
+};
+
+/**
+ * @class ScopedLatencyProbe
+ * @brief Измеряет время от создания до конца области видимости и добавляет его в гистограмму.
+ *
+ * Стоимость измерения — два чтения LatencyClock и запись в гистограмму. Если включена
+ * трассировка EventTrace, измеритель записывает и интервал с названием операции
+ * (категория "probe").
+ */
+class ScopedLatencyProbe
+{
+public:
+    /**
+     * @brief Конструктор класса ScopedLatencyProbe. Запоминает время начала.
+     * @param histogram Гистограмма операции.
+     */
+    explicit ScopedLatencyProbe(LatencyHistogram *histogram)
+        : target(histogram), start(LatencyClock::now()), trace("probe", histogram->name(), nullptr, start) {}
+
+    /**
+     * @brief Деструктор класса ScopedLatencyProbe. Добавляет длительность в гистограмму.
+     */
+    ~ScopedLatencyProbe() {
+        const quint64 end = LatencyClock::now();
+        target->record(end - start);
+        trace.finish(end);
+    }
+
+    ScopedLatencyProbe(const ScopedLatencyProbe &) = delete;
+    ScopedLatencyProbe &operator=(const ScopedLatencyProbe &) = delete;
+
+private:
+    LatencyHistogram *target; ///< Гистограмма операции
+    quint64 start; ///< Время начала, тактов
+    TraceScope trace; ///< Область трассировки операции
+};
+
+#define ACM_PROBE_CONCAT_(a, b) a##b
+#define ACM_PROBE_CONCAT(a, b) ACM_PROBE_CONCAT_(a, b)
+
+/**
+ * @def ACM_PROBE(name)
+ * @brief Измеряет длительность до конца текущей области видимости как операцию name.
+ *
+ * Без определения ACM_PROBES (опция сборки AIRCON_PROBES=OFF) раскрывается в пустой оператор.
+ */
+#ifdef ACM_PROBES
+#define ACM_PROBE(name) \
+    static LatencyHistogram *const ACM_PROBE_CONCAT(acmProbeHistogram_, __LINE__) = LatencyProbes::histogram(name); \
+    const ScopedLatencyProbe ACM_PROBE_CONCAT(acmProbe_, __LINE__)(ACM_PROBE_CONCAT(acmProbeHistogram_, __LINE__))
+#else
+#define ACM_PROBE(name) do {} while (false)
+#endif
+
+#endif
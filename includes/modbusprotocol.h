@@ -0,0 +1,182 @@
+#ifndef MODBUSPROTOCOL_H
+#define MODBUSPROTOCOL_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+#include "controlprotocol.h"
+
+/**
+ * @file modbusprotocol.h
+ * @brief Заголовочный файл для протокола Modbus-TCP.
+ *
+ * Этот файл содержит объявление запроса ModbusRequest и функций разбора кадров,
+ * карты регистров и записи ответов ModbusProtocol.
+ */
+
+/**
+ * @struct ModbusRequest
+ * @brief Разобранный кадр запроса. PDU не копируется: указатель ведёт в буфер соединения.
+ */
+struct ModbusRequest
+{
+    quint16 transaction = 0; ///< Идентификатор транзакции из заголовка MBAP
+    quint8 unit = 0; ///< Идентификатор устройства из заголовка MBAP (возвращается в ответе)
+    quint8 function = 0; ///< Код функции
+    const uchar *data = nullptr; ///< Данные PDU после кода функции
+    int size = 0; ///< Размер данных PDU
+};
+
+/**
+ * @class ModbusProtocol
+ * @brief Разбор кадров, карта регистров и запись ответов Modbus-TCP.
+ *
+ * Регистры — 16-битные слова, старший байт первым; знаковые значения — в дополнительном
+ * коде; величины с дробной частью передаются умноженными на 10. Адреса отсчитываются от 0.
+ *
+ * Входные регистры (функция 04, только чтение), состояние текущего блока:
+ * 0 — температура ×10 в текущей единице; 1 — влажность ×10, %; 2, 3 — давление ×10
+ * в текущей единице, 32 бита (старшее слово в регистре 2); 4 — уставка ×10; 5 — питание (0/1);
+ * 6 — горизонтальные жалюзи, градусы; 7 — вертикальные жалюзи, градусы (со знаком);
+ * 8 — единица температуры (1 — °C, 2 — °F, 3 — K); 9 — единица давления (1 — Па, 2 — мм рт. ст.);
+ * 10 — скорость вентилятора (1..3); 11 — номер текущего блока; 12 — количество блоков.
+ *
+ * Регистры хранения (функции 03, 06, 16): 0 — уставка ×10 в текущей единице;
+ * 1 — горизонтальные жалюзи (0..90); 2 — вертикальные жалюзи (-45..45); 3 — питание (0/1);
+ * 4 — единица температуры; 5 — единица давления; 6 — номер текущего блока.
+ *
+ * Катушка 0 (функции 01, 05) — питание.
+ *
+ * Исключения: 01 — неподдерживаемая функция; 02 — адрес вне карты; 03 — недопустимое
+ * значение (в том числе отклонённое моделью).
+ */
+class ModbusProtocol
+{
+public:
+    /**
+     * @enum Function
+     * @brief Поддерживаемые коды функций.
+     */
+    enum Function : quint8 {
+        ReadCoils = 0x01, ///< Чтение катушек
+        ReadHoldingRegisters = 0x03, ///< Чтение регистров хранения
+        ReadInputRegisters = 0x04, ///< Чтение входных регистров
+        WriteSingleCoil = 0x05, ///< Запись катушки
+        WriteSingleRegister = 0x06, ///< Запись регистра хранения
+        WriteMultipleRegisters = 0x10 ///< Запись нескольких регистров хранения
+    };
+
+    /**
+     * @enum Exception
+     * @brief Коды исключений в ответе.
+     */
+    enum Exception : quint8 {
+        NoException = 0, ///< Запрос выполнен
+        IllegalFunction = 0x01, ///< Функция не поддерживается
+        IllegalDataAddress = 0x02, ///< Адрес или количество вне карты
+        IllegalDataValue = 0x03 ///< Недопустимое значение
+    };
+
+    /**
+     * @enum InputRegister
+     * @brief Адреса входных регистров.
+     */
+    enum InputRegister {
+        InputTemperature = 0, ///< Температура ×10
+        InputHumidity, ///< Влажность ×10
+        InputPressureHigh, ///< Давление ×10, старшее слово
+        InputPressureLow, ///< Давление ×10, младшее слово
+        InputSetpoint, ///< Уставка ×10
+        InputPower, ///< Питание
+        InputHGate, ///< Горизонтальные жалюзи
+        InputVGate, ///< Вертикальные жалюзи
+        InputTemperatureUnit, ///< Единица температуры
+        InputPressureUnit, ///< Единица давления
+        InputFanSpeed, ///< Скорость вентилятора
+        InputCurrentUnit, ///< Номер текущего блока
+        InputFleetSize, ///< Количество блоков
+        InputRegisterCount ///< Количество входных регистров
+    };
+
+    /**
+     * @enum HoldingRegister
+     * @brief Адреса регистров хранения.
+     */
+    enum HoldingRegister {
+        HoldingSetpoint = 0, ///< Уставка ×10
+        HoldingHGate, ///< Горизонтальные жалюзи
+        HoldingVGate, ///< Вертикальные жалюзи
+        HoldingPower, ///< Питание
+        HoldingTemperatureUnit, ///< Единица температуры
+        HoldingPressureUnit, ///< Единица давления
+        HoldingCurrentUnit, ///< Номер текущего блока
+        HoldingRegisterCount ///< Количество регистров хранения
+    };
+
+    static const int kHeaderSize = 7; ///< Размер заголовка MBAP вместе с идентификатором устройства
+    static const int kMaxFrameSize = 260; ///< Наибольший размер кадра Modbus-TCP
+    static const int kCoilCount = 1; ///< Количество катушек
+
+    /**
+     * @brief Разбирает кадр в начале буфера без копирования.
+     * @param data Буфер.
+     * @param size Размер буфера.
+     * @param out Разобранный запрос (указывает в буфер).
+     * @return Размер кадра; 0 — кадр ещё не получен целиком; -1 — поток не является Modbus-TCP.
+     */
+    static int parseFrame(const char *data, qint64 size, ModbusRequest &out);
+
+    /**
+     * @brief Возвращает true, если функция меняет состояние и выполняется в потоке модели.
+     * @param function Код функции.
+     */
+    static bool isWrite(quint8 function);
+
+    /**
+     * @brief Дописывает ответ на запрос чтения (или исключение) по снимку состояния.
+     * @param request Запрос.
+     * @param state Состояние текущего блока.
+     * @param out Выходной буфер.
+     * @return Код исключения (NoException — ответ с данными).
+     */
+    static quint8 appendReadResponse(const ModbusRequest &request, const ControlState &state, QByteArray &out);
+
+    /**
+     * @brief Переводит запрос записи в команды модели.
+     * @param request Запрос записи.
+     * @param out Вектор, в который добавляются команды.
+     * @return Код исключения (NoException — команды добавлены).
+     */
+    static quint8 writeCommands(const ModbusRequest &request, QVector<ControlCommand> &out);
+
+    /**
+     * @brief Дописывает ответ на выполненный запрос записи.
+     * @param request Запрос записи.
+     * @param out Выходной буфер.
+     */
+    static void appendWriteResponse(const ModbusRequest &request, QByteArray &out);
+
+    /**
+     * @brief Дописывает ответ-исключение.
+     * @param request Запрос.
+     * @param code Код исключения.
+     * @param out Выходной буфер.
+     */
+    static void appendException(const ModbusRequest &request, quint8 code, QByteArray &out);
+
+    /**
+     * @brief Заполняет входные регистры по состоянию.
+     * @param state Состояние текущего блока.
+     * @param registers Массив из InputRegisterCount регистров.
+     */
+    static void inputRegisters(const ControlState &state, quint16 *registers);
+
+    /**
+     * @brief Заполняет регистры хранения по состоянию.
+     * @param state Состояние текущего блока.
+     * @param registers Массив из HoldingRegisterCount регистров.
+     */
+    static void holdingRegisters(const ControlState &state, quint16 *registers);
+};
+
+#endif
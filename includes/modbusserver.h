@@ -0,0 +1,152 @@
+#ifndef MODBUSSERVER_H
+#define MODBUSSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include "controlprotocol.h"
+
+class ControlServer;
+class ModbusServer;
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @file modbusserver.h
+ * @brief Заголовочный файл для сервера Modbus-TCP.
+ *
+ * Этот файл содержит объявление классов ModbusServer и ModbusServerWorker: опрос
+ * регистров системами диспетчеризации здания по Modbus-TCP на локальном адресе.
+ */
+
+/**
+ * @class ModbusServerWorker
+ * @brief Сетевая часть сервера Modbus-TCP, работающая в отдельном потоке.
+ *
+ * Все соединения обслуживает один цикл событий. Кадры разбираются прямо в буфере
+ * соединения; чтение регистров отвечает по снимку состояния ControlServer без обращения
+ * к потоку модели, а запись передаётся в поток модели через ControlServer::execute.
+ * Пока запись выполняется, следующие кадры соединения ждут в буфере, так что ответы
+ * идут в порядке запросов.
+ */
+class ModbusServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса ModbusServerWorker.
+     * @param owner Сервер.
+     */
+    explicit ModbusServerWorker(ModbusServer *owner);
+
+    /**
+     * @brief Начинает приём соединений на локальном адресе. Вызывается в потоке сервера.
+     * @param port Порт TCP (0 — выбрать свободный).
+     * @return Открытый порт или 0 при ошибке.
+     */
+    quint16 listen(quint16 port);
+
+    /**
+     * @brief Принимает результаты записи и отвечает на неё. Вызывается в потоке сервера.
+     * @param connection Номер соединения.
+     * @param results Результаты команд записи.
+     */
+    void complete(quint64 connection, const QVector<ControlResult> &results);
+
+private:
+    /**
+     * @struct Connection
+     * @brief Соединение клиента: принятые байты и ожидающая запись.
+     */
+    struct Connection
+    {
+        QTcpSocket *socket = nullptr; ///< Сокет клиента
+        QByteArray buffer; ///< Принятые байты
+        int begin = 0; ///< Начало первого необработанного кадра в buffer
+        bool inFlight = false; ///< Запись выполняется в потоке модели
+        QByteArray reply; ///< Ответ на выполняемую запись при успехе
+        QByteArray failure; ///< Ответ на выполняемую запись, если модель отклонила значение
+    };
+
+    void accept();
+    void readAvailable(quint64 id);
+    void process(quint64 id, Connection &connection);
+
+    ModbusServer *owner; ///< Сервер
+    QTcpServer *server = nullptr; ///< Сервер TCP
+    QHash<quint64, Connection> connections; ///< Соединения по номеру
+    quint64 nextConnection = 1; ///< Номер следующего соединения
+};
+
+/**
+ * @class ModbusServer
+ * @brief Сервер Modbus-TCP с картой регистров состояния текущего блока (см. ModbusProtocol).
+ *
+ * Живёт в потоке модели. Сетевая часть (ModbusServerWorker) работает в своём потоке;
+ * чтение регистров обслуживается по снимку состояния, который публикует ControlServer,
+ * а запись выполняется им же в потоке модели, по одному событию на кадр записи.
+ * Сервер принимает соединения только на локальном адресе.
+ */
+class ModbusServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const quint16 kDefaultPort = 1502; ///< Порт по умолчанию (502 требует прав администратора)
+    static const int kMaxBuffered = 64 * 1024; ///< Байт без ответа в соединении, после которых чтение приостанавливается
+
+    /**
+     * @brief Конструктор класса ModbusServer.
+     * @param control Сервер управления, публикующий состояние и выполняющий команды.
+     * @param parent Родительский объект.
+     */
+    explicit ModbusServer(ControlServer *control, QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса ModbusServer. Закрывает порт и останавливает поток сервера.
+     */
+    ~ModbusServer();
+
+    /**
+     * @brief Открывает порт на локальном адресе и запускает поток сервера.
+     * @param port Порт TCP (0 — выбрать свободный).
+     * @return true, если порт открыт.
+     */
+    bool listen(quint16 port = kDefaultPort);
+
+    /**
+     * @brief Закрывает порт и останавливает поток сервера.
+     */
+    void close();
+
+    /**
+     * @brief Возвращает открытый порт (0 — сервер не запущен).
+     */
+    quint16 serverPort() const { return port; }
+
+    /**
+     * @brief Возвращает количество обработанных запросов.
+     */
+    quint64 handledRequests() const { return handled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает количество ответов-исключений.
+     */
+    quint64 exceptionResponses() const { return exceptions.load(std::memory_order_relaxed); }
+
+private:
+    friend class ModbusServerWorker;
+
+    ControlServer *control; ///< Сервер управления
+    QThread serverThread; ///< Поток сетевой части
+    ModbusServerWorker *worker = nullptr; ///< Сетевая часть
+    quint16 port = 0; ///< Открытый порт
+    std::atomic<quint64> handled{0}; ///< Обработано запросов
+    std::atomic<quint64> exceptions{0}; ///< Отправлено исключений
+};
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file samplehistory.h
+ * @brief Заголовочный файл для истории измерений.
+ *
+ * Этот файл содержит объявление кольцевого буфера RingBuffer, истории измерений
+ * SampleHistory и функции прореживания minMaxDecimate(), сохраняющей экстремумы.
+ */
+
+/**
+ * @class RingBuffer
+ * @brief Кольцевой буфер фиксированной ёмкости с добавлением за O(1).
+ *
+ * При заполнении новые элементы вытесняют самые старые. Память выделяется один раз.
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+    /**
+     * @brief Конструктор класса RingBuffer.
+     * @param capacity Ёмкость буфера.
+     */
+    explicit RingBuffer(int capacity = 0) { reset(capacity); }
+
+    /**
+     * @brief Очищает буфер и задаёт новую ёмкость.
+     * @param capacity Ёмкость буфера.
+     */
+    void reset(int capacity) {
+        storage.fill(T(), capacity);
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Очищает буфер без изменения ёмкости.
+     */
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Добавляет элемент, при необходимости вытесняя самый старый.
+     * @param value Элемент.
+     */
+    void append(const T &value) {
+        storage[head] = value;
+        head = head + 1 == storage.size() ? 0 : head + 1;
+        if (count < storage.size()) {
+            ++count;
+        }
+    }
+
+    /**
+     * @brief Возвращает элемент по логическому номеру (0 — самый старый).
+     * @param i Логический номер.
+     */
+    const T &at(int i) const {
+        int pos = head - count + i;
+        return storage[pos < 0 ? pos + storage.size() : pos];
+    }
+
+    /**
+     * @brief Возвращает самый новый элемент. Буфер не должен быть пустым.
+     */
+    const T &last() const { return at(count - 1); }
+
+    /**
+     * @brief Возвращает количество элементов.
+     */
+    int size() const { return count; }
+
+    /**
+     * @brief Возвращает ёмкость буфера.
+     */
+    int capacity() const { return storage.size(); }
+
+    /**
+     * @brief Возвращает true, если буфер пуст.
+     */
+    bool isEmpty() const { return count == 0; }
+
+    /**
+     * @brief Возвращает указатель на хранилище.
+     *
+     * Заполненные элементы занимают позиции [0, size()) хранилища (в порядке,
+     * отличном от логического, если буфер переполнялся). Используется для
+     * поэлементной обработки, не зависящей от порядка, например пересчёта единиц.
+     */
+    T *rawData() { return storage.data(); }
+
+private:
+    QVector<T> storage; ///< Хранилище элементов
+    int head = 0; ///< Позиция для следующей записи
+    int count = 0; ///< Количество элементов
+};
+
+/**
+ * @struct MinMaxBucket
+ * @brief Интервал прореживания с минимальным и максимальным значением.
+ */
+struct MinMaxBucket
+{
+    double min; ///< Минимальное значение в интервале
+    double max; ///< Максимальное значение в интервале
+    bool empty; ///< true, если в интервал не попало ни одного измерения
+};
+Q_DECLARE_TYPEINFO(MinMaxBucket, Q_PRIMITIVE_TYPE);
+
+/**
+ * @class SampleHistory
+ * @brief История измерений температуры, влажности и давления.
+ *
+ * Метки времени хранятся в общем кольцевом буфере, значения каждого канала — в отдельном,
+ * все буферы имеют одинаковую ёмкость и заполняются синхронно.
+ */
+class SampleHistory
+{
+public:
+    /**
+     * @enum Channel
+     * @brief Каналы истории.
+     */
+    enum Channel {
+        Temperature = 0, ///< Температура
+        Humidity, ///< Влажность
+        Pressure, ///< Давление
+        ChannelCount
+    };
+
+    /**
+     * @brief Конструктор класса SampleHistory.
+     * @param capacity Ёмкость истории (количество измерений).
+     */
+    explicit SampleHistory(int capacity = 24 * 60 * 60);
+
+    /**
+     * @brief Добавляет измерение за O(1).
+     * @param timestampUs Метка времени в микросекундах (не убывает).
+     * @param temperature Температура.
+     * @param humidity Влажность.
+     * @param pressure Давление.
+     */
+    void append(qint64 timestampUs, double temperature, double humidity, double pressure);
+
+    /**
+     * @brief Очищает историю.
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает количество измерений.
+     */
+    int size() const { return timestamps.size(); }
+
+    /**
+     * @brief Возвращает ёмкость истории.
+     */
+    int capacity() const { return timestamps.capacity(); }
+
+    /**
+     * @brief Возвращает метку времени измерения (0 — самое старое).
+     * @param i Логический номер измерения.
+     */
+    qint64 timestampAt(int i) const { return timestamps.at(i); }
+
+    /**
+     * @brief Возвращает значение канала (0 — самое старое).
+     * @param channel Канал.
+     * @param i Логический номер измерения.
+     */
+    double valueAt(Channel channel, int i) const { return values[channel].at(i); }
+
+    /**
+     * @brief Возвращает метку времени самого старого измерения. История не должна быть пустой.
+     */
+    qint64 firstTimestamp() const { return timestamps.at(0); }
+
+    /**
+     * @brief Возвращает метку времени самого нового измерения. История не должна быть пустой.
+     */
+    qint64 lastTimestamp() const { return timestamps.last(); }
+
+    /**
+     * @brief Возвращает номер первого измерения с меткой не меньше заданной.
+     * @param timestampUs Метка времени.
+     * @return Логический номер или size(), если таких измерений нет.
+     */
+    int lowerBound(qint64 timestampUs) const;
+
+    /**
+     * @brief Возвращает буфер значений канала для поэлементной обработки.
+     * @param channel Канал.
+     */
+    RingBuffer<double> &channel(Channel channel) { return values[channel]; }
+
+private:
+    RingBuffer<qint64> timestamps; ///< Метки времени
+    RingBuffer<double> values[ChannelCount]; ///< Значения каналов
+};
+
+/**
+ * @brief Прореживает канал истории до заданного числа интервалов с сохранением экстремумов.
+ *
+ * Отрезок времени [fromUs, toUs) делится на buckets равных интервалов, для каждого
+ * интервала вычисляются минимум и максимум. Проход по истории линейный, выход имеет
+ * размер, равный ширине графика в пикселях, поэтому стоимость отрисовки не зависит
+ * от количества измерений.
+ *
+ * @param history История измерений.
+ * @param channel Канал.
+ * @param fromUs Начало отрезка времени.
+ * @param toUs Конец отрезка времени.
+ * @param buckets Количество интервалов.
+ * @param out Результат (размер изменяется до buckets).
+ */
+void minMaxDecimate(const SampleHistory &history, SampleHistory::Channel channel,
+                    qint64 fromUs, qint64 toUs, int buckets, QVector<MinMaxBucket> &out);
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "sensorsample.h"
+
+/**
+ * @file samplering.h
+ * @brief Заголовочный файл для кольцевой очереди измерений.
+ *
+ * Этот файл содержит объявление класса SampleRing — ограниченной очереди измерений
+ * без блокировок между одним потоком-производителем и одним потоком-потребителем.
+ */
+
+/**
+ * @class SampleRing
+ * @brief Ограниченная очередь измерений без блокировок для одного производителя и одного потребителя.
+ *
+ * Производитель (поток источника) добавляет измерения пакетами, потребитель (поток GUI)
+ * забирает всё накопленное один раз за кадр. В отличие от сигналов между потоками,
+ * очередь не выделяет память на каждое измерение и ограничена по размеру: при переполнении
+ * производитель либо вытесняет самые старые измерения (DropOldest), либо ждёт, пока
+ * потребитель освободит место (Block), и счётчики показывают, сколько раз это произошло.
+ *
+ * Позиции записи и чтения — монотонные 64-битные счётчики в отдельных строках кэша,
+ * поэтому производитель и потребитель не делят строку кэша при обычной работе.
+ * Вытесняя старые измерения, производитель сдвигает позицию чтения сравнением с обменом;
+ * потребитель подтверждает прочитанное так же и перечитывает, если его опередили.
+ * Ячейки хранятся атомарными 8-байтовыми словами, поэтому одновременные запись
+ * вытесненной ячейки и её чтение не являются гонкой данных.
+ */
+class SampleRing
+{
+public:
+    /**
+     * @enum OverflowPolicy
+     * @brief Поведение при переполнении очереди.
+     */
+    enum class OverflowPolicy {
+        DropOldest = 1, ///< Вытеснять самые старые измерения: производитель никогда не ждёт
+        Block ///< Ждать, пока потребитель освободит место (обратное давление на источник)
+    };
+
+    /**
+     * @brief Конструктор класса SampleRing.
+     * @param capacity Ёмкость в измерениях (округляется вверх до степени двойки).
+     * @param policy Поведение при переполнении.
+     */
+    explicit SampleRing(int capacity = 65536, OverflowPolicy policy = OverflowPolicy::Block);
+
+    SampleRing(const SampleRing &) = delete;
+    SampleRing &operator=(const SampleRing &) = delete;
+
+    /**
+     * @brief Добавляет измерения. Вызывается только потоком-производителем.
+     *
+     * При политике Block пакет больше свободного места записывается частями по мере
+     * освобождения; ожидание прерывается вызовом close().
+     * @param samples Массив измерений.
+     * @param count Количество измерений.
+     * @return Количество записанных измерений (меньше count, только если очередь закрыта).
+     */
+    int push(const SensorSample *samples, int count);
+
+    /**
+     * @brief Забирает накопленные измерения в конец вектора. Вызывается только потоком-потребителем.
+     * @param out Вектор, в который добавляются измерения в порядке поступления.
+     * @param maxCount Наибольшее количество забираемых измерений (-1 — все).
+     * @return Количество забранных измерений.
+     */
+    int drain(QVector<SensorSample> &out, int maxCount = -1);
+
+    /**
+     * @brief Закрывает очередь: ожидающий производитель возвращается, новые измерения не принимаются.
+     */
+    void close();
+
+    /**
+     * @brief Открывает очередь заново после close(). Содержимое сохраняется.
+     */
+    void reopen();
+
+    /**
+     * @brief Задаёт поведение при переполнении. Действует со следующего вызова push().
+     * @param policy Поведение при переполнении.
+     */
+    void setPolicy(OverflowPolicy policy) { overflowPolicy.store(policy, std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает поведение при переполнении.
+     */
+    OverflowPolicy policy() const { return overflowPolicy.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает ёмкость в измерениях.
+     */
+    int capacity() const { return static_cast<int>(mask + 1); }
+
+    /**
+     * @brief Возвращает количество измерений в очереди (приблизительно, если производитель работает).
+     */
+    int size() const;
+
+    quint64 pushedSamples() const { return pushed.load(std::memory_order_relaxed); } ///< Записано измерений
+    quint64 droppedSamples() const { return dropped.load(std::memory_order_relaxed); } ///< Вытеснено измерений (DropOldest)
+    quint64 overflowEvents() const { return overflows.load(std::memory_order_relaxed); } ///< Вызовов push(), заставших очередь полной
+    quint64 blockedWaits() const { return waits.load(std::memory_order_relaxed); } ///< Ожиданий свободного места (Block)
+
+private:
+    static constexpr int kWords = sizeof(SensorSample) / sizeof(quint64); ///< Слов на ячейку
+
+    void writeSlot(quint64 position, const SensorSample &sample);
+    void readSlot(quint64 position, SensorSample &sample) const;
+
+    // Поля производителя
+    alignas(64) std::atomic<quint64> tail{0}; ///< Позиция записи
+    std::atomic<quint64> pushed{0}; ///< Записано измерений
+    std::atomic<quint64> dropped{0}; ///< Вытеснено измерений
+    std::atomic<quint64> overflows{0}; ///< Вызовов push(), заставших очередь полной
+    std::atomic<quint64> waits{0}; ///< Ожиданий свободного места
+
+    // Поля потребителя (позицию чтения сдвигает и производитель при вытеснении)
+    alignas(64) std::atomic<quint64> head{0}; ///< Позиция чтения
+
+    // Неизменяемые после создания и редко меняемые поля
+    alignas(64) quint64 mask; ///< Ёмкость − 1
+    std::unique_ptr<std::atomic<quint64>[]> slots; ///< Ячейки: kWords слов на измерение
+    std::atomic<OverflowPolicy> overflowPolicy; ///< Поведение при переполнении
+    std::atomic<bool> closed{false}; ///< Очередь закрыта
+};
+
+#endif
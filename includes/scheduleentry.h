@@ -0,0 +1,77 @@
+#ifndef SCHEDULEENTRY_H
+#define SCHEDULEENTRY_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file scheduleentry.h
+ * @brief Заголовочный файл для записей недельного расписания.
+ *
+ * Этот файл содержит структуры ScheduleEntry (действие по дням недели),
+ * HolidayOverride (замена дня недели для даты) и ScheduleData (всё расписание).
+ * Структуры имеют фиксированную раскладку и сохраняются в снимок как есть.
+ */
+
+/**
+ * @struct ScheduleEntry
+ * @brief Действие над блоком, выполняемое в заданное время по выбранным дням недели.
+ *
+ * Время — местное, минута от начала суток. Уставка хранится в градусах Цельсия
+ * и переводится в текущую единицу при выполнении.
+ */
+struct ScheduleEntry
+{
+    /**
+     * @enum Action
+     * @brief Действие записи.
+     */
+    enum Action : quint8 {
+        SetSetpoint = 1, ///< Уставка температуры: setpoint
+        SetPower, ///< Питание: power
+        SetGates ///< Жалюзи: hGate, vGate
+    };
+
+    static const quint8 kAllDays = 0x7F; ///< Биты всех дней недели
+
+    quint32 id = 0; ///< Номер записи (0 — назначает планировщик)
+    qint32 unit = 0; ///< Номер блока
+    quint8 days = 0; ///< Биты дней недели: бит 0 — понедельник, ..., бит 6 — воскресенье
+    quint8 action = SetSetpoint; ///< Действие (Action)
+    quint16 minute = 0; ///< Минута суток по местному времени (0..1439)
+    qint8 hGate = 0; ///< Горизонтальные жалюзи, градусы (SetGates)
+    qint8 vGate = 0; ///< Вертикальные жалюзи, градусы (SetGates)
+    qint8 power = 0; ///< Питание: 1 — включить, 0 — выключить (SetPower)
+    qint8 reserved = 0; ///< Зарезервировано (0)
+    double setpoint = 0.0; ///< Уставка температуры, °C (SetSetpoint)
+};
+
+Q_DECLARE_TYPEINFO(ScheduleEntry, Q_PRIMITIVE_TYPE);
+
+/**
+ * @struct HolidayOverride
+ * @brief Замена расписания на одну дату: праздник, сокращённый или перенесённый рабочий день.
+ *
+ * В указанную дату записи выполняются так, как если бы это был день недели profile;
+ * profile 0 — в эту дату записи не выполняются. Замена для блока важнее замены для всего парка.
+ */
+struct HolidayOverride
+{
+    qint64 day = 0; ///< Дата (юлианский день, QDate::toJulianDay())
+    qint32 unit = -1; ///< Номер блока (-1 — весь парк)
+    qint32 profile = 0; ///< День недели, по расписанию которого живёт дата (1 — понедельник, ..., 7 — воскресенье; 0 — без расписания)
+};
+
+Q_DECLARE_TYPEINFO(HolidayOverride, Q_PRIMITIVE_TYPE);
+
+/**
+ * @struct ScheduleData
+ * @brief Всё расписание: записи и замены дат.
+ */
+struct ScheduleData
+{
+    QVector<ScheduleEntry> entries; ///< Записи расписания
+    QVector<HolidayOverride> holidays; ///< Замены дат
+};
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef SENSORINGEST_H
+#define SENSORINGEST_H
+
+#include <QObject>
+#include <QVector>
+#include <QThread>
+#include <QTimer>
+#include <QString>
+#include <QByteArray>
+#include <atomic>
+#include "samplering.h"
+#include "sensorsample.h"
+
+class QLocalSocket;
+class QSocketNotifier;
+class SensorIngest;
+
+/**
+ * @file sensoringest.h
+ * @brief Заголовочный файл для конвейера приёма данных датчиков.
+ *
+ * Этот файл содержит объявление классов SensorIngest и SensorSourceReader,
+ * которые принимают поток измерений из локального источника (UNIX-сокет, канал
+ * или файл), собирают их в пакеты и передают в GUI не чаще одного раза за кадр.
+ */
+
+/**
+ * @class SensorSourceReader
+ * @brief Читатель локального источника данных, работающий в отдельном потоке.
+ *
+ * Читает текстовый поток строк вида "<метка_мкс> <температура> <влажность> <давление>"
+ * (разделители — пробелы, табуляции или запятые, строки с '#' игнорируются),
+ * разбирает их и передаёт пакеты измерений в SensorIngest.
+ */
+class SensorSourceReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum SourceKind
+     * @brief Тип источника данных.
+     */
+    enum class SourceKind {
+        File = 1, ///< Обычный файл (дочитывается по мере роста) или канал
+        LocalSocket ///< Локальный сокет (UNIX-сокет или именованный канал Windows)
+    };
+
+    /**
+     * @brief Конструктор класса SensorSourceReader.
+     * @param kind Тип источника.
+     * @param address Путь к файлу/каналу ("-" — стандартный ввод) или имя сокета.
+     * @param sink Приёмник разобранных измерений.
+     */
+    SensorSourceReader(SourceKind kind, const QString &address, SensorIngest *sink);
+
+    /**
+     * @brief Деструктор класса SensorSourceReader.
+     */
+    ~SensorSourceReader();
+
+public slots:
+    /**
+     * @brief Открывает источник. Вызывается в потоке читателя.
+     */
+    void start();
+
+signals:
+    /**
+     * @brief Сигнал об ошибке источника.
+     * @param message Текст ошибки.
+     */
+    void sourceError(const QString &message);
+
+private:
+    void readAvailable();
+    void consume(const char *data, qint64 size);
+
+    SourceKind kind; ///< Тип источника
+    QString address; ///< Адрес источника
+    SensorIngest *sink; ///< Приёмник измерений
+
+    QLocalSocket *socket = nullptr; ///< Локальный сокет (для SourceKind::LocalSocket)
+    QSocketNotifier *notifier = nullptr; ///< Уведомитель готовности канала
+    QTimer *pollTimer = nullptr; ///< Таймер дочитывания обычного файла
+    int fd = -1; ///< Дескриптор файла или канала
+    bool ownsFd = false; ///< Закрывать ли дескриптор при уничтожении
+
+    QByteArray tail; ///< Незавершённая строка с прошлого чтения
+    bool discarding = false; ///< Пропускается остаток слишком длинной строки до перевода строки
+    QVector<SensorSample> parsed; ///< Буфер разобранных измерений
+};
+
+/**
+ * @class SensorIngest
+ * @brief Конвейер приёма измерений датчиков с частотой до десятков килогерц.
+ *
+ * Принимает измерения из потока читателя, накапливает их в очереди без блокировок
+ * (SampleRing) и один раз за кадр отдаёт накопленное пакетом сигналом batchReady().
+ * Таким образом поток GUI обрабатывает не более одного обновления сцены за кадр
+ * независимо от частоты источника, а источник не выделяет память и не ждёт мьютекс
+ * на каждое измерение. Очередь ограничена: при переполнении источник ждёт (по умолчанию,
+ * обратное давление на файл или сокет) или вытесняет самые старые измерения.
+ */
+class SensorIngest : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса SensorIngest.
+     * @param parent Родительский объект.
+     */
+    explicit SensorIngest(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса SensorIngest. Останавливает поток читателя.
+     */
+    ~SensorIngest();
+
+    /**
+     * @brief Начинает чтение из файла или канала.
+     * @param path Путь к файлу или каналу, "-" — стандартный ввод.
+     */
+    void openFile(const QString &path);
+
+    /**
+     * @brief Начинает чтение из локального сокета.
+     * @param serverName Имя сервера или путь к UNIX-сокету.
+     */
+    void openLocalSocket(const QString &serverName);
+
+    /**
+     * @brief Останавливает чтение источника.
+     */
+    void stop();
+
+    /**
+     * @brief Задаёт период выдачи пакетов (длительность кадра).
+     * @param ms Период в миллисекундах.
+     */
+    void setFrameInterval(int ms);
+
+    /**
+     * @brief Задаёт поведение очереди при переполнении.
+     * @param policy Поведение при переполнении.
+     */
+    void setOverflowPolicy(SampleRing::OverflowPolicy policy) { ring.setPolicy(policy); }
+
+    /**
+     * @brief Добавляет измерения в очередь.
+     *
+     * Вызывается одним потоком-производителем: потоком читателя источника или, если
+     * источник не открыт, другим потоком приложения (симулятор, генератор нагрузки).
+     * @param samples Массив измерений.
+     * @param count Количество измерений.
+     */
+    void pushSamples(const SensorSample *samples, int count);
+
+    /**
+     * @brief Разбирает одну строку измерения.
+     * @param begin Начало строки.
+     * @param end Конец строки (без символа перевода строки).
+     * @param sample Результат разбора.
+     * @return true, если строка содержит корректное измерение.
+     */
+    static bool parseLine(const char *begin, const char *end, SensorSample &sample);
+
+    /**
+     * @brief Разбирает все завершённые строки в буфере.
+     * @param data Буфер с текстом.
+     * @param size Размер буфера.
+     * @param out Вектор, в который добавляются измерения.
+     * @param malformed Счётчик некорректных строк (может быть nullptr).
+     * @return Количество обработанных байт (до начала незавершённой строки).
+     */
+    static qint64 parseChunk(const char *data, qint64 size, QVector<SensorSample> &out, quint64 *malformed = nullptr);
+
+    /**
+     * @brief Возвращает количество принятых измерений.
+     */
+    quint64 receivedSamples() const;
+
+    /**
+     * @brief Возвращает количество некорректных строк.
+     */
+    quint64 malformedLines() const;
+
+    /**
+     * @brief Возвращает количество выданных пакетов.
+     */
+    quint64 deliveredBatches() const;
+
+    /**
+     * @brief Возвращает очередь измерений (для счётчиков переполнения).
+     */
+    const SampleRing &queue() const { return ring; }
+
+signals:
+    /**
+     * @brief Сигнал с пакетом измерений, накопленных за кадр.
+     * @param batch Измерения в порядке поступления.
+     */
+    void batchReady(const QVector<SensorSample> &batch);
+
+    /**
+     * @brief Сигнал об ошибке источника.
+     * @param message Текст ошибки.
+     */
+    void sourceError(const QString &message);
+
+public slots:
+    /**
+     * @brief Выдаёт накопленный пакет. Вызывается таймером кадра.
+     */
+    void flush();
+
+private:
+    friend class SensorSourceReader;
+
+    void startReader(SensorSourceReader::SourceKind kind, const QString &address);
+    void countMalformed(quint64 count);
+
+    QThread readerThread; ///< Поток читателя источника
+    SensorSourceReader *reader = nullptr; ///< Читатель источника
+    QTimer *frameTimer; ///< Таймер кадра
+
+    SampleRing ring; ///< Очередь измерений от потока читателя к потоку GUI
+    QVector<SensorSample> delivering; ///< Выдаваемый пакет (память переиспользуется)
+
+    std::atomic<quint64> received{0}; ///< Принято измерений
+    std::atomic<quint64> malformed{0}; ///< Некорректных строк
+    quint64 batches = 0; ///< Выдано пакетов
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SENSORSAMPLE_H
+#define SENSORSAMPLE_H
+
+#include <QtGlobal>
+#include <QTypeInfo>
+
+/**
+ * @file sensorsample.h
+ * @brief Заголовочный файл для измерения датчика.
+ *
+ * Этот файл содержит объявление структуры SensorSample, общей для конвейера приёма
+ * измерений, очереди измерений и модели состояния.
+ */
+
+/**
+ * @struct SensorSample
+ * @brief Одно измерение датчика с меткой времени.
+ */
+struct SensorSample
+{
+    qint64 timestampUs; ///< Метка времени в микросекундах
+    double temperature; ///< Температура
+    double humidity; ///< Влажность
+    double pressure; ///< Давление
+};
+Q_DECLARE_TYPEINFO(SensorSample, Q_PRIMITIVE_TYPE);
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @file seqlock.h
+ * @brief Заголовочный файл для последовательной блокировки.
+ *
+ * Этот файл содержит шаблон SeqLock — передачу небольшой структуры от одного
+ * писателя читателям без ожидания со стороны писателя.
+ */
+
+/**
+ * @class SeqLock
+ * @brief Передача значения от одного писателя любому числу читателей без блокировки писателя.
+ *
+ * Писатель делает счётчик версии нечётным, копирует значение и делает счётчик чётным;
+ * читатель копирует значение и повторяет чтение, если версия была нечётной или изменилась.
+ * Писатель никогда не ждёт читателей, поэтому подходит для потоков реального времени.
+ * Значение хранится атомарными 8-байтовыми словами, так что одновременные чтение
+ * и запись не являются гонкой данных.
+ * @tparam T Тривиально копируемый тип.
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Конструктор класса SeqLock.
+     * @param value Начальное значение.
+     */
+    explicit SeqLock(const T &value = T()) {
+        store(value);
+    }
+
+    /**
+     * @brief Публикует значение. Вызывается только одним потоком-писателем.
+     * @param value Значение.
+     */
+    void store(const T &value) {
+        quint64 buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const quint64 version = sequence.load(std::memory_order_relaxed);
+        sequence.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < kWords; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(version + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Возвращает последнее опубликованное значение.
+     */
+    T load() const {
+        quint64 buffer[kWords];
+        quint64 before;
+        quint64 after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (int i = 0; i < kWords; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Возвращает количество публикаций.
+     */
+    quint64 version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr int kWords = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64); ///< Размер значения в словах
+
+    alignas(64) std::atomic<quint64> sequence{0}; ///< Счётчик версии: нечётный во время записи
+    std::atomic<quint64> words[kWords]; ///< Значение
+};
+
+#endif
@@ -21,7 +21,7 @@
  * @brief Класс для управления настройками приложения через графический интерфейс.
  * 
  * Обеспечивает функциональность управления шкалами данных, таких как
- * температура, влажность, давление, а так же изменение тем.
+ * температура, влажность, давление, а так же изменение тем и скорости вентилятора.
  */
 class Settings : public QDialog 
 {
@@ -64,6 +64,13 @@ public:
      * @param id Идентификатор шкалы давления (1 - Па, 2 - мм.рт.ст.).
      */
     void setActivePresUnit(int id);
+
+    /**
+     * @brief Устанавливает активную скорость вентилятора.
+     * 
+     * @param id Идентификатор скорости (1 - низкая, 2 - средняя, 3 - высокая).
+     */
+    void setActiveFanSpeed(int id);
 signals:
 
     /**
@@ -76,6 +83,13 @@ signals:
      */
     void lightThemeSelected();
 
+    /**
+     * @brief Сигнал, отправляемый при выборе скорости вентилятора.
+     * 
+     * @param id Идентификатор скорости (1 - низкая, 2 - средняя, 3 - высокая).
+     */
+    void fanSpeedSelected(int id);
+
     /**
      * @brief Сигнал, отправляемый при подтверждении настроек.
      * 
@@ -100,6 +114,13 @@ private:
     QRadioButton *pa; ///< Радиокнопка для выбора Паскаля.
     QRadioButton *mmrtst; ///< Радиокнопка для выбора миллиметров ртутного столба.
 
+    QHBoxLayout *fanLayout; ///< Компоновка для размещения элементов управления скоростью вентилятора.
+    QLabel *fanLabel; ///< Метка для отображения текста "Скорость вентилятора".
+    QButtonGroup *fanGroup; ///< Группа радиокнопок для выбора скорости вентилятора.
+    QRadioButton *fanLow; ///< Радиокнопка для выбора низкой скорости.
+    QRadioButton *fanMedium; ///< Радиокнопка для выбора средней скорости.
+    QRadioButton *fanHigh; ///< Радиокнопка для выбора высокой скорости.
+
     QHBoxLayout *themeLayout; ///< Компоновка для размещения элементов управления темой.
     QLabel *themeLabel; ///< Метка для отображения текста "Тема оформления".
     QPushButton *white; ///< Кнопка для выбора светлой темы.
@@ -0,0 +1,93 @@
+#ifndef SIMULATIONDRIVER_H
+#define SIMULATIONDRIVER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include "climatemodel.h"
+#include "thermalsimulator.h"
+
+/**
+ * @file simulationdriver.h
+ * @brief Заголовочный файл для связи теплового симулятора с моделью состояния.
+ *
+ * Этот файл содержит объявление класса SimulationDriver, который по таймеру продвигает
+ * ThermalSimulator и передаёт рассчитанные показания в ClimateModel.
+ */
+
+/**
+ * @class SimulationDriver
+ * @brief Источник показаний комнат, рассчитанных тепловым симулятором.
+ *
+ * На каждом такте управление блоков (питание, уставка, жалюзи) берётся из парка модели;
+ * мощность охлаждения текущего блока задаёт регулятор модели (ClimateController), если он
+ * запущен, остальные комнаты охлаждаются встроенным термостатом симулятора. Затем
+ * симулятор продвигается на прошедшее время с учётом ускорения, а результат
+ * передаётся в модель: весь парк — через ClimateModel::acceptFleetReadings(),
+ * текущий блок — через ClimateModel::acceptReading(), тем же путём, что и ввод пользователя.
+ * Давление не моделируется и остаётся прежним.
+ */
+class SimulationDriver : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса SimulationDriver.
+     * @param model Модель состояния.
+     * @param parent Родительский объект.
+     */
+    explicit SimulationDriver(ClimateModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief Запускает такты симуляции.
+     * @param intervalMs Период тактов, мс.
+     */
+    void start(int intervalMs = 1000);
+
+    /**
+     * @brief Останавливает такты симуляции.
+     */
+    void stop();
+
+    /**
+     * @brief Задаёт ускорение модельного времени относительно реального.
+     * @param factor Ускорение.
+     */
+    void setSpeed(double factor) { speed = factor; }
+
+    /**
+     * @brief Возвращает ускорение модельного времени.
+     */
+    double timeScale() const { return speed; }
+
+    /**
+     * @brief Возвращает симулятор (для настройки параметров комнат и потоков).
+     */
+    ThermalSimulator &simulator() { return sim; }
+
+public slots:
+    /**
+     * @brief Выполняет такт: продвигает симулятор на прошедшее время и передаёт показания в модель.
+     */
+    void tick();
+
+    /**
+     * @brief Выполняет такт на заданное модельное время.
+     * @param seconds Модельное время, с.
+     */
+    void advance(double seconds);
+
+private:
+    void syncFleet();
+
+    ClimateModel *model; ///< Модель состояния
+    ThermalSimulator sim; ///< Тепловой симулятор комнат
+    QTimer timer; ///< Таймер тактов
+    QElapsedTimer clock; ///< Реальное время с прошлого такта
+    QVector<double> converted; ///< Температуры в единице модели
+    double speed = 1.0; ///< Ускорение модельного времени
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef STALLMONITOR_H
+#define STALLMONITOR_H
+
+#include "eventtrace.h"
+#include "latencyprobe.h"
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file stallmonitor.h
+ * @brief Заголовочный файл для обнаружения зависаний цикла событий.
+ *
+ * Этот файл содержит объявление сторожа StallMonitor и описания зависания StallRecord.
+ */
+
+/**
+ * @struct StallRecord
+ * @brief Зависание цикла событий и обработчик, выполнявшийся во время зависания.
+ */
+struct StallRecord
+{
+    double durationMs = 0.0; ///< Длительность зависания, мс
+    QString event; ///< Внешняя область: тип события или операция ACM_PROBE (пусто — вне отмеченных обработчиков)
+    QString receiver; ///< Класс получателя события
+    QString scope; ///< Самая вложенная область в момент обнаружения
+    double eventElapsedMs = 0.0; ///< Сколько выполнялась внешняя область к моменту обнаружения, мс
+};
+
+/**
+ * @class StallMonitor
+ * @brief Сторож цикла событий: измеряет опоздание таймера и ловит зависания дольше порога.
+ *
+ * Цикл событий потока, в котором вызван start(), раз в четверть порога отмечает пульс
+ * таймером; опоздание пульса добавляется в гистограмму "event loop lag" (видна в таблице
+ * ACM_PROBE и её выгрузке). Отдельный поток-сторож с тем же периодом проверяет пульс:
+ * если его нет дольше порога, сторож, пока поток ещё занят, читает из EventTrace, какой
+ * обработчик выполняется. Когда пульс возобновляется, зависание записывается интервалом
+ * трассировки в поток "stall monitor", сообщается сигналом stallDetected() и, если задан
+ * путь захвата, трассировка вокруг зависания выгружается в файл.
+ *
+ * Пока сторож работает, включён режим EventTrace::Tracking.
+ */
+class StallMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kDefaultThresholdMs = 100; ///< Порог зависания по умолчанию, мс
+    static const int kMinPeriodMs = 5; ///< Наименьший период пульса и проверки, мс
+    static const int kMaxRecords = 256; ///< Хранимых зависаний (старые вытесняются)
+
+    /**
+     * @brief Конструктор класса StallMonitor. Сторож запускается вызовом start().
+     * @param parent Родительский объект.
+     */
+    explicit StallMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса StallMonitor. Останавливает поток-сторож.
+     */
+    ~StallMonitor();
+
+    /**
+     * @brief Запускает сторож для цикла событий текущего потока.
+     * @param thresholdMs Порог зависания, мс.
+     */
+    void start(int thresholdMs = kDefaultThresholdMs);
+
+    /**
+     * @brief Останавливает сторож.
+     */
+    void stop();
+
+    /**
+     * @brief Возвращает true, если сторож работает.
+     */
+    bool isRunning() const { return thread.joinable(); }
+
+    /**
+     * @brief Возвращает порог зависания, мс.
+     */
+    int threshold() const { return thresholdMs; }
+
+    /**
+     * @brief Задаёт файл, в который после каждого зависания выгружается трассировка.
+     *
+     * Непустой путь включает запись EventTrace.
+     * @param path Путь к файлу Chrome Trace Event (пусто — не выгружать).
+     */
+    void setCapturePath(const QString &path);
+
+    /**
+     * @brief Возвращает количество обнаруженных зависаний.
+     */
+    quint64 stallCount() const { return detected; }
+
+    /**
+     * @brief Возвращает последние обнаруженные зависания (не более kMaxRecords).
+     */
+    QVector<StallRecord> stalls() const { return records; }
+
+signals:
+    /**
+     * @brief Сигнал обнаруженного зависания (после того как цикл событий возобновился).
+     * @param stall Зависание.
+     */
+    void stallDetected(const StallRecord &stall);
+
+private slots:
+    /**
+     * @brief Отмечает пульс и добавляет опоздание таймера в гистограмму.
+     */
+    void beat();
+
+private:
+    void run();
+    void report(const StallRecord &stall);
+
+    int thresholdMs = kDefaultThresholdMs; ///< Порог зависания, мс
+    int periodMs = kDefaultThresholdMs / 4; ///< Период пульса и проверки, мс
+    QTimer heartbeat; ///< Таймер пульса в наблюдаемом потоке
+    EventTrace::Buffer *monitored = nullptr; ///< Буфер трассировки наблюдаемого потока
+    LatencyHistogram *lag; ///< Опоздания пульса
+    quint64 previousBeat = 0; ///< Время прошлого пульса, тактов (только наблюдаемый поток)
+    std::atomic<quint64> lastBeat{0}; ///< Время последнего пульса, тактов
+    std::atomic<quint64> periodTicks{0}; ///< Период пульса в тактах (0 — сторож ещё калибрует часы)
+    QString capturePath; ///< Файл выгрузки трассировки после зависания
+    QVector<StallRecord> records; ///< Последние зависания
+    quint64 detected = 0; ///< Количество зависаний
+
+    std::thread thread; ///< Поток-сторож
+    std::mutex stopMutex; ///< Защита флага завершения при ожидании проверки
+    std::condition_variable stopSignal; ///< Пробуждение сторожа при остановке
+    bool stopping = false; ///< Запрошена остановка сторожа
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file startuptrace.h
+ * @brief Заголовочный файл для трассировки запуска.
+ *
+ * Этот файл содержит объявление класса StartupTrace, который отмечает окончание
+ * этапов запуска приложения и выводит время до первого кадра по этапам.
+ */
+
+/**
+ * @class StartupTrace
+ * @brief Отметки времени этапов запуска от начала main().
+ *
+ * Этап отмечается вызовом mark() в момент его окончания; длительность этапа — разность
+ * с предыдущей отметкой. Отметки делаются только в потоке GUI и стоят одного чтения часов,
+ * поэтому трассировка включена всегда, а выводится по запросу (--startup-trace).
+ */
+class StartupTrace
+{
+public:
+    /**
+     * @struct Phase
+     * @brief Отметка окончания этапа.
+     */
+    struct Phase
+    {
+        const char *name; ///< Название этапа (строковый литерал)
+        qint64 endNs; ///< Время окончания от начала main(), нс
+    };
+
+    /**
+     * @brief Начинает отсчёт. Вызывается первой строкой main().
+     */
+    static void start();
+
+    /**
+     * @brief Отмечает окончание этапа.
+     * @param name Название этапа (строковый литерал).
+     */
+    static void mark(const char *name);
+
+    /**
+     * @brief Возвращает время от начала отсчёта, нс.
+     */
+    static qint64 elapsedNs();
+
+    /**
+     * @brief Возвращает отмеченные этапы в порядке отметки.
+     */
+    static const QVector<Phase> &phases();
+
+    /**
+     * @brief Возвращает время окончания этапа, нс (-1, если этап не отмечен).
+     * @param name Название этапа.
+     */
+    static qint64 phaseEndNs(const char *name);
+
+    /**
+     * @brief Возвращает отчёт: по строке на этап с длительностью и временем окончания.
+     */
+    static QString report();
+};
+
+#endif
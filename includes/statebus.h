@@ -0,0 +1,172 @@
+#ifndef STATEBUS_H
+#define STATEBUS_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+class QTimer;
+
+/**
+ * @file statebus.h
+ * @brief Заголовочный файл для шины изменений состояния.
+ *
+ * Этот файл содержит объявление изменения StateDelta и шины StateBus, которая
+ * раздаёт изменения подписчикам по битам полей.
+ */
+
+/**
+ * @struct StateDelta
+ * @brief Изменение состояния текущего блока: биты изменившихся полей и их новые значения.
+ *
+ * Значения действительны только для полей, биты которых (ClimateModel::Change) заданы
+ * в fields: TemperatureChanged — temperature, HumidityChanged — humidity,
+ * PressureChanged — pressure, HGateChanged — hGate, VGateChanged — vGate,
+ * PowerChanged — power, UnitsChanged — temperatureUnit и pressureUnit, ThemeChanged — theme,
+ * CurrentUnitChanged — unit и fleetSize, SetpointChanged — setpoint, FanSpeedChanged —
+ * fanSpeed. HistoryChanged значения не несёт. Значения — в текущих единицах.
+ */
+struct StateDelta
+{
+    quint64 sequence = 0; ///< Номер последнего вошедшего изменения
+    quint32 fields = 0; ///< Биты ClimateModel::Change изменившихся полей
+    qint32 unit = 0; ///< Номер текущего блока
+    qint32 fleetSize = 0; ///< Количество блоков
+    qint32 power = 0; ///< Питание (0 или 1)
+    qint32 hGate = 0; ///< Горизонтальные жалюзи, градусы
+    qint32 vGate = 0; ///< Вертикальные жалюзи, градусы
+    qint8 temperatureUnit = 0; ///< Единица температуры (ClimateModel::TemperatureUnit)
+    qint8 pressureUnit = 0; ///< Единица давления (ClimateModel::PressureUnit)
+    qint8 theme = 0; ///< Тема интерфейса (ClimateModel::Theme)
+    qint8 fanSpeed = 0; ///< Скорость вентилятора (ClimateModel::FanSpeed)
+    double temperature = 0.0; ///< Температура
+    double humidity = 0.0; ///< Влажность, %
+    double pressure = 0.0; ///< Давление
+    double setpoint = 0.0; ///< Уставка температуры
+
+    /**
+     * @brief Переносит из другого изменения значения выбранных полей и добавляет их биты.
+     * @param other Более новое изменение.
+     * @param mask Биты переносимых полей.
+     */
+    void merge(const StateDelta &other, quint32 mask);
+
+    /**
+     * @brief Возвращает изменение в виде короткой строки "temperature=23.4 power=1 ...".
+     */
+    QString toString() const;
+};
+
+/**
+ * @class StateBus
+ * @brief Раздача изменений состояния подписчикам по битам полей.
+ *
+ * Подписчик задаёт биты полей, которые ему нужны, и получает только изменения,
+ * затрагивающие эти поля, с маской, урезанной до них. Подписчик с окном объединения
+ * получает не чаще раза в окно одно изменение, в котором собраны последние значения
+ * всех изменившихся за окно полей; окно открывает первое изменение после доставки.
+ *
+ * Шина живёт в потоке модели, и обработчики вызываются в нём же. Подписчик может
+ * отписаться (и подписать других) прямо из обработчика. Маски подписчиков хранятся
+ * отдельным плотным массивом, поэтому подписчики, которым изменение не нужно,
+ * стоят одного сравнения.
+ */
+class StateBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Обработчик изменения.
+     */
+    using Handler = std::function<void(const StateDelta &)>;
+
+    /**
+     * @brief Конструктор класса StateBus.
+     * @param parent Родительский объект.
+     */
+    explicit StateBus(QObject *parent = nullptr);
+
+    /**
+     * @brief Подписывает обработчик на изменения выбранных полей.
+     * @param fields Биты ClimateModel::Change нужных полей.
+     * @param context Объект, при удалении которого подписка снимается (может быть nullptr).
+     * @param handler Обработчик.
+     * @param windowMs Окно объединения изменений, мс (0 — доставлять каждое изменение сразу).
+     * @return Номер подписки.
+     */
+    int subscribe(quint32 fields, QObject *context, Handler handler, int windowMs = 0);
+
+    /**
+     * @brief Снимает подписку. Объединённое, но не доставленное изменение отбрасывается.
+     * @param id Номер подписки.
+     */
+    void unsubscribe(int id);
+
+    /**
+     * @brief Возвращает true, если есть хотя бы одна подписка.
+     */
+    bool hasSubscribers() const { return active != 0; }
+
+    /**
+     * @brief Возвращает объединение полей всех подписок.
+     */
+    quint32 subscribedFields() const;
+
+    /**
+     * @brief Раздаёт изменение подписчикам.
+     * @param delta Изменение (номер присваивает шина).
+     */
+    void publish(const StateDelta &delta);
+
+    /**
+     * @brief Немедленно доставляет все объединённые изменения, не дожидаясь окон.
+     */
+    void flush();
+
+    /**
+     * @brief Возвращает количество опубликованных изменений.
+     */
+    quint64 publishedDeltas() const { return sequence; }
+
+    /**
+     * @brief Возвращает количество вызовов обработчиков.
+     */
+    quint64 deliveredDeltas() const { return delivered; }
+
+private:
+    /**
+     * @struct Subscriber
+     * @brief Подписка: обработчик, окно и объединённое изменение.
+     */
+    struct Subscriber
+    {
+        int id = 0; ///< Номер подписки (0 — снята)
+        quint32 fields = 0; ///< Биты нужных полей
+        Handler handler; ///< Обработчик
+        int windowMs = 0; ///< Окно объединения, мс
+        qint64 deadline = 0; ///< Время доставки объединённого изменения (по clock), мс
+        StateDelta pending; ///< Объединённое изменение (fields == 0 — нет)
+    };
+
+    void deliverDue(bool all);
+    void schedule(qint64 deadline);
+    void compact();
+
+    QVector<quint32> masks; ///< Биты полей подписок (0 — подписка снята), по порядку subscribers
+    QVector<Subscriber> subscribers; ///< Подписки
+    QVector<Subscriber> joining; ///< Подписки, сделанные во время раздачи (добавляются после неё)
+    QTimer *windowTimer; ///< Таймер ближайшего окна объединения
+    QElapsedTimer clock; ///< Часы окон объединения
+    qint64 scheduledAt = -1; ///< Срок, на который заведён windowTimer (-1 — не заведён)
+    quint64 sequence = 0; ///< Номер последнего изменения
+    quint64 delivered = 0; ///< Вызвано обработчиков
+    int nextId = 1; ///< Номер следующей подписки
+    int active = 0; ///< Действующих подписок
+    int dispatching = 0; ///< Глубина вложенных раздач
+    bool removed = false; ///< Есть снятые подписки, ожидающие удаления из массивов
+};
+
+#endif
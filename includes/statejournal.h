@@ -0,0 +1,263 @@
+#ifndef STATEJOURNAL_H
+#define STATEJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <functional>
+
+/**
+ * @file statejournal.h
+ * @brief Заголовочный файл для журнала изменений состояния.
+ *
+ * Этот файл содержит объявление структуры JournalRecord и класса StateJournal —
+ * журнала упреждающей записи, который фиксирует каждое изменение состояния окна
+ * и позволяет восстановить его после аварийного завершения.
+ */
+
+/**
+ * @struct JournalRecord
+ * @brief Запись журнала изменений фиксированного размера.
+ *
+ * Смысл значений зависит от типа записи (см. StateJournal::RecordType).
+ * Контрольная сумма вычисляется по всем полям, кроме неё самой, и позволяет
+ * отбросить запись, оборванную при сбое.
+ */
+struct JournalRecord
+{
+    quint64 sequence; ///< Сквозной номер записи (строго возрастает)
+    quint32 unit; ///< Номер блока парка
+    quint16 type; ///< Тип записи
+    quint16 reserved; ///< Зарезервировано (0)
+    double values[3]; ///< Значения записи
+    quint32 checksum; ///< Контрольная сумма записи
+    quint32 padding; ///< Выравнивание до 8 байт (0)
+};
+
+Q_DECLARE_TYPEINFO(JournalRecord, Q_PRIMITIVE_TYPE);
+
+/**
+ * @struct JournalOptions
+ * @brief Параметры группового коммита и уплотнения журнала.
+ */
+struct JournalOptions
+{
+    int groupCommitMs = 10; ///< Окно группового коммита: записи копятся не дольше этого времени
+    int readingCommitMs = 1000; ///< Окно коммита группы, состоящей только из измерений (Reading)
+    int maxBatchRecords = 256; ///< Коммит выполняется сразу, если накоплено столько записей
+    int syncEveryCommits = 1; ///< fsync выполняется каждые N коммитов (0 — без fsync)
+    qint64 compactMinBytes = 1024 * 1024; ///< Журнал меньше этого размера не уплотняется
+    double compactSnapshotRatio = 4.0; ///< Уплотнение, когда журнал больше снимка в указанное число раз
+    int compactIntervalMs = 5 * 60 * 1000; ///< Период плановой проверки необходимости уплотнения
+};
+
+/**
+ * @class StateJournal
+ * @brief Журнал упреждающей записи изменений состояния.
+ *
+ * Каждое изменение добавляется в память вызовом append() и записывается в файл
+ * группой: одной операцией записи по истечении окна группового коммита или при
+ * накоплении maxBatchRecords записей. Количество коммитов между вызовами fsync
+ * задаётся параметром syncEveryCommits, поэтому стоимость синхронизации делится
+ * между всеми записями группы.
+ *
+ * Измерения (Reading) приходят с частотой датчика и при сбое заменяются следующими,
+ * поэтому группа только из них копится readingCommitMs: при потоке показаний коммит
+ * и fsync выполняются раз в readingCommitMs, а не каждые groupCommitMs. Первое
+ * изменение от пользователя сокращает окно до groupCommitMs и записывается вместе
+ * с накопленными измерениями.
+ *
+ * Журнал не растёт без ограничения: когда его размер превышает
+ * max(compactMinBytes, compactSnapshotRatio × размер снимка), выдаётся сигнал
+ * compactionRequested(). Владелец записывает снимок с номером последней записи и
+ * вызывает truncate(). На каждый байт журнала приходится не более
+ * 1 / compactSnapshotRatio байт перезаписи снимка, то есть суммарный объём записи
+ * ограничен (1 + 1 / compactSnapshotRatio) от объёма журнала.
+ *
+ * При открытии журнал читается через отображение в память, записи с номером больше
+ * номера из снимка передаются обработчику, а оборванный хвост отрезается.
+ */
+class StateJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum RecordType
+     * @brief Типы записей журнала.
+     */
+    enum RecordType : quint16 {
+        Reading = 1, ///< Измерения блока: температура, влажность, давление
+        Temperature, ///< Заданная температура блока
+        Gates, ///< Положение жалюзи блока: горизонтальные, вертикальные
+        Power, ///< Питание блока: 1 — включён, 0 — выключен
+        Units, ///< Единицы измерения: температуры, давления
+        ThemeChange, ///< Тема интерфейса
+        FleetSize, ///< Количество блоков парка
+        SelectUnit, ///< Выбор текущего блока
+        Setpoint, ///< Уставка температуры блока
+        FanSpeed, ///< Скорость вентилятора
+        ScheduleAdd, ///< Запись расписания блока: номер, упакованные дни, минута, действие и значения, уставка
+        ScheduleRemove, ///< Удаление записи расписания: номер
+        HolidaySet, ///< Замена даты для блока (0xFFFFFFFF — парк): дата, день недели
+        HolidayRemove ///< Удаление замены даты для блока (0xFFFFFFFF — парк): дата
+    };
+
+    /**
+     * @brief Обработчик записей при восстановлении.
+     */
+    using ReplayHandler = std::function<void(const JournalRecord &)>;
+
+    /**
+     * @brief Конструктор класса StateJournal.
+     * @param parent Родительский объект.
+     */
+    explicit StateJournal(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор. Записывает накопленные записи и закрывает файл.
+     */
+    ~StateJournal();
+
+    /**
+     * @brief Задаёт параметры группового коммита и уплотнения.
+     * @param options Параметры.
+     */
+    void setOptions(const JournalOptions &options);
+
+    /**
+     * @brief Возвращает текущие параметры.
+     */
+    const JournalOptions &options() const { return opts; }
+
+    /**
+     * @brief Открывает журнал и восстанавливает записи, не учтённые в снимке.
+     *
+     * Записи с номером не больше snapshotSequence уже учтены в снимке и пропускаются.
+     * Чтение останавливается на первой повреждённой записи; хвост файла после неё отрезается.
+     * @param path Путь к файлу журнала.
+     * @param snapshotSequence Номер последней записи, учтённой в снимке.
+     * @param handler Обработчик восстановленных записей (может быть пустым).
+     * @return true, если файл журнала открыт для записи.
+     */
+    bool open(const QString &path, quint64 snapshotSequence, const ReplayHandler &handler);
+
+    /**
+     * @brief Записывает накопленные записи и закрывает файл.
+     */
+    void close();
+
+    /**
+     * @brief Добавляет запись в журнал.
+     *
+     * Запись попадает в файл при ближайшем групповом коммите.
+     * @param type Тип записи.
+     * @param unit Номер блока.
+     * @param a Первое значение.
+     * @param b Второе значение.
+     * @param c Третье значение.
+     * @return Номер записи.
+     */
+    quint64 append(RecordType type, quint32 unit, double a = 0.0, double b = 0.0, double c = 0.0);
+
+    /**
+     * @brief Записывает накопленные записи одной операцией.
+     *
+     * fsync выполняется согласно параметру syncEveryCommits.
+     * @return true, если запись прошла успешно.
+     */
+    bool commit();
+
+    /**
+     * @brief Принудительно синхронизирует файл журнала с диском.
+     * @return true, если синхронизация прошла успешно.
+     */
+    bool sync();
+
+    /**
+     * @brief Очищает журнал после записи снимка.
+     *
+     * Вызывается, когда все записи до lastSequence() учтены в снимке.
+     * Нумерация записей продолжается.
+     * @return true, если файл усечён.
+     */
+    bool truncate();
+
+    /**
+     * @brief Сообщает размер последнего записанного снимка для порога уплотнения.
+     * @param bytes Размер снимка в байтах.
+     */
+    void setSnapshotSize(qint64 bytes);
+
+    /**
+     * @brief Возвращает номер последней добавленной записи.
+     */
+    quint64 lastSequence() const { return nextSequence - 1; }
+
+    /**
+     * @brief Возвращает размер журнала с учётом ещё не записанных записей.
+     */
+    qint64 sizeBytes() const { return fileBytes + pending.size(); }
+
+    /**
+     * @brief Возвращает количество записей, восстановленных при открытии.
+     */
+    quint64 replayedRecords() const { return replayed; }
+
+    /**
+     * @brief Возвращает количество выполненных групповых коммитов.
+     */
+    quint64 commitCount() const { return commits; }
+
+    /**
+     * @brief Возвращает количество выполненных синхронизаций с диском.
+     */
+    quint64 syncCount() const { return syncs; }
+
+    /**
+     * @brief Возвращает true, если журнал открыт.
+     */
+    bool isOpen() const { return file.isOpen(); }
+
+    /**
+     * @brief Вычисляет контрольную сумму записи.
+     * @param record Запись.
+     * @return Контрольная сумма по всем полям, кроме checksum и padding.
+     */
+    static quint32 recordChecksum(const JournalRecord &record);
+
+signals:
+    /**
+     * @brief Сигнал о том, что журнал пора уплотнить в снимок.
+     */
+    void compactionRequested();
+
+    /**
+     * @brief Сигнал об ошибке записи журнала.
+     * @param message Описание ошибки.
+     */
+    void journalError(const QString &message);
+
+private:
+    void checkCompaction();
+
+    JournalOptions opts; ///< Параметры журнала
+    QFile file; ///< Файл журнала (без буферизации)
+    QTimer commitTimer; ///< Таймер окна группового коммита
+    QTimer compactTimer; ///< Таймер плановой проверки уплотнения
+    QByteArray pending; ///< Записи, ожидающие коммита
+    quint64 nextSequence = 1; ///< Номер следующей записи
+    qint64 fileBytes = 0; ///< Размер записанной части журнала
+    qint64 snapshotBytes = 0; ///< Размер последнего снимка
+    int commitsSinceSync = 0; ///< Коммиты после последней синхронизации
+    bool pendingChanges = false; ///< Среди ожидающих записей есть не только измерения
+    bool compactionSignalled = false; ///< Сигнал уплотнения уже выдан и ещё не обработан
+    quint64 replayed = 0; ///< Восстановлено записей при открытии
+    quint64 commits = 0; ///< Выполнено коммитов
+    quint64 syncs = 0; ///< Выполнено синхронизаций
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef STATESNAPSHOT_H
+#define STATESNAPSHOT_H
+
+#include <QString>
+#include <QtGlobal>
+#include "fleetstore.h"
+#include "historyarchive.h"
+#include "samplehistory.h"
+#include "scheduleentry.h"
+
+/**
+ * @file statesnapshot.h
+ * @brief Заголовочный файл для двоичного снимка состояния.
+ *
+ * Этот файл содержит объявление структуры SnapshotSettings и класса StateSnapshot,
+ * который сохраняет и загружает состояние приложения в компактном версионированном
+ * двоичном формате.
+ */
+
+/**
+ * @struct SnapshotSettings
+ * @brief Скалярные настройки, сохраняемые в снимке.
+ *
+ * Единицы измерения, тема и скорость вентилятора хранятся числовыми идентификаторами
+ * перечислений ClimateModel::TemperatureUnit, ClimateModel::PressureUnit, ClimateModel::Theme
+ * и ClimateModel::FanSpeed.
+ */
+struct SnapshotSettings
+{
+    double temperature = 16.0; ///< Температура текущего блока
+    double humidity = 0.0; ///< Влажность текущего блока
+    double pressure = 87000.0; ///< Давление текущего блока
+    qint32 temperatureUnit = 1; ///< Единица измерения температуры
+    qint32 pressureUnit = 1; ///< Единица измерения давления
+    qint32 theme = 1; ///< Тема интерфейса
+    qint32 currentUnit = 0; ///< Номер текущего блока
+    qint32 fanSpeed = 2; ///< Скорость вентилятора
+    quint64 journalSequence = 0; ///< Последняя запись журнала, учтённая в снимке
+};
+
+/**
+ * @class StateSnapshot
+ * @brief Запись и чтение двоичного снимка состояния.
+ *
+ * Формат файла: заголовок (сигнатура, версия, метка порядка байт, количество секций),
+ * каталог секций (идентификатор, смещение, размер) и секции, выровненные по 8 байт.
+ * Колонки парка и истории хранятся как непрерывные массивы и копируются одним блоком.
+ * Файл читается через отображение в память, а записывается атомарно: во временный
+ * файл с последующим переименованием (QSaveFile), поэтому сбой во время записи
+ * не повреждает предыдущий снимок. Неизвестные секции при чтении пропускаются,
+ * что позволяет добавлять новые секции без смены версии.
+ */
+class StateSnapshot
+{
+public:
+    /**
+     * @brief Текущая версия формата.
+     */
+    static const quint32 kVersion = 1;
+
+    /**
+     * @enum Section
+     * @brief Идентификаторы секций снимка.
+     */
+    enum Section : quint32 {
+        SettingsSection = 1, ///< Скалярные настройки
+        FleetSection, ///< Колонки парка
+        HistorySection, ///< История измерений текущего блока
+        JournalSection, ///< Последний номер записи журнала изменений
+        SetpointSection, ///< Колонка уставок температуры парка
+        FanSection, ///< Скорость вентилятора
+        ScheduleSection, ///< Недельное расписание и замены дат
+        ArchiveSection ///< Блоки сжатого архива измерений текущего блока
+    };
+
+    /**
+     * @brief Записывает снимок атомарно.
+     * @param path Путь к файлу снимка.
+     * @param settings Скалярные настройки.
+     * @param fleet Состояние парка.
+     * @param history История измерений.
+     * @param schedule Расписание (nullptr — пустое).
+     * @param archive Сжатый архив измерений (nullptr — пустой).
+     * @return true, если снимок записан.
+     */
+    static bool write(const QString &path, const SnapshotSettings &settings,
+                      const FleetStore &fleet, const SampleHistory &history,
+                      const ScheduleData *schedule = nullptr, const HistoryArchive *archive = nullptr);
+
+    /**
+     * @brief Читает снимок через отображение файла в память.
+     *
+     * При ошибке выходные параметры не изменяются.
+     * @param path Путь к файлу снимка.
+     * @param settings Скалярные настройки.
+     * @param fleet Состояние парка.
+     * @param history История измерений (может быть nullptr, если история не нужна).
+     * @param schedule Расписание (может быть nullptr, если расписание не нужно).
+     * @param archive Блоки сжатого архива (может быть nullptr, если архив не нужен).
+     * @return true, если снимок прочитан.
+     */
+    static bool read(const QString &path, SnapshotSettings &settings,
+                     FleetStore &fleet, SampleHistory *history, ScheduleData *schedule = nullptr,
+                     QVector<HistoryArchive::Block> *archive = nullptr);
+
+    /**
+     * @brief Импортирует настройки из XML-файла прежнего формата.
+     *
+     * XML-файл содержит элементы Temperature, Humidity, Pressure и Theme.
+     * Парк после импорта состоит из одного блока с этими значениями.
+     * @param path Путь к XML-файлу.
+     * @param settings Скалярные настройки.
+     * @param fleet Состояние парка.
+     * @return true, если файл прочитан.
+     */
+    static bool importXml(const QString &path, SnapshotSettings &settings, FleetStore &fleet);
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef THEMEENGINE_H
+#define THEMEENGINE_H
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <QWidget>
+
+/**
+ * @file themeengine.h
+ * @brief Заголовочный файл для класса ThemeEngine.
+ *
+ * Этот файл содержит объявление палитры темы ThemePalette и класса ThemeEngine,
+ * который оформляет интерфейс одной таблицей стилей уровня приложения.
+ */
+
+/**
+ * @struct ThemePalette
+ * @brief Цвета темы для виджетов и элементов сцены.
+ */
+struct ThemePalette
+{
+    QColor background; ///< Фон окна
+    QColor foreground; ///< Текст, рамки кнопок и контуры шкал
+    QColor locked; ///< Фон заблокированных элементов управления
+    QColor temperatureFill; ///< Заливка уровня температуры
+    QColor humidityFill; ///< Заливка уровня влажности
+    QColor pressureFill; ///< Заливка уровня давления
+    QColor arrow; ///< Стрелка направления воздушного потока
+    QColor arrowGuide; ///< Неподвижные стрелки крайних положений
+    QColor arc; ///< Дуга угла направления воздушного потока
+};
+
+/**
+ * @class ThemeEngine
+ * @brief Оформление интерфейса таблицей стилей уровня приложения.
+ *
+ * Для каждой темы таблица стилей строится один раз и кэшируется; смена темы — это
+ * один вызов QApplication::setStyleSheet() вместо отдельного setStyleSheet() на
+ * каждом виджете, каждый из которых заново разбирает стиль и переполирует поддерево.
+ * Правила ограничены корневым виджетом с заданным objectName, поэтому диалоги
+ * приложения не затрагиваются.
+ *
+ * Блокировка элементов управления задаётся динамическим свойством locked, на которое
+ * ссылается таблица стилей: при изменении переполируется только сам виджет.
+ *
+ * Идентификаторы тем совпадают с ClimateModel::Theme: 1 — светлая, 2 — тёмная.
+ */
+class ThemeEngine
+{
+public:
+    /**
+     * @brief Конструктор класса ThemeEngine.
+     * @param scope objectName корневого виджета, к которому применяются правила.
+     */
+    explicit ThemeEngine(const QString &scope);
+
+    /**
+     * @brief Применяет тему ко всему приложению.
+     *
+     * Повторное применение уже действующей темы ничего не делает.
+     * @param themeId Идентификатор темы.
+     */
+    void apply(int themeId);
+
+    /**
+     * @brief Возвращает идентификатор действующей темы (0, если тема не применялась).
+     */
+    int currentTheme() const { return applied; }
+
+    /**
+     * @brief Возвращает палитру действующей темы.
+     */
+    const ThemePalette &palette() const { return current; }
+
+    /**
+     * @brief Возвращает палитру темы.
+     * @param themeId Идентификатор темы.
+     */
+    static ThemePalette paletteFor(int themeId);
+
+    /**
+     * @brief Помечает виджет заблокированным или разблокированным.
+     *
+     * Виджет переполируется, только если состояние изменилось.
+     * @param widget Виджет.
+     * @param locked Новое состояние.
+     */
+    static void setLocked(QWidget *widget, bool locked);
+
+    /**
+     * @brief Возвращает таблицу стилей темы.
+     * @param themeId Идентификатор темы.
+     */
+    const QString &styleSheet(int themeId);
+
+private:
+    QString buildStyleSheet(const ThemePalette &palette) const;
+
+    QString scope; ///< objectName корневого виджета
+    QHash<int, QString> sheets; ///< Построенные таблицы стилей по идентификатору темы
+    ThemePalette current; ///< Палитра действующей темы
+    int applied = 0; ///< Идентификатор действующей темы
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef THERMALSIMULATOR_H
+#define THERMALSIMULATOR_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file thermalsimulator.h
+ * @brief Заголовочный файл для теплового симулятора комнат.
+ *
+ * Этот файл содержит объявление структуры ThermalRoomParams и класса ThermalSimulator —
+ * модели с сосредоточенными параметрами, по которой температура и влажность комнат
+ * откликаются на питание, уставку и положение жалюзи кондиционера.
+ */
+
+/**
+ * @struct ThermalRoomParams
+ * @brief Тепловые параметры комнаты.
+ */
+struct ThermalRoomParams
+{
+    double outdoorTemperature = 30.0; ///< Температура снаружи, °C
+    double outdoorHumidity = 60.0; ///< Влажность снаружи, %
+    double thermalTimeConstant = 7200.0; ///< Постоянная времени теплообмена с улицей (R·C), с
+    double coolingTimeConstant = 600.0; ///< Постоянная времени охлаждения блоком при полном перемешивании, с
+    double humidityTimeConstant = 3600.0; ///< Постоянная времени обмена влагой с улицей, с
+    double dryingTimeConstant = 900.0; ///< Постоянная времени осушения блоком при полной нагрузке, с
+};
+
+/**
+ * @class ThermalSimulator
+ * @brief Параллельный симулятор температуры и влажности множества комнат.
+ *
+ * Каждая комната — тепловая ёмкость, связанная с улицей и с кондиционером:
+ * dT/dt = (Tнаруж − T)/τт + P·η/τохл·(Tпод − T), где Tпод — температура воздуха
+ * после испарителя, η — доля воздушного потока, перемешивающего объём комнаты
+ * (зависит от жалюзи), а P — мощность охлаждения 0..1. Мощность задаёт внешний регулятор
+ * (setControl() с неотрицательной мощностью) или встроенный пропорциональный термостат
+ * по уставке комнаты; у выключенного блока мощность 0. Шаг интегрирования (1 с) много
+ * меньше постоянных времени, поэтому явная схема Эйлера устойчива.
+ * Влажность стремится к наружной и снижается осушением пропорционально мощности.
+ *
+ * Состояние и коэффициенты хранятся структурой массивов; коэффициенты пересчитываются
+ * только при изменении параметров или управления комнаты, поэтому шаг — это несколько
+ * умножений, сложений и выборов на комнату без ветвлений, которые компилятор векторизует.
+ * Комнаты независимы: диапазон комнат делится на непрерывные части по потокам,
+ * и каждый поток проходит все шаги на своей части блоками, помещающимися в кэш.
+ * Температура — в градусах Цельсия, влажность — в процентах.
+ */
+class ThermalSimulator
+{
+public:
+    static constexpr double kStepSeconds = 1.0; ///< Шаг интегрирования модельного времени, с
+
+    /**
+     * @brief Конструктор класса ThermalSimulator.
+     * @param threads Количество потоков (0 — по числу ядер).
+     */
+    explicit ThermalSimulator(int threads = 0);
+
+    /**
+     * @brief Деструктор класса ThermalSimulator. Останавливает рабочие потоки.
+     */
+    ~ThermalSimulator();
+
+    ThermalSimulator(const ThermalSimulator &) = delete;
+    ThermalSimulator &operator=(const ThermalSimulator &) = delete;
+
+    /**
+     * @brief Возвращает количество комнат.
+     */
+    int size() const { return temperatures.size(); }
+
+    /**
+     * @brief Изменяет количество комнат. Новые комнаты получают параметры по умолчанию и выключенный блок.
+     * @param count Количество комнат.
+     * @param temperature Начальная температура новых комнат, °C.
+     * @param humidity Начальная влажность новых комнат, %.
+     */
+    void resize(int count, double temperature, double humidity);
+
+    /**
+     * @brief Задаёт тепловые параметры комнаты.
+     * @param room Номер комнаты.
+     * @param params Параметры.
+     */
+    void setRoomParams(int room, const ThermalRoomParams &params);
+
+    /**
+     * @brief Задаёт управление блоком комнаты. Коэффициенты пересчитываются, только если управление изменилось.
+     * @param room Номер комнаты.
+     * @param on Питание блока.
+     * @param setpoint Уставка температуры встроенного термостата, °C.
+     * @param hGateDir Угол горизонтальных жалюзи (0..90).
+     * @param vGateDir Угол вертикальных жалюзи (-45..45).
+     * @param capacity Мощность охлаждения 0..1 от внешнего регулятора (отрицательная — встроенный термостат).
+     */
+    void setControl(int room, bool on, double setpoint, int hGateDir, int vGateDir, double capacity = -1.0);
+
+    /**
+     * @brief Задаёт температуру и влажность комнаты.
+     * @param room Номер комнаты.
+     * @param temperature Температура, °C.
+     * @param humidity Влажность, %.
+     */
+    void setState(int room, double temperature, double humidity);
+
+    /**
+     * @brief Продвигает модельное время. Остаток меньше шага переносится на следующий вызов.
+     * @param seconds Модельное время, с.
+     * @return Количество выполненных шагов.
+     */
+    int advance(double seconds);
+
+    /**
+     * @brief Выполняет заданное количество шагов.
+     * @param steps Количество шагов.
+     */
+    void step(int steps);
+
+    /**
+     * @brief Задаёт количество потоков.
+     * @param threads Количество потоков (0 — по числу ядер).
+     */
+    void setThreadCount(int threads);
+
+    /**
+     * @brief Возвращает количество потоков.
+     */
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    double temperature(int room) const { return temperatures[room]; } ///< Температура комнаты, °C
+    double humidity(int room) const { return humidities[room]; } ///< Влажность комнаты, %
+    const double *temperatureData() const { return temperatures.constData(); } ///< Колонка температур, °C
+    const double *humidityData() const { return humidities.constData(); } ///< Колонка влажности, %
+
+    /**
+     * @brief Возвращает долю воздушного потока, перемешивающего объём комнаты.
+     *
+     * Поток, направленный прямо вперёд, перемешивает комнату лучше всего; поток в потолок,
+     * в пол или в стену — хуже.
+     * @param hGateDir Угол горизонтальных жалюзи (0..90).
+     * @param vGateDir Угол вертикальных жалюзи (-45..45).
+     */
+    static double airflowEfficiency(int hGateDir, int vGateDir);
+
+private:
+    void updateCoefficients(int room);
+    void run(int part, int steps);
+    void workerLoop(int part);
+    void startWorkers(int count);
+    void stopWorkers();
+
+    // Состояние
+    QVector<double> temperatures; ///< Температура, °C
+    QVector<double> humidities; ///< Влажность, %
+
+    // Параметры и управление
+    QVector<ThermalRoomParams> params; ///< Тепловые параметры
+    QVector<double> setpoints; ///< Уставка, °C
+    QVector<qint8> hGates; ///< Горизонтальные жалюзи
+    QVector<qint8> vGates; ///< Вертикальные жалюзи
+    QVector<quint8> powered; ///< Питание блока
+    QVector<double> capacities; ///< Мощность от внешнего регулятора (отрицательная — встроенный термостат)
+
+    // Коэффициенты шага, пересчитываемые при изменении параметров и управления
+    QVector<double> outdoor; ///< Температура снаружи, °C
+    QVector<double> leak; ///< Доля теплообмена с улицей за шаг
+    QVector<double> cooling; ///< Доля охлаждения за шаг при полной мощности
+    QVector<double> command; ///< Мощность за шаг: внешняя или отрицательная (встроенный термостат)
+    QVector<double> humidityTarget; ///< Наружная влажность, %
+    QVector<double> humidityLeak; ///< Доля обмена влагой с улицей за шаг
+    QVector<double> drying; ///< Доля осушения за шаг при полной нагрузке
+
+    double pendingSeconds = 0.0; ///< Модельное время меньше шага, перенесённое на следующий вызов
+
+    // Рабочие потоки: поток part обрабатывает часть part, вызывающий поток — часть 0
+    std::vector<std::thread> workers; ///< Рабочие потоки
+    std::mutex mutex; ///< Защита полей задания
+    std::condition_variable wake; ///< Сигнал нового задания
+    std::condition_variable done; ///< Сигнал завершения частей
+    quint64 generation = 0; ///< Номер задания
+    int stepsToRun = 0; ///< Шагов в задании
+    int pending = 0; ///< Частей задания, ещё не завершённых рабочими потоками
+    bool stopping = false; ///< Потоки завершаются
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @file timerwheel.h
+ * @brief Заголовочный файл для иерархического колеса таймеров.
+ *
+ * Этот файл содержит объявление класса TimerWheel — множества отложенных срабатываний
+ * с постановкой и отменой за O(1) независимо от количества таймеров.
+ */
+
+/**
+ * @class TimerWheel
+ * @brief Иерархическое колесо таймеров с целочисленными тактами.
+ *
+ * Четыре уровня по 256 ячеек: нулевой уровень хранит таймеры ближайших 256 тактов
+ * по одному такту на ячейку, каждый следующий — в 256 раз грубее. Когда младший
+ * уровень проходит полный оборот, ячейка старшего уровня раскладывается по младшим
+ * (каскад), так что каждый таймер переносится не больше трёх раз. Постановка
+ * и отмена — вставка и удаление из двусвязного списка ячейки.
+ *
+ * Узлы таймеров лежат в одном массиве и связаны номерами, свободные узлы переиспользуются,
+ * поэтому постановка не выделяет память, пока массив не растёт. Дескриптор таймера
+ * содержит поколение узла: отмена уже сработавшего или отменённого таймера безопасна.
+ * Непустые ячейки нулевого уровня отмечены битами, поэтому такты без срабатываний
+ * колесо пропускает целыми участками. Такты — любые целые (например, секунды).
+ */
+class TimerWheel
+{
+public:
+    /**
+     * @brief Дескриптор таймера (0 — нет таймера).
+     */
+    using Handle = quint64;
+
+    /**
+     * @struct Fired
+     * @brief Сработавший таймер.
+     */
+    struct Fired
+    {
+        Handle handle; ///< Дескриптор (уже недействителен)
+        quint32 payload; ///< Значение, заданное при постановке
+    };
+
+    static const int kLevelBits = 8; ///< Бит номера ячейки на уровне
+    static const int kSlots = 1 << kLevelBits; ///< Ячеек на уровне
+    static const int kLevels = 4; ///< Уровней (охват 2^32 тактов)
+
+    /**
+     * @brief Конструктор класса TimerWheel.
+     * @param now Текущий такт (уже обработанный).
+     */
+    explicit TimerWheel(qint64 now = 0);
+
+    /**
+     * @brief Удаляет все таймеры и переводит колесо на такт.
+     * @param now Текущий такт.
+     */
+    void reset(qint64 now);
+
+    /**
+     * @brief Ставит таймер.
+     * @param tick Такт срабатывания (не позже текущего — на следующем такте).
+     * @param payload Значение, возвращаемое при срабатывании.
+     * @return Дескриптор таймера.
+     */
+    Handle schedule(qint64 tick, quint32 payload);
+
+    /**
+     * @brief Отменяет таймер.
+     * @param handle Дескриптор.
+     * @return true, если таймер ещё не сработал и отменён.
+     */
+    bool cancel(Handle handle);
+
+    /**
+     * @brief Продвигает колесо до первого такта со срабатываниями, но не дальше limit.
+     *
+     * Сработавшие таймеры удаляются из колеса и дописываются в out; такт их срабатывания — now().
+     * @param limit Наибольший такт.
+     * @param out Вектор, в который добавляются сработавшие таймеры.
+     * @return Количество сработавших таймеров (0 — колесо дошло до limit).
+     */
+    int expire(qint64 limit, QVector<Fired> &out);
+
+    /**
+     * @brief Возвращает последний обработанный такт.
+     */
+    qint64 now() const { return nextTick - 1; }
+
+    /**
+     * @brief Возвращает количество ожидающих таймеров.
+     */
+    int size() const { return pending; }
+
+private:
+    /**
+     * @struct Node
+     * @brief Узел таймера.
+     */
+    struct Node
+    {
+        qint64 expires = 0; ///< Такт срабатывания
+        quint32 payload = 0; ///< Значение таймера
+        quint32 generation = 1; ///< Поколение узла (растёт при освобождении)
+        int prev = -1; ///< Предыдущий узел ячейки
+        int next = -1; ///< Следующий узел ячейки (или свободного списка)
+        int slot = -1; ///< Ячейка (-1 — узел свободен)
+    };
+
+    void link(int index);
+    void unlink(int index);
+    void release(int index);
+    void cascade(int level);
+    int firstOccupied(int from) const;
+
+    QVector<Node> nodes; ///< Узлы таймеров
+    int heads[kLevels * kSlots]; ///< Первые узлы ячеек (-1 — ячейка пуста)
+    quint64 occupied[kSlots / 64]; ///< Биты непустых ячеек нулевого уровня
+    int freeList = -1; ///< Первый свободный узел
+    int pending = 0; ///< Ожидающих таймеров
+    qint64 nextTick = 1; ///< Следующий необработанный такт
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TRACEDAPPLICATION_H
+#define TRACEDAPPLICATION_H
+
+#include "eventtrace.h"
+#include <QObject>
+
+/**
+ * @file tracedapplication.h
+ * @brief Заголовочный файл для приложения с трассировкой доставки событий.
+ *
+ * Этот файл содержит шаблон TracedApplication, который отмечает каждую доставку события
+ * (таймеры, отрисовка, отложенные вызовы слотов, ввод) областью трассировки EventTrace.
+ */
+
+/**
+ * @class TracedApplication
+ * @brief Приложение, доставка каждого события в котором — интервал трассировки.
+ *
+ * Интервал называется по типу события ("Timer", "Paint", "MetaCall" — вызов слота
+ * через очередь), в уточнении — класс получателя. Вызовы слотов напрямую видны
+ * как вложенные интервалы ACM_PROBE. Пока EventTrace выключен, доставка стоит одно чтение
+ * атомарной переменной.
+ * @tparam Application QCoreApplication или QApplication.
+ */
+template <class Application>
+class TracedApplication : public Application
+{
+public:
+    /**
+     * @brief Конструктор класса TracedApplication.
+     * @param argc Количество аргументов командной строки.
+     * @param argv Массив аргументов командной строки.
+     */
+    TracedApplication(int &argc, char **argv)
+        : Application(argc, argv) {}
+
+    /**
+     * @brief Доставляет событие получателю внутри области трассировки.
+     * @param receiver Получатель.
+     * @param event Событие.
+     */
+    bool notify(QObject *receiver, QEvent *event) override {
+        if (EventTrace::mode() == 0 || !receiver) {
+            return Application::notify(receiver, event);
+        }
+        const TraceScope scope("event", EventTrace::eventName(event->type()),
+                               receiver->metaObject()->className(), EventTrace::now());
+        return Application::notify(receiver, event);
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TRACEREPLAYER_H
+#define TRACEREPLAYER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "climatemodel.h"
+#include "inputtrace.h"
+
+/**
+ * @file tracereplayer.h
+ * @brief Заголовочный файл для воспроизведения записи входных воздействий.
+ *
+ * Этот файл содержит объявление класса TraceReplayer, который передаёт события
+ * записи InputTraceWriter в ClimateModel в реальном времени, с ускорением или без пауз.
+ */
+
+/**
+ * @class TraceReplayer
+ * @brief Воспроизведение записанных измерений и действий пользователя.
+ *
+ * Перед первым событием модели задаётся начальное состояние из заголовка записи.
+ * Идущие подряд измерения передаются одним пакетом через ClimateModel::acceptBatch(),
+ * действия — вызовом тех же слотов модели, что и при записи, поэтому повтор проходит
+ * через журнал, регулятор и отображение так же, как исходный сеанс.
+ *
+ * При ускорении больше нуля события выдаются по таймеру в момент, соответствующий их
+ * времени в записи, делённому на ускорение. При ускорении 0 события выдаются без пауз
+ * порциями, между которыми обрабатывается цикл событий; runToEnd() воспроизводит всё
+ * синхронно и годится как воспроизводимый нагрузочный тест модели.
+ */
+class TraceReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса TraceReplayer.
+     * @param model Модель состояния.
+     * @param parent Родительский объект.
+     */
+    explicit TraceReplayer(ClimateModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief Открывает файл записи.
+     * @param path Путь к файлу.
+     * @return true, если файл прочитан и заголовок корректен.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Открывает запись из буфера в памяти.
+     * @param data Содержимое файла записи.
+     * @return true, если заголовок корректен.
+     */
+    bool openData(const QByteArray &data);
+
+    /**
+     * @brief Запускает воспроизведение по таймеру.
+     * @param factor Ускорение относительно записи (0 — без пауз).
+     */
+    void start(double factor = 1.0);
+
+    /**
+     * @brief Останавливает воспроизведение.
+     */
+    void stop();
+
+    /**
+     * @brief Воспроизводит запись от начала до конца без пауз, не возвращаясь в цикл событий.
+     * @return Количество воспроизведённых событий.
+     */
+    quint64 runToEnd();
+
+    /**
+     * @brief Возвращает true, если воспроизведение идёт.
+     */
+    bool isRunning() const { return timer.isActive(); }
+
+    quint64 replayedEvents() const { return events; } ///< Воспроизведено событий
+    quint64 replayedSamples() const { return samples; } ///< Воспроизведено измерений
+    qint64 elapsedNs() const { return elapsed; } ///< Время воспроизведения, нс
+    const InputTraceReader &trace() const { return reader; } ///< Читаемая запись
+
+signals:
+    /**
+     * @brief Сигнал о завершении воспроизведения (конец записи или повреждённое событие).
+     */
+    void finished();
+
+private slots:
+    void tick();
+
+private:
+    void begin();
+    bool step(qint64 untilUs, int maxEvents);
+    void apply(const TraceEvent &event);
+    void flushBatch();
+    void finish();
+
+    ClimateModel *model; ///< Модель состояния
+    InputTraceReader reader; ///< Читаемая запись
+    QTimer timer; ///< Таймер порций воспроизведения
+    QElapsedTimer clock; ///< Время от начала воспроизведения
+    QVector<SensorSample> batch; ///< Идущие подряд измерения
+    TraceEvent pending; ///< Прочитанное, но ещё не наступившее событие
+    bool hasPending = false; ///< Событие pending прочитано
+    double speed = 1.0; ///< Ускорение (0 — без пауз)
+    quint64 events = 0; ///< Воспроизведено событий
+    quint64 samples = 0; ///< Воспроизведено измерений
+    qint64 elapsed = 0; ///< Время воспроизведения, нс
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TRENDCHART_H
+#define TRENDCHART_H
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QLineF>
+#include <QVector>
+#include "samplehistory.h"
+
+/**
+ * @file trendchart.h
+ * @brief Заголовочный файл для класса TrendChartItem.
+ *
+ * Этот файл содержит объявление элемента сцены, рисующего график истории
+ * температуры, влажности и давления.
+ */
+
+/**
+ * @class TrendChartItem
+ * @brief Элемент сцены с графиком истории измерений.
+ *
+ * Каждый канал перед отрисовкой прореживается функцией minMaxDecimate() до одного
+ * интервала на пиксель ширины графика, поэтому отрисовка суток данных с частотой 1 Гц
+ * стоит примерно столько же, сколько отрисовка ширины графика в пикселях. Каналы
+ * нормируются каждый в свой диапазон и рисуются цветами соответствующих шкал.
+ */
+class TrendChartItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Конструктор класса TrendChartItem.
+     * @param history История измерений.
+     * @param width Ширина графика в пикселях.
+     * @param height Высота графика в пикселях.
+     * @param parent Родительский элемент.
+     */
+    TrendChartItem(const SampleHistory *history, int width, int height, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    /**
+     * @brief Задаёт диапазон отображения канала.
+     * @param channel Канал.
+     * @param min Значение у нижнего края графика.
+     * @param max Значение у верхнего края графика.
+     */
+    void setRange(SampleHistory::Channel channel, double min, double max);
+
+    /**
+     * @brief Задаёт цвет линии канала.
+     * @param channel Канал.
+     * @param color Цвет.
+     */
+    void setChannelColor(SampleHistory::Channel channel, const QColor &color);
+
+    /**
+     * @brief Задаёт цвет рамки графика.
+     * @param color Цвет.
+     */
+    void setFrameColor(const QColor &color);
+
+    /**
+     * @brief Задаёт максимальную длительность отображаемого отрезка.
+     * @param spanUs Длительность в микросекундах.
+     */
+    void setMaxSpan(qint64 spanUs);
+
+private:
+    const SampleHistory *history; ///< История измерений
+    int width; ///< Ширина графика
+    int height; ///< Высота графика
+    qint64 maxSpanUs; ///< Максимальная длительность отображаемого отрезка
+    double rangeMin[SampleHistory::ChannelCount]; ///< Нижняя граница диапазона канала
+    double rangeMax[SampleHistory::ChannelCount]; ///< Верхняя граница диапазона канала
+    QColor colors[SampleHistory::ChannelCount]; ///< Цвета каналов
+    QColor frameColor; ///< Цвет рамки
+
+    QVector<MinMaxBucket> buckets; ///< Буфер прореживания (переиспользуется между кадрами)
+    QVector<QLineF> lines; ///< Буфер отрезков (переиспользуется между кадрами)
+};
+
+#endif
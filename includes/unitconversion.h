@@ -0,0 +1,102 @@
+#ifndef UNITCONVERSION_H
+#define UNITCONVERSION_H
+
+#include <QtGlobal>
+
+/**
+ * @file unitconversion.h
+ * @brief Заголовочный файл для ядра пересчёта единиц измерения.
+ *
+ * Этот файл содержит объявление класса UnitConversion, который переводит
+ * значения температуры (C, F, K) и давления (Па, мм рт. ст.) целыми массивами.
+ */
+
+/**
+ * @class UnitConversion
+ * @brief Табличный пересчёт единиц измерения для массивов значений.
+ *
+ * Любой перевод между единицами одной величины — аффинное преобразование
+ * y = (x + pre) * scale + post. Коэффициенты для всех пар единиц собраны в таблицы,
+ * поэтому пересчёт массива — один проход без ветвлений. Форма с двумя сдвигами
+ * повторяет прежние формулы (например, (F - 32) * 5/9); единственное отличие —
+ * деление на 133.3224 при переводе Па в мм рт. ст. заменено умножением на обратное
+ * значение (расхождение не больше одной единицы последнего разряда).
+ *
+ * Массивы обрабатываются векторными инструкциями SSE2 (x86) или NEON (AArch64)
+ * по четыре значения за итерацию; на остальных платформах используется скалярный цикл.
+ * На x86 векторный и скалярный пути дают одинаковый результат бит в бит.
+ *
+ * Идентификаторы единиц совпадают с ClimateModel::TemperatureUnit (1 — C, 2 — F, 3 — K)
+ * и ClimateModel::PressureUnit (1 — Па, 2 — мм рт. ст.).
+ */
+class UnitConversion
+{
+public:
+    /**
+     * @struct Affine
+     * @brief Коэффициенты аффинного преобразования y = (x + pre) * scale + post.
+     */
+    struct Affine
+    {
+        double pre; ///< Сдвиг до масштабирования
+        double scale; ///< Масштаб
+        double post; ///< Сдвиг после масштабирования
+    };
+
+    /**
+     * @brief Возвращает преобразование между единицами температуры.
+     * @param from Исходная единица.
+     * @param to Целевая единица.
+     * @return Преобразование; для неизвестных единиц — тождественное.
+     */
+    static Affine temperature(int from, int to);
+
+    /**
+     * @brief Возвращает преобразование между единицами давления.
+     * @param from Исходная единица.
+     * @param to Целевая единица.
+     * @return Преобразование; для неизвестных единиц — тождественное.
+     */
+    static Affine pressure(int from, int to);
+
+    /**
+     * @brief Возвращает true, если преобразование тождественное.
+     * @param affine Преобразование.
+     */
+    static bool isIdentity(const Affine &affine) {
+        return affine.pre == 0.0 && affine.scale == 1.0 && affine.post == 0.0;
+    }
+
+    /**
+     * @brief Пересчитывает одно значение.
+     * @param affine Преобразование.
+     * @param value Значение.
+     * @return Пересчитанное значение.
+     */
+    static double apply(const Affine &affine, double value) {
+        return (value + affine.pre) * affine.scale + affine.post;
+    }
+
+    /**
+     * @brief Пересчитывает массив на месте векторными инструкциями.
+     * @param affine Преобразование.
+     * @param data Массив значений.
+     * @param count Количество значений.
+     */
+    static void apply(const Affine &affine, double *data, qint64 count);
+
+    /**
+     * @brief Пересчитывает массив на месте скалярным циклом.
+     * @param affine Преобразование.
+     * @param data Массив значений.
+     * @param count Количество значений.
+     */
+    static void applyScalar(const Affine &affine, double *data, qint64 count);
+
+    /**
+     * @brief Возвращает название набора инструкций, используемого apply().
+     */
+    static const char *backend();
+};
+
+#endif
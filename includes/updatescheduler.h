@@ -0,0 +1,91 @@
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include <QObject>
+
+class FrameClock;
+
+/**
+ * @file updatescheduler.h
+ * @brief Заголовочный файл для планировщика обновлений сцены.
+ *
+ * Этот файл содержит объявление класса UpdateScheduler, который накапливает изменения
+ * модели в виде битов изменённых полей и применяет их к сцене один раз за кадр.
+ */
+
+/**
+ * @class UpdateScheduler
+ * @brief Объединение изменений модели в одно обновление сцены за кадр.
+ *
+ * Изменение модели помечает поля (markDirty()), а в ближайшем кадре часов FrameClock
+ * сигнал updatesReady() передаёт объединение всех помеченных с прошлого кадра полей.
+ * Сколько бы изменений ни пришло за кадр, сцена обновляется один раз и только в
+ * изменённых частях. Счётчики позволяют проверить объединение под нагрузкой.
+ */
+class UpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса UpdateScheduler.
+     * @param clock Часы кадров.
+     * @param parent Родительский объект.
+     */
+    explicit UpdateScheduler(FrameClock *clock, QObject *parent = nullptr);
+
+    /**
+     * @brief Помечает поля изменёнными и запрашивает кадр.
+     * @param fields Биты полей.
+     */
+    void markDirty(quint32 fields);
+
+    /**
+     * @brief Возвращает поля, ожидающие применения.
+     */
+    quint32 pendingFields() const { return dirty; }
+
+    /**
+     * @brief Немедленно применяет ожидающие изменения, не дожидаясь кадра.
+     */
+    void flushNow();
+
+    /**
+     * @brief Возвращает количество запросов на обновление (вызовов markDirty()).
+     */
+    quint64 requestedUpdates() const { return requested; }
+
+    /**
+     * @brief Возвращает количество запросов, объединённых с уже ожидающим обновлением.
+     */
+    quint64 coalescedUpdates() const { return coalesced; }
+
+    /**
+     * @brief Возвращает количество применённых обновлений сцены.
+     */
+    quint64 appliedUpdates() const { return applied; }
+
+    /**
+     * @brief Сбрасывает счётчики.
+     */
+    void resetCounters();
+
+signals:
+    /**
+     * @brief Сигнал применения изменений.
+     * @param fields Биты полей, изменённых с прошлого применения.
+     */
+    void updatesReady(quint32 fields);
+
+private slots:
+    void onFrame();
+
+private:
+    FrameClock *clock; ///< Часы кадров
+    quint32 dirty = 0; ///< Изменённые поля
+    quint64 requested = 0; ///< Запросов на обновление
+    quint64 coalesced = 0; ///< Объединённых запросов
+    quint64 applied = 0; ///< Применённых обновлений
+};
+
+#endif
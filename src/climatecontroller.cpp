@@ -0,0 +1,199 @@
+#include "../includes/climatecontroller.h"
+#include <algorithm>
+#include <chrono>
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @file climatecontroller.cpp
+ * @brief Реализация класса ClimateController.
+ *
+ * Этот файл содержит реализацию законов регулирования и цикла потока регулятора
+ * с абсолютным расписанием тактов и статистикой опозданий.
+ */
+
+namespace {
+
+/**
+ * @brief Пытается поднять приоритет текущего потока до реального времени.
+ *
+ * Без прав (CAP_SYS_NICE) приоритет не меняется, и поток работает с обычным приоритетом.
+ */
+void raisePriority() {
+#ifdef Q_OS_UNIX
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+/**
+ * @brief Возвращает процентиль опоздания по гистограмме (верхняя граница корзины).
+ */
+qint64 histogramPercentile(const quint64 *buckets, quint64 total, double p, qint64 maxNs) {
+    const quint64 rank = static_cast<quint64>(p / 100.0 * total + 0.999999);
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < ClimateController::kHistogramBuckets; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return qMin(maxNs, (bucket + 1) * ClimateController::kBucketNs);
+        }
+    }
+    return maxNs; // Процентиль в последней, открытой сверху корзине
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ClimateController.
+ */
+ClimateController::ClimateController()
+    : input(pendingSettings)
+{
+}
+
+/**
+ * @brief Деструктор класса ClimateController.
+ */
+ClimateController::~ClimateController() {
+    stop();
+}
+
+/**
+ * @brief Запускает поток регулятора.
+ * @param period Период тактов, нс.
+ */
+void ClimateController::start(qint64 period) {
+    stop();
+    periodNs = qMax<qint64>(1000, period);
+    stopping = false;
+    thread = std::thread(&ClimateController::run, this);
+}
+
+/**
+ * @brief Останавливает поток регулятора.
+ */
+void ClimateController::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopSignal.notify_all();
+    thread.join();
+}
+
+/**
+ * @brief Передаёт регулятору новые настройки и входы.
+ * @param settings Настройки.
+ */
+void ClimateController::setSettings(const ControllerSettings &settings) {
+    pendingSettings = settings;
+    input.store(settings);
+}
+
+/**
+ * @brief Выполняет один шаг закона регулирования.
+ *
+ * Двухпозиционный закон включает компрессор, когда температура выше уставки больше чем
+ * на половину зоны, и выключает, когда ниже больше чем на половину зоны; внутри зоны
+ * состояние сохраняется. ПИД считает мощность по рассогласованию; интеграл ограничен
+ * диапазоном мощности, чтобы не накапливаться, пока выход в насыщении, а дифференциальная
+ * составляющая берётся по измерению, чтобы смена уставки не давала скачка.
+ * @param settings Настройки и входы.
+ * @param previous Состояние после прошлого такта.
+ * @param dt Период, с.
+ * @return Новое состояние.
+ */
+ControllerState ClimateController::compute(const ControllerSettings &settings, const ControllerState &previous, double dt) {
+    ControllerState state = previous;
+    state.tick = previous.tick + 1;
+    state.setpoint = settings.setpoint;
+    state.measured = settings.measured;
+    state.error = settings.measured - settings.setpoint;
+    state.mode = settings.mode;
+
+    if (!settings.enabled) {
+        state.output = 0.0;
+        state.integral = 0.0;
+        state.compressorOn = 0;
+        return state;
+    }
+
+    if (settings.mode == ControllerSettings::Pid) {
+        const bool continued = previous.mode == ControllerSettings::Pid && previous.tick > 0;
+        state.integral = std::min(std::max(continued ? previous.integral + settings.ki * state.error * dt : 0.0, 0.0), 1.0);
+        const double derivative = continued ? settings.kd * (settings.measured - previous.measured) / dt : 0.0;
+        state.output = std::min(std::max(settings.kp * state.error + state.integral + derivative, 0.0), 1.0);
+        state.compressorOn = state.output > 0.0;
+    } else {
+        if (state.error > settings.band) {
+            state.compressorOn = 1;
+        } else if (state.error < -settings.band) {
+            state.compressorOn = 0;
+        }
+        state.output = state.compressorOn ? 1.0 : 0.0;
+        state.integral = 0.0;
+    }
+    return state;
+}
+
+/**
+ * @brief Цикл потока регулятора.
+ *
+ * Поток ждёт момента очередного такта по абсолютному расписанию, измеряет опоздание,
+ * выполняет закон регулирования на последних настройках и публикует состояние и статистику.
+ * В цикле нет выделений памяти и блокировок, которые мог бы удерживать поток интерфейса.
+ */
+void ClimateController::run() {
+    using Clock = std::chrono::steady_clock;
+    raisePriority();
+
+    const std::chrono::nanoseconds period(periodNs);
+    const double dt = periodNs / 1e9;
+    const Clock::time_point origin = Clock::now();
+    quint64 slot = 0;
+
+    quint64 buckets[kHistogramBuckets] = {};
+    JitterStats stats;
+    double sumNs = 0.0;
+    ControllerState state = published.load();
+
+    std::unique_lock<std::mutex> lock(stopMutex);
+    for (;;) {
+        ++slot;
+        const Clock::time_point deadline = origin + period * slot;
+        if (stopSignal.wait_until(lock, deadline, [this]() { return stopping; })) {
+            return;
+        }
+
+        const qint64 lateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - deadline).count();
+        if (lateNs >= periodNs) {
+            const quint64 missed = static_cast<quint64>(lateNs / periodNs);
+            stats.overruns += missed;
+            slot += missed; // Пропущенные такты не навёрстываются
+        }
+
+        if (resetRequested.exchange(false, std::memory_order_relaxed)) {
+            std::fill(buckets, buckets + kHistogramBuckets, 0);
+            stats = JitterStats();
+            sumNs = 0.0;
+        }
+        const qint64 late = qMax<qint64>(0, lateNs);
+        ++buckets[qMin<qint64>(late / kBucketNs, kHistogramBuckets - 1)];
+        stats.minNs = stats.ticks == 0 ? late : qMin(stats.minNs, late);
+        stats.maxNs = qMax(stats.maxNs, late);
+        ++stats.ticks;
+        sumNs += late;
+        stats.meanNs = sumNs / stats.ticks;
+        stats.p99Ns = histogramPercentile(buckets, stats.ticks, 99.0, stats.maxNs);
+
+        state = compute(input.load(), state, dt);
+        published.store(state);
+        publishedJitter.store(stats);
+    }
+}
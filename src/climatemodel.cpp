@@ -0,0 +1,1041 @@
+#include "../includes/climatemodel.h"
+#include "../includes/statesnapshot.h"
+#include "../includes/latencyprobe.h"
+#include "../includes/unitconversion.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+
+/**
+ * @file climatemodel.cpp
+ * @brief Реализация класса ClimateModel.
+ *
+ * Этот файл содержит реализацию состояния и управления парком кондиционеров,
+ * его сохранения в снимок и восстановления по журналу изменений.
+ */
+
+namespace {
+
+const qint64 kHistoryResolutionUs = 1000000; ///< Шаг записи истории (1 Гц)
+const char *const kSnapshotFile = "user_settings.bin"; ///< Файл двоичного снимка состояния по умолчанию
+
+/**
+ * @brief Возвращает путь к файлу рядом со снимком с тем же именем и другим расширением.
+ */
+QString siblingPath(const QString &snapshotPath, const char *suffix) {
+    const QFileInfo info(snapshotPath);
+    return info.dir().filePath(info.completeBaseName() + suffix);
+}
+
+/**
+ * @brief Упаковывает дни, минуту, действие, жалюзи и питание записи расписания в одно значение журнала.
+ *
+ * Поля занимают 38 бит и представляются double без потерь.
+ */
+double packSchedule(const ScheduleEntry &entry) {
+    const quint64 packed = quint64(entry.days) | quint64(entry.minute) << 7 | quint64(entry.action & 0x7) << 18
+        | quint64(entry.hGate + 128) << 21 | quint64(entry.vGate + 128) << 29 | quint64(entry.power & 0x1) << 37;
+    return static_cast<double>(packed);
+}
+
+/**
+ * @brief Восстанавливает запись расписания из записи журнала ScheduleAdd.
+ */
+ScheduleEntry unpackSchedule(const JournalRecord &record) {
+    const quint64 packed = static_cast<quint64>(record.values[1]);
+    ScheduleEntry entry;
+    entry.id = static_cast<quint32>(record.values[0]);
+    entry.unit = static_cast<qint32>(record.unit);
+    entry.days = static_cast<quint8>(packed & 0x7F);
+    entry.minute = static_cast<quint16>((packed >> 7) & 0x7FF);
+    entry.action = static_cast<quint8>((packed >> 18) & 0x7);
+    entry.hGate = static_cast<qint8>(static_cast<int>((packed >> 21) & 0xFF) - 128);
+    entry.vGate = static_cast<qint8>(static_cast<int>((packed >> 29) & 0xFF) - 128);
+    entry.power = static_cast<qint8>((packed >> 37) & 0x1);
+    entry.setpoint = record.values[2];
+    return entry;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ClimateModel.
+ *
+ * До загрузки парк состоит из одного блока с базовыми настройками.
+ * @param parent Родительский объект.
+ */
+ClimateModel::ClimateModel(QObject *parent)
+    : QObject(parent)
+{
+    stateJournal = new StateJournal(this);
+    connect(stateJournal, &StateJournal::compactionRequested, this, &ClimateModel::compact);
+    connect(stateJournal, &StateJournal::journalError, this, [](const QString &message) {
+        qWarning() << "Ошибка журнала изменений:" << message;
+    });
+    bus = new StateBus(this);
+    climateScheduler = new ClimateScheduler(this);
+    climateScheduler->setHandler([this](const ScheduleEntry &entry) { applyScheduleEntry(entry); });
+    connect(this, &ClimateModel::changed, this, &ClimateModel::syncController);
+    connect(this, &ClimateModel::changed, this, &ClimateModel::publishDelta);
+    resetToDefaults();
+    syncController();
+}
+
+/**
+ * @brief Деструктор класса ClimateModel.
+ *
+ * При штатном завершении уплотняет журнал изменений в снимок.
+ */
+ClimateModel::~ClimateModel() {
+    climateController.stop();
+    climateScheduler->stop();
+    if (stateJournal->isOpen()) {
+        compact();
+        stateJournal->close();
+    }
+}
+
+/**
+ * @brief Возвращает начальное состояние для новой записи входных воздействий.
+ */
+TraceInitialState ClimateModel::traceState() const {
+    TraceInitialState state;
+    state.fleetSize = fleetStore.size();
+    state.currentUnit = current;
+    state.temperatureUnit = static_cast<qint32>(tempUnit);
+    state.pressureUnit = static_cast<qint32>(presUnit);
+    state.on = isOn() ? 1 : 0;
+    state.hGateDir = hGateDir();
+    state.vGateDir = vGateDir();
+    state.setpoint = setpoint();
+    return state;
+}
+
+/**
+ * @brief Возвращает путь к снимку состояния по умолчанию.
+ */
+QString ClimateModel::defaultSnapshotPath() {
+    return kSnapshotFile;
+}
+
+/**
+ * @brief Загружает состояние из двоичного снимка и журнала изменений.
+ *
+ * Если снимка нет, однократно импортируются настройки из XML-файла прежнего формата
+ * и сразу сохраняются в снимок. Если недоступно и то и другое, загружаются базовые настройки.
+ * Затем поверх снимка применяются записи журнала, сделанные после его записи.
+ * @param snapshotPath Путь к файлу снимка.
+ * @param deferHistory true — историю измерений не читать до вызова loadHistory().
+ */
+void ClimateModel::load(const QString &snapshotPath, bool deferHistory) {
+    ACM_PROBE("ClimateModel::load");
+    emit fleetAboutToResize();
+
+    this->snapshotPath = snapshotPath;
+    const QString journalPath = siblingPath(snapshotPath, ".journal");
+    const QString legacyPath = siblingPath(snapshotPath, ".xml");
+
+    SnapshotSettings settings;
+    ScheduleData schedule;
+    QVector<HistoryArchive::Block> archived;
+    resetHistory();
+    bool loaded = StateSnapshot::read(snapshotPath, settings, fleetStore, deferHistory ? nullptr : &samples, &schedule,
+                                      deferHistory ? nullptr : &archived);
+    historyDeferred = loaded && deferHistory; // Сбрасывается, если журнал выберет другой блок
+    if (!loaded && StateSnapshot::importXml(legacyPath, settings, fleetStore)) {
+        loaded = true;
+        StateSnapshot::write(snapshotPath, settings, fleetStore, samples); // Однократный перенос в двоичный формат
+    }
+    if (!loaded || fleetStore.size() == 0) {
+        resetToDefaults();
+        settings.journalSequence = 0;
+    } else {
+        tempUnit = settings.temperatureUnit >= 1 && settings.temperatureUnit <= 3
+            ? static_cast<TemperatureUnit>(settings.temperatureUnit) : TemperatureUnit::Celsius;
+        presUnit = settings.pressureUnit == 2 ? PressureUnit::Mmhg : PressureUnit::Pascal;
+        currentTheme = settings.theme == 2 ? Theme::Dark : Theme::Light;
+        currentFanSpeed = settings.fanSpeed >= 1 && settings.fanSpeed <= 3
+            ? static_cast<FanSpeed>(settings.fanSpeed) : FanSpeed::Medium;
+        current = qBound(0, static_cast<int>(settings.currentUnit), fleetStore.size() - 1);
+    }
+    if (!historyDeferred) {
+        restoreArchive(archived); // До журнала: история ещё в единицах снимка
+    }
+    climateScheduler->assign(schedule);
+    stateJournal->setSnapshotSize(QFileInfo(snapshotPath).size());
+
+    // Восстановление изменений, сделанных после записи снимка
+    bool opened = stateJournal->open(journalPath, settings.journalSequence, [this](const JournalRecord &record) {
+        applyJournalRecord(record);
+    });
+    if (!opened) {
+        qWarning() << "Не удалось открыть журнал изменений" << journalPath;
+    }
+
+    emit fleetResized();
+    emit changed(AllChanged);
+}
+
+/**
+ * @brief Сохраняет состояние в двоичный снимок.
+ *
+ * Сохраняет показания текущего блока, единицы измерения, тему интерфейса, скорость вентилятора, состояние
+ * всех блоков парка, историю измерений текущего блока и её сжатый архив, недельное расписание
+ * и номер последней записи журнала, учтённой в снимке. Запись атомарна.
+ * @param snapshotPath Путь к файлу снимка.
+ * @return true, если снимок записан.
+ */
+bool ClimateModel::save(const QString &snapshotPath) {
+    loadHistory(); // Снимок заменяет файл, из которого ещё не прочитана история
+
+    SnapshotSettings settings;
+    settings.temperature = temperature();
+    settings.humidity = humidity();
+    settings.pressure = pressure();
+    settings.temperatureUnit = static_cast<qint32>(tempUnit);
+    settings.pressureUnit = static_cast<qint32>(presUnit);
+    settings.theme = static_cast<qint32>(currentTheme);
+    settings.fanSpeed = static_cast<qint32>(currentFanSpeed);
+    settings.currentUnit = current;
+    settings.journalSequence = stateJournal->lastSequence();
+    const ScheduleData schedule = climateScheduler->data();
+
+    if (!StateSnapshot::write(snapshotPath, settings, fleetStore, samples, &schedule, &longTerm)) {
+        qWarning() << "Не удалось сохранить настройки в" << snapshotPath;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Читает историю измерений, отложенную при load().
+ *
+ * Снимок читается повторно только ради секции истории; значения переводятся из единиц
+ * снимка в текущие (журнал мог сменить единицы). Измерения, принятые после загрузки,
+ * добавляются после прочитанных, если они новее на шаг истории.
+ */
+void ClimateModel::loadHistory() {
+    if (!historyDeferred) {
+        return;
+    }
+    historyDeferred = false;
+    ACM_PROBE("ClimateModel::loadHistory");
+
+    SnapshotSettings settings;
+    FleetStore fleet;
+    SampleHistory loaded(samples.capacity());
+    QVector<HistoryArchive::Block> archived;
+    if (!StateSnapshot::read(snapshotPath, settings, fleet, &loaded, nullptr, &archived)) {
+        return;
+    }
+    const int tempId = settings.temperatureUnit >= 1 && settings.temperatureUnit <= 3 ? settings.temperatureUnit : 1;
+    const int presId = settings.pressureUnit == 2 ? 2 : 1;
+    UnitConversion::apply(UnitConversion::temperature(tempId, static_cast<int>(tempUnit)),
+                          loaded.channel(SampleHistory::Temperature).rawData(), loaded.size());
+    UnitConversion::apply(UnitConversion::pressure(presId, static_cast<int>(presUnit)),
+                          loaded.channel(SampleHistory::Pressure).rawData(), loaded.size());
+
+    for (int i = 0; i < samples.size(); ++i) {
+        const qint64 ts = samples.timestampAt(i);
+        if (loaded.size() == 0 || ts >= loaded.lastTimestamp() + kHistoryResolutionUs) {
+            loaded.append(ts, samples.valueAt(SampleHistory::Temperature, i), samples.valueAt(SampleHistory::Humidity, i),
+                          samples.valueAt(SampleHistory::Pressure, i));
+        }
+    }
+    samples = loaded;
+    restoreArchive(archived);
+    emit changed(HistoryChanged);
+}
+
+/**
+ * @brief Восстанавливает сжатый архив из блоков снимка и дописывает измерения истории новее архива.
+ *
+ * Снимок без секции архива даёт пустой список блоков, и архив строится из истории целиком.
+ * История должна быть в текущих единицах: в архив значения попадают в градусах Цельсия и Паскалях.
+ * @param saved Блоки архива из снимка.
+ */
+void ClimateModel::restoreArchive(const QVector<HistoryArchive::Block> &saved) {
+    longTerm.restore(saved);
+    const bool empty = longTerm.blockCount() == 0;
+    const qint64 lastUs = empty ? 0 : longTerm.block(longTerm.blockCount() - 1).lastTimestampUs;
+    for (int i = 0; i < samples.size(); ++i) {
+        const qint64 ts = samples.timestampAt(i);
+        if (empty || ts > lastUs) {
+            longTerm.append(ts,
+                            convertTemperature(samples.valueAt(SampleHistory::Temperature, i), tempUnit, TemperatureUnit::Celsius),
+                            samples.valueAt(SampleHistory::Humidity, i),
+                            convertPressure(samples.valueAt(SampleHistory::Pressure, i), presUnit, PressureUnit::Pascal));
+        }
+    }
+}
+
+/**
+ * @brief Уплотняет журнал изменений в снимок.
+ *
+ * Журнал очищается только после успешной записи снимка: если сбой произойдёт между
+ * записью снимка и очисткой, записи журнала с номерами из снимка будут пропущены при восстановлении.
+ */
+void ClimateModel::compact() {
+    if (snapshotPath.isEmpty()) {
+        return;
+    }
+    if (save(snapshotPath)) {
+        stateJournal->truncate();
+        stateJournal->setSnapshotSize(QFileInfo(snapshotPath).size());
+    }
+}
+
+/**
+ * @brief Возвращает минимально допустимую температуру для текущей единицы измерения.
+ */
+double ClimateModel::minTemperature() const {
+    switch (tempUnit) {
+        case TemperatureUnit::Celsius:
+            return -10; // Минимальная температура в Цельсиях
+        case TemperatureUnit::Fahrenheit:
+            return 14; // Минимальная температура в Фаренгейтах
+        case TemperatureUnit::Kelvin:
+            return 263.15; // Минимальная температура в Кельвинах
+        default:
+            return 0.0; // Значение по умолчанию
+    }
+}
+
+/**
+ * @brief Возвращает максимально допустимую температуру для текущей единицы измерения.
+ */
+double ClimateModel::maxTemperature() const {
+    switch (tempUnit) {
+        case TemperatureUnit::Celsius:
+            return 30.0; // Максимальная температура в Цельсиях
+        case TemperatureUnit::Fahrenheit:
+            return 86; // Максимальная температура в Фаренгейтах
+        case TemperatureUnit::Kelvin:
+            return 303.15; // Максимальная температура в Кельвинах
+        default:
+            return 30.0; // Значение по умолчанию
+    }
+}
+
+/**
+ * @brief Возвращает минимальное давление для текущей единицы измерения.
+ */
+double ClimateModel::minPressure() const {
+    switch (presUnit) {
+        case PressureUnit::Pascal:
+            return 87000.0; // Минимальное давление в Паскалях
+        case PressureUnit::Mmhg:
+            return 652.0; // Минимальное давление в мм рт. ст.
+        default:
+            return 87000.0; // Значение по умолчанию
+    }
+}
+
+/**
+ * @brief Возвращает максимальное давление для текущей единицы измерения.
+ */
+double ClimateModel::maxPressure() const {
+    switch (presUnit) {
+        case PressureUnit::Pascal:
+            return 108500.0; // Максимальное давление в Паскалях
+        case PressureUnit::Mmhg:
+            return 814.0; // Максимальное давление в мм рт. ст.
+        default:
+            return 108500.0; // Значение по умолчанию
+    }
+}
+
+/**
+ * @brief Возвращает шаг изменения температуры кнопками.
+ */
+double ClimateModel::temperatureStep() const {
+    return tempUnit == TemperatureUnit::Fahrenheit ? 1.8 : 1.0;
+}
+
+/**
+ * @brief Возвращает обозначение единицы температуры.
+ * @param id Единица.
+ */
+QString ClimateModel::temperatureScale(TemperatureUnit id) {
+    switch (id) {
+        case TemperatureUnit::Celsius:
+            return "C";
+        case TemperatureUnit::Fahrenheit:
+            return "F";
+        case TemperatureUnit::Kelvin:
+            return "K";
+    }
+
+    return "Unknown";
+}
+
+/**
+ * @brief Возвращает обозначение единицы давления.
+ * @param id Единица.
+ */
+QString ClimateModel::pressureScale(PressureUnit id) {
+    switch (id) {
+        case PressureUnit::Pascal:
+            return "Pa";
+        case PressureUnit::Mmhg:
+            return "mm.h.g.";
+    }
+
+    return "Unknown";
+}
+
+/**
+ * @brief Переводит значение температуры из одной единицы измерения в другую.
+ * @param value Значение.
+ * @param from Исходная единица.
+ * @param to Целевая единица.
+ */
+double ClimateModel::convertTemperature(double value, TemperatureUnit from, TemperatureUnit to) {
+    return UnitConversion::apply(UnitConversion::temperature(static_cast<int>(from), static_cast<int>(to)), value);
+}
+
+/**
+ * @brief Переводит значение давления из одной единицы измерения в другую.
+ * @param value Значение.
+ * @param from Исходная единица.
+ * @param to Целевая единица.
+ */
+double ClimateModel::convertPressure(double value, PressureUnit from, PressureUnit to) {
+    return UnitConversion::apply(UnitConversion::pressure(static_cast<int>(from), static_cast<int>(to)), value);
+}
+
+/**
+ * @brief Принимает измерение.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void ClimateModel::acceptReading(double temperature, double humidity, double pressure) {
+    const qint64 timestampUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+    if (recorder) {
+        const SensorSample sample{ timestampUs, temperature, humidity, pressure };
+        recorder->writeSamples(&sample, 1);
+    }
+    recordHistory(timestampUs, temperature, humidity, pressure);
+    setReading(temperature, humidity, pressure);
+}
+
+/**
+ * @brief Принимает пакет измерений.
+ *
+ * Промежуточные измерения пакета попадают только в историю: показаниями блока
+ * становится последнее значение.
+ * @param batch Измерения в порядке поступления.
+ */
+void ClimateModel::acceptBatch(const QVector<SensorSample> &batch) {
+    ACM_PROBE("ClimateModel::acceptBatch");
+    if (batch.isEmpty()) {
+        return;
+    }
+    if (recorder) {
+        recorder->writeSamples(batch.constData(), batch.size());
+    }
+
+    for (const SensorSample &sample : batch) {
+        recordHistory(sample.timestampUs, sample.temperature, sample.humidity, sample.pressure);
+    }
+
+    const SensorSample &last = batch.constLast();
+    setReading(last.temperature, last.humidity, last.pressure);
+}
+
+/**
+ * @brief Задаёт показания текущего блока без записи в историю.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void ClimateModel::setReading(double temperature, double humidity, double pressure) {
+    fleetStore.setReading(current, temperature, humidity, pressure);
+    stateJournal->append(StateJournal::Reading, current, temperature, humidity, pressure);
+    notifyUnit(current, ReadingChanged);
+}
+
+/**
+ * @brief Задаёт температуру и влажность первых count блоков парка одним проходом.
+ * @param temperatures Температуры в текущей единице.
+ * @param humidities Влажность.
+ * @param count Количество блоков.
+ */
+void ClimateModel::acceptFleetReadings(const double *temperatures, const double *humidities, int count) {
+    count = qMin(count, fleetStore.size());
+    if (count <= 0) {
+        return;
+    }
+    std::memcpy(fleetStore.temperatureData(), temperatures, count * sizeof(double));
+    std::memcpy(fleetStore.humidityData(), humidities, count * sizeof(double));
+    emit fleetReadingsChanged();
+}
+
+/**
+ * @brief Добавляет измерение в историю не чаще одного раза за шаг истории.
+ *
+ * Измерения с меткой времени раньше последней записанной пропускаются.
+ * @param timestampUs Метка времени в микросекундах.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void ClimateModel::recordHistory(qint64 timestampUs, double temperature, double humidity, double pressure) {
+    if (samples.size() == 0 || timestampUs >= samples.lastTimestamp() + kHistoryResolutionUs) {
+        samples.append(timestampUs, temperature, humidity, pressure);
+        longTerm.append(timestampUs, convertTemperature(temperature, tempUnit, TemperatureUnit::Celsius), humidity,
+                        convertPressure(pressure, presUnit, PressureUnit::Pascal));
+        emit changed(HistoryChanged);
+    }
+}
+
+/**
+ * @brief Очищает историю измерений текущего блока.
+ */
+void ClimateModel::clearHistory() {
+    resetHistory();
+    emit changed(HistoryChanged);
+}
+
+/**
+ * @brief Задаёт температуру текущего блока.
+ * @param value Температура в текущей единице.
+ * @return true, если значение в допустимом диапазоне.
+ */
+bool ClimateModel::setTemperature(double value) {
+    if (value < minTemperature() || value > maxTemperature()) {
+        return false;
+    }
+    fleetStore.setReading(current, value, humidity(), pressure());
+    stateJournal->append(StateJournal::Temperature, current, value);
+    notifyUnit(current, TemperatureChanged);
+    return true;
+}
+
+/**
+ * @brief Задаёт уставку температуры текущего блока.
+ * @param value Уставка в текущей единице.
+ * @return true, если значение в допустимом диапазоне.
+ */
+bool ClimateModel::setSetpoint(double value) {
+    if (recorder) {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        recorder->writeAction(InputTraceWriter::Setpoint, static_cast<qint32>(bits), static_cast<qint32>(bits >> 32));
+    }
+    return applySetpoint(current, value);
+}
+
+/**
+ * @brief Задаёт уставку температуры блока без записи во входные воздействия.
+ * @param id Номер блока.
+ * @param value Уставка в текущей единице.
+ * @return true, если значение в допустимом диапазоне.
+ */
+bool ClimateModel::applySetpoint(int id, double value) {
+    if (value < minTemperature() || value > maxTemperature()) {
+        return false;
+    }
+    fleetStore.setSetpoint(id, value);
+    stateJournal->append(StateJournal::Setpoint, id, value);
+    notifyUnit(id, SetpointChanged);
+    return true;
+}
+
+/**
+ * @brief Увеличивает уставку температуры на шаг.
+ */
+void ClimateModel::temperatureUp() {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::TemperatureUp);
+    }
+    applySetpoint(current, setpoint() + temperatureStep());
+}
+
+/**
+ * @brief Уменьшает уставку температуры на шаг.
+ */
+void ClimateModel::temperatureDown() {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::TemperatureDown);
+    }
+    applySetpoint(current, setpoint() - temperatureStep());
+}
+
+/**
+ * @brief Задаёт положение жалюзи текущего блока.
+ * @param hDir Угол горизонтальных жалюзи.
+ * @param vDir Угол вертикальных жалюзи.
+ * @return true, если положение в допустимом диапазоне.
+ */
+bool ClimateModel::setGates(int hDir, int vDir) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::Gates, hDir, vDir);
+    }
+    return applyGates(current, hDir, vDir);
+}
+
+/**
+ * @brief Поворачивает горизонтальные жалюзи.
+ * @param delta Изменение угла.
+ */
+void ClimateModel::moveHGate(int delta) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::HGate, delta);
+    }
+    applyGates(current, hGateDir() + delta, vGateDir());
+}
+
+/**
+ * @brief Поворачивает вертикальные жалюзи.
+ * @param delta Изменение угла.
+ */
+void ClimateModel::moveVGate(int delta) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::VGate, delta);
+    }
+    applyGates(current, hGateDir(), vGateDir() + delta);
+}
+
+/**
+ * @brief Задаёт положение жалюзи блока без записи во входные воздействия.
+ * @param id Номер блока.
+ * @param hDir Угол горизонтальных жалюзи.
+ * @param vDir Угол вертикальных жалюзи.
+ * @return true, если положение в допустимом диапазоне.
+ */
+bool ClimateModel::applyGates(int id, int hDir, int vDir) {
+    if (hDir < minHGate() || hDir > maxHGate() || vDir < minVGate() || vDir > maxVGate()) {
+        return false;
+    }
+    quint32 fields = (hDir != fleetStore.hGateDir(id) ? HGateChanged : 0) | (vDir != fleetStore.vGateDir(id) ? VGateChanged : 0);
+    fleetStore.setGates(id, hDir, vDir);
+    stateJournal->append(StateJournal::Gates, id, hDir, vDir);
+    notifyUnit(id, fields);
+    return true;
+}
+
+/**
+ * @brief Включает или выключает текущий блок.
+ * @param on Новое состояние.
+ */
+void ClimateModel::setPower(bool on) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::Power, on ? 1 : 0);
+    }
+    applyPower(current, on);
+}
+
+/**
+ * @brief Включает или выключает блок без записи во входные воздействия.
+ * @param id Номер блока.
+ * @param on Новое состояние.
+ */
+void ClimateModel::applyPower(int id, bool on) {
+    if (on == fleetStore.isOn(id)) {
+        return;
+    }
+    quint32 fields = PowerChanged;
+    fleetStore.setOn(id, on);
+    if (!on) {
+        fleetStore.setGates(id, 0, 0); // Жалюзи в стартовую позицию
+        fields |= HGateChanged | VGateChanged;
+    }
+    stateJournal->append(StateJournal::Power, id, on ? 1.0 : 0.0);
+    notifyUnit(id, fields);
+}
+
+/**
+ * @brief Добавляет запись недельного расписания.
+ *
+ * Уставка и жалюзи проверяются по диапазонам сразу, чтобы неверная запись
+ * не срабатывала впустую каждую неделю.
+ * @param entry Запись.
+ * @return Номер записи или 0.
+ */
+quint32 ClimateModel::addSchedule(const ScheduleEntry &entry) {
+    if (entry.unit < 0 || entry.unit >= fleetStore.size()) {
+        return 0;
+    }
+    if (entry.action == ScheduleEntry::SetSetpoint
+        && (entry.setpoint < convertTemperature(minTemperature(), tempUnit, TemperatureUnit::Celsius)
+            || entry.setpoint > convertTemperature(maxTemperature(), tempUnit, TemperatureUnit::Celsius))) {
+        return 0;
+    }
+    if (entry.action == ScheduleEntry::SetGates
+        && (entry.hGate < minHGate() || entry.hGate > maxHGate() || entry.vGate < minVGate() || entry.vGate > maxVGate())) {
+        return 0;
+    }
+    const quint32 id = climateScheduler->add(entry);
+    if (id != 0) {
+        const ScheduleEntry *added = climateScheduler->entry(id);
+        stateJournal->append(StateJournal::ScheduleAdd, added->unit, id, packSchedule(*added), added->setpoint);
+    }
+    return id;
+}
+
+/**
+ * @brief Удаляет запись недельного расписания.
+ * @param id Номер записи.
+ * @return true, если запись была.
+ */
+bool ClimateModel::removeSchedule(quint32 id) {
+    const ScheduleEntry *entry = climateScheduler->entry(id);
+    if (!entry) {
+        return false;
+    }
+    const quint32 unit = static_cast<quint32>(entry->unit);
+    climateScheduler->remove(id);
+    stateJournal->append(StateJournal::ScheduleRemove, unit, id);
+    return true;
+}
+
+/**
+ * @brief Задаёт замену даты в расписании.
+ * @param holiday Замена.
+ * @return true, если замена верна.
+ */
+bool ClimateModel::setHoliday(const HolidayOverride &holiday) {
+    if (!climateScheduler->setHoliday(holiday)) {
+        return false;
+    }
+    stateJournal->append(StateJournal::HolidaySet, static_cast<quint32>(holiday.unit), static_cast<double>(holiday.day),
+                         holiday.profile);
+    return true;
+}
+
+/**
+ * @brief Удаляет замену даты в расписании.
+ * @param day Дата (юлианский день).
+ * @param unit Номер блока (-1 — весь парк).
+ * @return true, если замена была.
+ */
+bool ClimateModel::removeHoliday(qint64 day, qint32 unit) {
+    if (!climateScheduler->removeHoliday(day, unit)) {
+        return false;
+    }
+    stateJournal->append(StateJournal::HolidayRemove, static_cast<quint32>(unit), static_cast<double>(day));
+    return true;
+}
+
+/**
+ * @brief Переключает питание текущего блока.
+ */
+void ClimateModel::togglePower() {
+    setPower(!isOn());
+}
+
+/**
+ * @brief Переводит все значения в новые единицы измерения.
+ * @param tempId Идентификатор единицы температуры.
+ * @param presId Идентификатор единицы давления.
+ */
+void ClimateModel::setUnits(int tempId, int presId) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::Units, tempId, presId);
+    }
+    if (tempId < 1 || tempId > 3 || presId < 1 || presId > 2) {
+        return;
+    }
+    convertUnits(static_cast<TemperatureUnit>(tempId), static_cast<PressureUnit>(presId));
+    stateJournal->append(StateJournal::Units, current, tempId, presId);
+    for (int id = 0; id < fleetStore.size(); ++id) {
+        emit unitStateChanged(id);
+    }
+    emit changed(UnitsChanged | ReadingChanged | SetpointChanged | HistoryChanged);
+}
+
+/**
+ * @brief Задаёт тему интерфейса.
+ * @param themeId Идентификатор темы.
+ */
+void ClimateModel::setTheme(int themeId) {
+    const Theme id = themeId == 2 ? Theme::Dark : Theme::Light;
+    if (id == currentTheme) {
+        return;
+    }
+    currentTheme = id;
+    stateJournal->append(StateJournal::ThemeChange, current, static_cast<double>(id));
+    emit changed(ThemeChanged);
+}
+
+/**
+ * @brief Задаёт скорость вентилятора.
+ * @param speedId Идентификатор скорости.
+ */
+void ClimateModel::setFanSpeed(int speedId) {
+    if (speedId < 1 || speedId > 3) {
+        return;
+    }
+    const FanSpeed id = static_cast<FanSpeed>(speedId);
+    if (id == currentFanSpeed) {
+        return;
+    }
+    currentFanSpeed = id;
+    stateJournal->append(StateJournal::FanSpeed, current, static_cast<double>(id));
+    emit changed(FanSpeedChanged);
+}
+
+/**
+ * @brief Делает блок текущим.
+ * @param id Номер блока.
+ */
+void ClimateModel::selectUnit(int id) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::SelectUnit, id);
+    }
+    if (id < 0 || id >= fleetStore.size() || id == current) {
+        return;
+    }
+    current = id;
+    resetHistory(); // История относится к текущему блоку
+    stateJournal->append(StateJournal::SelectUnit, current);
+    emit changed(AllChanged & ~(UnitsChanged | ThemeChanged | FanSpeedChanged));
+}
+
+/**
+ * @brief Задаёт количество блоков в парке.
+ * @param count Количество блоков.
+ */
+void ClimateModel::setFleetSize(int count) {
+    if (recorder) {
+        recorder->writeAction(InputTraceWriter::FleetSize, count);
+    }
+    if (count < 1) {
+        count = 1;
+    }
+
+    emit fleetAboutToResize();
+    fleetStore.resize(count, temperature(), humidity(), pressure());
+    const bool moved = current >= count;
+    if (moved) {
+        current = count - 1;
+        resetHistory();
+    }
+    stateJournal->append(StateJournal::FleetSize, current, count);
+    emit fleetResized();
+
+    if (moved) {
+        emit changed(AllChanged & ~(UnitsChanged | ThemeChanged | FanSpeedChanged));
+    }
+}
+
+/**
+ * @brief Устанавливает базовые настройки.
+ *
+ * Парк состоит из одного блока со значениями по умолчанию: температура — 16°C,
+ * давление — 87000 Паскалей, влажность — 0%; тема интерфейса — светлая.
+ */
+void ClimateModel::resetToDefaults() {
+    fleetStore.resize(0, 0.0, 0.0, 0.0);
+    fleetStore.resize(1, 16.0, 0.0, 87000.0);
+    resetHistory();
+    tempUnit = TemperatureUnit::Celsius;
+    presUnit = PressureUnit::Pascal;
+    currentTheme = Theme::Light;
+    currentFanSpeed = FanSpeed::Medium;
+    current = 0;
+}
+
+/**
+ * @brief Переводит значения всех блоков парка и историю в новые единицы измерения.
+ * @param tid Новая единица измерения температуры.
+ * @param pid Новая единица измерения давления.
+ */
+void ClimateModel::convertUnits(TemperatureUnit tid, PressureUnit pid) {
+    const UnitConversion::Affine tConv = UnitConversion::temperature(static_cast<int>(tempUnit), static_cast<int>(tid));
+    const UnitConversion::Affine pConv = UnitConversion::pressure(static_cast<int>(presUnit), static_cast<int>(pid));
+
+    // Пересчёт колонок парка и каналов истории целыми массивами
+    UnitConversion::apply(tConv, fleetStore.temperatureData(), fleetStore.size());
+    UnitConversion::apply(tConv, fleetStore.setpointData(), fleetStore.size());
+    UnitConversion::apply(pConv, fleetStore.pressureData(), fleetStore.size());
+    UnitConversion::apply(tConv, samples.channel(SampleHistory::Temperature).rawData(), samples.size());
+    UnitConversion::apply(pConv, samples.channel(SampleHistory::Pressure).rawData(), samples.size());
+
+    tempUnit = tid;
+    presUnit = pid;
+}
+
+/**
+ * @brief Применяет запись журнала к состоянию при восстановлении.
+ * @param record Запись журнала.
+ */
+void ClimateModel::applyJournalRecord(const JournalRecord &record) {
+    const int unit = static_cast<int>(record.unit);
+    const bool validUnit = unit >= 0 && unit < fleetStore.size();
+    const double *values = record.values;
+
+    switch (record.type) {
+        case StateJournal::Reading:
+            if (validUnit) {
+                fleetStore.setReading(unit, values[0], values[1], values[2]);
+            }
+            break;
+        case StateJournal::Temperature:
+            if (validUnit) {
+                fleetStore.setReading(unit, values[0], fleetStore.humidity(unit), fleetStore.pressure(unit));
+            }
+            break;
+        case StateJournal::Setpoint:
+            if (validUnit) {
+                fleetStore.setSetpoint(unit, values[0]);
+            }
+            break;
+        case StateJournal::Gates:
+            if (validUnit) {
+                fleetStore.setGates(unit, static_cast<int>(values[0]), static_cast<int>(values[1]));
+            }
+            break;
+        case StateJournal::Power:
+            if (validUnit) {
+                fleetStore.setOn(unit, values[0] != 0.0);
+                if (values[0] == 0.0) {
+                    fleetStore.setGates(unit, 0, 0); // Выключение возвращает жалюзи в стартовую позицию
+                }
+            }
+            break;
+        case StateJournal::Units: {
+            const int tempId = static_cast<int>(values[0]);
+            const int presId = static_cast<int>(values[1]);
+            if (tempId >= 1 && tempId <= 3 && presId >= 1 && presId <= 2) {
+                convertUnits(static_cast<TemperatureUnit>(tempId), static_cast<PressureUnit>(presId));
+            }
+            break;
+        }
+        case StateJournal::ThemeChange:
+            currentTheme = values[0] == 2.0 ? Theme::Dark : Theme::Light;
+            break;
+        case StateJournal::FanSpeed:
+            if (values[0] >= 1.0 && values[0] <= 3.0) {
+                currentFanSpeed = static_cast<FanSpeed>(static_cast<int>(values[0]));
+            }
+            break;
+        case StateJournal::FleetSize: {
+            const int count = qMax(1, static_cast<int>(values[0]));
+            fleetStore.resize(count, fleetStore.temperature(current), fleetStore.humidity(current), fleetStore.pressure(current));
+            if (current >= count) {
+                current = count - 1;
+                resetHistory();
+            }
+            break;
+        }
+        case StateJournal::SelectUnit:
+            if (validUnit && unit != current) {
+                current = unit;
+                resetHistory(); // История относится к текущему блоку
+            }
+            break;
+        case StateJournal::ScheduleAdd:
+            climateScheduler->add(unpackSchedule(record));
+            break;
+        case StateJournal::ScheduleRemove:
+            climateScheduler->remove(static_cast<quint32>(values[0]));
+            break;
+        case StateJournal::HolidaySet: {
+            HolidayOverride holiday;
+            holiday.day = static_cast<qint64>(values[0]);
+            holiday.unit = unit;
+            holiday.profile = static_cast<qint32>(values[1]);
+            climateScheduler->setHoliday(holiday);
+            break;
+        }
+        case StateJournal::HolidayRemove:
+            climateScheduler->removeHoliday(static_cast<qint64>(values[0]), unit);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Очищает историю измерений текущего блока: оперативную, сжатую и отложенную.
+ */
+void ClimateModel::resetHistory() {
+    samples.clear();
+    longTerm.clear();
+    historyDeferred = false;
+}
+
+/**
+ * @brief Сообщает об изменении блока; об изменении текущего блока — и сигналом changed().
+ * @param id Номер блока.
+ * @param fields Биты изменившихся частей.
+ */
+void ClimateModel::notifyUnit(int id, quint32 fields) {
+    emit unitStateChanged(id);
+    if (id == current && fields != 0) {
+        emit changed(fields);
+    }
+}
+
+/**
+ * @brief Выполняет сработавшую запись расписания.
+ *
+ * Записи блоков, которых больше нет в парке, пропускаются; уставка переводится
+ * из °C в текущую единицу.
+ * @param entry Запись.
+ */
+void ClimateModel::applyScheduleEntry(const ScheduleEntry &entry) {
+    if (entry.unit >= fleetStore.size()) {
+        return;
+    }
+    switch (entry.action) {
+        case ScheduleEntry::SetSetpoint:
+            applySetpoint(entry.unit, convertTemperature(entry.setpoint, TemperatureUnit::Celsius, tempUnit));
+            break;
+        case ScheduleEntry::SetPower:
+            applyPower(entry.unit, entry.power != 0);
+            break;
+        case ScheduleEntry::SetGates:
+            applyGates(entry.unit, entry.hGate, entry.vGate);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Передаёт регулятору входы текущего блока.
+ *
+ * Вызывается при каждом изменении состояния; регулятор работает в градусах Цельсия
+ * независимо от единицы отображения. Передача не блокирует поток регулятора.
+ */
+void ClimateModel::syncController() {
+    ControllerSettings settings = climateController.settings();
+    settings.enabled = isOn();
+    settings.setpoint = convertTemperature(setpoint(), tempUnit, TemperatureUnit::Celsius);
+    settings.measured = convertTemperature(temperature(), tempUnit, TemperatureUnit::Celsius);
+    climateController.setSettings(settings);
+}
+
+/**
+ * @brief Публикует изменение в шину со значениями текущего блока.
+ *
+ * Без подписчиков изменение не собирается.
+ * @param fields Биты изменившихся частей.
+ */
+void ClimateModel::publishDelta(quint32 fields) {
+    if (!bus->hasSubscribers()) {
+        return;
+    }
+    StateDelta delta;
+    delta.fields = fields;
+    delta.unit = current;
+    delta.fleetSize = fleetStore.size();
+    delta.power = isOn() ? 1 : 0;
+    delta.hGate = hGateDir();
+    delta.vGate = vGateDir();
+    delta.temperatureUnit = static_cast<qint8>(tempUnit);
+    delta.pressureUnit = static_cast<qint8>(presUnit);
+    delta.theme = static_cast<qint8>(currentTheme);
+    delta.fanSpeed = static_cast<qint8>(currentFanSpeed);
+    delta.temperature = temperature();
+    delta.humidity = humidity();
+    delta.pressure = pressure();
+    delta.setpoint = setpoint();
+    bus->publish(delta);
+}
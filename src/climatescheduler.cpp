@@ -0,0 +1,407 @@
+#include "../includes/climatescheduler.h"
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+#include <QTimer>
+#include <algorithm>
+
+/**
+ * @file climatescheduler.cpp
+ * @brief Реализация планировщика недельного расписания.
+ *
+ * Этот файл содержит поиск ближайшего срабатывания записи по местному времени,
+ * постановку записей на колесо таймеров и выполнение наступивших записей.
+ */
+
+namespace {
+
+const int kTickMs = 1000; ///< Период продвижения часов, мс
+const int kMinutesPerDay = 24 * 60; ///< Минут в сутках
+const qint64 kSecondsPerDay = 24 * 60 * 60; ///< Секунд в сутках без перевода часов
+const int kMaxCachedDays = 4096; ///< Предельный размер кэша начал суток
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ClimateScheduler.
+ * @param parent Родительский объект.
+ */
+ClimateScheduler::ClimateScheduler(QObject *parent)
+    : QObject(parent)
+    , wheel(QDateTime::currentSecsSinceEpoch())
+{
+    tick = new QTimer(this);
+    tick->setInterval(kTickMs);
+    connect(tick, &QTimer::timeout, this, [=]() { advanceTo(QDateTime::currentSecsSinceEpoch()); });
+}
+
+/**
+ * @brief Проверяет запись.
+ * @param entry Запись.
+ * @return true, если заданы дни недели, минута суток и известное действие.
+ */
+bool ClimateScheduler::isValid(const ScheduleEntry &entry) {
+    if (entry.unit < 0 || entry.days == 0 || (entry.days & ~ScheduleEntry::kAllDays) != 0 || entry.minute >= kMinutesPerDay) {
+        return false;
+    }
+    switch (entry.action) {
+        case ScheduleEntry::SetSetpoint:
+        case ScheduleEntry::SetGates:
+            return true;
+        case ScheduleEntry::SetPower:
+            return entry.power == 0 || entry.power == 1;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Добавляет запись и ставит её на ближайшее срабатывание.
+ * @param entry Запись.
+ * @return Номер записи или 0.
+ */
+quint32 ClimateScheduler::add(const ScheduleEntry &entry) {
+    const quint32 id = entry.id != 0 ? entry.id : nextId;
+    if (!isValid(entry) || ids.contains(id)) {
+        return 0;
+    }
+    int index;
+    if (freeItems.isEmpty()) {
+        index = items.size();
+        items.append(Item());
+    } else {
+        index = freeItems.takeLast();
+    }
+    items[index].entry = entry;
+    items[index].entry.id = id;
+    ids.insert(id, index);
+    nextId = qMax(nextId, id + 1);
+    arm(index, wheel.now());
+    return id;
+}
+
+/**
+ * @brief Удаляет запись.
+ * @param id Номер записи.
+ * @return true, если запись была.
+ */
+bool ClimateScheduler::remove(quint32 id) {
+    const auto it = ids.constFind(id);
+    if (it == ids.constEnd()) {
+        return false;
+    }
+    const int index = it.value();
+    ids.erase(it);
+    wheel.cancel(items[index].timer);
+    items[index] = Item();
+    freeItems.append(index);
+    return true;
+}
+
+/**
+ * @brief Задаёт замену даты.
+ *
+ * Замены редки, поэтому срабатывания пересчитываются у всех записей.
+ * @param holiday Замена.
+ * @return true, если замена верна.
+ */
+bool ClimateScheduler::setHoliday(const HolidayOverride &holiday) {
+    if (holiday.unit < -1 || holiday.profile < 0 || holiday.profile > 7) {
+        return false;
+    }
+    QVector<HolidayOverride> &overrides = holidays[holiday.day];
+    auto it = std::find_if(overrides.begin(), overrides.end(),
+                           [&](const HolidayOverride &other) { return other.unit == holiday.unit; });
+    if (it != overrides.end()) {
+        *it = holiday;
+    } else {
+        overrides.append(holiday);
+    }
+    rearmAll();
+    return true;
+}
+
+/**
+ * @brief Удаляет замену даты.
+ * @param day Дата.
+ * @param unit Номер блока (-1 — весь парк).
+ * @return true, если замена была.
+ */
+bool ClimateScheduler::removeHoliday(qint64 day, qint32 unit) {
+    const auto found = holidays.find(day);
+    if (found == holidays.end()) {
+        return false;
+    }
+    QVector<HolidayOverride> &overrides = found.value();
+    for (int i = 0; i < overrides.size(); ++i) {
+        if (overrides[i].unit == unit) {
+            overrides.remove(i);
+            if (overrides.isEmpty()) {
+                holidays.erase(found);
+            }
+            rearmAll();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Удаляет все записи и замены.
+ */
+void ClimateScheduler::clear() {
+    wheel.reset(wheel.now());
+    items.clear();
+    freeItems.clear();
+    ids.clear();
+    holidays.clear();
+    nextId = 1;
+}
+
+/**
+ * @brief Возвращает всё расписание.
+ *
+ * Записи упорядочены по номерам, замены — по дате и блоку, поэтому снимок
+ * одного и того же расписания всегда одинаков.
+ */
+ScheduleData ClimateScheduler::data() const {
+    ScheduleData data;
+    data.entries.reserve(ids.size());
+    for (const Item &item : items) {
+        if (item.entry.id != 0) {
+            data.entries.append(item.entry);
+        }
+    }
+    std::sort(data.entries.begin(), data.entries.end(),
+              [](const ScheduleEntry &a, const ScheduleEntry &b) { return a.id < b.id; });
+    for (const QVector<HolidayOverride> &overrides : holidays) {
+        data.holidays += overrides;
+    }
+    std::sort(data.holidays.begin(), data.holidays.end(), [](const HolidayOverride &a, const HolidayOverride &b) {
+        return a.day != b.day ? a.day < b.day : a.unit < b.unit;
+    });
+    return data;
+}
+
+/**
+ * @brief Заменяет расписание.
+ * @param data Расписание.
+ */
+void ClimateScheduler::assign(const ScheduleData &data) {
+    clear();
+    for (const HolidayOverride &holiday : data.holidays) {
+        if (holiday.unit >= -1 && holiday.profile >= 0 && holiday.profile <= 7) {
+            holidays[holiday.day].append(holiday);
+        }
+    }
+    items.reserve(data.entries.size());
+    ids.reserve(data.entries.size());
+    for (const ScheduleEntry &entry : data.entries) {
+        add(entry);
+    }
+}
+
+/**
+ * @brief Возвращает запись по номеру.
+ * @param id Номер записи.
+ */
+const ScheduleEntry *ClimateScheduler::entry(quint32 id) const {
+    const auto it = ids.constFind(id);
+    return it != ids.constEnd() ? &items[it.value()].entry : nullptr;
+}
+
+/**
+ * @brief Возвращает время ближайшего срабатывания записи.
+ * @param id Номер записи.
+ */
+qint64 ClimateScheduler::nextFire(quint32 id) const {
+    const auto it = ids.constFind(id);
+    return it != ids.constEnd() ? items[it.value()].due : -1;
+}
+
+/**
+ * @brief Возвращает количество замен дат.
+ */
+int ClimateScheduler::holidayCount() const {
+    int count = 0;
+    for (const QVector<HolidayOverride> &overrides : holidays) {
+        count += overrides.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Запускает выполнение записей по часам системы.
+ */
+void ClimateScheduler::start() {
+    advanceTo(QDateTime::currentSecsSinceEpoch());
+    tick->start();
+}
+
+/**
+ * @brief Останавливает выполнение записей.
+ */
+void ClimateScheduler::stop() {
+    tick->stop();
+}
+
+/**
+ * @brief Переводит часы планировщика и пересчитывает срабатывания от нового времени.
+ * @param secs Секунды от начала эпохи.
+ */
+void ClimateScheduler::resetClock(qint64 secs) {
+    wheel.reset(secs);
+    rearmAll();
+}
+
+/**
+ * @brief Продвигает часы планировщика и выполняет наступившие записи.
+ *
+ * Записи выполняются по порядку времени срабатывания, каждая сразу ставится на следующее.
+ * Обработчик может добавлять и удалять записи: удалённая до своего срабатывания запись
+ * не выполняется.
+ * @param secs Секунды от начала эпохи.
+ */
+void ClimateScheduler::advanceTo(qint64 secs) {
+    if (secs < wheel.now() || secs - wheel.now() > kMaxCatchUpSeconds) {
+        resetClock(secs);
+        return;
+    }
+    due.clear();
+    while (wheel.expire(secs, due) > 0) {
+        const qint64 at = wheel.now();
+        for (int i = 0; i < due.size(); ++i) {
+            const int index = static_cast<int>(due[i].payload);
+            if (items[index].timer != due[i].handle) {
+                continue; // Запись удалена обработчиком раньше в этом такте
+            }
+            items[index].timer = 0;
+            items[index].due = -1;
+            const ScheduleEntry entry = items[index].entry;
+            ++fired;
+            if (fire) {
+                fire(entry);
+            }
+            if (items[index].entry.id == entry.id && items[index].timer == 0) {
+                arm(index, at);
+            }
+        }
+        due.clear();
+    }
+}
+
+/**
+ * @brief Ставит запись на ближайшее срабатывание позже заданного времени.
+ * @param index Элемент items.
+ * @param after Время, секунды от начала эпохи.
+ */
+void ClimateScheduler::arm(int index, qint64 after) {
+    Item &item = items[index];
+    if (item.timer != 0) {
+        wheel.cancel(item.timer);
+        item.timer = 0;
+    }
+    item.due = nextOccurrence(item.entry, after);
+    if (item.due >= 0) {
+        item.timer = wheel.schedule(item.due, static_cast<quint32>(index));
+    }
+}
+
+/**
+ * @brief Пересчитывает срабатывания всех записей от текущего времени планировщика.
+ */
+void ClimateScheduler::rearmAll() {
+    for (int index = 0; index < items.size(); ++index) {
+        if (items[index].entry.id != 0) {
+            arm(index, wheel.now());
+        }
+    }
+}
+
+/**
+ * @brief Ищет ближайшее срабатывание записи позже заданного времени.
+ * @param entry Запись.
+ * @param after Время, секунды от начала эпохи.
+ * @return Время срабатывания или -1, если за kMaxScanDays дней срабатываний нет.
+ */
+qint64 ClimateScheduler::nextOccurrence(const ScheduleEntry &entry, qint64 after) const {
+    const qint64 first = localDay(after);
+    for (qint64 day = first; day <= first + kMaxScanDays; ++day) {
+        const int weekday = weekdayOf(day, entry.unit);
+        if (weekday == 0 || (entry.days & (1u << (weekday - 1))) == 0) {
+            continue;
+        }
+        const qint64 begin = dayStart(day);
+        qint64 time = begin + entry.minute * 60;
+        if (dayStart(day + 1) - begin != kSecondsPerDay) {
+            // Сутки перевода часов: минута считается по местному времени
+            const QDateTime local(QDate::fromJulianDay(day), QTime(entry.minute / 60, entry.minute % 60));
+            if (local.isValid()) {
+                time = local.toSecsSinceEpoch();
+            }
+        }
+        if (time > after) {
+            return time;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Возвращает день недели, по расписанию которого живёт дата для блока.
+ * @param day Дата (юлианский день).
+ * @param unit Номер блока.
+ * @return 1 — понедельник, ..., 7 — воскресенье; 0 — записи в эту дату не выполняются.
+ */
+int ClimateScheduler::weekdayOf(qint64 day, qint32 unit) const {
+    int weekday = static_cast<int>(day % 7) + 1; // Юлианский день 0 — понедельник
+    if (!holidays.isEmpty()) {
+        const auto it = holidays.constFind(day);
+        if (it != holidays.constEnd()) {
+            for (const HolidayOverride &holiday : it.value()) {
+                if (holiday.unit == unit) {
+                    return holiday.profile;
+                }
+                if (holiday.unit == -1) {
+                    weekday = holiday.profile;
+                }
+            }
+        }
+    }
+    return weekday;
+}
+
+/**
+ * @brief Возвращает местную дату, которой принадлежит время.
+ * @param secs Секунды от начала эпохи.
+ * @return Юлианский день.
+ */
+qint64 ClimateScheduler::localDay(qint64 secs) const {
+    if (cachedEnd == 0 || secs < cachedBegin || secs >= cachedEnd) {
+        cachedDay = QDateTime::fromSecsSinceEpoch(secs).date().toJulianDay();
+        cachedBegin = dayStart(cachedDay);
+        cachedEnd = dayStart(cachedDay + 1);
+    }
+    return cachedDay;
+}
+
+/**
+ * @brief Возвращает начало местных суток.
+ * @param day Дата (юлианский день).
+ * @return Секунды от начала эпохи.
+ */
+qint64 ClimateScheduler::dayStart(qint64 day) const {
+    const auto it = dayStarts.constFind(day);
+    if (it != dayStarts.constEnd()) {
+        return it.value();
+    }
+    if (dayStarts.size() >= kMaxCachedDays) {
+        dayStarts.clear();
+    }
+    const QDate date = QDate::fromJulianDay(day);
+    const QDateTime midnight(date, QTime(0, 0));
+    // Полночь, пропущенная переводом часов, — сутки начинаются часом позже
+    const qint64 secs = midnight.isValid() ? midnight.toSecsSinceEpoch() : QDateTime(date, QTime(1, 0)).toSecsSinceEpoch();
+    dayStarts.insert(day, secs);
+    return secs;
+}
@@ -0,0 +1,546 @@
+#include "../includes/controlprotocol.h"
+#include <QDate>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @file controlprotocol.cpp
+ * @brief Реализация протокола управления по локальному сокету.
+ *
+ * Этот файл содержит разбор строк запросов JSON в команды и запись ответов.
+ */
+
+namespace {
+
+const char *const kTemperatureUnits[] = { "C", "F", "K" }; ///< Обозначения единиц температуры по порядку TemperatureUnit
+const char *const kPressureUnits[] = { "Pa", "mmHg" }; ///< Обозначения единиц давления по порядку PressureUnit
+const char *const kWeekdays[] = { "mon", "tue", "wed", "thu", "fri", "sat", "sun" }; ///< Обозначения дней недели с понедельника
+
+const char *const kMalformed = "malformed json"; ///< Строка не является JSON
+const char *const kNotObject = "request must be an object"; ///< Запрос не объект
+const char *const kUnknownOp = "unknown op"; ///< Неизвестная операция
+const char *const kBadArgument = "missing or invalid argument"; ///< Нет аргумента или он неверного типа
+const char *const kBadUnit = "unknown unit"; ///< Неизвестная единица измерения
+const char *const kBadId = "id must be a number, string or null"; ///< Идентификатор неверного типа
+const char *const kBadDays = "days must be weekday names, ranges or numbers 1-7"; ///< Неверные дни недели
+const char *const kBadTime = "time must be \"HH:MM\""; ///< Неверное время суток
+const char *const kBadDate = "date must be \"YYYY-MM-DD\""; ///< Неверная дата
+const char *const kBadAction = "schedule needs exactly one of setpoint, power or h and v"; ///< Нет действия записи или их несколько
+
+/**
+ * @struct OpName
+ * @brief Название операции в протоколе.
+ */
+struct OpName
+{
+    const char *name; ///< Название
+    ControlCommand::Op op; ///< Операция
+};
+
+const OpName kOps[] = {
+    { "ping", ControlCommand::Ping },
+    { "get", ControlCommand::Get },
+    { "set_setpoint", ControlCommand::SetSetpoint },
+    { "step_setpoint", ControlCommand::StepSetpoint },
+    { "set_gates", ControlCommand::SetGates },
+    { "set_power", ControlCommand::SetPower },
+    { "toggle_power", ControlCommand::TogglePower },
+    { "select_unit", ControlCommand::SelectUnit },
+    { "set_units", ControlCommand::SetUnits },
+    { "add_schedule", ControlCommand::AddSchedule },
+    { "remove_schedule", ControlCommand::RemoveSchedule },
+    { "set_holiday", ControlCommand::SetHoliday },
+    { "remove_holiday", ControlCommand::RemoveHoliday },
+}; ///< Операции протокола
+
+/**
+ * @brief Дописывает строку JSON с экранированием.
+ * @param out Выходной буфер.
+ * @param text Строка UTF-8.
+ */
+void appendString(QByteArray &out, const QByteArray &text) {
+    out.append('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.append('\\').append(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out.append("\\u00").append(QByteArray::number(static_cast<unsigned char>(c), 16).rightJustified(2, '0'));
+        } else {
+            out.append(c);
+        }
+    }
+    out.append('"');
+}
+
+/**
+ * @brief Дописывает число в кратчайшей точной записи.
+ * @param out Выходной буфер.
+ * @param value Число.
+ */
+void appendNumber(QByteArray &out, double value) {
+    if (!std::isfinite(value)) {
+        out.append("null");
+    } else if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        out.append(QByteArray::number(static_cast<qint64>(value)));
+    } else {
+        out.append(QByteArray::number(value, 'g', 15));
+    }
+}
+
+/**
+ * @brief Читает целое число из значения JSON.
+ * @param value Значение.
+ * @param out Результат.
+ * @return true, если значение — целое число в диапазоне qint32.
+ */
+bool toInt(const QJsonValue &value, qint32 &out) {
+    if (!value.isDouble()) {
+        return false;
+    }
+    const double d = value.toDouble();
+    if (d != std::floor(d) || d < -2147483648.0 || d > 2147483647.0) {
+        return false;
+    }
+    out = static_cast<qint32>(d);
+    return true;
+}
+
+/**
+ * @brief Находит единицу по обозначению или номеру.
+ * @param value Обозначение ("C") или номер единицы (1).
+ * @param names Обозначения единиц по порядку.
+ * @param count Количество единиц.
+ * @param out Номер единицы (с 1).
+ * @return true, если единица известна.
+ */
+bool toUnit(const QJsonValue &value, const char *const *names, int count, qint32 &out) {
+    if (value.isString()) {
+        const QString name = value.toString();
+        for (int i = 0; i < count; ++i) {
+            if (name.compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0) {
+                out = i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+    return toInt(value, out) && out >= 1 && out <= count;
+}
+
+/**
+ * @brief Находит день недели по обозначению или номеру.
+ * @param value Обозначение ("mon") или номер дня (1 — понедельник, ..., 7 — воскресенье).
+ * @param out Номер дня.
+ * @return true, если день известен.
+ */
+bool toWeekday(const QJsonValue &value, qint32 &out) {
+    return toUnit(value, kWeekdays, 7, out);
+}
+
+/**
+ * @brief Читает дни недели: строку "mon-fri,sun", "all" или массив дней.
+ * @param value Значение.
+ * @param out Биты дней (бит 0 — понедельник).
+ * @return true, если задан хотя бы один день и все дни известны.
+ */
+bool toDays(const QJsonValue &value, quint8 &out) {
+    out = 0;
+    if (value.isArray()) {
+        for (const QJsonValue &day : value.toArray()) {
+            qint32 weekday;
+            if (!toWeekday(day, weekday)) {
+                return false;
+            }
+            out |= static_cast<quint8>(1u << (weekday - 1));
+        }
+        return out != 0;
+    }
+    if (!value.isString()) {
+        return false;
+    }
+    const QString text = value.toString();
+    if (text.compare(QLatin1String("all"), Qt::CaseInsensitive) == 0) {
+        out = ScheduleEntry::kAllDays;
+        return true;
+    }
+    for (const QString &part : text.split(QLatin1Char(','))) {
+        const QStringList range = part.trimmed().split(QLatin1Char('-'));
+        qint32 first;
+        qint32 last;
+        if (range.size() > 2 || !toWeekday(range.first(), first) || !toWeekday(range.last(), last)) {
+            return false;
+        }
+        for (qint32 day = first;; day = day % 7 + 1) { // Диапазон может переходить через воскресенье: "fri-mon"
+            out |= static_cast<quint8>(1u << (day - 1));
+            if (day == last) {
+                break;
+            }
+        }
+    }
+    return out != 0;
+}
+
+/**
+ * @brief Читает время суток "HH:MM".
+ * @param value Значение.
+ * @param out Минута суток.
+ * @return true, если время верно.
+ */
+bool toMinute(const QJsonValue &value, quint16 &out) {
+    const QStringList parts = value.toString().split(QLatin1Char(':'));
+    bool hoursOk = false;
+    bool minutesOk = false;
+    const int hours = parts.size() == 2 ? parts[0].toInt(&hoursOk) : -1;
+    const int minutes = parts.size() == 2 ? parts[1].toInt(&minutesOk) : -1;
+    if (!hoursOk || !minutesOk || hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+        return false;
+    }
+    out = static_cast<quint16>(hours * 60 + minutes);
+    return true;
+}
+
+/**
+ * @brief Читает дату "YYYY-MM-DD".
+ * @param value Значение.
+ * @param out Юлианский день.
+ * @return true, если дата верна.
+ */
+bool toDate(const QJsonValue &value, qint64 &out) {
+    const QDate date = QDate::fromString(value.toString(), Qt::ISODate);
+    if (!date.isValid()) {
+        return false;
+    }
+    out = date.toJulianDay();
+    return true;
+}
+
+/**
+ * @brief Разбирает запись расписания запроса add_schedule.
+ * @param request Объект запроса.
+ * @param command Команда.
+ * @return Ошибка или nullptr.
+ */
+const char *parseSchedule(const QJsonObject &request, ControlCommand &command) {
+    ScheduleEntry &entry = command.schedule;
+    if (!toInt(request.value(QLatin1String("unit")), entry.unit)) {
+        return kBadArgument;
+    }
+    if (!toDays(request.value(QLatin1String("days")), entry.days)) {
+        return kBadDays;
+    }
+    if (!toMinute(request.value(QLatin1String("time")), entry.minute)) {
+        return kBadTime;
+    }
+    const QJsonValue setpoint = request.value(QLatin1String("setpoint"));
+    const QJsonValue power = request.value(QLatin1String("power"));
+    const QJsonValue h = request.value(QLatin1String("h"));
+    const QJsonValue v = request.value(QLatin1String("v"));
+    const int actions = (setpoint.isUndefined() ? 0 : 1) + (power.isUndefined() ? 0 : 1)
+        + (h.isUndefined() && v.isUndefined() ? 0 : 1);
+    if (actions != 1) {
+        return kBadAction;
+    }
+    if (!setpoint.isUndefined()) {
+        if (!setpoint.isDouble()) {
+            return kBadArgument;
+        }
+        entry.action = ScheduleEntry::SetSetpoint;
+        command.value = setpoint.toDouble();
+        const QJsonValue unit = request.value(QLatin1String("temperature_unit"));
+        if (!unit.isUndefined()) {
+            command.hasFirst = true;
+            if (!toUnit(unit, kTemperatureUnits, 3, command.first)) {
+                return kBadUnit;
+            }
+        }
+    } else if (!power.isUndefined()) {
+        if (!power.isBool()) {
+            return kBadArgument;
+        }
+        entry.action = ScheduleEntry::SetPower;
+        entry.power = power.toBool() ? 1 : 0;
+    } else {
+        qint32 hDir;
+        qint32 vDir;
+        if (!toInt(h, hDir) || !toInt(v, vDir) || hDir < -128 || hDir > 127 || vDir < -128 || vDir > 127) {
+            return kBadArgument;
+        }
+        entry.action = ScheduleEntry::SetGates;
+        entry.hGate = static_cast<qint8>(hDir);
+        entry.vGate = static_cast<qint8>(vDir);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Разбирает объект запроса в команду.
+ * @param request Объект запроса.
+ * @return Команда (Invalid с текстом ошибки, если запрос неверен).
+ */
+ControlCommand parseObject(const QJsonObject &request) {
+    ControlCommand command;
+    const QJsonValue id = request.value(QLatin1String("id"));
+    if (id.isDouble()) {
+        appendNumber(command.id, id.toDouble());
+    } else if (id.isString()) {
+        appendString(command.id, id.toString().toUtf8());
+    } else if (id.isNull()) {
+        command.id = "null";
+    } else if (!id.isUndefined()) {
+        command.error = kBadId;
+        return command;
+    }
+
+    const QString op = request.value(QLatin1String("op")).toString();
+    for (const OpName &entry : kOps) {
+        if (op == QLatin1String(entry.name)) {
+            command.op = entry.op;
+            break;
+        }
+    }
+
+    const char *error = nullptr;
+    switch (command.op) {
+        case ControlCommand::Invalid:
+            error = kUnknownOp;
+            break;
+        case ControlCommand::SetSetpoint: {
+            const QJsonValue value = request.value(QLatin1String("value"));
+            if (!value.isDouble()) {
+                error = kBadArgument;
+                break;
+            }
+            command.value = value.toDouble();
+            const QJsonValue unit = request.value(QLatin1String("unit"));
+            if (!unit.isUndefined()) {
+                command.hasFirst = true;
+                if (!toUnit(unit, kTemperatureUnits, 3, command.first)) {
+                    error = kBadUnit;
+                }
+            }
+            break;
+        }
+        case ControlCommand::StepSetpoint:
+            command.hasFirst = toInt(request.value(QLatin1String("steps")), command.first);
+            error = command.hasFirst ? nullptr : kBadArgument;
+            break;
+        case ControlCommand::SetGates: {
+            const QJsonValue h = request.value(QLatin1String("h"));
+            const QJsonValue v = request.value(QLatin1String("v"));
+            command.hasFirst = !h.isUndefined();
+            command.hasSecond = !v.isUndefined();
+            if ((!command.hasFirst && !command.hasSecond)
+                || (command.hasFirst && !toInt(h, command.first))
+                || (command.hasSecond && !toInt(v, command.second))) {
+                error = kBadArgument;
+            }
+            break;
+        }
+        case ControlCommand::SetPower: {
+            const QJsonValue on = request.value(QLatin1String("on"));
+            command.hasFirst = on.isBool();
+            command.first = on.toBool() ? 1 : 0;
+            error = command.hasFirst ? nullptr : kBadArgument;
+            break;
+        }
+        case ControlCommand::SelectUnit:
+            command.hasFirst = toInt(request.value(QLatin1String("unit")), command.first);
+            error = command.hasFirst ? nullptr : kBadArgument;
+            break;
+        case ControlCommand::SetUnits: {
+            const QJsonValue temperature = request.value(QLatin1String("temperature"));
+            const QJsonValue pressure = request.value(QLatin1String("pressure"));
+            command.hasFirst = !temperature.isUndefined();
+            command.hasSecond = !pressure.isUndefined();
+            if (!command.hasFirst && !command.hasSecond) {
+                error = kBadArgument;
+            } else if ((command.hasFirst && !toUnit(temperature, kTemperatureUnits, 3, command.first))
+                       || (command.hasSecond && !toUnit(pressure, kPressureUnits, 2, command.second))) {
+                error = kBadUnit;
+            }
+            break;
+        }
+        case ControlCommand::AddSchedule:
+            error = parseSchedule(request, command);
+            break;
+        case ControlCommand::RemoveSchedule: {
+            qint32 id;
+            if (!toInt(request.value(QLatin1String("schedule")), id) || id <= 0) {
+                error = kBadArgument;
+            }
+            command.schedule.id = static_cast<quint32>(id);
+            break;
+        }
+        case ControlCommand::SetHoliday:
+        case ControlCommand::RemoveHoliday: {
+            const QJsonValue unit = request.value(QLatin1String("unit"));
+            const QJsonValue weekday = request.value(QLatin1String("as"));
+            if (!toDate(request.value(QLatin1String("date")), command.holiday.day)) {
+                error = kBadDate;
+            } else if (!unit.isUndefined() && (!toInt(unit, command.holiday.unit) || command.holiday.unit < 0)) {
+                error = kBadArgument;
+            } else if (command.op == ControlCommand::SetHoliday && !weekday.isUndefined()
+                       && !toWeekday(weekday, command.holiday.profile)) {
+                error = kBadDays;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    if (error) {
+        command.op = ControlCommand::Invalid;
+        command.error = error;
+    }
+    return command;
+}
+
+} // namespace
+
+/**
+ * @brief Разбирает все завершённые строки в буфере.
+ * @param data Буфер с текстом.
+ * @param size Размер буфера.
+ * @param out Вектор, в который добавляются команды.
+ * @return Количество обработанных байт.
+ */
+qint64 ControlProtocol::parseChunk(const char *data, qint64 size, QVector<ControlCommand> &out) {
+    const char *begin = data;
+    const char *end = data + size;
+    for (;;) {
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        if (!newline) {
+            break;
+        }
+        const char *lineEnd = newline;
+        if (lineEnd > begin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd > begin) {
+            parseLine(begin, lineEnd, out);
+        }
+        begin = newline + 1;
+    }
+    return begin - data;
+}
+
+/**
+ * @brief Разбирает одну строку запроса.
+ * @param begin Начало строки.
+ * @param end Конец строки.
+ * @param out Вектор, в который добавляются команды.
+ */
+void ControlProtocol::parseLine(const char *begin, const char *end, QVector<ControlCommand> &out) {
+    QJsonParseError status;
+    const QJsonDocument document = QJsonDocument::fromJson(QByteArray::fromRawData(begin, static_cast<int>(end - begin)), &status);
+    if (status.error != QJsonParseError::NoError) {
+        out.append(invalidCommand(kMalformed));
+        return;
+    }
+    if (document.isObject()) {
+        out.append(parseObject(document.object()));
+        return;
+    }
+    const QJsonArray batch = document.array();
+    if (batch.isEmpty()) {
+        ControlCommand empty;
+        empty.op = ControlCommand::Empty;
+        empty.framing = ControlCommand::InBatch | ControlCommand::OpensBatch | ControlCommand::ClosesBatch;
+        out.append(empty);
+        return;
+    }
+    const int first = out.size();
+    for (const QJsonValue &request : batch) {
+        out.append(request.isObject() ? parseObject(request.toObject()) : invalidCommand(kNotObject));
+        out.last().framing = ControlCommand::InBatch;
+    }
+    out[first].framing |= ControlCommand::OpensBatch;
+    out.last().framing |= ControlCommand::ClosesBatch;
+}
+
+/**
+ * @brief Дописывает ответ на команду с учётом её положения в пакете.
+ * @param command Команда.
+ * @param result Результат выполнения.
+ * @param out Выходной буфер.
+ */
+void ControlProtocol::appendResponse(const ControlCommand &command, const ControlResult &result, QByteArray &out) {
+    if (command.framing & ControlCommand::InBatch) {
+        out.append((command.framing & ControlCommand::OpensBatch) ? '[' : ',');
+    }
+    if (command.op != ControlCommand::Empty) {
+        out.append('{');
+        if (!command.id.isEmpty()) {
+            out.append("\"id\":").append(command.id).append(',');
+        }
+        const char *error = command.error ? command.error : result.error;
+        if (error) {
+            out.append("\"ok\":false,\"error\":");
+            appendString(out, QByteArray::fromRawData(error, static_cast<int>(std::strlen(error))));
+        } else {
+            out.append("\"ok\":true");
+        }
+        if (!error && result.hasState) {
+            const ControlState &s = result.state;
+            out.append(",\"state\":{\"unit\":").append(QByteArray::number(s.unit));
+            out.append(",\"fleet_size\":").append(QByteArray::number(s.fleetSize));
+            out.append(",\"power\":").append(s.power ? "true" : "false");
+            out.append(",\"temperature\":");
+            appendNumber(out, s.temperature);
+            out.append(",\"setpoint\":");
+            appendNumber(out, s.setpoint);
+            out.append(",\"humidity\":");
+            appendNumber(out, s.humidity);
+            out.append(",\"pressure\":");
+            appendNumber(out, s.pressure);
+            out.append(",\"h_gate\":").append(QByteArray::number(s.hGate));
+            out.append(",\"v_gate\":").append(QByteArray::number(s.vGate));
+            out.append(",\"temperature_unit\":\"").append(temperatureUnitName(s.temperatureUnit));
+            out.append("\",\"pressure_unit\":\"").append(pressureUnitName(s.pressureUnit));
+            out.append("\",\"fan_speed\":").append(QByteArray::number(s.fanSpeed));
+            out.append('}');
+        }
+        if (!error && result.schedule != 0) {
+            out.append(",\"schedule\":").append(QByteArray::number(result.schedule));
+        }
+        out.append('}');
+    }
+    if (command.framing & ControlCommand::InBatch) {
+        if (command.framing & ControlCommand::ClosesBatch) {
+            out.append("]\n");
+        }
+    } else {
+        out.append('\n');
+    }
+}
+
+/**
+ * @brief Возвращает команду-ошибку.
+ * @param error Текст ошибки.
+ */
+ControlCommand ControlProtocol::invalidCommand(const char *error) {
+    ControlCommand command;
+    command.error = error;
+    return command;
+}
+
+/**
+ * @brief Возвращает обозначение единицы температуры в протоколе.
+ * @param id Единица.
+ */
+const char *ControlProtocol::temperatureUnitName(int id) {
+    return id >= 1 && id <= 3 ? kTemperatureUnits[id - 1] : "?";
+}
+
+/**
+ * @brief Возвращает обозначение единицы давления в протоколе.
+ * @param id Единица.
+ */
+const char *ControlProtocol::pressureUnitName(int id) {
+    return id >= 1 && id <= 2 ? kPressureUnits[id - 1] : "?";
+}
@@ -0,0 +1,424 @@
+#include "../includes/controlserver.h"
+#include "../includes/climatemodel.h"
+#include "../includes/latencyprobe.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+
+/**
+ * @file controlserver.cpp
+ * @brief Реализация сервера управления по локальному сокету.
+ *
+ * Этот файл содержит реализацию сетевой части сервера (соединения, очереди команд,
+ * ответы) и выполнения команд над моделью.
+ */
+
+namespace {
+
+const qint64 kReadBufferSize = 1 << 20; ///< Наибольший буфер чтения сокета (дальше клиент ждёт в ядре)
+const char *const kLineTooLong = "line too long"; ///< Строка запроса длиннее ControlProtocol::kMaxLineLength
+const char *const kOutOfRange = "value out of range"; ///< Модель не приняла значение
+const char *const kNoSuchUnit = "no such unit"; ///< Номер блока вне парка
+const char *const kNoSuchSchedule = "no such schedule"; ///< Нет записи расписания с таким номером
+const char *const kNoSuchHoliday = "no such holiday"; ///< Нет замены для этой даты и блока
+
+const quint32 kStateFields = ClimateModel::ReadingChanged | ClimateModel::SetpointChanged | ClimateModel::HGateChanged
+    | ClimateModel::VGateChanged | ClimateModel::PowerChanged | ClimateModel::UnitsChanged
+    | ClimateModel::FanSpeedChanged | ClimateModel::CurrentUnitChanged; ///< Поля шины изменений, из которых состоит ControlState
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ControlServerWorker.
+ * @param owner Сервер, выполняющий команды.
+ */
+ControlServerWorker::ControlServerWorker(ControlServer *owner)
+    : owner(owner)
+{
+}
+
+/**
+ * @brief Начинает приём соединений.
+ *
+ * Сокет доступен только текущему пользователю; оставшийся от прошлого запуска файл
+ * сокета удаляется.
+ * @param name Имя сервера или путь к UNIX-сокету.
+ * @return true, если сокет открыт.
+ */
+bool ControlServerWorker::listen(const QString &name) {
+    server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &ControlServerWorker::accept);
+    QLocalServer::removeServer(name);
+    return server->listen(name);
+}
+
+/**
+ * @brief Принимает ожидающие соединения.
+ */
+void ControlServerWorker::accept() {
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        const quint64 id = nextConnection++;
+        socket->setReadBufferSize(kReadBufferSize);
+        connections[id].socket = socket;
+        connect(socket, &QLocalSocket::readyRead, this, [=]() { readAvailable(id); });
+        connect(socket, &QLocalSocket::disconnected, this, [=]() {
+            connections.remove(id);
+            socket->deleteLater();
+        });
+        readAvailable(id);
+    }
+}
+
+/**
+ * @brief Читает и разбирает доступные запросы соединения.
+ *
+ * Пока в соединении больше ControlServer::kMaxPending команд без ответа, чтение
+ * приостанавливается (возобновляется из complete()), и клиент упирается в буфер сокета.
+ * @param id Номер соединения.
+ */
+void ControlServerWorker::readAvailable(quint64 id) {
+    const auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection &connection = *it;
+    if (connection.pending.size() - connection.next >= ControlServer::kMaxPending) {
+        return;
+    }
+    QByteArray data = connection.socket->readAll();
+    if (data.isEmpty()) {
+        return;
+    }
+    if (connection.discarding) {
+        const int newline = data.indexOf('\n');
+        if (newline < 0) {
+            return;
+        }
+        data.remove(0, newline + 1);
+        connection.discarding = false;
+    }
+    if (connection.tail.isEmpty()) {
+        connection.tail = data;
+    } else {
+        connection.tail.append(data);
+    }
+    const qint64 used = ControlProtocol::parseChunk(connection.tail.constData(), connection.tail.size(), connection.pending);
+    connection.tail.remove(0, static_cast<int>(used));
+    if (connection.tail.size() > ControlProtocol::kMaxLineLength) {
+        connection.pending.append(ControlProtocol::invalidCommand(kLineTooLong));
+        connection.tail.clear();
+        connection.discarding = true;
+    }
+    pump(id, connection);
+}
+
+/**
+ * @brief Отвечает на команды очереди соединения по порядку.
+ *
+ * Команды, не меняющие состояние, получают ответ сразу по снимку состояния. Встретив
+ * команду, меняющую состояние, отправляет в поток модели порцию с неё (не больше
+ * ControlServer::kMaxCommandsPerHop команд, включая следующие за ней get) и ждёт результатов.
+ * @param id Номер соединения.
+ * @param connection Соединение.
+ */
+void ControlServerWorker::pump(quint64 id, Connection &connection) {
+    QByteArray out;
+    int answered = 0;
+    while (!connection.inFlight && connection.next < connection.pending.size()) {
+        const ControlCommand &command = connection.pending.at(connection.next);
+        if (!command.isMutating()) {
+            ControlProtocol::appendResponse(command, owner->answer(command), out);
+            ++connection.next;
+            ++answered;
+            continue;
+        }
+        const int count = qMin(ControlServer::kMaxCommandsPerHop, connection.pending.size() - connection.next);
+        const QVector<ControlCommand> portion = connection.pending.mid(connection.next, count);
+        connection.next += count;
+        connection.inFlight = true;
+        ControlServer *server = owner;
+        // close() удаляет работника, пока порция ещё ждёт в потоке модели: ответ тогда отбрасывается.
+        // close() возвращается после завершения потока сервера, поэтому проверка не гонится с удалением
+        QPointer<ControlServerWorker> self(this);
+        QMetaObject::invokeMethod(owner, [server, self, id, portion]() {
+            const QVector<ControlResult> results = server->execute(portion);
+            if (!self) {
+                return;
+            }
+            QMetaObject::invokeMethod(self.data(), [self, id, portion, results]() {
+                self->complete(id, portion, results);
+            }, Qt::QueuedConnection);
+        }, Qt::QueuedConnection);
+    }
+    if (connection.next == connection.pending.size()) {
+        connection.pending.resize(0);
+        connection.next = 0;
+    } else if (connection.next >= 4 * ControlServer::kMaxCommandsPerHop) {
+        connection.pending.remove(0, connection.next);
+        connection.next = 0;
+    }
+    owner->handled.fetch_add(static_cast<quint64>(answered), std::memory_order_relaxed);
+    if (!out.isEmpty()) {
+        connection.socket->write(out);
+    }
+}
+
+/**
+ * @brief Принимает результаты порции команд и отвечает на них.
+ * @param id Номер соединения.
+ * @param commands Команды порции.
+ * @param results Результаты команд.
+ */
+void ControlServerWorker::complete(quint64 id, const QVector<ControlCommand> &commands, const QVector<ControlResult> &results) {
+    const auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection &connection = *it;
+    QByteArray out;
+    for (int i = 0; i < commands.size(); ++i) {
+        ControlProtocol::appendResponse(commands[i], results[i], out);
+    }
+    owner->handled.fetch_add(static_cast<quint64>(commands.size()), std::memory_order_relaxed);
+    connection.socket->write(out);
+    connection.inFlight = false;
+    pump(id, connection);
+    readAvailable(id);
+}
+
+/**
+ * @brief Конструктор класса ControlServer.
+ * @param model Модель состояния.
+ * @param parent Родительский объект.
+ */
+ControlServer::ControlServer(ClimateModel *model, QObject *parent)
+    : QObject(parent)
+    , model(model)
+{
+    serverThread.setObjectName("control server");
+    model->stateBus()->subscribe(kStateFields, this, [=](const StateDelta &delta) { applyDelta(delta); });
+    connect(model, &ClimateModel::fleetResized, this, &ControlServer::publishState);
+    publishState();
+}
+
+/**
+ * @brief Деструктор класса ControlServer.
+ */
+ControlServer::~ControlServer() {
+    close();
+}
+
+/**
+ * @brief Открывает локальный сокет и запускает поток сервера.
+ * @param name Имя сервера или путь к UNIX-сокету.
+ * @return true, если сокет открыт.
+ */
+bool ControlServer::listen(const QString &name) {
+    close();
+    worker = new ControlServerWorker(this);
+    worker->moveToThread(&serverThread);
+    connect(&serverThread, &QThread::finished, worker, &QObject::deleteLater);
+    serverThread.start();
+
+    bool ok = false;
+    ControlServerWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target, name, &ok]() { ok = target->listen(name); }, Qt::BlockingQueuedConnection);
+    if (!ok) {
+        close();
+    }
+    return ok;
+}
+
+/**
+ * @brief Закрывает сокет и останавливает поток сервера.
+ */
+void ControlServer::close() {
+    if (serverThread.isRunning()) {
+        serverThread.quit();
+        serverThread.wait();
+    }
+    worker = nullptr;
+}
+
+/**
+ * @brief Выполняет порцию команд над моделью.
+ * @param commands Команды.
+ * @return Результаты в порядке команд.
+ */
+QVector<ControlResult> ControlServer::execute(const QVector<ControlCommand> &commands) {
+    ACM_PROBE("ControlServer::execute");
+    QVector<ControlResult> results;
+    results.reserve(commands.size());
+    for (const ControlCommand &command : commands) {
+        results.append(apply(command));
+    }
+    hops.fetch_add(1, std::memory_order_relaxed);
+    return results;
+}
+
+/**
+ * @brief Отвечает на команду, не меняющую состояние, по снимку состояния.
+ * @param command Команда.
+ */
+ControlResult ControlServer::answer(const ControlCommand &command) const {
+    ControlResult result;
+    if (command.op == ControlCommand::Get) {
+        result.hasState = true;
+        result.state = state();
+    }
+    return result;
+}
+
+/**
+ * @brief Публикует состояние текущего блока для потока сервера целиком.
+ *
+ * Вызывается при создании и после изменения размера парка; остальные изменения
+ * приходят из шины через applyDelta().
+ */
+void ControlServer::publishState() {
+    ControlState &state = current;
+    state.unit = model->currentUnit();
+    state.fleetSize = model->fleetSize();
+    state.power = model->isOn() ? 1 : 0;
+    state.hGate = model->hGateDir();
+    state.vGate = model->vGateDir();
+    state.temperatureUnit = static_cast<qint32>(model->temperatureUnit());
+    state.pressureUnit = static_cast<qint32>(model->pressureUnit());
+    state.fanSpeed = static_cast<qint32>(model->fanSpeed());
+    state.temperature = model->temperature();
+    state.setpoint = model->setpoint();
+    state.humidity = model->humidity();
+    state.pressure = model->pressure();
+    published.store(state);
+}
+
+/**
+ * @brief Переносит в состояние изменившиеся поля и публикует его для потока сервера.
+ * @param delta Изменение из шины (только поля kStateFields).
+ */
+void ControlServer::applyDelta(const StateDelta &delta) {
+    if (delta.fields & ClimateModel::TemperatureChanged) {
+        current.temperature = delta.temperature;
+    }
+    if (delta.fields & ClimateModel::HumidityChanged) {
+        current.humidity = delta.humidity;
+    }
+    if (delta.fields & ClimateModel::PressureChanged) {
+        current.pressure = delta.pressure;
+    }
+    if (delta.fields & ClimateModel::SetpointChanged) {
+        current.setpoint = delta.setpoint;
+    }
+    if (delta.fields & ClimateModel::HGateChanged) {
+        current.hGate = delta.hGate;
+    }
+    if (delta.fields & ClimateModel::VGateChanged) {
+        current.vGate = delta.vGate;
+    }
+    if (delta.fields & ClimateModel::PowerChanged) {
+        current.power = delta.power;
+    }
+    if (delta.fields & ClimateModel::UnitsChanged) {
+        current.temperatureUnit = delta.temperatureUnit;
+        current.pressureUnit = delta.pressureUnit;
+    }
+    if (delta.fields & ClimateModel::FanSpeedChanged) {
+        current.fanSpeed = delta.fanSpeed;
+    }
+    if (delta.fields & ClimateModel::CurrentUnitChanged) {
+        current.unit = delta.unit;
+        current.fleetSize = delta.fleetSize;
+    }
+    published.store(current);
+}
+
+/**
+ * @brief Выполняет одну команду над моделью.
+ *
+ * Команды идут через те же слоты модели, что и кнопки окна, поэтому попадают в журнал
+ * и в запись входных воздействий. Шина доставляет изменения синхронно, поэтому снимок
+ * состояния к этому моменту уже обновлён, и get внутри порции видит результат предыдущих команд.
+ * @param command Команда.
+ */
+ControlResult ControlServer::apply(const ControlCommand &command) {
+    ControlResult result;
+    switch (command.op) {
+        case ControlCommand::SetSetpoint: {
+            const double value = command.hasFirst
+                ? ClimateModel::convertTemperature(command.value, static_cast<ClimateModel::TemperatureUnit>(command.first),
+                                                   model->temperatureUnit())
+                : command.value;
+            if (!model->setSetpoint(value)) {
+                result.error = kOutOfRange;
+            }
+            break;
+        }
+        case ControlCommand::StepSetpoint:
+            if (!model->setSetpoint(model->setpoint() + command.first * model->temperatureStep())) {
+                result.error = kOutOfRange;
+            }
+            break;
+        case ControlCommand::SetGates:
+            if (!model->setGates(command.hasFirst ? command.first : model->hGateDir(),
+                                 command.hasSecond ? command.second : model->vGateDir())) {
+                result.error = kOutOfRange;
+            }
+            break;
+        case ControlCommand::SetPower:
+            model->setPower(command.first != 0);
+            break;
+        case ControlCommand::TogglePower:
+            model->togglePower();
+            break;
+        case ControlCommand::SelectUnit:
+            if (command.first < 0 || command.first >= model->fleetSize()) {
+                result.error = kNoSuchUnit;
+            } else {
+                model->selectUnit(command.first);
+            }
+            break;
+        case ControlCommand::SetUnits:
+            model->setUnits(command.hasFirst ? command.first : static_cast<int>(model->temperatureUnit()),
+                            command.hasSecond ? command.second : static_cast<int>(model->pressureUnit()));
+            break;
+        case ControlCommand::AddSchedule: {
+            ScheduleEntry entry = command.schedule;
+            if (entry.action == ScheduleEntry::SetSetpoint) {
+                const ClimateModel::TemperatureUnit unit = command.hasFirst
+                    ? static_cast<ClimateModel::TemperatureUnit>(command.first) : model->temperatureUnit();
+                entry.setpoint = ClimateModel::convertTemperature(command.value, unit, ClimateModel::TemperatureUnit::Celsius);
+            }
+            if (entry.unit < 0 || entry.unit >= model->fleetSize()) {
+                result.error = kNoSuchUnit;
+            } else {
+                result.schedule = model->addSchedule(entry);
+                if (result.schedule == 0) {
+                    result.error = kOutOfRange;
+                }
+            }
+            break;
+        }
+        case ControlCommand::RemoveSchedule:
+            if (!model->removeSchedule(command.schedule.id)) {
+                result.error = kNoSuchSchedule;
+            }
+            break;
+        case ControlCommand::SetHoliday:
+            if (command.holiday.unit >= model->fleetSize()) {
+                result.error = kNoSuchUnit;
+            } else {
+                model->setHoliday(command.holiday);
+            }
+            break;
+        case ControlCommand::RemoveHoliday:
+            if (!model->removeHoliday(command.holiday.day, command.holiday.unit)) {
+                result.error = kNoSuchHoliday;
+            }
+            break;
+        default:
+            result = answer(command);
+            break;
+    }
+    return result;
+}
@@ -1,10 +1,11 @@
 #include "../includes/coolwindow.h"
-#include <QFile>
-#include <QDomDocument>
-#include <QDomElement>
-#include <QTextStream>
+#include "../includes/startuptrace.h"
+#include "../includes/latencyprobe.h"
+#include "../includes/eventtrace.h"
 #include <QDebug>
-#include <QtMath>
+#include <QEvent>
+#include <QHeaderView>
+#include <QShortcut>
 
 /**
  * @file coolwindow.cpp
@@ -13,70 +14,102 @@
  * Этот файл содержит реализацию методов класса CoolWindow,
  * отвечающего за создание и управление основным интерфейсом приложения.
  */
+
+namespace {
+
+const char *const kFanBlades = ":/fan.gif"; ///< Изображение вентилятора (ресурс resourses/resources.qrc)
+const int kFanSizePx = 100; ///< Размер вентилятора на экране
+const int kLatencyRefreshMs = 500; ///< Период обновления таблицы длительностей операций
+
+/**
+ * @brief Возвращает скорость вращения вентилятора на экране, оборотов в секунду.
+ */
+double fanRevolutionsPerSecond(ClimateModel::FanSpeed speed) {
+    switch (speed) {
+        case ClimateModel::FanSpeed::Low:
+            return 0.5;
+        case ClimateModel::FanSpeed::High:
+            return 2.0;
+        default:
+            return 1.0;
+    }
+}
+
+} // namespace
+
 /**
  * @brief Конструктор класса CoolWindow.
  * 
- * Загружает настройки пользователя из XML-файла, устанавливает начальные значения для параметров
- * температуры, влажности и давления. Определяет графический интерфейс пользователя (GUI) с элементами
+ * Создаёт модель состояния и загружает в неё сохранённое состояние из двоичного снимка и журнала изменений. Определяет графический интерфейс пользователя (GUI) с элементами
  * управления, такими как кнопки включения/выключения, управление температурой, направлением воздуха,
  * а также интерфейс для отображения графических элементов.
+ *
+ * До первого кадра выполняется только то, что на нём видно: история измерений загружается
+ * в finishStartup() после первой отрисовки, окна настроек и ввода создаются при первом открытии. Этапы отмечаются в StartupTrace.
  * @param parent Родительский виджет для главного окна.
  */
 CoolWindow::CoolWindow(QWidget *parent)
-    : QMainWindow(parent)
+    : QMainWindow(parent), themes("centralWidget"),
+      temperatureLabel("Т: ", {"", " C", " F", " K"}, 2, true),
+      humidityLabel("В: ", {" %"}, 2, true),
+      pressureLabel("Д: ", {"", " Pa", " mm.h.g."}, 1, false),
+      setpointLabel("Уставка: ", {"", " C", " F", " K"}, 2, true),
+      outputLabel("Мощность: ", {" %"}, 0, false)
 {
-    loadSettings("user_settings.xml"); // Загрузка настроек пользователя
-    hGateDir = new int(0); // Инициализация направления по горизонтали
-    vGateDir = new int(0); // Инициализация направления по вертикали
+    model = new ClimateModel(this);
+    frameClock = new FrameClock(this);
+    sceneUpdates = new UpdateScheduler(frameClock, this);
+    connect(sceneUpdates, &UpdateScheduler::updatesReady, this, &CoolWindow::applySceneUpdates);
+    model->load(ClimateModel::defaultSnapshotPath(), true); // Загрузка настроек пользователя и восстановление по журналу; история — после первого кадра
+    StartupTrace::mark("model");
 
     // Установка минимального и максимального размера окна
     this->setMinimumSize(800,600);
     this->setMaximumSize(1024, 768);
 
     centralWidget = new QWidget(this); // Центральный виджет окна
+    centralWidget->setObjectName("centralWidget"); // Корень правил таблицы стилей темы
     this->setCentralWidget(centralWidget); // Установка центрального виджета
 
     dataLayout = new QHBoxLayout;
 
-    // Метка для индикации включения/выключения
-    onOffLabel = new QLabel;
-
-    airBlades = new QMovie("../../resourses/fan.gif");
-    onOffLabel->setMovie(airBlades);
-    onOffLabel->setFixedSize(100, 100);  // Пример размера 100x100 пикселей
-    onOffLabel->setScaledContents(true);
-    airBlades->start();
-    airBlades->stop();
+    // Вентилятор для индикации включения/выключения
+    fan = new FanWidget(frameClock);
+    fan->setFixedSize(kFanSizePx, kFanSizePx);
+    fan->loadBlades(kFanBlades);
 
     // Создание сцены и графического вида для отображения данных
     scene = new QGraphicsScene(this);
-    view = new QGraphicsView(scene);
-    view->setStyleSheet("border: 0px;");
-
-    // Добавление графических элементов на сцену для отображения температуры, влажности и давления
-    thermometer = scene->addRect(50, 10, 30, 300);
-    mercuryLevel = scene->addRect(51, 310, 28, 0, QPen(), QBrush(Qt::red));
-
-    humidityScale = scene->addRect(150, 10, 30, 300);
-    QColor customBlueColor("#8AC8FF");
-    QBrush humBrush(customBlueColor);
-    humidityLevel = scene->addRect(151, 310, 28, 0, QPen(), humBrush);
-
-    pressureScale = scene->addRect(250, 10, 30, 300);
-    pressureLevel = scene->addRect(251, 310, 28, 0, QPen(), QBrush(Qt::gray));
+    view = new ProbedGraphicsView(scene); // Отрисовка сцены измеряется как операция "paint"
+
+    // Цвета элементов сцены берутся из палитры темы
+    const ThemePalette palette = ThemeEngine::paletteFor(static_cast<int>(model->theme()));
+
+    // Неподвижный фон приборов: контуры шкал и крайние положения жалюзи (кэшируется в растр)
+    gaugeBackground = new GaugeBackgroundItem();
+    gaugeBackground->addScale(QRectF(50, 10, 30, 300));
+    gaugeBackground->addScale(QRectF(150, 10, 30, 300));
+    gaugeBackground->addScale(QRectF(250, 10, 30, 300));
+    gaugeBackground->addGuide(QLineF(450, 10, 450, 100));
+    gaugeBackground->addGuide(QLineF(450, 10, 360, 10));
+    gaugeBackground->addGuide(QLineF(405, 195, 360, 240));
+    gaugeBackground->addGuide(QLineF(405, 195, 450, 240));
+    gaugeBackground->setGuidePen(QPen(palette.arrowGuide, 3));
+    scene->addItem(gaugeBackground);
+
+    // Столбики уровней температуры, влажности и давления
+    mercuryLevel = new LevelBarItem(QRectF(51, 10, 28, 300), QBrush(palette.temperatureFill));
+    humidityLevel = new LevelBarItem(QRectF(151, 10, 28, 300), QBrush(palette.humidityFill));
+    pressureLevel = new LevelBarItem(QRectF(251, 10, 28, 300), QBrush(palette.pressureFill));
+    scene->addItem(mercuryLevel);
+    scene->addItem(humidityLevel);
+    scene->addItem(pressureLevel);
 
     // Создаем стрелку, указывающую текущее вертикальное направление
-    hArrow = scene->addLine(0, 0, 0, -90, QPen(Qt::red, 3));
-    hStaticArrow = scene->addLine(0, 0, 0, -90, QPen(Qt::gray, 3));
-    hStaticArrow->setLine(450, 10, 450, 100);
-    hStaticArrow2 = scene->addLine(0, 0, -90, 0, QPen(Qt::gray, 3));
-    hStaticArrow2->setLine(450, 10, 360, 10);
-
-    hAngleArc = new QGraphicsPathItem();
-    hAngleArc->setPen(QPen(Qt::blue, 2));
-    scene->addItem(hAngleArc);
-
+    hArrow = new GateArrowItem(QPointF(450, 10), 90, QPen(palette.arrow, 3));
+    hArrow->setArcPen(QPen(palette.arc, 2));
     hArrow->setZValue(1);
+    scene->addItem(hArrow);
 
     updateHArrow();
 
@@ -84,13 +117,9 @@ CoolWindow::CoolWindow(QWidget *parent)
     hAirText->setPos(310, 125);
 
     // Создаем стрелку, указывающую текущее горизонтальное направление
-    vArrow = scene->addLine(0, 0, 0, -90, QPen(Qt::red, 3));
-    vStaticArrow = scene->addLine(0, 0, 0, -90, QPen(Qt::gray, 3));
-    vStaticArrow->setLine(405, 195, 360, 240);
-    vStaticArrow2 = scene->addLine(0, 0, -90, 0, QPen(Qt::gray, 3));
-    vStaticArrow2->setLine(405, 195, 450, 240);
-
+    vArrow = new GateArrowItem(QPointF(405, 195), 55, QPen(palette.arrow, 3));
     vArrow->setZValue(1);
+    scene->addItem(vArrow);
 
     updateVArrow();
 
@@ -98,15 +127,60 @@ CoolWindow::CoolWindow(QWidget *parent)
     vAirText->setPos(310, 260);
 
     // Отображение текстовых меток для температуры, влажности и давления
-    temperatureText = scene->addText("Т: ");
-    temperatureText->setPos(40, 320);
-    humidityText = scene->addText("В: ");
-    humidityText->setPos(150, 320);
-    pressureText = scene->addText("Д: ");
-    pressureText->setPos(220, 320);
-
-    // Добавление виджета индикации включения/выключения и графического вида в макет
-    dataLayout->addWidget(onOffLabel);
+    // (простой текст без документа; позиции сдвинуты на поле документа прежних меток)
+    temperatureText = scene->addSimpleText(temperatureLabel.text());
+    temperatureText->setPos(44, 324);
+    humidityText = scene->addSimpleText(humidityLabel.text());
+    humidityText->setPos(154, 324);
+    pressureText = scene->addSimpleText(pressureLabel.text());
+    pressureText->setPos(224, 324);
+
+    // Уставка температуры: отметка на шкале и метка; под ней мощность охлаждения от регулятора
+    setpointMarker = scene->addLine(QLineF(44, 0, 86, 0), QPen(palette.foreground, 2));
+    setpointMarker->setZValue(1);
+    setpointText = scene->addSimpleText(setpointLabel.text());
+    setpointText->setPos(314, 292);
+    outputText = scene->addSimpleText(outputLabel.text());
+    outputText->setPos(314, 312);
+
+    // График истории измерений под шкалами
+    trendChart = new TrendChartItem(&model->history(), 420, 90);
+    trendChart->setPos(40, 355);
+    trendChart->setChannelColor(SampleHistory::Temperature, palette.temperatureFill);
+    trendChart->setChannelColor(SampleHistory::Humidity, palette.humidityFill);
+    trendChart->setChannelColor(SampleHistory::Pressure, palette.pressureFill);
+    scene->addItem(trendChart);
+    updateTrendRanges();
+
+    // Настройка перерисовки: элементов мало и они часто меняют геометрию, поэтому индекс
+    // не нужен; границы сцены фиксируются, чтобы не пересчитываться при каждом изменении
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    scene->setSceneRect(scene->itemsBoundingRect());
+    view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    view->setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
+    StartupTrace::mark("scene");
+
+    // Список блоков парка (виртуализированный: отрисовываются только видимые строки)
+    fleetModel = new FleetModel(&model->fleet(), this);
+    fleetModel->setScales(ClimateModel::temperatureScale(model->temperatureUnit()), ClimateModel::pressureScale(model->pressureUnit()));
+    fleetView = new QTableView(this);
+    fleetView->setModel(fleetModel);
+    fleetView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    fleetView->setSelectionMode(QAbstractItemView::SingleSelection);
+    fleetView->setWordWrap(false);
+    fleetView->setShowGrid(false);
+    fleetView->verticalHeader()->hide();
+    fleetView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed); // Строки одной высоты
+    fleetView->verticalHeader()->setDefaultSectionSize(20);
+    fleetView->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    fleetView->horizontalHeader()->setDefaultSectionSize(55);
+    fleetView->horizontalHeader()->setStretchLastSection(true);
+    fleetView->setFixedWidth(300);
+    fleetView->hide(); // Список показывается, только если блоков больше одного
+
+    // Добавление списка блоков, виджета индикации включения/выключения и графического вида в макет
+    dataLayout->addWidget(fleetView);
+    dataLayout->addWidget(fan);
     dataLayout->addWidget(view);
 
     buttonsLayout = new QHBoxLayout;
@@ -118,11 +192,9 @@ CoolWindow::CoolWindow(QWidget *parent)
     changeTempLayout = new QVBoxLayout;
     tempUp = new QPushButton("+", this); // Кнопка увеличения температуры
     tempUp->setMaximumSize(35,35);
-    tempUp->setEnabled(isOn); // Кнопка активна, если система включена
 
     tempDown = new QPushButton("-", this); // Кнопка уменьшения температуры
     tempDown->setMaximumSize(35,35);
-    tempDown->setEnabled(isOn); // Кнопка активна, если система включена
 
     changeTempLayout->addWidget(tempUp);
     changeTempLayout->addWidget(tempDown);
@@ -141,10 +213,6 @@ CoolWindow::CoolWindow(QWidget *parent)
     airDown->setMinimumHeight(25);
     airLeft->setMinimumHeight(25);
     airRight->setMinimumHeight(25);
-    airUp->setEnabled(isOn);
-    airDown->setEnabled(isOn);
-    airLeft->setEnabled(isOn);
-    airRight->setEnabled(isOn);
 
     // Добавление кнопок управления воздухом в макет
     airBttnsLabel = new QLabel;
@@ -161,13 +229,11 @@ CoolWindow::CoolWindow(QWidget *parent)
     openSettings = new QPushButton("Настройки", this);
     openSettings->setMinimumHeight(50);
     openSettings->setMaximumWidth(300);
-    openSettings->setEnabled(isOn);
 
     // Кнопка для изменения входных параметров
     openInput = new QPushButton("Изменить входные параметры", this);
     openInput->setMinimumHeight(50);
     openInput->setMaximumWidth(300);
-    openInput->setEnabled(isOn);
 
     // Добавление всех кнопок в макет
     buttonsLayout->addWidget(onOffButton);
@@ -180,45 +246,97 @@ CoolWindow::CoolWindow(QWidget *parent)
     mainLayout->addLayout(dataLayout);
     mainLayout->addLayout(buttonsLayout);
 
-    setCurrentTheme(); // Установка текущей темы оформления
-    openSettings->setStyleSheet(getLockStyle());
-    openInput->setStyleSheet(getLockStyle());
-    tempUp->setStyleSheet(getLockStyle());
-    tempDown->setStyleSheet(getLockStyle());
-    airUp->setStyleSheet(getLockStyle());
-    airDown->setStyleSheet(getLockStyle());
-    airLeft->setStyleSheet(getLockStyle());
-    airRight->setStyleSheet(getLockStyle());
+    applyTheme(model->theme()); // Установка текущей темы оформления
+    applyFanSpeed();
 
     centralWidget->setLayout(mainLayout);
+    StartupTrace::mark("widgets");
 
     // Соединение сигналов и слотов для обработки нажатий кнопок
     connect(onOffButton, &QPushButton::clicked, this, &CoolWindow::toggleIndicator);
     connect(openSettings, &QPushButton::clicked, this, &CoolWindow::openSettingsWindow);
     connect(openInput, &QPushButton::clicked, this, &CoolWindow::openInputWindow);
-    connect(tempUp, &QPushButton::clicked, this, &CoolWindow::temperatureUp);
-    connect(tempDown, &QPushButton::clicked, this, &CoolWindow::temperatureDown);
-    connect(airUp, &QPushButton::clicked, this, &CoolWindow::addAirUp);
-    connect(airDown, &QPushButton::clicked, this, &CoolWindow::addAirDown);
-    connect(airLeft, &QPushButton::clicked, this, &CoolWindow::addAirLeft);
-    connect(airRight, &QPushButton::clicked, this, &CoolWindow::addAirRight);
-}
-
-/**
- * @brief Устанавливает текущую тему оформления в зависимости от выбранной пользователем.
- */
-void CoolWindow::setCurrentTheme() {
-    switch (currentTheme) {
-        case Theme::Light:
-            applyLightTheme();
-            return;
-        case Theme::Dark:
-            applyDarkTheme();
-            return;
-        default:
-            applyLightTheme();
-            return;
+    connect(tempUp, &QPushButton::clicked, model, &ClimateModel::temperatureUp);
+    connect(tempDown, &QPushButton::clicked, model, &ClimateModel::temperatureDown);
+    connect(airUp, &QPushButton::clicked, model, [=]() { model->moveHGate(ClimateModel::kGateStep); });
+    connect(airDown, &QPushButton::clicked, model, [=]() { model->moveHGate(-ClimateModel::kGateStep); });
+    connect(airLeft, &QPushButton::clicked, model, [=]() { model->moveVGate(ClimateModel::kGateStep); });
+    connect(airRight, &QPushButton::clicked, model, [=]() { model->moveVGate(-ClimateModel::kGateStep); });
+    connect(fleetView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, [=](const QModelIndex &current) {
+        if (current.isValid()) {
+            selectUnit(current.row());
+        }
+    });
+
+    // Отладочная таблица длительностей операций, её выгрузка в JSON и трассировка событий
+    connect(new QShortcut(QKeySequence(Qt::Key_F12), this), &QShortcut::activated, this, &CoolWindow::toggleLatencyOverlay);
+    connect(new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_D), this), &QShortcut::activated, this, [=]() {
+        dumpLatency();
+    });
+    connect(new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_T), this), &QShortcut::activated, this, [=]() {
+        toggleTrace();
+    });
+
+    // Отображение изменений модели: окно — подписчик шины на все поля текущего блока
+    model->stateBus()->subscribe(ClimateModel::AllChanged, this, [=](const StateDelta &delta) {
+        onModelChanged(delta.fields);
+    });
+    connect(model, &ClimateModel::unitStateChanged, fleetModel, &FleetModel::unitChanged);
+    connect(model, &ClimateModel::fleetReadingsChanged, fleetModel, &FleetModel::allUnitsChanged);
+    connect(model, &ClimateModel::fleetAboutToResize, fleetModel, &FleetModel::beginResize);
+    connect(model, &ClimateModel::fleetResized, this, [=]() {
+        fleetModel->endResize();
+        updateFleetView();
+    });
+
+    // Регулятор работает в своём потоке; окно забирает его состояние по таймеру, не блокируя поток
+    model->controller()->start();
+    model->scheduler()->start(); // Недельное расписание парка выполняется в потоке окна вместе с моделью
+    controllerPoll = new QTimer(this);
+    connect(controllerPoll, &QTimer::timeout, this, &CoolWindow::pollController);
+    controllerPoll->start(static_cast<int>(model->controller()->period() / 1000000));
+
+    // Восстановление сохранённого парка и состояния питания текущего блока
+    updateFleetView();
+    applyPowerState();
+    sceneUpdates->markDirty(HGateField | VGateField | TrendField | SetpointField);
+
+    // Отложенная работа запуска начинается после первой отрисовки сцены
+    view->viewport()->installEventFilter(this);
+    StartupTrace::mark("window");
+}
+
+/**
+ * @brief Отслеживает первую отрисовку окна.
+ *
+ * Отложенная работа ставится в очередь событий и выполняется после того, как кадр
+ * отрисован и выведен на экран.
+ * @param watched Объект, которому адресовано событие.
+ * @param event Событие.
+ * @return Результат обработки базовым классом.
+ */
+bool CoolWindow::eventFilter(QObject *watched, QEvent *event) {
+    if (event->type() == QEvent::Paint && watched == view->viewport()) {
+        view->viewport()->removeEventFilter(this);
+        QTimer::singleShot(0, this, &CoolWindow::finishStartup);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+/**
+ * @brief Выполняет работу, отложенную до первого кадра.
+ */
+void CoolWindow::finishStartup() {
+    if (startupFinished) {
+        return;
     }
+    StartupTrace::mark("first frame");
+
+    model->loadHistory();
+    StartupTrace::mark("history");
+
+    startupFinished = true;
+    emit startupComplete();
 }
 
 /**
@@ -227,35 +345,8 @@ void CoolWindow::setCurrentTheme() {
  * Устанавливает темный фон и белые границы для всех элементов интерфейса.
  */
 void CoolWindow::applyDarkTheme() {
-    centralWidget->setStyleSheet("background: black; color: white;");
-    onOffButton->setStyleSheet("border: 1px solid white;");
-    openSettings->setStyleSheet("border: 1px solid white;");
-    openInput->setStyleSheet("border: 1px solid white;");
-    tempUp->setStyleSheet("border: 1px solid white;");
-    tempDown->setStyleSheet("border: 1px solid white;");
-    airBttnsLabel->setStyleSheet("color: white;");
-    airUp->setStyleSheet("border: 1px solid white;");
-    airDown->setStyleSheet("border: 1px solid white;");
-    airLeft->setStyleSheet("border: 1px solid white;");
-    airRight->setStyleSheet("border: 1px solid white;");
-    temperatureText->setDefaultTextColor(Qt::white);
-    humidityText->setDefaultTextColor(Qt::white);
-    pressureText->setDefaultTextColor(Qt::white);
-    hAirText->setDefaultTextColor(Qt::white);
-    vAirText->setDefaultTextColor(Qt::white);
-
-    QPen pen;
-    pen.setColor(Qt::white);
-    pen.setWidth(1);
-    thermometer->setPen(pen);
-    humidityScale->setPen(pen);
-    pressureScale->setPen(pen);
-
-    mercuryLevel->setPen(pen);
-    humidityLevel->setPen(pen);
-    pressureLevel->setPen(pen);
-
-    currentTheme = Theme::Dark;
+    ACM_PROBE("applyDarkTheme");
+    model->setTheme(static_cast<int>(Theme::Dark));
 }
 
 /**
@@ -264,35 +355,51 @@ void CoolWindow::applyDarkTheme() {
  * Устанавливает светлый фон и черные границы для всех элементов интерфейса.
  */
 void CoolWindow::applyLightTheme() {
-    centralWidget->setStyleSheet("background: white; color: black;");
-    onOffButton->setStyleSheet("border: 1px solid black;");
-    openSettings->setStyleSheet("border: 1px solid black;");
-    openInput->setStyleSheet("border: 1px solid black;");
-    tempUp->setStyleSheet("border: 1px solid black;");
-    tempDown->setStyleSheet("border: 1px solid black;");
-    airBttnsLabel->setStyleSheet("color: black;");
-    airUp->setStyleSheet("border: 1px solid black;");
-    airDown->setStyleSheet("border: 1px solid black;");
-    airLeft->setStyleSheet("border: 1px solid black;");
-    airRight->setStyleSheet("border: 1px solid black;");
-    temperatureText->setDefaultTextColor(Qt::black);
-    humidityText->setDefaultTextColor(Qt::black);
-    pressureText->setDefaultTextColor(Qt::black);
-    hAirText->setDefaultTextColor(Qt::black);
-    vAirText->setDefaultTextColor(Qt::black);
+    ACM_PROBE("applyLightTheme");
+    model->setTheme(static_cast<int>(Theme::Light));
+}
+
+/**
+ * @brief Применяет тему оформления.
+ *
+ * Виджеты оформляются таблицей стилей темы уровня приложения, а перья и цвета
+ * элементов сцены берутся из палитры темы.
+ * @param id Тема.
+ */
+void CoolWindow::applyTheme(Theme id) {
+    themes.apply(static_cast<int>(id));
+    const ThemePalette &palette = themes.palette();
+
+    temperatureText->setBrush(palette.foreground);
+    humidityText->setBrush(palette.foreground);
+    pressureText->setBrush(palette.foreground);
+    setpointText->setBrush(palette.foreground);
+    outputText->setBrush(palette.foreground);
+    setpointMarker->setPen(QPen(palette.foreground, 2));
+    hAirText->setDefaultTextColor(palette.foreground);
+    vAirText->setDefaultTextColor(palette.foreground);
 
     QPen pen;
-    pen.setColor(Qt::black);
+    pen.setColor(palette.foreground);
     pen.setWidth(1);
-    thermometer->setPen(pen);
-    humidityScale->setPen(pen);
-    pressureScale->setPen(pen);
+    gaugeBackground->setFramePen(pen);
 
     mercuryLevel->setPen(pen);
     humidityLevel->setPen(pen);
     pressureLevel->setPen(pen);
+    trendChart->setFrameColor(palette.foreground);
+}
 
-    currentTheme = Theme::Light;
+/**
+ * @brief Включает или выключает элементы управления и помечает выключенные заблокированными.
+ * @param widgets Элементы управления.
+ * @param enabled Новое состояние.
+ */
+void CoolWindow::setControlsEnabled(std::initializer_list<QWidget *> widgets, bool enabled) {
+    for (QWidget *widget : widgets) {
+        widget->setEnabled(enabled);
+        ThemeEngine::setLocked(widget, !enabled);
+    }
 }
 
 /**
@@ -303,430 +410,367 @@ void CoolWindow::applyLightTheme() {
  * @param pData Давление.
  */
 void CoolWindow::acceptNewData(double tData, double hData, double pData) {
-    delete temperature;
-    temperature = new double(tData);
-    delete humidity;
-    humidity = new double(hData);
-    delete pressure;
-    pressure = new double(pData);
-
-    setTemp();
-    setHum();
-    setPres();
-    temperatureText->setPlainText("Т: " + QString::number(*temperature) + " " + getTemperatureScaleByUnitId(currentTempUnit));
-    humidityText->setPlainText("В: " + QString::number(*humidity) + " %");
-    pressureText->setPlainText("Д: " + QString::number(*pressure, 'f', 1) + " " + getPressureScaleByUnitId(currentPresUnit));
+    ACM_PROBE("acceptNewData");
+    model->acceptReading(tData, hData, pData);
 }
 
 /**
- * @brief Обновляет визуальное представление уровня ртути в зависимости от температуры.
+ * @brief Задаёт диапазоны каналов графика истории по текущим единицам измерения.
  */
-void CoolWindow::setTemp() {
-    double minT = getMinTempForCurrentUnit();
-    double maxT = getMaxTempForCurrentUnit();
-    double range = 300/(maxT-minT);
-    mercuryLevel->setRect(51, 310 - (*temperature - minT) * range, 28, (*temperature - minT) * range);
+void CoolWindow::updateTrendRanges() {
+    trendChart->setRange(SampleHistory::Temperature, model->minTemperature(), model->maxTemperature());
+    trendChart->setRange(SampleHistory::Humidity, ClimateModel::minHumidity(), ClimateModel::maxHumidity());
+    trendChart->setRange(SampleHistory::Pressure, model->minPressure(), model->maxPressure());
 }
 
 /**
- * @brief Обновляет визуальное представление уровня влажности.
+ * @brief Принимает пакет измерений от конвейера приёма данных.
+ *
+ * Промежуточные измерения пакета не отображаются: экран может показать только
+ * последнее значение, а обновление сцены откладывается до ближайшего кадра.
+ * @param batch Измерения в порядке поступления.
  */
-void CoolWindow::setHum() {
-    humidityLevel->setRect(151, 310 - *humidity * 3, 28, *humidity * 3);
+void CoolWindow::acceptNewDataBatch(const QVector<SensorSample> &batch) {
+    ACM_PROBE("acceptNewDataBatch");
+    model->acceptBatch(batch);
 }
 
 /**
- * @brief Обновляет визуальное представление уровня давления.
+ * @brief Отображает изменения модели.
+ *
+ * Изменившиеся части сцены помечаются для обновления в ближайшем кадре, а элементы
+ * управления, список блоков и открытое окно ввода обновляются сразу.
+ * @param fields Биты ClimateModel::Change изменившихся частей.
  */
-void CoolWindow::setPres() {
-    double minP = getMinPresForCurrentUnit();
-    double maxP = getMaxPresForCurrentUnit();
-    double range = 300/(maxP-minP);
-    pressureLevel->setRect(251, 310 - (*pressure - minP) * range, 28, (*pressure - minP) * range);
-}
-
-/**
- * @brief Принимает новые настройки для единиц измерения температуры и давления.
- * 
- * @param tempId ID новой единицы измерения температуры.
- * @param presId ID новой единицы измерения давления.
- */
-void CoolWindow::acceptSettings(int tempId, int presId) {
-    TemperatureUnit tid = static_cast<TemperatureUnit>(tempId);
-    PressureUnit pid = static_cast<PressureUnit>(presId);
-
-    recalculateTemp(currentTempUnit, tid);
-    recalculatePres(currentPresUnit, pid);
-
-    currentTempUnit = tid;
-    currentPresUnit = pid;
-
-    setTemp();
-    setHum();
-    setPres();
-    temperatureText->setPlainText("Т: " + QString::number(*temperature) + " " + getTemperatureScaleByUnitId(currentTempUnit));
-    humidityText->setPlainText("В: " + QString::number(*humidity) + " %");
-    pressureText->setPlainText("Д: " + QString::number(*pressure, 'f', 1) + " " + getPressureScaleByUnitId(currentPresUnit));
-
-    if (inputWindow) {
-        inputWindow->setMinMaxTempUnit(getMinTempForCurrentUnit(), getMaxTempForCurrentUnit());
-        setHumRange();
-        inputWindow->setMinMaxPresUnit(getMinPresForCurrentUnit(), getMaxPresForCurrentUnit());
-        inputWindow->setCurrentValues(*temperature, getTemperatureScaleByUnitId(currentTempUnit), *humidity, *pressure, getPressureScaleByUnitId(currentPresUnit));
+void CoolWindow::onModelChanged(quint32 fields) {
+    quint32 sceneFields = 0;
+    if (fields & ClimateModel::TemperatureChanged) {
+        sceneFields |= TemperatureField;
     }
-}
-
-/**
- * @brief Возвращает строковое представление единицы измерения температуры по ID.
- * 
- * @param id ID единицы измерения температуры.
- * @return QString Строка с обозначением единицы (C, F, K).
- */
-QString CoolWindow::getTemperatureScaleByUnitId(TemperatureUnit id) {
-    switch (id) {
-        case TemperatureUnit::Celsius:
-            currentTempUnit = TemperatureUnit::Celsius;
-            return "C";
-        case TemperatureUnit::Fahrenheit:
-            currentTempUnit = TemperatureUnit::Fahrenheit;
-            return "F";
-        case TemperatureUnit::Kelvin:
-            currentTempUnit = TemperatureUnit::Kelvin;
-            return "K";
+    if (fields & ClimateModel::HumidityChanged) {
+        sceneFields |= HumidityField;
+    }
+    if (fields & ClimateModel::PressureChanged) {
+        sceneFields |= PressureField;
+    }
+    if (fields & ClimateModel::HGateChanged) {
+        sceneFields |= HGateField;
+    }
+    if (fields & ClimateModel::VGateChanged) {
+        sceneFields |= VGateField;
+    }
+    if (fields & ClimateModel::HistoryChanged) {
+        sceneFields |= TrendField;
+    }
+    if (fields & ClimateModel::SetpointChanged) {
+        sceneFields |= SetpointField;
+    }
+    if (fields & ClimateModel::PowerChanged) {
+        applyPowerState();
+    }
+    if (fields & ClimateModel::UnitsChanged) {
+        updateTrendRanges();
+        fleetModel->setScales(ClimateModel::temperatureScale(model->temperatureUnit()), ClimateModel::pressureScale(model->pressureUnit()));
+        sceneFields |= ReadingFields | TrendField | SetpointField;
+    }
+    if (fields & ClimateModel::ThemeChanged) {
+        applyTheme(model->theme());
+    }
+    if (fields & ClimateModel::FanSpeedChanged) {
+        applyFanSpeed();
+    }
+    if (fields & ClimateModel::CurrentUnitChanged) {
+        updateFleetView();
+    }
+    if (fields & (ClimateModel::UnitsChanged | ClimateModel::CurrentUnitChanged)) {
+        updateInputWindow();
+    }
+    if (sceneFields != 0) {
+        sceneUpdates->markDirty(sceneFields);
     }
-
-    return "Unknown";
 }
 
 /**
- * @brief Возвращает единицу измерения температуры по строковому обозначению.
- * 
- * @param scale Строка с обозначением единицы измерения.
- * @return CoolWindow::TemperatureUnit Соответствующая единица измерения температуры.
+ * @brief Забирает последнее состояние регулятора.
+ *
+ * Чтение не ждёт поток регулятора; метка обновляется в ближайшем кадре вместе
+ * с остальными изменениями сцены.
  */
-CoolWindow::TemperatureUnit CoolWindow::getTemperatureUnitByScale(QString scale) {
-    if (scale == "C") {
-        return TemperatureUnit::Celsius;
-    } else if (scale == "F") {
-        return TemperatureUnit::Fahrenheit;
-    } else if (scale == "K") {
-        return TemperatureUnit::Kelvin;
+void CoolWindow::pollController() {
+    const quint64 tick = model->controller()->state().tick;
+    if (tick != controllerTick) {
+        controllerTick = tick;
+        sceneUpdates->markDirty(ControlField);
     }
-
-    return TemperatureUnit::Celsius;
 }
 
 /**
- * @brief Увеличивает значение температуры.
+ * @brief Применяет к сцене изменения, накопленные за кадр.
+ *
+ * Обновляются только помеченные части. Если система выключена, уровни показаний
+ * опускаются до нуля, а в метках остаются только префиксы.
+ * @param fields Биты изменённых частей сцены.
  */
-void CoolWindow::temperatureUp() {
-    switch (currentTempUnit) {
-        case TemperatureUnit::Fahrenheit:
-            if (*temperature + 1.8 <= getMaxTempForCurrentUnit()) {
-                *temperature = *temperature + 1.8;
+void CoolWindow::applySceneUpdates(quint32 fields) {
+    ACM_PROBE("scene update");
+    const bool isOn = model->isOn();
+    if (fields & TemperatureField) {
+        if (isOn) {
+            setTemp();
+            updateTemperatureText();
+        } else {
+            mercuryLevel->setLevel(0);
+            if (temperatureLabel.clear()) {
+                temperatureText->setText(temperatureLabel.text());
             }
-            break;
-        default:
-            if (*temperature + 1 <= getMaxTempForCurrentUnit()) {
-                *temperature = *temperature + 1;
+        }
+    }
+    if (fields & HumidityField) {
+        if (isOn) {
+            setHum();
+            if (humidityLabel.format(model->humidity())) {
+                humidityText->setText(humidityLabel.text());
             }
-            break;
+        } else {
+            humidityLevel->setLevel(0);
+            if (humidityLabel.clear()) {
+                humidityText->setText(humidityLabel.text());
+            }
+        }
     }
-
-    setTemp();
-    temperatureText->setPlainText("Т: " + QString::number(*temperature) + " " + getTemperatureScaleByUnitId(currentTempUnit));
-}
-
-/**
- * @brief Уменьшает значение температуры.
- */
-void CoolWindow::temperatureDown() {
-    switch (currentTempUnit) {
-        case TemperatureUnit::Fahrenheit:
-            if (*temperature - 1.8 >= getMinTempForCurrentUnit()) {
-                *temperature = *temperature - 1.8;
+    if (fields & PressureField) {
+        if (isOn) {
+            setPres();
+            if (pressureLabel.format(model->pressure(), static_cast<int>(model->pressureUnit()))) {
+                pressureText->setText(pressureLabel.text());
             }
-            break;
-        default:
-            if (*temperature - 1 >= getMinTempForCurrentUnit()) {
-                *temperature = *temperature - 1;
+        } else {
+            pressureLevel->setLevel(0);
+            if (pressureLabel.clear()) {
+                pressureText->setText(pressureLabel.text());
             }
-            break;
+        }
     }
-
-    setTemp();
-    temperatureText->setPlainText("Т: " + QString::number(*temperature) + " " + getTemperatureScaleByUnitId(currentTempUnit));
-}
-
-/**
- * @brief Увеличивает направление воздушного потока вверх.
- */
-void CoolWindow::addAirUp() {
-    if (*hGateDir + 5 <= getMaxHDir()) {
-        *hGateDir = *hGateDir + 5;
-        updateHArrow();
+    if (fields & SetpointField) {
+        setpointMarker->setVisible(isOn);
+        if (isOn) {
+            setSetpoint();
+            if (setpointLabel.format(model->setpoint(), static_cast<int>(model->temperatureUnit()))) {
+                setpointText->setText(setpointLabel.text());
+            }
+        } else if (setpointLabel.clear()) {
+            setpointText->setText(setpointLabel.text());
+        }
     }
-}
-
-/**
- * @brief Увеличивает направление воздушного потока вниз.
- */
-void CoolWindow::addAirDown() {
-    if (*hGateDir - 5 >= getMinHDir()) {
-        *hGateDir = *hGateDir - 5;
+    if (fields & ControlField) {
+        const bool changed = isOn ? outputLabel.format(model->controller()->state().output * 100.0) : outputLabel.clear();
+        if (changed) {
+            outputText->setText(outputLabel.text());
+        }
+    }
+    if (fields & HGateField) {
         updateHArrow();
     }
-}
-
-/**
- * @brief Увеличивает направление воздушного потока влево.
- */
-void CoolWindow::addAirLeft() {
-    if (*vGateDir + 5 <= getMaxVDir()) {
-        *vGateDir = *vGateDir + 5;
+    if (fields & VGateField) {
         updateVArrow();
     }
+    if (fields & TrendField) {
+        trendChart->update();
+    }
 }
 
 /**
- * @brief Уменьшает направление воздушного потока вправо.
+ * @brief Обновляет текстовую метку температуры, если изменилось отображаемое значение.
  */
-void CoolWindow::addAirRight() {
-    if (*vGateDir - 5 >= getMinVDir()) {
-        *vGateDir = *vGateDir - 5;
-        updateVArrow();
+void CoolWindow::updateTemperatureText() {
+    if (temperatureLabel.format(model->temperature(), static_cast<int>(model->temperatureUnit()))) {
+        temperatureText->setText(temperatureLabel.text());
     }
 }
 
 /**
- * @brief Возвращает минимальное значение направления вертикального потока воздуха.
- * 
- * @return int Минимальное значение направления вертикального потока воздуха.
+ * @brief Обновляет визуальное представление уровня ртути в зависимости от температуры.
  */
-int CoolWindow::getMinHDir() {
-    return 0;
+void CoolWindow::setTemp() {
+    double minT = model->minTemperature();
+    double maxT = model->maxTemperature();
+    double range = 300/(maxT-minT);
+    mercuryLevel->setLevel((model->temperature() - minT) * range);
 }
 
 /**
- * @brief Возвращает максимальное значение направления вертикального потока воздуха.
- * 
- * @return int Максимальное значение направления вертикального потока воздуха.
+ * @brief Переносит отметку уставки на высоту уставки на шкале температуры.
  */
-int CoolWindow::getMaxHDir() {
-    return 90;
+void CoolWindow::setSetpoint() {
+    double minT = model->minTemperature();
+    double maxT = model->maxTemperature();
+    double range = 300/(maxT-minT);
+    setpointMarker->setY(310 - qBound(0.0, (model->setpoint() - minT) * range, 300.0));
 }
 
 /**
- * @brief Возвращает минимальное значение направления горизонтального потока воздуха.
- * 
- * @return int Минимальное значение направления горизонтального потока воздуха.
+ * @brief Обновляет визуальное представление уровня влажности.
  */
-int CoolWindow::getMinVDir() {
-    return -45;
+void CoolWindow::setHum() {
+    humidityLevel->setLevel(model->humidity() * 3);
 }
 
 /**
- * @brief Возвращает максимальное значение направления горизонтального потока воздуха.
- * 
- * @return int Максимальное значение направления горизонтального потока воздуха.
+ * @brief Обновляет визуальное представление уровня давления.
  */
-int CoolWindow::getMaxVDir() {
-    return 45;
+void CoolWindow::setPres() {
+    double minP = model->minPressure();
+    double maxP = model->maxPressure();
+    double range = 300/(maxP-minP);
+    pressureLevel->setLevel((model->pressure() - minP) * range);
 }
 
 /**
- * @brief Возвращает строковое представление единицы измерения давления по ID.
+ * @brief Принимает новые настройки для единиц измерения температуры и давления.
  * 
- * @param id ID единицы измерения давления.
- * @return QString Строка с обозначением единицы (Pa, mm.h.g.).
+ * @param tempId ID новой единицы измерения температуры.
+ * @param presId ID новой единицы измерения давления.
  */
-QString CoolWindow::getPressureScaleByUnitId(PressureUnit id) {
-    switch (id) {
-        case PressureUnit::Pascal:
-            currentPresUnit = PressureUnit::Pascal;
-            return "Pa";
-        case PressureUnit::Mmhg:
-            currentPresUnit = PressureUnit::Mmhg;
-            return "mm.h.g.";
-    }
-
-    return "Unknown";
+void CoolWindow::acceptSettings(int tempId, int presId) {
+    ACM_PROBE("acceptSettings");
+    model->setUnits(tempId, presId);
 }
 
 /**
- * @brief Возвращает единицу измерения давления по строковому обозначению.
- * 
- * @param scale Строка с обозначением единицы измерения.
- * @return CoolWindow::PressureUnit Соответствующая единица измерения давления.
+ * @brief Показывает или скрывает таблицу длительностей операций поверх сцены.
+ *
+ * Таблица создаётся при первом показе и обновляется по таймеру только пока показана.
  */
-CoolWindow::PressureUnit CoolWindow::getPressureUnitByScale(QString scale) {
-    if (scale == "Pa") {
-        return PressureUnit::Pascal;
-    } else if (scale == "mm.h.g.") {
-        return PressureUnit::Mmhg;
+void CoolWindow::toggleLatencyOverlay() {
+    if (!latencyOverlay) {
+        latencyOverlay = new LatencyOverlayItem();
+        latencyOverlay->setZValue(10);
+        latencyOverlay->setPos(scene->sceneRect().topLeft());
+        latencyOverlay->setVisible(false);
+        scene->addItem(latencyOverlay);
+        latencyRefresh = new QTimer(this);
+        connect(latencyRefresh, &QTimer::timeout, this, [=]() {
+            latencyOverlay->refresh();
+        });
+    }
+    const bool show = !latencyOverlay->isVisible();
+    latencyOverlay->setVisible(show);
+    if (show) {
+        latencyOverlay->refresh();
+        latencyRefresh->start(kLatencyRefreshMs);
+    } else {
+        latencyRefresh->stop();
     }
-
-    return PressureUnit::Pascal;
 }
 
 /**
- * @brief Возвращает строковое представление темы по ID.
- * 
- * @param id ID темы.
- * @return QString Строка с обозначением темы (Light, Dark).
+ * @brief Выгружает гистограммы длительностей операций в JSON.
+ * @param path Путь к файлу.
+ * @return true, если файл записан.
  */
-QString CoolWindow::getThemeById(Theme id) {
-    switch (id) {
-        case Theme::Light:
-            currentPresUnit = PressureUnit::Pascal;
-            return "Light";
-        case Theme::Dark:
-            currentPresUnit = PressureUnit::Mmhg;
-            return "Dark";
+bool CoolWindow::dumpLatency(const QString &path) {
+    if (!LatencyProbes::dump(path)) {
+        qWarning() << "Не удалось записать длительности операций в" << path;
+        return false;
     }
-
-    return "Unknown";
+    return true;
 }
 
 /**
- * @brief Возвращает тему по ее строковому обозначению.
- * 
- * @param theme Строка с обозначением темы.
- * @return CoolWindow::Theme Соответствующая тема.
+ * @brief Включает трассировку событий или выключает её и выгружает в формате Chrome Trace Event.
+ *
+ * При включении записанные ранее интервалы забываются, так что выгрузка содержит
+ * только промежуток между двумя нажатиями.
+ * @param path Путь к файлу выгрузки.
+ * @return true, если трассировка включена или успешно выгружена.
  */
-CoolWindow::Theme CoolWindow::getThemeUnitByName(QString theme) {
-    if (theme == "Light") {
-        return Theme::Light;
-    } else if (theme == "Dark") {
-        return Theme::Dark;
+bool CoolWindow::toggleTrace(const QString &path) {
+    if (!EventTrace::isRecording()) {
+        EventTrace::clear();
+        EventTrace::setRecording(true);
+        return true;
+    }
+    EventTrace::setRecording(false);
+    if (!EventTrace::exportChrome(path)) {
+        qWarning() << "Не удалось записать трассировку событий в" << path;
+        return false;
     }
-    return Theme::Light;
+    return true;
 }
 
 /**
- * @brief Пересчитывает температуру из одной единицы измерения в другую.
- * 
- * @param from Единица измерения, из которой необходимо пересчитать.
- * @param to Единица измерения, в которую необходимо пересчитать.
+ * @brief Передаёт открытому окну ввода диапазоны и текущие значения в текущих единицах измерения.
  */
-void CoolWindow::recalculateTemp(TemperatureUnit from, TemperatureUnit to) {
-    if (from == to) {
+void CoolWindow::updateInputWindow() {
+    if (!inputWindow) {
         return;
     }
 
-    if (from == TemperatureUnit::Celsius) {
-        if (to == TemperatureUnit::Fahrenheit) {
-            *temperature = *temperature * (9.0/5.0) + 32;
-            return;
-        }
-        if (to == TemperatureUnit::Kelvin) {
-            *temperature = *temperature + 273.15;
-            return;
-        }
-    }
-    if (from == TemperatureUnit::Fahrenheit) {
-        if (to == TemperatureUnit::Celsius) {
-            *temperature = (*temperature - 32) * (5.0/9.0);
-            return;
-        }
-        if (to == TemperatureUnit::Kelvin) {
-            *temperature = (*temperature - 32) * (5.0/9.0) + 273.15;
-            return;
-        }
-    }
-    if (from == TemperatureUnit::Kelvin) {
-        if (to == TemperatureUnit::Celsius) {
-            *temperature = *temperature - 273.15;
-            return;
-        }
-        if (to == TemperatureUnit::Fahrenheit) {
-            *temperature = (*temperature - 273.15) * (9.0/5.0) + 32;
-            return;
-        }
-    }
+    inputWindow->setMinMaxTempUnit(model->minTemperature(), model->maxTemperature());
+    setHumRange();
+    inputWindow->setMinMaxPresUnit(model->minPressure(), model->maxPressure());
+    inputWindow->setCurrentValues(model->temperature(), ClimateModel::temperatureScale(model->temperatureUnit()),
+                                  model->humidity(), model->pressure(), ClimateModel::pressureScale(model->pressureUnit()));
 }
 
 /**
- * @brief Пересчитывает давление из одной единицы измерения в другую.
- * 
- * @param from Единица измерения, из которой необходимо пересчитать.
- * @param to Единица измерения, в которую необходимо пересчитать.
+ * @brief Переключает индикатор состояния устройства (включено/выключено).
  */
-void CoolWindow::recalculatePres(PressureUnit from, PressureUnit to) {
-    if (from == to) {
-        return;
-    }
-    if (from == PressureUnit::Pascal) {
-        if (to == PressureUnit::Mmhg) {
-            *pressure = *pressure / (133.3224);
-            return;
-        }
-    }
-    if (from == PressureUnit::Mmhg) {
-        if (to == PressureUnit::Pascal) {
-            *pressure = *pressure * 133.3224;
-            return;
-        }
-    }
+void CoolWindow::toggleIndicator() {
+    ACM_PROBE("toggleIndicator");
+    model->togglePower();
 }
 
 /**
- * @brief Переключает индикатор состояния устройства (включено/выключено).
+ * @brief Отображает состояние питания текущего блока: вентилятор, надпись кнопки,
+ * доступность элементов управления и сцену включённой или выключенной системы.
  */
-void CoolWindow::toggleIndicator() {
-    isOn = !isOn;
+void CoolWindow::applyPowerState() {
+    const bool isOn = model->isOn();
+    fan->setRunning(isOn); // Выключенный вентилятор останавливается на текущем угле
     if (isOn) {
-        airBlades->start();
         onOffButton->setText("Выкл");
-
-        setTemp(); // Установка температуры
-        setHum(); // Установка влажности
-        setPres(); // Установка давления
-        temperatureText->setPlainText("Т: " + QString::number(*temperature) + " " + getTemperatureScaleByUnitId(currentTempUnit));
-        humidityText->setPlainText("В: " + QString::number(*humidity) + " %");
-        pressureText->setPlainText("Д: " + QString::number(*pressure, 'f', 1) + " " + getPressureScaleByUnitId(currentPresUnit));
-        setCurrentTheme();
     } else {
-        airBlades->stop();
         onOffButton->setText("Вкл");
-
-        offSystem();
-
-        openSettings->setStyleSheet(getLockStyle());
-        openInput->setStyleSheet(getLockStyle());
-        tempUp->setStyleSheet(getLockStyle());
-        tempDown->setStyleSheet(getLockStyle());
-        airUp->setStyleSheet(getLockStyle());
-        airDown->setStyleSheet(getLockStyle());
-        airLeft->setStyleSheet(getLockStyle());
-        airRight->setStyleSheet(getLockStyle());
     }
-    openInput->setEnabled(isOn);
-    tempUp->setEnabled(isOn);
-    tempDown->setEnabled(isOn);
-    airUp->setEnabled(isOn);
-    airDown->setEnabled(isOn);
-    airLeft->setEnabled(isOn);
-    airRight->setEnabled(isOn);
-    openSettings->setEnabled(isOn);
+    setControlsEnabled({openSettings, openInput, tempUp, tempDown, airUp, airDown, airLeft, airRight}, isOn);
+    sceneUpdates->markDirty(ReadingFields | SetpointField | ControlField);
 }
 
 /**
- * @brief Задаёт минимальные значения столбцов с показателями, убирает показатель температуры и устанавливает жалюзи в стартовую позицию.
+ * @brief Задаёт скорость вращения вентилятора по настройке модели.
  */
-void CoolWindow::offSystem() {
-    mercuryLevel->setRect(51, 310, 28, 0);
-    pressureLevel->setRect(251, 310, 28, 0);
-    humidityLevel->setRect(151, 310, 28, 0);
+void CoolWindow::applyFanSpeed() {
+    fan->setSpeed(fanRevolutionsPerSecond(model->fanSpeed()));
+}
 
-    temperatureText->setPlainText("Т: ");
-    humidityText->setPlainText("В: ");
-    pressureText->setPlainText("Д: ");
+/**
+ * @brief Делает блок текущим и отображает его на сцене.
+ * @param id Номер блока.
+ */
+void CoolWindow::selectUnit(int id) {
+    model->selectUnit(id);
+}
 
-    *vGateDir = 0;
-    *hGateDir = 0;
-    updateVArrow();
-    updateHArrow();
+/**
+ * @brief Задаёт количество блоков в парке.
+ *
+ * Новые блоки выключены и получают текущие показания выбранного блока.
+ * @param count Количество блоков.
+ */
+void CoolWindow::setFleetSize(int count) {
+    model->setFleetSize(count);
+}
+
+/**
+ * @brief Показывает список блоков, если их больше одного, и выделяет в нём текущий блок.
+ */
+void CoolWindow::updateFleetView() {
+    const bool multiple = model->fleetSize() > 1;
+    fleetView->setVisible(multiple);
+    if (multiple) {
+        fleetView->selectRow(model->currentUnit());
+    }
 }
 
 /**
@@ -741,13 +785,15 @@ void CoolWindow::openSettingsWindow() {
 
         connect(settingsWindow, &Settings::darkThemeSelected, this, &CoolWindow::applyDarkTheme);
         connect(settingsWindow, &Settings::lightThemeSelected, this, &CoolWindow::applyLightTheme);
+        connect(settingsWindow, &Settings::fanSpeedSelected, model, &ClimateModel::setFanSpeed);
         connect(settingsWindow, &Settings::confirmSettings, this, &CoolWindow::acceptSettings);
 
-        int tid = static_cast<int>(currentTempUnit);
-        int pid = static_cast<int>(currentPresUnit);
+        int tid = static_cast<int>(model->temperatureUnit());
+        int pid = static_cast<int>(model->pressureUnit());
 
         settingsWindow->setActiveTempUnit(tid);
         settingsWindow->setActivePresUnit(pid);
+        settingsWindow->setActiveFanSpeed(static_cast<int>(model->fanSpeed()));
     }
 
     settingsWindow->show();
@@ -762,41 +808,15 @@ void CoolWindow::openInputWindow() {
     if (!inputWindow) {
         inputWindow = new CoolInput(this);
 
-        onOffButton->setEnabled(false);
-        tempUp->setEnabled(false);
-        tempDown->setEnabled(false);
-        airUp->setEnabled(false);
-        airDown->setEnabled(false);
-        airLeft->setEnabled(false);
-        airRight->setEnabled(false);
-
-        QString lockStyle = getLockStyle();
-        onOffButton->setStyleSheet(lockStyle);
-        tempUp->setStyleSheet(lockStyle);
-        tempDown->setStyleSheet(lockStyle);
-        airUp->setStyleSheet(lockStyle);
-        airDown->setStyleSheet(lockStyle);
-        airLeft->setStyleSheet(lockStyle);
-        airRight->setStyleSheet(lockStyle);
+        setControlsEnabled({onOffButton, tempUp, tempDown, airUp, airDown, airLeft, airRight}, false);
         connect(inputWindow, &QDialog::finished, this, [=]() {
             inputWindow = nullptr;
-            onOffButton->setEnabled(true);
-            tempUp->setEnabled(true);
-            tempDown->setEnabled(true);
-            airUp->setEnabled(true);
-            airDown->setEnabled(true);
-            airLeft->setEnabled(true);
-            airRight->setEnabled(true);
-
-            setCurrentTheme();
+            setControlsEnabled({onOffButton, tempUp, tempDown, airUp, airDown, airLeft, airRight}, true);
         });
 
-        connect(inputWindow, &CoolInput::sendInputData, this, &CoolWindow::acceptNewData);
+        connect(inputWindow, &CoolInput::sendInputData, model, &ClimateModel::acceptReading);
 
-        inputWindow->setMinMaxTempUnit(getMinTempForCurrentUnit(), getMaxTempForCurrentUnit());
-        setHumRange();
-        inputWindow->setMinMaxPresUnit(getMinPresForCurrentUnit(), getMaxPresForCurrentUnit());
-        inputWindow->setCurrentValues(*temperature, getTemperatureScaleByUnitId(currentTempUnit), *humidity, *pressure, getPressureScaleByUnitId(currentPresUnit));
+        updateInputWindow();
     }
     
     inputWindow->show();
@@ -804,237 +824,33 @@ void CoolWindow::openInputWindow() {
     inputWindow->activateWindow();
 }
 
-/**
- * @brief Возвращает стиль блокировки в зависимости от текущей темы.
- * 
- * @return QString Стиль блокировки в виде строки.
- */
-QString CoolWindow::getLockStyle() {
-    switch (currentTheme) {
-        case Theme::Dark:
-            return "background-color: rgba(169, 169, 169, 150); border: 1px solid white;";
-        case Theme::Light:
-            return "background-color: rgba(169, 169, 169, 150); border: 1px solid black;";
-        default:
-            return "background-color: rgba(169, 169, 169, 150); border: 1px solid black;";
-    }
-}
-
-/**
- * @brief Возвращает минимально допустимую температуру для текущей единицы измерения.
- * @return Минимальная температура в текущей единице измерения (Цельсий, Фаренгейт, Кельвин).
- */
-double CoolWindow::getMinTempForCurrentUnit() {
-    switch (currentTempUnit) {
-        case TemperatureUnit::Celsius:
-            return -10; // Минимальная температура в Цельсиях
-        case TemperatureUnit::Fahrenheit:
-            return 14; // Минимальная температура в Фаренгейтах
-        case TemperatureUnit::Kelvin:
-            return 263.15; // Минимальная температура в Кельвинах
-        default:
-            return 0.0; // Значение по умолчанию
-    }
-}
-
-/**
- * @brief Возвращает максимально допустимую температуру для текущей единицы измерения.
- * @return Максимальная температура в текущей единице измерения (Цельсий, Фаренгейт, Кельвин).
- */
-double CoolWindow::getMaxTempForCurrentUnit() {
-    switch (currentTempUnit) {
-        case TemperatureUnit::Celsius:
-            return 30.0; // Максимальная температура в Цельсиях
-        case TemperatureUnit::Fahrenheit:
-            return 86; // Максимальная температура в Фаренгейтах
-        case TemperatureUnit::Kelvin:
-            return 303.15; // Максимальная температура в Кельвинах
-        default:
-            return 30.0; // Значение по умолчанию
-    }
-}
-
 /**
  * @brief Устанавливает диапазон влажности в окне ввода данных.
  * 
  * Минимальное значение влажности установлено на 0%, максимальное — на 100%.
  */
 void CoolWindow::setHumRange() {
-    double minH, maxH;
-    minH = 0.0; // Минимальная влажность
-    maxH = 100.0; // Максимальная влажность
-    inputWindow->setMinMaxHumUnit(minH, maxH); // Установка диапазона влажности
-}
-
-/**
- * @brief Возвращает минимальное давление для текущей единицы измерения.
- * @return Минимальное давление в текущей единице измерения (Паскали или мм рт. ст.).
- */
-double CoolWindow::getMinPresForCurrentUnit() {
-    switch (currentPresUnit) {
-        case PressureUnit::Pascal:
-            return 87000.0; // Минимальное давление в Паскалях
-        case PressureUnit::Mmhg:
-            return 652.0; // Минимальное давление в мм рт. ст.
-        default:
-            return 87000.0; // Значение по умолчанию
-    }
-}
-
-/**
- * @brief Возвращает максимальное давление для текущей единицы измерения.
- * @return Максимальное давление в текущей единице измерения (Паскали или мм рт. ст.).
- */
-double CoolWindow::getMaxPresForCurrentUnit() {
-    switch (currentPresUnit) {
-        case PressureUnit::Pascal:
-            return 108500.0; // Максимальное давление в Паскалях
-        case PressureUnit::Mmhg:
-            return 814.0; // Максимальное давление в мм рт. ст.
-        default:
-            return 108500.0; // Значение по умолчанию
-    }
-}
-
-/**
- * @brief Сохраняет текущие настройки пользователя в XML-файл.
- * @param filePath Путь к файлу для сохранения настроек.
- * 
- * Сохраняет значения температуры, влажности, давления и выбранную тему интерфейса
- * в указанный XML-файл.
- */
-void CoolWindow::saveSettings(const QString &filePath) {
-    QFile file(filePath);
-
-    if (!file.open(QIODevice::WriteOnly)) {
-        return;
-    }
-
-    QDomDocument doc;
-    QDomElement root = doc.createElement("Settings");
-    doc.appendChild(root);
-
-    QDomElement tempElem = doc.createElement("Temperature");
-    tempElem.setAttribute("value", QString::number(*temperature));
-    tempElem.setAttribute("scale", getTemperatureScaleByUnitId(currentTempUnit));
-    root.appendChild(tempElem);
-
-    QDomElement humElem = doc.createElement("Humidity");
-    humElem.setAttribute("value", QString::number(*humidity));
-    root.appendChild(humElem);
-
-    QDomElement presElem = doc.createElement("Pressure");
-    presElem.setAttribute("value", QString::number(*pressure));
-    presElem.setAttribute("scale", getPressureScaleByUnitId(currentPresUnit));
-    root.appendChild(presElem);
-
-    QDomElement themeElem = doc.createElement("Theme");
-    themeElem.setAttribute("value", getThemeById(currentTheme));
-    root.appendChild(themeElem);
-
-    QTextStream stream(&file);
-    stream << doc.toString();
-    file.close();
-}
-
-/**
- * @brief Загружает настройки пользователя из XML-файла.
- * @param filePath Путь к файлу для загрузки настроек.
- * 
- * Загружает значения температуры, влажности, давления и темы интерфейса из указанного XML-файла.
- * Если файл недоступен или имеет ошибку, загружаются базовые настройки.
- */
-void CoolWindow::loadSettings(const QString &filePath) {
-    QFile file(filePath);
-
-    if (!file.open(QIODevice::ReadOnly)) {
-        setBaseSettings();
-        return;
-    }
-
-    QDomDocument doc;
-    if (!doc.setContent(&file)) {
-        file.close();
-        setBaseSettings();
-        return;
-    }
-    file.close();
-
-    QDomElement root = doc.documentElement();
-
-    QDomElement tempElem = root.firstChildElement("Temperature");
-    temperature = new double(tempElem.attribute("value").toDouble());
-    currentTempUnit = getTemperatureUnitByScale(tempElem.attribute("scale"));
-
-    QDomElement humElem = root.firstChildElement("Humidity");
-    humidity = new double(humElem.attribute("value").toDouble());
-
-    QDomElement presElem = root.firstChildElement("Pressure");
-    pressure = new double(presElem.attribute("value").toDouble());
-    currentPresUnit = getPressureUnitByScale(presElem.attribute("scale"));
-
-    QDomElement themeElem = root.firstChildElement("Theme");
-    currentTheme = getThemeUnitByName(themeElem.attribute("value"));
-}
-
-/**
- * @brief Устанавливает базовые настройки температуры, влажности, давления и темы.
- * 
- * Устанавливаются значения по умолчанию: температура — 16°C, давление — 87000 Паскалей,
- * влажность — 0%, тема интерфейса — светлая.
- */
-void CoolWindow::setBaseSettings() {
-    temperature = new double(16.0);
-    humidity = new double(0.0);
-    pressure = new double(87000.0);
-    currentTempUnit = TemperatureUnit::Celsius;
-    currentPresUnit = PressureUnit::Pascal;
-    currentTheme = Theme::Light;
+    inputWindow->setMinMaxHumUnit(ClimateModel::minHumidity(), ClimateModel::maxHumidity()); // Установка диапазона влажности
 }
 
 /**
  * @brief Изменяет положение горизонтальных жалюзи и отображает вертикальное направление воздуха.
  */
 void CoolWindow::updateHArrow() {
-    double radians = qDegreesToRadians(static_cast<double>(*hGateDir+90));
-    int x = static_cast<int>(90 * qCos(radians));
-    int y = static_cast<int>(90 * qSin(radians));
-
-    hArrow->setLine(450, 10, x+450, y+10);
-
-    QPainterPath path;
-    path.moveTo(450, 100);
-
-    double endAngle = *hGateDir;
-
-    QRectF arcRect(360, -80, 180, 180);
-    path.arcTo(arcRect, -90, -endAngle);
-
-    hAngleArc->setPath(path);
+    hArrow->setAngle(model->hGateDir());
 }
 
 /**
  * @brief Изменяет положение вертикальных жалюзи и отображает горизонтальное направление воздуха.
  */
 void CoolWindow::updateVArrow() {
-    double radians = qDegreesToRadians(static_cast<double>(*vGateDir+90));
-    int x = static_cast<int>(55 * qCos(radians));
-    int y = static_cast<int>(55 * qSin(radians));
-
-    vArrow->setLine(405, 195, x+405, y+195);
+    vArrow->setAngle(model->vGateDir());
 }
 
 /**
  * @brief Деструктор класса CoolWindow.
  * 
- * При завершении работы сохраняет настройки в файл "user_settings.xml" и освобождает память,
- * выделенную под значения температуры, влажности и давления.
+ * Состояние сохраняет модель: при уничтожении она уплотняет журнал изменений в файл "user_settings.bin".
  */
 CoolWindow::~CoolWindow() {
-    saveSettings("user_settings.xml");
-    delete temperature;
-    delete humidity;
-    delete pressure;
-    delete hGateDir;
-    delete vGateDir;
-}
\ No newline at end of file
+}
@@ -0,0 +1,389 @@
+#include "../includes/eventtrace.h"
+#include "../includes/latencyprobe.h"
+#include "../includes/seqlock.h"
+#include <QCoreApplication>
+#include <QMetaEnum>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+
+/**
+ * @file eventtrace.cpp
+ * @brief Реализация трассировки событий в формате Chrome Trace Event.
+ *
+ * Этот файл содержит реализацию буферов потоков, областей трассировки и выгрузки
+ * интервалов в JSON.
+ */
+
+/**
+ * @struct EventTrace::Buffer
+ * @brief Кольцевой буфер интервалов одного потока и его текущая активность.
+ *
+ * Пишет только поток-владелец; читатель (выгрузка) копирует интервалы в диапазоне
+ * [head - kBufferCapacity, head) и отбрасывает те, что могли быть перезаписаны
+ * во время копирования. Поля интервала атомарны, поэтому одновременные чтение и запись
+ * не являются гонкой данных.
+ */
+struct EventTrace::Buffer
+{
+    /**
+     * @struct Slot
+     * @brief Записанный интервал.
+     */
+    struct Slot
+    {
+        std::atomic<const char *> category{nullptr}; ///< Категория
+        std::atomic<const char *> name{nullptr}; ///< Название
+        std::atomic<const char *> detail{nullptr}; ///< Уточнение
+        std::atomic<quint64> start{0}; ///< Начало, тактов
+        std::atomic<quint64> end{0}; ///< Конец, тактов
+    };
+
+    int id = 0; ///< Номер потока в выгрузке
+    QByteArray threadName; ///< Название потока (защищено мьютексом реестра)
+    std::atomic<Slot *> entries{nullptr}; ///< Интервалы (выделяются при первой записи)
+    std::atomic<quint64> head{0}; ///< Количество записанных интервалов
+    std::atomic<quint64> floor{0}; ///< Интервалы с меньшими номерами забыты clear()
+    int depth = 0; ///< Вложенность открытых областей (только поток-владелец)
+    EventTrace::Activity current; ///< Текущая активность (только поток-владелец)
+    SeqLock<EventTrace::Activity> published; ///< Текущая активность для других потоков
+};
+
+std::atomic<int> EventTrace::modeBits{0};
+
+namespace {
+
+const char *const kUnknownEvent = "QEvent"; ///< Название типа события, отсутствующего в QEvent::Type
+
+/**
+ * @struct Registry
+ * @brief Буферы всех потоков. Буферы не удаляются до завершения программы.
+ */
+struct Registry
+{
+    QMutex mutex; ///< Защита списка и названий потоков
+    QVector<EventTrace::Buffer *> buffers; ///< Буферы в порядке создания
+};
+
+/**
+ * @brief Возвращает реестр буферов.
+ */
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local EventTrace::Buffer *threadBuffer = nullptr; ///< Буфер текущего потока
+
+/**
+ * @struct Interval
+ * @brief Копия интервала для выгрузки.
+ */
+struct Interval
+{
+    const char *category; ///< Категория
+    const char *name; ///< Название
+    const char *detail; ///< Уточнение
+    quint64 start; ///< Начало, тактов
+    quint64 end; ///< Конец, тактов
+};
+
+/**
+ * @brief Копирует интервалы буфера, пропуская перезаписанные во время копирования.
+ * @param buffer Буфер потока.
+ */
+QVector<Interval> snapshot(const EventTrace::Buffer *buffer) {
+    QVector<Interval> intervals;
+    const EventTrace::Buffer::Slot *entries = buffer->entries.load(std::memory_order_acquire);
+    if (!entries) {
+        return intervals;
+    }
+    const quint64 capacity = EventTrace::kBufferCapacity;
+    const quint64 head = buffer->head.load(std::memory_order_acquire);
+    const quint64 first = qMax(buffer->floor.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0);
+    intervals.reserve(static_cast<int>(head - first));
+    for (quint64 i = first; i < head; ++i) {
+        const EventTrace::Buffer::Slot &slot = entries[i & (capacity - 1)];
+        intervals.append({ slot.category.load(std::memory_order_relaxed), slot.name.load(std::memory_order_relaxed),
+                           slot.detail.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                           slot.end.load(std::memory_order_relaxed) });
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const quint64 after = buffer->head.load(std::memory_order_relaxed);
+    const quint64 overwritten = after > capacity ? after - capacity : 0;
+    if (overwritten > first) {
+        intervals.remove(0, static_cast<int>(qMin(overwritten, head) - first));
+    }
+    return intervals;
+}
+
+/**
+ * @brief Дописывает строку JSON с экранированием кавычек, обратной черты и управляющих символов.
+ * @param out Выходной буфер.
+ * @param text Строка.
+ */
+void appendJsonString(QByteArray &out, const char *text) {
+    out.append('"');
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out.append('\\').append(*c);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out.append(QByteArray("\\u00") + QByteArray::number(static_cast<unsigned char>(*c), 16).rightJustified(2, '0'));
+        } else {
+            out.append(*c);
+        }
+    }
+    out.append('"');
+}
+
+} // namespace
+
+/**
+ * @brief Включает или выключает запись интервалов.
+ * @param enabled true — записывать.
+ */
+void EventTrace::setRecording(bool enabled) {
+    LatencyClock::start();
+    if (enabled) {
+        modeBits.fetch_or(Recording, std::memory_order_relaxed);
+    } else {
+        modeBits.fetch_and(~Recording, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Включает или выключает отметку текущего обработчика в потоках.
+ * @param enabled true — отмечать.
+ */
+void EventTrace::setTracking(bool enabled) {
+    LatencyClock::start();
+    if (enabled) {
+        modeBits.fetch_or(Tracking, std::memory_order_relaxed);
+    } else {
+        modeBits.fetch_and(~Tracking, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Возвращает текущее время в тактах LatencyClock.
+ */
+quint64 EventTrace::now() {
+    return LatencyClock::now();
+}
+
+/**
+ * @brief Возвращает буфер текущего потока, создавая его при первом обращении.
+ *
+ * Поток приложения называется "GUI", остальные — по objectName() своего QThread
+ * или по номеру.
+ */
+EventTrace::Buffer *EventTrace::currentBuffer() {
+    if (threadBuffer) {
+        return threadBuffer;
+    }
+    Buffer *buffer = new Buffer;
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        buffer->threadName = "GUI";
+    } else if (!thread->objectName().isEmpty()) {
+        buffer->threadName = thread->objectName().toUtf8();
+    }
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    buffer->id = r.buffers.size() + 1;
+    if (buffer->threadName.isEmpty()) {
+        buffer->threadName = "thread " + QByteArray::number(buffer->id);
+    }
+    r.buffers.append(buffer);
+    threadBuffer = buffer;
+    return buffer;
+}
+
+/**
+ * @brief Задаёт название текущего потока в выгрузке.
+ * @param name Название потока.
+ */
+void EventTrace::setThreadName(const QByteArray &name) {
+    Buffer *buffer = currentBuffer();
+    QMutexLocker locker(&registry().mutex);
+    buffer->threadName = name;
+}
+
+/**
+ * @brief Возвращает, что выполняет поток буфера.
+ * @param buffer Буфер потока.
+ */
+EventTrace::Activity EventTrace::activity(const Buffer *buffer) {
+    return buffer->published.load();
+}
+
+/**
+ * @brief Записывает интервал в буфер текущего потока (если запись включена).
+ * @param category Категория интервала.
+ * @param name Название интервала.
+ * @param detail Уточнение или nullptr.
+ * @param startTicks Начало интервала, тактов LatencyClock.
+ * @param endTicks Конец интервала, тактов LatencyClock.
+ */
+void EventTrace::record(const char *category, const char *name, const char *detail, quint64 startTicks, quint64 endTicks) {
+    if (!isRecording()) {
+        return;
+    }
+    Buffer *buffer = currentBuffer();
+    Buffer::Slot *entries = buffer->entries.load(std::memory_order_relaxed);
+    if (!entries) {
+        entries = new Buffer::Slot[kBufferCapacity];
+        buffer->entries.store(entries, std::memory_order_release);
+    }
+    const quint64 index = buffer->head.load(std::memory_order_relaxed);
+    Buffer::Slot &slot = entries[index & (kBufferCapacity - 1)];
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.detail.store(detail, std::memory_order_relaxed);
+    slot.start.store(startTicks, std::memory_order_relaxed);
+    slot.end.store(endTicks, std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Забывает записанные интервалы всех потоков.
+ */
+void EventTrace::clear() {
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (Buffer *buffer : r.buffers) {
+        buffer->floor.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Возвращает записанные интервалы в формате Chrome Trace Event (JSON).
+ *
+ * Интервалы выгружаются событиями "X" (начало и длительность в микросекундах от самого
+ * раннего интервала), названия потоков — метаданными "thread_name". Уточнение
+ * интервала попадает в args.detail.
+ */
+QByteArray EventTrace::toChromeJson() {
+    QVector<QPair<int, QByteArray>> threads;
+    QVector<QVector<Interval>> perThread;
+    {
+        Registry &r = registry();
+        QMutexLocker locker(&r.mutex);
+        for (const Buffer *buffer : r.buffers) {
+            threads.append(qMakePair(buffer->id, buffer->threadName));
+            perThread.append(snapshot(buffer));
+        }
+    }
+
+    quint64 origin = ~quint64(0);
+    for (const QVector<Interval> &intervals : perThread) {
+        for (const Interval &interval : intervals) {
+            origin = qMin(origin, interval.start);
+        }
+    }
+    const double usPerTick = LatencyClock::nanosecondsPerTick() / 1000.0;
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out;
+    out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (int t = 0; t < threads.size(); ++t) {
+        const QByteArray tid = QByteArray::number(threads[t].first);
+        out.append(first ? "\n" : ",\n");
+        first = false;
+        out.append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":").append(pid).append(",\"tid\":").append(tid);
+        out.append(",\"args\":{\"name\":");
+        appendJsonString(out, threads[t].second.constData());
+        out.append("}}");
+        for (const Interval &interval : perThread[t]) {
+            const quint64 end = qMax(interval.end, interval.start);
+            out.append(",\n{\"ph\":\"X\",\"cat\":");
+            appendJsonString(out, interval.category);
+            out.append(",\"name\":");
+            appendJsonString(out, interval.name);
+            out.append(",\"pid\":").append(pid).append(",\"tid\":").append(tid);
+            out.append(",\"ts\":").append(QByteArray::number((interval.start - origin) * usPerTick, 'f', 3));
+            out.append(",\"dur\":").append(QByteArray::number((end - interval.start) * usPerTick, 'f', 3));
+            if (interval.detail) {
+                out.append(",\"args\":{\"detail\":");
+                appendJsonString(out, interval.detail);
+                out.append('}');
+            }
+            out.append('}');
+        }
+    }
+    out.append("\n]}\n");
+    return out;
+}
+
+/**
+ * @brief Записывает toChromeJson() в файл атомарно.
+ * @param path Путь к файлу.
+ * @return true, если файл записан.
+ */
+bool EventTrace::exportChrome(const QString &path) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const QByteArray json = toChromeJson();
+    if (file.write(json) != json.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+/**
+ * @brief Возвращает название типа события Qt.
+ *
+ * Строка берётся из метаданных перечисления QEvent::Type и живёт до завершения программы.
+ * @param type Тип события.
+ */
+const char *EventTrace::eventName(QEvent::Type type) {
+    static const QMetaEnum types = QMetaEnum::fromType<QEvent::Type>();
+    const char *name = types.valueToKey(type);
+    return name ? name : kUnknownEvent;
+}
+
+/**
+ * @brief Открывает область: отмечает её как текущую активность потока.
+ * @param category Категория интервала.
+ * @param name Название интервала.
+ * @param detail Уточнение или nullptr.
+ * @param startTicks Начало интервала, тактов LatencyClock.
+ */
+void TraceScope::enter(const char *category, const char *name, const char *detail, quint64 startTicks) {
+    buffer = EventTrace::currentBuffer();
+    this->category = category;
+    this->name = name;
+    this->detail = detail;
+    start = startTicks;
+    EventTrace::Activity &current = buffer->current;
+    enclosing = current.scope;
+    if (buffer->depth++ == 0) {
+        current.event = name;
+        current.receiver = detail;
+        current.startTicks = startTicks;
+    }
+    current.scope = name;
+    buffer->published.store(current);
+}
+
+/**
+ * @brief Закрывает область: записывает интервал и возвращает активность охватывающей области.
+ * @param endTicks Конец интервала, тактов LatencyClock.
+ */
+void TraceScope::leave(quint64 endTicks) {
+    EventTrace::Activity &current = buffer->current;
+    current.scope = enclosing;
+    if (--buffer->depth == 0) {
+        current = EventTrace::Activity();
+    }
+    buffer->published.store(current);
+    EventTrace::record(category, name, detail, start, endTicks);
+    buffer = nullptr;
+}
@@ -0,0 +1,151 @@
+#include "../includes/fanwidget.h"
+#include "../includes/frameclock.h"
+#include <QImage>
+#include <QImageReader>
+#include <QPainter>
+#include <QWindow>
+#include <cmath>
+
+/**
+ * @file fanwidget.cpp
+ * @brief Реализация класса FanWidget.
+ *
+ * Этот файл содержит реализацию вращения изображения вентилятора по часам кадров.
+ */
+
+namespace {
+
+const int kDefaultSizePx = 100; ///< Размер вентилятора, если размер виджета не задан
+
+} // namespace
+
+/**
+ * @brief Конструктор класса FanWidget.
+ * @param clock Часы кадров.
+ * @param parent Родительский виджет.
+ */
+FanWidget::FanWidget(FrameClock *clock, QWidget *parent)
+    : QWidget(parent), clock(clock)
+{
+    connect(clock, &FrameClock::frame, this, &FanWidget::onFrame);
+}
+
+/**
+ * @brief Загружает изображение лопастей.
+ *
+ * Изображение уменьшается при чтении (QImageReader::setScaledSize) и хранится
+ * с предумноженной альфой — в формате, который отрисовка использует без преобразования.
+ * @param path Путь к изображению.
+ * @return true, если изображение прочитано.
+ */
+bool FanWidget::loadBlades(const QString &path) {
+    const QSize target = size().isEmpty() ? QSize(kDefaultSizePx, kDefaultSizePx) : size();
+    QImageReader reader(path);
+    reader.setScaledSize(target);
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        return false;
+    }
+    blades = QPixmap::fromImage(image.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    update();
+    return true;
+}
+
+/**
+ * @brief Включает или останавливает вращение.
+ * @param on true — вращать.
+ */
+void FanWidget::setRunning(bool on) {
+    if (running == on) {
+        return;
+    }
+    running = on;
+    if (running) {
+        resume();
+    } else {
+        animating = false;
+    }
+}
+
+/**
+ * @brief Задаёт скорость вращения.
+ * @param value Оборотов в секунду.
+ */
+void FanWidget::setSpeed(double value) {
+    revolutionsPerSecond = qMax(0.0, value);
+}
+
+/**
+ * @brief Возвращает предпочтительный размер виджета.
+ */
+QSize FanWidget::sizeHint() const {
+    return blades.isNull() ? QSize(kDefaultSizePx, kDefaultSizePx) : blades.size();
+}
+
+/**
+ * @brief Рисует лопасти, повёрнутые на текущий угол.
+ *
+ * Отрисовка означает, что виджет снова виден, поэтому приостановленное вращение
+ * возобновляется отсюда.
+ * @param event Событие отрисовки.
+ */
+void FanWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    if (running && !animating) {
+        resume();
+    }
+    if (blades.isNull()) {
+        return;
+    }
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.translate(width() / 2.0, height() / 2.0);
+    painter.rotate(degrees);
+    painter.drawPixmap(QPointF(-blades.width() / 2.0, -blades.height() / 2.0), blades);
+}
+
+/**
+ * @brief Поворачивает лопасти на угол, пройденный с предыдущего кадра.
+ *
+ * Если виджет не виден, кадры больше не запрашиваются до следующей отрисовки.
+ * @param timestampNs Время кадра часов.
+ */
+void FanWidget::onFrame(qint64 timestampNs) {
+    if (!animating) {
+        return;
+    }
+    if (!isOnScreen()) {
+        animating = false;
+        return;
+    }
+    if (lastFrameNs >= 0) {
+        const double turns = (timestampNs - lastFrameNs) * 1e-9 * revolutionsPerSecond;
+        degrees = std::fmod(degrees + turns * 360.0, 360.0);
+    }
+    lastFrameNs = timestampNs;
+    update();
+    clock->requestFrame();
+}
+
+/**
+ * @brief Возвращает true, если виджет может быть виден на экране.
+ */
+bool FanWidget::isOnScreen() const {
+    if (!isVisible() || window()->isMinimized()) {
+        return false;
+    }
+    const QWindow *handle = window()->windowHandle();
+    return handle == nullptr || handle->isExposed();
+}
+
+/**
+ * @brief Начинает запрашивать кадры вращения.
+ */
+void FanWidget::resume() {
+    if (!isOnScreen()) {
+        return;
+    }
+    animating = true;
+    lastFrameNs = -1; // Время, пока вентилятор не был виден, не учитывается
+    clock->requestFrame();
+}
@@ -0,0 +1,147 @@
+#include "../includes/fleetmodel.h"
+#include "../includes/labelformatter.h"
+
+/**
+ * @file fleetmodel.cpp
+ * @brief Реализация класса FleetModel.
+ *
+ * Этот файл содержит реализацию табличной модели парка кондиционеров.
+ */
+
+namespace {
+
+const QString kHumiditySuffix = " %"; ///< Обозначение единицы влажности в ячейках
+
+} // namespace
+
+/**
+ * @brief Конструктор класса FleetModel.
+ * @param store Хранилище состояния парка.
+ * @param parent Родительский объект.
+ */
+FleetModel::FleetModel(const FleetStore *store, QObject *parent)
+    : QAbstractTableModel(parent), store(store)
+{
+}
+
+/**
+ * @brief Возвращает количество строк (блоков).
+ */
+int FleetModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : store->size();
+}
+
+/**
+ * @brief Возвращает количество колонок.
+ */
+int FleetModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/**
+ * @brief Возвращает данные ячейки.
+ *
+ * Текст формируется только для запрошенных (видимых) ячеек.
+ * @param index Индекс ячейки.
+ * @param role Роль данных.
+ */
+QVariant FleetModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= store->size()) {
+        return QVariant();
+    }
+
+    int id = index.row();
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == UnitColumn ? int(Qt::AlignLeft | Qt::AlignVCenter) : int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+        case UnitColumn:
+            return "Блок " + QString::number(id + 1);
+        case PowerColumn:
+            return store->isOn(id) ? "Вкл" : "Выкл";
+        case TemperatureColumn:
+            return LabelFormatter::fixed(store->temperature(id), 1, temperatureScale);
+        case HumidityColumn:
+            return LabelFormatter::fixed(store->humidity(id), 0, kHumiditySuffix);
+        case PressureColumn:
+            return LabelFormatter::fixed(store->pressure(id), 1, pressureScale);
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * @brief Возвращает заголовки колонок.
+ * @param section Номер колонки.
+ * @param orientation Ориентация заголовка.
+ * @param role Роль данных.
+ */
+QVariant FleetModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case UnitColumn:
+            return "Блок";
+        case PowerColumn:
+            return "Питание";
+        case TemperatureColumn:
+            return "Т";
+        case HumidityColumn:
+            return "В";
+        case PressureColumn:
+            return "Д";
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * @brief Задаёт обозначения единиц измерения.
+ * @param temperatureScale Обозначение единицы температуры.
+ * @param pressureScale Обозначение единицы давления.
+ */
+void FleetModel::setScales(const QString &temperatureScale, const QString &pressureScale) {
+    this->temperatureScale = " " + temperatureScale;
+    this->pressureScale = " " + pressureScale;
+    allUnitsChanged();
+}
+
+/**
+ * @brief Сообщает представлению об изменении одного блока.
+ * @param id Номер блока.
+ */
+void FleetModel::unitChanged(int id) {
+    emit dataChanged(index(id, 0), index(id, ColumnCount - 1), {Qt::DisplayRole});
+}
+
+/**
+ * @brief Сообщает представлению об изменении значений всех блоков.
+ *
+ * Представление перерисовывает только видимую часть диапазона.
+ */
+void FleetModel::allUnitsChanged() {
+    if (store->size() == 0) {
+        return;
+    }
+    emit dataChanged(index(0, 0), index(store->size() - 1, ColumnCount - 1), {Qt::DisplayRole});
+}
+
+/**
+ * @brief Начинает изменение количества блоков.
+ */
+void FleetModel::beginResize() {
+    beginResetModel();
+}
+
+/**
+ * @brief Завершает изменение количества блоков.
+ */
+void FleetModel::endResize() {
+    endResetModel();
+}
@@ -0,0 +1,113 @@
+#include "../includes/fleetstore.h"
+#include <cstring>
+
+/**
+ * @file fleetstore.cpp
+ * @brief Реализация класса FleetStore.
+ *
+ * Этот файл содержит реализацию методов колоночного хранилища состояния парка кондиционеров.
+ */
+
+/**
+ * @brief Изменяет количество блоков.
+ * @param count Новое количество блоков.
+ * @param temperature Начальная температура новых блоков.
+ * @param humidity Начальная влажность новых блоков.
+ * @param pressure Начальное давление новых блоков.
+ */
+void FleetStore::resize(int count, double temperature, double humidity, double pressure) {
+    int old = size();
+    temperatures.resize(count);
+    humidities.resize(count);
+    pressures.resize(count);
+    setpoints.resize(count);
+    hGateDirs.resize(count);
+    vGateDirs.resize(count);
+    flags.resize(count);
+
+    for (int id = old; id < count; ++id) {
+        temperatures[id] = temperature;
+        humidities[id] = humidity;
+        pressures[id] = pressure;
+        setpoints[id] = temperature;
+        hGateDirs[id] = 0;
+        vGateDirs[id] = 0;
+        flags[id] = 0;
+    }
+}
+
+/**
+ * @brief Заменяет содержимое хранилища колонками из внешнего буфера.
+ * @param count Количество блоков.
+ * @param temperature Колонка температур.
+ * @param humidity Колонка влажности.
+ * @param pressure Колонка давления.
+ * @param hDir Колонка положений горизонтальных жалюзи.
+ * @param vDir Колонка положений вертикальных жалюзи.
+ * @param flagColumn Колонка флагов.
+ */
+void FleetStore::assign(int count, const double *temperature, const double *humidity, const double *pressure,
+                        const qint8 *hDir, const qint8 *vDir, const quint8 *flagColumn) {
+    temperatures.resize(count);
+    humidities.resize(count);
+    pressures.resize(count);
+    setpoints.resize(count);
+    hGateDirs.resize(count);
+    vGateDirs.resize(count);
+    flags.resize(count);
+
+    memcpy(temperatures.data(), temperature, count * sizeof(double));
+    memcpy(setpoints.data(), temperature, count * sizeof(double));
+    memcpy(humidities.data(), humidity, count * sizeof(double));
+    memcpy(pressures.data(), pressure, count * sizeof(double));
+    memcpy(hGateDirs.data(), hDir, count * sizeof(qint8));
+    memcpy(vGateDirs.data(), vDir, count * sizeof(qint8));
+    memcpy(flags.data(), flagColumn, count * sizeof(quint8));
+}
+
+/**
+ * @brief Записывает измерения блока.
+ * @param id Номер блока.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void FleetStore::setReading(int id, double temperature, double humidity, double pressure) {
+    temperatures[id] = temperature;
+    humidities[id] = humidity;
+    pressures[id] = pressure;
+}
+
+/**
+ * @brief Записывает положение жалюзи блока.
+ * @param id Номер блока.
+ * @param hDir Положение горизонтальных жалюзи.
+ * @param vDir Положение вертикальных жалюзи.
+ */
+void FleetStore::setGates(int id, int hDir, int vDir) {
+    hGateDirs[id] = static_cast<qint8>(hDir);
+    vGateDirs[id] = static_cast<qint8>(vDir);
+}
+
+/**
+ * @brief Включает или выключает блок.
+ * @param id Номер блока.
+ * @param on Новое состояние.
+ */
+void FleetStore::setOn(int id, bool on) {
+    if (on) {
+        flags[id] |= PowerOn;
+    } else {
+        flags[id] &= ~PowerOn;
+    }
+}
+
+/**
+ * @brief Возвращает объём памяти, занятый колонками.
+ * @return Объём в байтах.
+ */
+qint64 FleetStore::memoryUsage() const {
+    return qint64(temperatures.capacity() + humidities.capacity() + pressures.capacity() + setpoints.capacity()) * sizeof(double)
+         + qint64(hGateDirs.capacity() + vGateDirs.capacity()) * sizeof(qint8)
+         + qint64(flags.capacity()) * sizeof(quint8);
+}
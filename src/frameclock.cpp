@@ -0,0 +1,76 @@
+#include "../includes/frameclock.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
+
+/**
+ * @file frameclock.cpp
+ * @brief Реализация класса FrameClock.
+ *
+ * Этот файл содержит реализацию часов кадров.
+ */
+
+namespace {
+
+const qreal kDefaultRefreshRate = 60.0; ///< Частота обновления экрана по умолчанию, Гц
+
+} // namespace
+
+/**
+ * @brief Конструктор класса FrameClock.
+ * @param parent Родительский объект.
+ */
+FrameClock::FrameClock(QObject *parent)
+    : QObject(parent)
+{
+    qreal rate = kDefaultRefreshRate;
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 1.0) {
+            rate = screen->refreshRate();
+        }
+    }
+    intervalNs = static_cast<qint64>(1e9 / rate);
+
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &FrameClock::tick);
+    clock.start();
+}
+
+/**
+ * @brief Запрашивает кадр.
+ *
+ * Кадр выдаётся сразу (через цикл событий), если с прошлого кадра прошёл целый период,
+ * иначе — в начале следующего периода.
+ */
+void FrameClock::requestFrame() {
+    if (requested) {
+        return;
+    }
+    requested = true;
+
+    qint64 delayNs = 0;
+    if (lastFrameNs >= 0) {
+        delayNs = qMax<qint64>(0, lastFrameNs + intervalNs - clock.nsecsElapsed());
+    }
+    timer->start(static_cast<int>((delayNs + 999999) / 1000000));
+}
+
+/**
+ * @brief Задаёт период кадра.
+ * @param ns Период в наносекундах.
+ */
+void FrameClock::setFrameInterval(qint64 ns) {
+    intervalNs = qMax<qint64>(0, ns);
+}
+
+/**
+ * @brief Выдаёт кадр.
+ */
+void FrameClock::tick() {
+    requested = false;
+    lastFrameNs = clock.nsecsElapsed();
+    ++frames;
+    emit frame(lastFrameNs);
+}
@@ -0,0 +1,262 @@
+#include "../includes/gaugeitems.h"
+#include <QPainter>
+#include <QtMath>
+
+/**
+ * @file gaugeitems.cpp
+ * @brief Реализация элементов сцены приборной панели.
+ *
+ * Этот файл содержит реализацию кэшируемого фона шкал, столбиков уровня и стрелок направления.
+ */
+
+namespace {
+
+/**
+ * @brief Возвращает запас границ для пера: половина толщины и пиксель на сглаживание.
+ */
+qreal penMargin(const QPen &pen) {
+    return qMax<qreal>(pen.widthF(), 1.0) / 2 + 1.0;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса GaugeBackgroundItem.
+ * @param parent Родительский элемент.
+ */
+GaugeBackgroundItem::GaugeBackgroundItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+{
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+}
+
+/**
+ * @brief Добавляет контур шкалы.
+ * @param rect Прямоугольник шкалы.
+ */
+void GaugeBackgroundItem::addScale(const QRectF &rect) {
+    scales.append(rect);
+    updateBounds();
+}
+
+/**
+ * @brief Добавляет неподвижную направляющую.
+ * @param line Отрезок.
+ */
+void GaugeBackgroundItem::addGuide(const QLineF &line) {
+    guides.append(line);
+    updateBounds();
+}
+
+/**
+ * @brief Задаёт перо контуров шкал.
+ * @param pen Перо.
+ */
+void GaugeBackgroundItem::setFramePen(const QPen &pen) {
+    if (pen == framePen) {
+        return;
+    }
+    framePen = pen;
+    updateBounds();
+    update(); // Сбрасывает кэш элемента
+}
+
+/**
+ * @brief Задаёт перо направляющих.
+ * @param pen Перо.
+ */
+void GaugeBackgroundItem::setGuidePen(const QPen &pen) {
+    if (pen == guidePen) {
+        return;
+    }
+    guidePen = pen;
+    updateBounds();
+    update();
+}
+
+/**
+ * @brief Пересчитывает границы по контурам, направляющим и толщине перьев.
+ */
+void GaugeBackgroundItem::updateBounds() {
+    QRectF rect;
+    for (const QRectF &scale : scales) {
+        rect |= scale;
+    }
+    QRectF guideRect;
+    for (const QLineF &guide : guides) {
+        guideRect |= QRectF(guide.p1(), guide.p2()).normalized();
+    }
+    const qreal frameMargin = penMargin(framePen);
+    const qreal guideMargin = penMargin(guidePen);
+    prepareGeometryChange();
+    bounds = rect.adjusted(-frameMargin, -frameMargin, frameMargin, frameMargin)
+           | guideRect.adjusted(-guideMargin, -guideMargin, guideMargin, guideMargin);
+}
+
+/**
+ * @brief Возвращает границы элемента.
+ */
+QRectF GaugeBackgroundItem::boundingRect() const {
+    return bounds;
+}
+
+/**
+ * @brief Рисует контуры шкал и направляющие.
+ */
+void GaugeBackgroundItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(framePen);
+    painter->drawRects(scales.constData(), scales.size());
+    painter->setPen(guidePen);
+    painter->drawLines(guides.constData(), guides.size());
+}
+
+/**
+ * @brief Конструктор класса LevelBarItem.
+ * @param track Область, которую может занять столбик.
+ * @param brush Заливка столбика.
+ * @param parent Родительский элемент.
+ */
+LevelBarItem::LevelBarItem(const QRectF &track, const QBrush &brush, QGraphicsItem *parent)
+    : QGraphicsItem(parent), track(track), brush(brush)
+{
+}
+
+/**
+ * @brief Задаёт высоту столбика.
+ * @param value Высота в пикселях.
+ */
+void LevelBarItem::setLevel(double value) {
+    value = qBound(0.0, value, track.height());
+    if (value == height) {
+        return;
+    }
+    prepareGeometryChange(); // Старые границы помечаются для перерисовки
+    height = value;
+}
+
+/**
+ * @brief Задаёт перо контура столбика.
+ * @param value Перо.
+ */
+void LevelBarItem::setPen(const QPen &value) {
+    if (value == pen) {
+        return;
+    }
+    prepareGeometryChange();
+    pen = value;
+}
+
+/**
+ * @brief Возвращает прямоугольник текущего столбика.
+ */
+QRectF LevelBarItem::barRect() const {
+    return QRectF(track.left(), track.bottom() - height, track.width(), height);
+}
+
+/**
+ * @brief Возвращает границы текущего столбика с учётом пера.
+ */
+QRectF LevelBarItem::boundingRect() const {
+    const qreal margin = penMargin(pen);
+    return barRect().adjusted(-margin, -margin, margin, margin);
+}
+
+/**
+ * @brief Рисует столбик.
+ */
+void LevelBarItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->setPen(pen);
+    painter->setBrush(brush);
+    painter->drawRect(barRect());
+}
+
+/**
+ * @brief Конструктор класса GateArrowItem.
+ * @param origin Начальная точка стрелки.
+ * @param length Длина стрелки.
+ * @param pen Перо стрелки.
+ * @param parent Родительский элемент.
+ */
+GateArrowItem::GateArrowItem(const QPointF &origin, double length, const QPen &pen, QGraphicsItem *parent)
+    : QGraphicsItem(parent), origin(origin), length(length), pen(pen)
+{
+    updateGeometry();
+}
+
+/**
+ * @brief Включает отрисовку дуги угла.
+ * @param value Перо дуги.
+ */
+void GateArrowItem::setArcPen(const QPen &value) {
+    arcPen = value;
+    hasArc = true;
+    updateGeometry();
+    update();
+}
+
+/**
+ * @brief Задаёт угол стрелки.
+ * @param degrees Угол в градусах.
+ */
+void GateArrowItem::setAngle(double degrees) {
+    if (degrees == angle) {
+        return;
+    }
+    angle = degrees;
+    updateGeometry();
+}
+
+/**
+ * @brief Пересчитывает отрезок, дугу и границы по текущему углу.
+ *
+ * Координаты конца стрелки округляются к целым пикселям, как в прежней отрисовке.
+ */
+void GateArrowItem::updateGeometry() {
+    prepareGeometryChange();
+
+    const double radians = qDegreesToRadians(angle + 90);
+    const int x = static_cast<int>(length * qCos(radians));
+    const int y = static_cast<int>(length * qSin(radians));
+    line = QLineF(origin, origin + QPointF(x, y));
+
+    const qreal margin = penMargin(pen);
+    bounds = QRectF(line.p1(), line.p2()).normalized().adjusted(-margin, -margin, margin, margin);
+
+    arc = QPainterPath();
+    if (hasArc) {
+        arc.moveTo(origin + QPointF(0, length));
+        arc.arcTo(QRectF(origin.x() - length, origin.y() - length, 2 * length, 2 * length), -90, -angle);
+        const qreal arcMargin = penMargin(arcPen);
+        bounds |= arc.boundingRect().adjusted(-arcMargin, -arcMargin, arcMargin, arcMargin);
+    }
+}
+
+/**
+ * @brief Возвращает границы стрелки и дуги.
+ */
+QRectF GateArrowItem::boundingRect() const {
+    return bounds;
+}
+
+/**
+ * @brief Рисует дугу и стрелку.
+ */
+void GateArrowItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if (hasArc) {
+        painter->setPen(arcPen);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawPath(arc);
+    }
+    painter->setPen(pen);
+    painter->drawLine(line);
+}
@@ -0,0 +1,485 @@
+#include "../includes/historyarchive.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+/**
+ * @file historyarchive.cpp
+ * @brief Реализация классов HistoryArchive и ArchiveCursor.
+ *
+ * Этот файл содержит реализацию кодирования измерений в поток бит по блокам
+ * и их последовательного декодирования.
+ *
+ * Метка времени (кроме первой в блоке) — разность интервалов dod:
+ * 0 — «0»; [-64, 63] — «10» + 7 бит; [-2048, 2047] — «110» + 12 бит;
+ * [-2^19, 2^19) — «1110» + 20 бит; 32-битная — «11110» + 32 бита; иначе «11111» + 64 бита.
+ * Значение — исключающее ИЛИ с предыдущим: 0 — «0»; значащие биты внутри окна
+ * предыдущего значения — «10» + биты окна; иначе «11» + 6 бит ведущих нулей +
+ * 6 бит длины − 1 + значащие биты (окно запоминается).
+ */
+
+namespace {
+
+const int kNoWindow = 64; ///< Ведущие нули «нет окна»: первое ненулевое ИЛИ задаёт окно
+
+/**
+ * @struct DodBucket
+ * @brief Диапазон разности интервалов: префикс и ширина значения.
+ */
+struct DodBucket
+{
+    quint64 prefix; ///< Префикс
+    int prefixBits; ///< Длина префикса
+    int valueBits; ///< Ширина значения
+};
+
+const DodBucket kDodBuckets[] = {
+    {0x2, 2, 7},
+    {0x6, 3, 12},
+    {0xe, 4, 20},
+    {0x1e, 5, 32},
+    {0x1f, 5, 64},
+};
+
+/**
+ * @brief Возвращает биты числа с плавающей точкой.
+ */
+quint64 bitsOf(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Возвращает число с плавающей точкой по битам.
+ */
+double fromBits(quint64 bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Возвращает true, если знаковое число помещается в count бит.
+ */
+bool fitsSigned(qint64 value, int count) {
+    if (count >= 64) {
+        return true;
+    }
+    const qint64 limit = qint64(1) << (count - 1);
+    return value >= -limit && value < limit;
+}
+
+/**
+ * @brief Расширяет знак числа шириной count бит.
+ */
+qint64 signExtend(quint64 value, int count) {
+    if (count >= 64) {
+        return static_cast<qint64>(value);
+    }
+    const int shift = 64 - count;
+    return static_cast<qint64>(value << shift) >> shift;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса HistoryArchive.
+ * @param blockSamples Количество измерений в блоке.
+ * @param maxBlocks Наибольшее количество блоков (0 — без ограничения).
+ */
+HistoryArchive::HistoryArchive(int blockSamples, int maxBlocks)
+    : blockSamples(qMax(2, blockSamples)), maxBlocks(qMax(0, maxBlocks))
+{
+}
+
+/**
+ * @brief Добавляет измерение.
+ *
+ * Первое измерение блока записывается целиком (метка и три значения по 64 бита).
+ * @param timestampUs Метка времени в микросекундах.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void HistoryArchive::append(qint64 timestampUs, double temperature, double humidity, double pressure) {
+    const double values[3] = { temperature, humidity, pressure };
+
+    if (!blockOpen || blocks.last().count >= blockSamples) {
+        blocks.append(Block());
+        blockOpen = true;
+        Block &block = blocks.last();
+        block.bits.reserve(blockSamples * 2);
+        block.firstTimestampUs = timestampUs;
+        freeBits = 0;
+        writeBits(static_cast<quint64>(timestampUs), 64);
+        for (int c = 0; c < 3; ++c) {
+            channels[c].bits = bitsOf(values[c]);
+            channels[c].leading = kNoWindow;
+            channels[c].trailing = 0;
+            writeBits(channels[c].bits, 64);
+        }
+        prevDeltaUs = 0;
+        trimBlocks();
+    } else {
+        const qint64 delta = timestampUs - prevTimestampUs;
+        const qint64 dod = delta - prevDeltaUs;
+        if (dod == 0) {
+            writeBits(0, 1);
+        } else {
+            for (const DodBucket &bucket : kDodBuckets) {
+                if (fitsSigned(dod, bucket.valueBits)) {
+                    writeBits(bucket.prefix, bucket.prefixBits);
+                    writeBits(static_cast<quint64>(dod), bucket.valueBits);
+                    break;
+                }
+            }
+        }
+        prevDeltaUs = delta;
+        for (int c = 0; c < 3; ++c) {
+            writeValue(channels[c], values[c]);
+        }
+    }
+
+    Block &block = blocks.last();
+    block.lastTimestampUs = timestampUs;
+    ++block.count;
+    prevTimestampUs = timestampUs;
+    ++total;
+}
+
+/**
+ * @brief Записывает значение канала исключающим ИЛИ с предыдущим.
+ * @param state Состояние канала.
+ * @param value Значение.
+ */
+void HistoryArchive::writeValue(ChannelState &state, double value) {
+    const quint64 bits = bitsOf(value);
+    const quint64 x = bits ^ state.bits;
+    state.bits = bits;
+    if (x == 0) {
+        writeBits(0, 1);
+        return;
+    }
+
+    const int leading = qMin(63, static_cast<int>(qCountLeadingZeroBits(x)));
+    const int trailing = static_cast<int>(qCountTrailingZeroBits(x));
+    if (leading >= state.leading && trailing >= state.trailing) {
+        writeBits(0x2, 2);
+        writeBits(x >> state.trailing, 64 - state.leading - state.trailing);
+    } else {
+        const int meaningful = 64 - leading - trailing;
+        writeBits(0x3, 2);
+        writeBits(static_cast<quint64>(leading), 6);
+        writeBits(static_cast<quint64>(meaningful - 1), 6);
+        writeBits(x >> trailing, meaningful);
+        state.leading = leading;
+        state.trailing = trailing;
+    }
+}
+
+/**
+ * @brief Дописывает младшие count бит числа в открытый блок, начиная со старшего.
+ * @param value Число.
+ * @param count Количество бит (0–64).
+ */
+void HistoryArchive::writeBits(quint64 value, int count) {
+    QByteArray &bits = blocks.last().bits;
+    while (count > 0) {
+        if (freeBits == 0) {
+            bits.append('\0');
+            freeBits = 8;
+        }
+        const int take = qMin(count, freeBits);
+        const quint64 chunk = (value >> (count - take)) & ((quint64(1) << take) - 1);
+        char &byte = bits.data()[bits.size() - 1];
+        byte = static_cast<char>(static_cast<uchar>(byte) | (chunk << (freeBits - take)));
+        freeBits -= take;
+        count -= take;
+    }
+}
+
+/**
+ * @brief Очищает архив.
+ */
+void HistoryArchive::clear() {
+    blocks.clear();
+    total = 0;
+    blockOpen = false;
+    freeBits = 0;
+    prevTimestampUs = 0;
+    prevDeltaUs = 0;
+}
+
+/**
+ * @brief Заменяет содержимое архива сохранёнными блоками.
+ *
+ * Состояние кодирования открытого блока (окна значащих бит, предыдущий интервал) не хранится,
+ * поэтому последний блок восстанавливается повторным кодированием его измерений.
+ * @param saved Блоки в порядке записи.
+ */
+void HistoryArchive::restore(const QVector<Block> &saved) {
+    clear();
+    if (saved.isEmpty()) {
+        return;
+    }
+
+    HistoryArchive tail(blockSamples);
+    tail.blocks.append(saved.last());
+    QVector<SensorSample> samples;
+    samples.reserve(saved.last().count);
+    tail.decodeBlock(0, samples);
+
+    blocks = saved;
+    blocks.removeLast();
+    for (const Block &block : blocks) {
+        total += block.count;
+    }
+    for (const SensorSample &sample : samples) {
+        append(sample.timestampUs, sample.temperature, sample.humidity, sample.pressure);
+    }
+    trimBlocks();
+}
+
+/**
+ * @brief Задаёт наибольшее количество блоков.
+ * @param count Количество блоков (0 — без ограничения).
+ */
+void HistoryArchive::setMaxBlocks(int count) {
+    maxBlocks = qMax(0, count);
+    trimBlocks();
+}
+
+/**
+ * @brief Удаляет самые старые блоки сверх ограничения.
+ */
+void HistoryArchive::trimBlocks() {
+    if (maxBlocks == 0 || blocks.size() <= maxBlocks) {
+        return;
+    }
+    const int extra = blocks.size() - maxBlocks;
+    for (int i = 0; i < extra; ++i) {
+        total -= blocks.at(i).count;
+    }
+    blocks.erase(blocks.begin(), blocks.begin() + extra);
+}
+
+/**
+ * @brief Возвращает размер сжатых данных в байтах.
+ */
+qint64 HistoryArchive::sizeBytes() const {
+    qint64 bytes = 0;
+    for (const Block &block : blocks) {
+        bytes += block.bits.size();
+    }
+    return bytes;
+}
+
+/**
+ * @brief Возвращает номер блока, содержащего первое измерение с меткой не меньше заданной.
+ *
+ * Метки не убывают, поэтому по последним меткам блоков выполняется двоичный поиск.
+ * @param timestampUs Метка времени.
+ * @return Номер блока или blockCount().
+ */
+int HistoryArchive::findBlock(qint64 timestampUs) const {
+    int low = 0;
+    int high = blocks.size();
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (blocks.at(mid).lastTimestampUs < timestampUs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Декодирует блок.
+ * @param i Номер блока.
+ * @param out Вектор, в который добавляются измерения.
+ * @return Количество декодированных измерений.
+ */
+int HistoryArchive::decodeBlock(int i, QVector<SensorSample> &out) const {
+    if (i < 0 || i >= blocks.size()) {
+        return 0;
+    }
+    ArchiveCursor cursor(*this);
+    cursor.openBlock(i);
+    const int count = cursor.remaining;
+    const int base = out.size();
+    out.resize(base + count);
+    SensorSample *dst = out.data() + base;
+    for (int k = 0; k < count; ++k) {
+        cursor.decodeNext(dst[k]);
+    }
+    return count;
+}
+
+/**
+ * @brief Конструктор класса ArchiveCursor.
+ * @param archive Архив.
+ */
+ArchiveCursor::ArchiveCursor(const HistoryArchive &archive)
+    : archive(archive)
+{
+    openBlock(0);
+}
+
+/**
+ * @brief Делает блок текущим и возвращает чтение к его началу.
+ * @param i Номер блока.
+ */
+void ArchiveCursor::openBlock(int i) {
+    blockIndex = i;
+    decoded = 0;
+    bytePos = 0;
+    buffer = 0;
+    bufferBits = 0;
+    if (i < archive.blocks.size()) {
+        const HistoryArchive::Block &block = archive.blocks.at(i);
+        data = reinterpret_cast<const uchar *>(block.bits.constData());
+        dataSize = block.bits.size();
+        remaining = block.count;
+    } else {
+        data = nullptr;
+        dataSize = 0;
+        remaining = 0;
+    }
+}
+
+/**
+ * @brief Устанавливает курсор на первое измерение с меткой не меньше заданной.
+ *
+ * Блок находится по индексу, внутри блока измерения до нужного декодируются и пропускаются.
+ * @param timestampUs Метка времени.
+ */
+void ArchiveCursor::seek(qint64 timestampUs) {
+    hasPending = false;
+    openBlock(archive.findBlock(timestampUs));
+    while (remaining > 0) {
+        decodeNext(pending);
+        if (pending.timestampUs >= timestampUs) {
+            hasPending = true;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Читает следующее измерение.
+ * @param sample Измерение.
+ * @return false, если измерения закончились.
+ */
+bool ArchiveCursor::next(SensorSample &sample) {
+    if (hasPending) {
+        sample = pending;
+        hasPending = false;
+        return true;
+    }
+    while (remaining == 0) {
+        if (blockIndex + 1 >= archive.blocks.size()) {
+            return false;
+        }
+        openBlock(blockIndex + 1);
+    }
+    decodeNext(sample);
+    return true;
+}
+
+/**
+ * @brief Читает до count следующих измерений.
+ * @param out Массив измерений.
+ * @param count Размер массива.
+ * @return Количество прочитанных измерений.
+ */
+int ArchiveCursor::read(SensorSample *out, int count) {
+    int n = 0;
+    while (n < count && next(out[n])) {
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Декодирует следующее измерение текущего блока. В блоке должны оставаться измерения.
+ * @param sample Измерение.
+ */
+void ArchiveCursor::decodeNext(SensorSample &sample) {
+    if (decoded == 0) {
+        last.timestampUs = static_cast<qint64>(readBits(64));
+        for (int c = 0; c < 3; ++c) {
+            valueBits[c] = readBits(64);
+            leading[c] = kNoWindow;
+            trailing[c] = 0;
+        }
+        lastDeltaUs = 0;
+    } else {
+        qint64 dod = 0;
+        if (readBits(1) != 0) {
+            int bucket = 0; // Количество единиц префикса после первой; у «11111» завершающего нуля нет
+            while (bucket < 4 && readBits(1) != 0) {
+                ++bucket;
+            }
+            const int width = kDodBuckets[bucket].valueBits;
+            dod = signExtend(readBits(width), width);
+        }
+        lastDeltaUs += dod;
+        last.timestampUs += lastDeltaUs;
+        for (int c = 0; c < 3; ++c) {
+            readValue(c);
+        }
+    }
+    last.temperature = fromBits(valueBits[0]);
+    last.humidity = fromBits(valueBits[1]);
+    last.pressure = fromBits(valueBits[2]);
+    sample = last;
+    ++decoded;
+    --remaining;
+}
+
+/**
+ * @brief Декодирует значение канала.
+ * @param channel Канал.
+ * @return Значение.
+ */
+double ArchiveCursor::readValue(int channel) {
+    if (readBits(1) != 0) {
+        if (readBits(1) != 0) {
+            leading[channel] = static_cast<int>(readBits(6));
+            const int meaningful = static_cast<int>(readBits(6)) + 1;
+            trailing[channel] = 64 - leading[channel] - meaningful;
+        }
+        const int width = 64 - leading[channel] - trailing[channel];
+        valueBits[channel] ^= readBits(width) << trailing[channel];
+    }
+    return fromBits(valueBits[channel]);
+}
+
+/**
+ * @brief Читает count бит (0–64), начиная со старшего.
+ *
+ * Буфер пополняется побайтно; за концом блока читаются нули.
+ * @param count Количество бит.
+ * @return Прочитанные биты в младших разрядах.
+ */
+quint64 ArchiveCursor::readBits(int count) {
+    if (count > 32) {
+        const quint64 high = readBits(count - 32);
+        return (high << 32) | readBits(32);
+    }
+    if (count == 0) {
+        return 0;
+    }
+    while (bufferBits <= 56) {
+        const quint64 byte = bytePos < dataSize ? data[bytePos] : 0;
+        ++bytePos;
+        buffer |= byte << (56 - bufferBits);
+        bufferBits += 8;
+    }
+    const quint64 result = buffer >> (64 - count);
+    buffer <<= count;
+    bufferBits -= count;
+    return result;
+}
@@ -0,0 +1,392 @@
+#include "../includes/inputtrace.h"
+#include <cstring>
+
+/**
+ * @file inputtrace.cpp
+ * @brief Реализация записи и чтения входных воздействий.
+ *
+ * Этот файл содержит реализацию кодирования событий приращениями и исключающим ИЛИ
+ * и их последовательного декодирования.
+ */
+
+namespace {
+
+const int kFlushBytes = 64 * 1024; ///< Накопленный объём, после которого события записываются в файл
+const qint64 kFlushIntervalUs = 1000000; ///< События записываются в файл не реже раза в секунду
+
+/**
+ * @struct TraceHeader
+ * @brief Заголовок файла записи.
+ */
+struct TraceHeader
+{
+    quint32 magic; ///< Сигнатура
+    quint32 version; ///< Версия формата
+    TraceInitialState initial; ///< Начальное состояние
+};
+
+static_assert(sizeof(TraceInitialState) == 40, "TraceInitialState must stay 40 bytes");
+
+/**
+ * @brief Дописывает беззнаковое число в формате varint (по 7 бит, старший бит — продолжение).
+ */
+void putVarint(QByteArray &out, quint64 value) {
+    char bytes[10];
+    int n = 0;
+    while (value >= 0x80) {
+        bytes[n++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = static_cast<char>(value);
+    out.append(bytes, n);
+}
+
+/**
+ * @brief Читает число в формате varint.
+ * @return false, если данные оборваны.
+ */
+bool getVarint(const uchar *&p, const uchar *end, quint64 &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uchar byte = *p++;
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Отображает знаковое число в беззнаковое так, что малые по модулю значения остаются малыми.
+ */
+quint64 zigzag(qint64 value) {
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+/**
+ * @brief Обратное отображение zigzag().
+ */
+qint64 unzigzag(quint64 value) {
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+/**
+ * @brief Возвращает биты числа с плавающей точкой.
+ */
+quint64 bitsOf(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Возвращает число с плавающей точкой по битам.
+ */
+double fromBits(quint64 bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Возвращает количество значащих младших байт числа (0 для нуля).
+ */
+int significantBytes(quint64 value) {
+    int n = 0;
+    while (value != 0) {
+        ++n;
+        value >>= 8;
+    }
+    return n;
+}
+
+/**
+ * @brief Дописывает младшие байты числа.
+ */
+void putBytes(QByteArray &out, quint64 value, int count) {
+    char bytes[8];
+    for (int i = 0; i < count; ++i) {
+        bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+    out.append(bytes, count);
+}
+
+/**
+ * @brief Читает младшие байты числа.
+ * @return false, если данные оборваны.
+ */
+bool getBytes(const uchar *&p, const uchar *end, int count, quint64 &value) {
+    if (end - p < count) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        value |= quint64(p[i]) << (8 * i);
+    }
+    p += count;
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Деструктор класса InputTraceWriter.
+ */
+InputTraceWriter::~InputTraceWriter() {
+    close();
+}
+
+/**
+ * @brief Создаёт файл записи и записывает заголовок.
+ * @param path Путь к файлу.
+ * @param initial Начальное состояние.
+ * @return true, если файл создан.
+ */
+bool InputTraceWriter::open(const QString &path, const TraceInitialState &initial) {
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    TraceHeader header;
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.initial = initial;
+    buffer.clear();
+    buffer.reserve(kFlushBytes * 2);
+    buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    lastTimeUs = 0;
+    lastSample = SensorSample();
+    events = 0;
+    fileBytes = 0;
+    clock.start();
+    return flush();
+}
+
+/**
+ * @brief Записывает накопленные события и закрывает файл.
+ */
+void InputTraceWriter::close() {
+    if (file.isOpen()) {
+        flush();
+        file.close();
+    }
+}
+
+/**
+ * @brief Добавляет измерения.
+ * @param samples Массив измерений.
+ * @param count Количество измерений.
+ */
+void InputTraceWriter::writeSamples(const SensorSample *samples, int count) {
+    if (!file.isOpen()) {
+        return;
+    }
+    TraceEvent event;
+    event.type = Sample;
+    event.timeUs = clock.nsecsElapsed() / 1000;
+    for (int i = 0; i < count; ++i) {
+        event.sample = samples[i];
+        writeEvent(event);
+    }
+}
+
+/**
+ * @brief Добавляет действие пользователя.
+ * @param type Тип действия.
+ * @param a Первое значение.
+ * @param b Второе значение.
+ */
+void InputTraceWriter::writeAction(EventType type, qint32 a, qint32 b) {
+    if (!file.isOpen()) {
+        return;
+    }
+    TraceEvent event;
+    event.type = type;
+    event.timeUs = clock.nsecsElapsed() / 1000;
+    event.a = a;
+    event.b = b;
+    writeEvent(event);
+}
+
+/**
+ * @brief Добавляет событие с заданным временем.
+ *
+ * Накопленные события записываются в файл, когда буфер превышает порог
+ * или с прошлой записи прошла секунда времени записи.
+ * @param event Событие.
+ */
+void InputTraceWriter::writeEvent(const TraceEvent &event) {
+    if (!file.isOpen()) {
+        return;
+    }
+    const qint64 previousTimeUs = lastTimeUs;
+    encode(event);
+    ++events;
+    if (buffer.size() >= kFlushBytes || lastTimeUs / kFlushIntervalUs != previousTimeUs / kFlushIntervalUs) {
+        flush();
+    }
+}
+
+/**
+ * @brief Кодирует событие в буфер.
+ *
+ * Формат события: байт типа (у измерения в старшем полубайте — количество байт давления),
+ * приращение времени (varint), затем данные. Измерение: приращение метки (zigzag varint),
+ * байт с количествами байт температуры и влажности, младшие байты XOR трёх каналов.
+ * Действие: значения a и b (zigzag varint).
+ * @param event Событие.
+ */
+void InputTraceWriter::encode(const TraceEvent &event) {
+    const qint64 timeUs = qMax(lastTimeUs, event.timeUs); // Время записи не убывает
+    if (event.type == Sample) {
+        const SensorSample &s = event.sample;
+        const quint64 tx = bitsOf(s.temperature) ^ bitsOf(lastSample.temperature);
+        const quint64 hx = bitsOf(s.humidity) ^ bitsOf(lastSample.humidity);
+        const quint64 px = bitsOf(s.pressure) ^ bitsOf(lastSample.pressure);
+        const int tn = significantBytes(tx);
+        const int hn = significantBytes(hx);
+        const int pn = significantBytes(px);
+
+        buffer.append(static_cast<char>(Sample | (pn << 4)));
+        putVarint(buffer, quint64(timeUs - lastTimeUs));
+        putVarint(buffer, zigzag(s.timestampUs - lastSample.timestampUs));
+        buffer.append(static_cast<char>(tn | (hn << 4)));
+        putBytes(buffer, tx, tn);
+        putBytes(buffer, hx, hn);
+        putBytes(buffer, px, pn);
+        lastSample = s;
+    } else {
+        buffer.append(static_cast<char>(event.type));
+        putVarint(buffer, quint64(timeUs - lastTimeUs));
+        putVarint(buffer, zigzag(event.a));
+        putVarint(buffer, zigzag(event.b));
+    }
+    lastTimeUs = timeUs;
+}
+
+/**
+ * @brief Записывает накопленные события в файл.
+ * @return true, если запись прошла успешно.
+ */
+bool InputTraceWriter::flush() {
+    if (buffer.isEmpty() || !file.isOpen()) {
+        return true;
+    }
+    const qint64 written = file.write(buffer);
+    file.flush();
+    const bool ok = written == buffer.size();
+    fileBytes += qMax<qint64>(0, written);
+    buffer.clear();
+    return ok;
+}
+
+/**
+ * @brief Открывает файл записи и читает заголовок.
+ * @param path Путь к файлу.
+ * @return true, если файл прочитан и заголовок корректен.
+ */
+bool InputTraceReader::open(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return openData(file.readAll());
+}
+
+/**
+ * @brief Открывает запись из буфера в памяти.
+ * @param bytes Содержимое файла записи.
+ * @return true, если заголовок корректен.
+ */
+bool InputTraceReader::openData(const QByteArray &bytes) {
+    data = bytes;
+    begin = pos = end = nullptr;
+    if (data.size() < static_cast<int>(sizeof(TraceHeader))) {
+        return false;
+    }
+    TraceHeader header;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (header.magic != InputTraceWriter::kMagic || header.version != InputTraceWriter::kVersion) {
+        return false;
+    }
+    initial = header.initial;
+    begin = reinterpret_cast<const uchar *>(data.constData()) + sizeof(TraceHeader);
+    end = reinterpret_cast<const uchar *>(data.constData()) + data.size();
+    rewind();
+    return true;
+}
+
+/**
+ * @brief Возвращает чтение к первому событию.
+ */
+void InputTraceReader::rewind() {
+    pos = begin;
+    lastTimeUs = 0;
+    lastSample = SensorSample();
+    corrupted = false;
+}
+
+/**
+ * @brief Читает следующее событие.
+ *
+ * Оборванное последнее событие (запись прервана сбоем) завершает чтение.
+ * @param event Событие.
+ * @return false в конце записи или на повреждённом событии.
+ */
+bool InputTraceReader::next(TraceEvent &event) {
+    if (pos == nullptr || pos >= end) {
+        return false;
+    }
+    const uchar *p = pos;
+    const uchar tag = *p++;
+    const quint8 type = tag & 0x0f;
+    quint64 timeDelta;
+    if (!getVarint(p, end, timeDelta)) {
+        corrupted = true;
+        return false;
+    }
+
+    if (type == InputTraceWriter::Sample) {
+        quint64 stampDelta;
+        if (!getVarint(p, end, stampDelta) || p >= end) {
+            corrupted = true;
+            return false;
+        }
+        const uchar counts = *p++;
+        const int tn = counts & 0x0f;
+        const int hn = counts >> 4;
+        const int pn = tag >> 4;
+        quint64 tx, hx, px;
+        if (tn > 8 || hn > 8 || pn > 8 || !getBytes(p, end, tn, tx) || !getBytes(p, end, hn, hx) || !getBytes(p, end, pn, px)) {
+            corrupted = true;
+            return false;
+        }
+        lastSample.timestampUs += unzigzag(stampDelta);
+        lastSample.temperature = fromBits(bitsOf(lastSample.temperature) ^ tx);
+        lastSample.humidity = fromBits(bitsOf(lastSample.humidity) ^ hx);
+        lastSample.pressure = fromBits(bitsOf(lastSample.pressure) ^ px);
+        event.sample = lastSample;
+        event.a = event.b = 0;
+    } else if (type >= InputTraceWriter::Power && type <= InputTraceWriter::FleetSize) {
+        quint64 a, b;
+        if (!getVarint(p, end, a) || !getVarint(p, end, b)) {
+            corrupted = true;
+            return false;
+        }
+        event.a = static_cast<qint32>(unzigzag(a));
+        event.b = static_cast<qint32>(unzigzag(b));
+    } else {
+        corrupted = true;
+        return false;
+    }
+
+    lastTimeUs += static_cast<qint64>(timeDelta);
+    event.timeUs = lastTimeUs;
+    event.type = type;
+    pos = p;
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "../includes/labelformatter.h"
+#include <QtMath>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @file labelformatter.cpp
+ * @brief Реализация класса LabelFormatter.
+ *
+ * Этот файл содержит реализацию форматирования текстовых меток показаний.
+ */
+
+namespace {
+
+const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9}; ///< Степени десяти для знаков после точки
+const double kMaxScaled = 1e15; ///< Предел целочисленного пути (точность double)
+
+} // namespace
+
+/**
+ * @brief Конструктор класса LabelFormatter.
+ * @param prefix Префикс метки.
+ * @param suffixes Обозначения единиц по идентификатору единицы.
+ * @param decimals Количество знаков после точки.
+ * @param trimZeros Отбрасывать ли незначащие нули дробной части.
+ */
+LabelFormatter::LabelFormatter(const QString &prefix, const QStringList &suffixes, int decimals, bool trimZeros)
+    : prefix(prefix), suffixes(suffixes), decimals(qBound(0, decimals, 9)), trimZeros(trimZeros), rendered(prefix)
+{
+}
+
+/**
+ * @brief Форматирует показание.
+ *
+ * Выделение памяти происходит только при изменении текста метки.
+ * @param value Значение.
+ * @param unit Идентификатор единицы.
+ * @return true, если текст метки изменился.
+ */
+bool LabelFormatter::format(double value, int unit) {
+    char buffer[kMaxChars];
+    const int count = formatFixed(value, decimals, trimZeros, buffer);
+    if (count == length && unit == this->unit && memcmp(buffer, digits, static_cast<size_t>(count)) == 0) {
+        return false;
+    }
+    memcpy(digits, buffer, static_cast<size_t>(count));
+    length = count;
+    this->unit = unit;
+
+    const QString &suffix = unit >= 0 && unit < suffixes.size() ? suffixes.at(unit) : QString();
+    rendered.clear();
+    rendered.reserve(prefix.size() + count + suffix.size());
+    rendered += prefix;
+    rendered += QLatin1String(digits, count);
+    rendered += suffix;
+    return true;
+}
+
+/**
+ * @brief Оставляет в метке только префикс.
+ * @return true, если текст метки изменился.
+ */
+bool LabelFormatter::clear() {
+    if (length < 0) {
+        return false;
+    }
+    length = -1;
+    unit = -1;
+    rendered = prefix;
+    return true;
+}
+
+/**
+ * @brief Записывает число с фиксированным количеством знаков после точки.
+ *
+ * Значение масштабируется на 10^decimals, округляется до целого и раскладывается
+ * на цифры; значения вне точности double и нечисла выводятся через snprintf.
+ * @param value Значение.
+ * @param decimals Количество знаков после точки.
+ * @param trimZeros Отбрасывать ли незначащие нули.
+ * @param out Буфер не короче kMaxChars.
+ * @return Количество записанных символов.
+ */
+int LabelFormatter::formatFixed(double value, int decimals, bool trimZeros, char *out) {
+    decimals = qBound(0, decimals, 9);
+    const double scaled = std::round(std::fabs(value) * kPow10[decimals]);
+    if (!qIsFinite(value) || scaled >= kMaxScaled) {
+        return qMin(std::snprintf(out, kMaxChars, "%.*g", 15, value), kMaxChars - 1);
+    }
+
+    // Цифры в обратном порядке; не меньше decimals + 1, чтобы была целая часть
+    char reversed[kMaxChars];
+    quint64 number = static_cast<quint64>(scaled);
+    const bool negative = value < 0 && number != 0;
+    int count = 0;
+    do {
+        reversed[count++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0 || count <= decimals);
+
+    int first = 0; // Первая значащая цифра дробной части с конца
+    if (trimZeros) {
+        while (first < decimals && reversed[first] == '0') {
+            ++first;
+        }
+    }
+
+    int pos = 0;
+    if (negative) {
+        out[pos++] = '-';
+    }
+    for (int i = count - 1; i >= decimals; --i) {
+        out[pos++] = reversed[i];
+    }
+    if (first < decimals) {
+        out[pos++] = '.';
+        for (int i = decimals - 1; i >= first; --i) {
+            out[pos++] = reversed[i];
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Возвращает число с фиксированным количеством знаков и обозначением единицы одной строкой.
+ * @param value Значение.
+ * @param decimals Количество знаков после точки.
+ * @param suffix Обозначение единицы.
+ */
+QString LabelFormatter::fixed(double value, int decimals, const QString &suffix) {
+    char buffer[kMaxChars];
+    const int count = formatFixed(value, decimals, false, buffer);
+    QString text;
+    text.reserve(count + suffix.size());
+    text += QLatin1String(buffer, count);
+    text += suffix;
+    return text;
+}
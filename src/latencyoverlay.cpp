@@ -0,0 +1,117 @@
+#include "../includes/latencyoverlay.h"
+#include "../includes/latencyprobe.h"
+#include <QFontDatabase>
+#include <QFontMetricsF>
+#include <QPainter>
+
+/**
+ * @file latencyoverlay.cpp
+ * @brief Реализация отладочного показа длительностей операций.
+ *
+ * Этот файл содержит реализацию таблицы гистограмм на сцене и измеряемого вида сцены.
+ */
+
+namespace {
+
+const qreal kPadding = 6.0; ///< Поле вокруг таблицы
+const QColor kBackground(0, 0, 0, 190); ///< Полупрозрачный фон таблицы
+const QColor kText(230, 230, 230); ///< Цвет текста таблицы
+
+/**
+ * @brief Возвращает моноширинный шрифт таблицы.
+ */
+QFont overlayFont() {
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPointSize(8);
+    return font;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса LatencyOverlayItem.
+ * @param parent Родительский элемент.
+ */
+LatencyOverlayItem::LatencyOverlayItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+{
+}
+
+/**
+ * @brief Перечитывает гистограммы и перерисовывает таблицу.
+ */
+void LatencyOverlayItem::refresh() {
+    const double usPerTick = LatencyClock::nanosecondsPerTick() / 1000.0;
+    QStringList lines;
+    lines.append(QString::asprintf("%-24s %8s %9s %9s %9s", "operation", "count", "p50 us", "p99 us", "max us"));
+    for (const LatencyHistogram *histogram : LatencyProbes::all()) {
+        lines.append(QString::asprintf("%-24s %8llu %9.1f %9.1f %9.1f", histogram->name(),
+                                       static_cast<unsigned long long>(histogram->count()),
+                                       histogram->percentile(50.0) * usPerTick,
+                                       histogram->percentile(99.0) * usPerTick,
+                                       histogram->max() * usPerTick));
+    }
+    if (!LatencyProbes::isEnabled()) {
+        lines.append("probes disabled at build time (AIRCON_PROBES=OFF)");
+    }
+
+    const QFontMetricsF metrics(overlayFont());
+    qreal width = 0.0;
+    for (const QString &line : lines) {
+        width = qMax(width, metrics.horizontalAdvance(line));
+    }
+    const QRectF newBounds(0, 0, width + 2 * kPadding, lines.size() * metrics.lineSpacing() + 2 * kPadding);
+    if (newBounds != bounds) {
+        prepareGeometryChange();
+        bounds = newBounds;
+    }
+    rows = lines;
+    update();
+}
+
+/**
+ * @brief Возвращает границы элемента.
+ */
+QRectF LatencyOverlayItem::boundingRect() const {
+    return bounds;
+}
+
+/**
+ * @brief Рисует таблицу на полупрозрачном фоне.
+ * @param painter Объект рисования.
+ * @param option Параметры отрисовки.
+ * @param widget Виджет, на котором рисуется элемент.
+ */
+void LatencyOverlayItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    painter->fillRect(bounds, kBackground);
+    const QFont font = overlayFont();
+    const QFontMetricsF metrics(font);
+    painter->setFont(font);
+    painter->setPen(kText);
+    qreal y = kPadding + metrics.ascent();
+    for (const QString &line : rows) {
+        painter->drawText(QPointF(kPadding, y), line);
+        y += metrics.lineSpacing();
+    }
+}
+
+/**
+ * @brief Конструктор класса ProbedGraphicsView.
+ * @param scene Сцена.
+ * @param parent Родительский виджет.
+ */
+ProbedGraphicsView::ProbedGraphicsView(QGraphicsScene *scene, QWidget *parent)
+    : QGraphicsView(scene, parent)
+{
+}
+
+/**
+ * @brief Отрисовывает сцену, измеряя длительность отрисовки.
+ * @param event Событие отрисовки.
+ */
+void ProbedGraphicsView::paintEvent(QPaintEvent *event) {
+    ACM_PROBE("paint");
+    QGraphicsView::paintEvent(event);
+}
@@ -0,0 +1,271 @@
+#include "../includes/latencyprobe.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <atomic>
+#include <cstring>
+
+/**
+ * @file latencyprobe.cpp
+ * @brief Реализация гистограмм и реестра измерителей длительности.
+ *
+ * Этот файл содержит реализацию калибровки часов, процентилей гистограммы, реестра
+ * гистограмм и их выгрузки в JSON.
+ */
+
+namespace {
+
+const double kReportedPercentiles[] = { 50.0, 90.0, 99.0, 99.9 }; ///< Процентили в отчёте JSON
+const qint64 kMinCalibrationNs = 10000000; ///< Наименьший интервал калибровки часов
+
+/**
+ * @struct Calibration
+ * @brief Начальная пара отметок часов.
+ */
+struct Calibration
+{
+    std::atomic<bool> started{false}; ///< Отметки взяты
+    quint64 ticks = 0; ///< Такты LatencyClock
+    qint64 ns = 0; ///< Наносекунды steady_clock
+};
+
+/**
+ * @brief Возвращает начальную пару отметок.
+ */
+Calibration &calibration() {
+    static Calibration instance;
+    return instance;
+}
+
+/**
+ * @brief Возвращает время steady_clock в наносекундах.
+ */
+qint64 steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @struct Registry
+ * @brief Гистограммы всех операций. Гистограммы не удаляются до завершения программы.
+ */
+struct Registry
+{
+    QMutex mutex; ///< Защита списка (регистрация возможна из любого потока)
+    QVector<LatencyHistogram *> histograms; ///< Гистограммы в порядке создания
+};
+
+/**
+ * @brief Возвращает реестр гистограмм.
+ */
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+} // namespace
+
+/**
+ * @brief Запоминает начальную пару отметок для калибровки.
+ */
+void LatencyClock::start() {
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    Calibration &c = calibration();
+    if (c.started.load(std::memory_order_relaxed)) {
+        return;
+    }
+    c.ns = steadyNs();
+    c.ticks = now();
+    c.started.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Возвращает длительность такта в наносекундах.
+ *
+ * Если с начальной отметки прошло меньше 10 мс, вызов ждёт, чтобы погрешность
+ * частоты не превышала долей процента.
+ */
+double LatencyClock::nanosecondsPerTick() {
+#ifdef ACM_PROBE_TSC
+    start();
+    const Calibration &c = calibration();
+    qint64 ns = steadyNs();
+    if (ns - c.ns < kMinCalibrationNs) {
+        QThread::usleep(static_cast<unsigned long>((kMinCalibrationNs - (ns - c.ns)) / 1000 + 1));
+        ns = steadyNs();
+    }
+    const quint64 ticks = now();
+    return ticks > c.ticks ? double(ns - c.ns) / double(ticks - c.ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * @brief Конструктор класса LatencyHistogram.
+ * @param name Название операции.
+ */
+LatencyHistogram::LatencyHistogram(const char *name)
+    : label(name)
+{
+}
+
+/**
+ * @brief Очищает гистограмму.
+ */
+void LatencyHistogram::reset() {
+    std::memset(counts, 0, sizeof(counts));
+    total = 0;
+    sum = 0;
+    maxValue = 0;
+}
+
+/**
+ * @brief Возвращает значение, не превышаемое заданной долей измерений.
+ * @param percentile Процентиль от 0 до 100.
+ * @return Длительность в тактах.
+ */
+quint64 LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+    const double fraction = qBound(0.0, percentile, 100.0) / 100.0;
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(fraction * total + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return qMin(bucketLow(i) + bucketWidth(i) - 1, maxValue);
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * @brief Возвращает нижнюю границу корзины.
+ * @param i Номер корзины.
+ */
+quint64 LatencyHistogram::bucketLow(int i) {
+    if (i < 2 * kSubBuckets) {
+        return static_cast<quint64>(i);
+    }
+    const int shift = i / kSubBuckets - 1;
+    return quint64(i % kSubBuckets + kSubBuckets) << shift;
+}
+
+/**
+ * @brief Возвращает ширину корзины.
+ * @param i Номер корзины.
+ */
+quint64 LatencyHistogram::bucketWidth(int i) {
+    if (i < 2 * kSubBuckets) {
+        return 1;
+    }
+    return quint64(1) << (i / kSubBuckets - 1);
+}
+
+/**
+ * @brief Возвращает гистограмму операции, создавая её при первом обращении.
+ * @param name Название операции.
+ */
+LatencyHistogram *LatencyProbes::histogram(const char *name) {
+    LatencyClock::start();
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (LatencyHistogram *histogram : r.histograms) {
+        if (std::strcmp(histogram->name(), name) == 0) {
+            return histogram;
+        }
+    }
+    LatencyHistogram *histogram = new LatencyHistogram(name);
+    r.histograms.append(histogram);
+    return histogram;
+}
+
+/**
+ * @brief Возвращает все гистограммы в порядке создания.
+ */
+QVector<LatencyHistogram *> LatencyProbes::all() {
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    return r.histograms;
+}
+
+/**
+ * @brief Очищает все гистограммы.
+ */
+void LatencyProbes::resetAll() {
+    for (LatencyHistogram *histogram : all()) {
+        histogram->reset();
+    }
+}
+
+/**
+ * @brief Возвращает гистограммы в формате JSON.
+ *
+ * Для каждой операции: количество, средняя и наибольшая длительность, процентили
+ * и непустые корзины парами [нижняя граница, количество]; все длительности в наносекундах.
+ */
+QByteArray LatencyProbes::toJson() {
+    const double nsPerTick = LatencyClock::nanosecondsPerTick();
+    QJsonArray probes;
+    for (const LatencyHistogram *histogram : all()) {
+        QJsonObject probe;
+        probe["name"] = QString::fromUtf8(histogram->name());
+        probe["count"] = static_cast<double>(histogram->count());
+        probe["mean_ns"] = histogram->mean() * nsPerTick;
+        probe["max_ns"] = histogram->max() * nsPerTick;
+        QJsonObject percentiles;
+        for (double p : kReportedPercentiles) {
+            percentiles[QString::number(p)] = histogram->percentile(p) * nsPerTick;
+        }
+        probe["percentiles_ns"] = percentiles;
+        QJsonArray buckets;
+        for (int i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+            if (histogram->bucketCount(i) != 0) {
+                buckets.append(QJsonArray{ LatencyHistogram::bucketLow(i) * nsPerTick,
+                                           static_cast<double>(histogram->bucketCount(i)) });
+            }
+        }
+        probe["buckets"] = buckets;
+        probes.append(probe);
+    }
+    QJsonObject root;
+    root["enabled"] = isEnabled();
+    root["ns_per_tick"] = nsPerTick;
+    root["probes"] = probes;
+    return QJsonDocument(root).toJson();
+}
+
+/**
+ * @brief Записывает toJson() в файл атомарно.
+ * @param path Путь к файлу.
+ * @return true, если файл записан.
+ */
+bool LatencyProbes::dump(const QString &path) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const QByteArray json = toJson();
+    if (file.write(json) != json.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+/**
+ * @brief Возвращает true, если измерители включены при сборке.
+ */
+bool LatencyProbes::isEnabled() {
+#ifdef ACM_PROBES
+    return true;
+#else
+    return false;
+#endif
+}
@@ -1,28 +1,297 @@
 /**
  * @file main.cpp
  * @brief Основной файл приложения для управления системой кондиционирования.
- * 
+ *
  * Этот файл содержит точку входа в приложение, создаёт экземпляр главного окна
- * и запускает основной цикл обработки событий.
+ * и запускает основной цикл обработки событий. В режиме --headless окно не создаётся:
+ * модель состояния работает без графического интерфейса (для серверов и нагрузочных тестов).
  */
 
 #include "../includes/coolwindow.h"
+#include "../includes/climatemodel.h"
+#include "../includes/controlserver.h"
+#include "../includes/modbusserver.h"
+#include "../includes/latencyprobe.h"
+#include "../includes/sensoringest.h"
+#include "../includes/simulationdriver.h"
+#include "../includes/stallmonitor.h"
+#include "../includes/startuptrace.h"
+#include "../includes/tracedapplication.h"
+#include "../includes/tracereplayer.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QScopedPointer>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Проверяет, запрошен ли режим без окна.
+ *
+ * Проверка выполняется до создания приложения: от неё зависит, нужен ли QApplication
+ * с подключением к оконной системе или достаточно QCoreApplication.
+ */
+bool isHeadless(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Записывает трассировку событий, если она запрошена параметром --trace.
+ * @param path Путь к файлу (пусто — трассировка не запрошена).
+ */
+void exportTrace(const QString &path) {
+    if (!path.isEmpty() && !EventTrace::exportChrome(path)) {
+        qWarning() << "Не удалось записать трассировку событий в" << path;
+    }
+}
+
+} // namespace
 
 /**
  * @brief Главная функция приложения.
- * 
+ *
+ * Поддерживаемые параметры командной строки:
+ * --ingest <путь> — чтение измерений из файла или канала ("-" — стандартный ввод);
+ * --ingest-socket <имя> — чтение измерений из локального сокета;
+ * --ingest-overflow <block|drop> — при переполнении очереди измерений ждать или вытеснять старые;
+ * --control <имя> — управление и запрос состояния по локальному сокету (NDJSON, см. ControlProtocol);
+ * --log-changes <мс> — вывод изменений состояния из шины StateBus, объединённых за окно;
+ * --modbus <порт> — сервер Modbus-TCP на локальном адресе (карта регистров — см. ModbusProtocol);
+ * --fleet <N> — количество блоков в парке;
+ * --simulate <k> — показания от теплового симулятора комнат с ускорением времени k;
+ * --record <путь> — запись принятых измерений и действий пользователя для повтора;
+ * --replay <путь> — повтор записи; --replay-speed <k> — с ускорением k (0 — без пауз;
+ *   без окна повтор без пауз выводит пропускную способность и завершает работу);
+ * --latency-dump <путь> — выгрузка гистограмм длительностей операций (ACM_PROBE) в JSON при завершении;
+ * --startup-trace — вывод длительности этапов запуска до первого кадра в стандартный поток ошибок;
+ * --trace <путь> — трассировка доставки событий и операций ACM_PROBE, при завершении
+ *   выгружается в формате Chrome Trace Event (chrome://tracing, Perfetto);
+ * --stall-threshold <мс> — сообщать о зависаниях цикла событий дольше порога;
+ * --stall-capture <путь> — после каждого зависания выгружать трассировку вокруг него;
+ * --headless — работа без окна;
+ * --duration <с> — завершение через заданное время (в режиме без окна).
+ *
  * @param argc Количество аргументов командной строки.
  * @param argv Массив аргументов командной строки.
  * @return int Код завершения приложения.
  */
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    StartupTrace::start();
+    const bool headless = isHeadless(argc, argv);
+    QScopedPointer<QCoreApplication> a(headless ? static_cast<QCoreApplication *>(new TracedApplication<QCoreApplication>(argc, argv))
+                                                : new TracedApplication<QApplication>(argc, argv));
+    StartupTrace::mark("application");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption ingestOption("ingest", "Чтение измерений из файла или канала (\"-\" — стандартный ввод).", "path");
+    QCommandLineOption socketOption("ingest-socket", "Чтение измерений из локального сокета.", "name");
+    QCommandLineOption overflowOption("ingest-overflow", "При переполнении очереди измерений: block — ждать, drop — вытеснять старые.", "policy", "block");
+    QCommandLineOption controlOption("control", "Управление по локальному сокету: строки JSON с командами get, set_setpoint, set_gates, set_power, select_unit, set_units, add_schedule, remove_schedule, set_holiday, remove_holiday.", "name");
+    QCommandLineOption logChangesOption("log-changes", "Выводить изменения состояния, объединённые за окно (0 — каждое).", "ms");
+    QCommandLineOption modbusOption("modbus", "Сервер Modbus-TCP на локальном адресе: состояние во входных регистрах, управление регистрами хранения.", "port");
+    QCommandLineOption fleetOption("fleet", "Количество блоков в парке.", "count");
+    QCommandLineOption simulateOption("simulate", "Показания от теплового симулятора комнат с ускорением модельного времени.", "factor");
+    QCommandLineOption recordOption("record", "Запись принятых измерений и действий пользователя в файл.", "path");
+    QCommandLineOption replayOption("replay", "Повтор записи измерений и действий пользователя.", "path");
+    QCommandLineOption replaySpeedOption("replay-speed", "Ускорение повтора записи (0 — без пауз).", "factor", "1");
+    QCommandLineOption latencyDumpOption("latency-dump", "Выгрузить длительности операций в JSON при завершении.", "path");
+    QCommandLineOption startupTraceOption("startup-trace", "Вывести длительность этапов запуска до первого кадра.");
+    QCommandLineOption traceOption("trace", "Трассировать события и выгрузить трассировку Chrome Trace Event при завершении.", "path");
+    QCommandLineOption stallThresholdOption("stall-threshold", "Сообщать о зависаниях цикла событий дольше порога.", "ms");
+    QCommandLineOption stallCaptureOption("stall-capture", "Выгружать трассировку событий после каждого зависания.", "path");
+    QCommandLineOption headlessOption("headless", "Работа без окна: только модель состояния и приём измерений.");
+    QCommandLineOption durationOption("duration", "Завершить работу без окна через заданное время.", "seconds");
+    parser.addOption(ingestOption);
+    parser.addOption(socketOption);
+    parser.addOption(overflowOption);
+    parser.addOption(controlOption);
+    parser.addOption(modbusOption);
+    parser.addOption(logChangesOption);
+    parser.addOption(fleetOption);
+    parser.addOption(simulateOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(replaySpeedOption);
+    parser.addOption(latencyDumpOption);
+    parser.addOption(startupTraceOption);
+    parser.addOption(traceOption);
+    parser.addOption(stallThresholdOption);
+    parser.addOption(stallCaptureOption);
+    parser.addOption(headlessOption);
+    parser.addOption(durationOption);
+    parser.process(*a);
+
+    const QString tracePath = parser.value(traceOption); ///< Файл трассировки событий.
+    EventTrace::setRecording(!tracePath.isEmpty());
+    StallMonitor stallMonitor; ///< Сторож зависаний цикла событий.
+    if (parser.isSet(stallThresholdOption) || parser.isSet(stallCaptureOption)) {
+        QObject::connect(&stallMonitor, &StallMonitor::stallDetected, [](const StallRecord &stall) {
+            qWarning().noquote() << QString("Зависание цикла событий %1 мс: %2 %3 (%4)")
+                                        .arg(stall.durationMs, 0, 'f', 1)
+                                        .arg(stall.event.isEmpty() ? QString("вне отмеченных обработчиков") : stall.event,
+                                             stall.receiver, stall.scope);
+        });
+        stallMonitor.setCapturePath(parser.value(stallCaptureOption));
+        stallMonitor.start(parser.isSet(stallThresholdOption) ? parser.value(stallThresholdOption).toInt()
+                                                              : StallMonitor::kDefaultThresholdMs);
+    }
+
+    QScopedPointer<CoolWindow> cw; ///< Главное окно приложения (нет в режиме без окна).
+    QScopedPointer<ClimateModel> headlessModel; ///< Модель состояния в режиме без окна.
+    ClimateModel *model;
+    if (headless) {
+        headlessModel.reset(new ClimateModel);
+        headlessModel->load(ClimateModel::defaultSnapshotPath());
+        headlessModel->controller()->start();
+        headlessModel->scheduler()->start();
+        model = headlessModel.data();
+        StartupTrace::mark("model");
+        if (parser.isSet(startupTraceOption)) {
+            std::fputs(qPrintable(StartupTrace::report()), stderr);
+        }
+    } else {
+        cw.reset(new CoolWindow);
+        model = cw->climateModel();
+        if (parser.isSet(startupTraceOption)) {
+            QObject::connect(cw.data(), &CoolWindow::startupComplete, []() {
+                std::fputs(qPrintable(StartupTrace::report()), stderr);
+            });
+        }
+    }
+    if (parser.isSet(fleetOption)) {
+        model->setFleetSize(parser.value(fleetOption).toInt());
+    }
+
+    if (parser.isSet(logChangesOption)) {
+        model->stateBus()->subscribe(ClimateModel::AllChanged & ~ClimateModel::HistoryChanged, nullptr, [](const StateDelta &delta) {
+            qInfo().noquote() << "Изменение состояния" << delta.toString();
+        }, parser.value(logChangesOption).toInt());
+    }
+
+    QScopedPointer<ControlServer> control; ///< Сервер управления по локальному сокету.
+    if (parser.isSet(controlOption) || parser.isSet(modbusOption)) {
+        control.reset(new ControlServer(model));
+    }
+    if (parser.isSet(controlOption) && !control->listen(parser.value(controlOption))) {
+        qWarning() << "Не удалось открыть сокет управления" << parser.value(controlOption);
+    }
+    QScopedPointer<ModbusServer> modbus; ///< Сервер Modbus-TCP.
+    if (parser.isSet(modbusOption)) {
+        modbus.reset(new ModbusServer(control.data()));
+        if (!modbus->listen(static_cast<quint16>(parser.value(modbusOption).toUInt()))) {
+            qWarning() << "Не удалось открыть порт Modbus-TCP" << parser.value(modbusOption);
+            modbus.reset();
+        }
+    }
+
+    InputTraceWriter recorder; ///< Запись входных воздействий.
+    if (parser.isSet(recordOption)) {
+        if (recorder.open(parser.value(recordOption), model->traceState())) {
+            model->setRecorder(&recorder);
+        } else {
+            qWarning() << "Не удалось создать запись" << parser.value(recordOption);
+        }
+    }
+
+    SensorIngest ingest; ///< Конвейер приёма измерений датчиков.
+    if (parser.value(overflowOption) == "drop") {
+        ingest.setOverflowPolicy(SampleRing::OverflowPolicy::DropOldest);
+    }
+    QObject::connect(&ingest, &SensorIngest::batchReady, model, &ClimateModel::acceptBatch);
+    QObject::connect(&ingest, &SensorIngest::sourceError, [](const QString &message) {
+        qWarning() << "Источник измерений:" << message;
+    });
+    QScopedPointer<SimulationDriver> simulation; ///< Тепловой симулятор комнат.
+    if (parser.isSet(simulateOption)) {
+        simulation.reset(new SimulationDriver(model));
+        simulation->setSpeed(parser.value(simulateOption).toDouble());
+        simulation->start();
+    }
+
+    if (parser.isSet(ingestOption)) {
+        ingest.openFile(parser.value(ingestOption));
+    } else if (parser.isSet(socketOption)) {
+        ingest.openLocalSocket(parser.value(socketOption));
+    }
+
+    QScopedPointer<TraceReplayer> replayer; ///< Повтор записи входных воздействий.
+    const double replaySpeed = parser.value(replaySpeedOption).toDouble();
+    if (parser.isSet(replayOption)) {
+        model->scheduler()->stop(); // Срабатывания по часам смешались бы с повторяемыми действиями
+        replayer.reset(new TraceReplayer(model));
+        if (!replayer->open(parser.value(replayOption))) {
+            qWarning() << "Не удалось прочитать запись" << parser.value(replayOption);
+            replayer.reset();
+        } else if (headless && replaySpeed <= 0.0) {
+            const quint64 events = replayer->runToEnd();
+            std::printf("replayed %llu events (%llu samples) in %.3f ms  %.0f events/s%s\n",
+                        static_cast<unsigned long long>(events), static_cast<unsigned long long>(replayer->replayedSamples()),
+                        replayer->elapsedNs() / 1e6, events / qMax(1e-9, replayer->elapsedNs() / 1e9),
+                        replayer->trace().isCorrupted() ? "  (trace truncated)" : "");
+            model->setRecorder(nullptr);
+            exportTrace(tracePath);
+            return 0;
+        } else {
+            if (headless && !parser.isSet(durationOption)) {
+                QObject::connect(replayer.data(), &TraceReplayer::finished, a.data(), &QCoreApplication::quit);
+            }
+            replayer->start(replaySpeed);
+        }
+    }
+
+    if (!headless) {
+        cw->show(); ///< Отображение главного окна.
+        const int code = a->exec(); ///< Запуск основного цикла обработки событий.
+        model->setRecorder(nullptr);
+        if (parser.isSet(latencyDumpOption)) {
+            cw->dumpLatency(parser.value(latencyDumpOption));
+        }
+        stallMonitor.stop();
+        exportTrace(tracePath);
+        return code;
+    }
 
-    CoolWindow cw; ///< Экземпляр главного окна приложения.
-    cw.show(); ///< Отображение главного окна.
+    if (parser.isSet(durationOption)) {
+        QTimer::singleShot(qRound(parser.value(durationOption).toDouble() * 1000), a.data(), &QCoreApplication::quit);
+    }
+    int code = a->exec();
+    model->setRecorder(nullptr);
+    if (parser.isSet(latencyDumpOption) && !LatencyProbes::dump(parser.value(latencyDumpOption))) {
+        qWarning() << "Не удалось записать длительности операций в" << parser.value(latencyDumpOption);
+    }
+    stallMonitor.stop();
+    exportTrace(tracePath);
 
-    return a.exec(); ///< Запуск основного цикла обработки событий.
-}
\ No newline at end of file
+    const JitterStats jitter = model->controller()->jitter();
+    std::printf("controller ticks %llu  overruns %llu  jitter max %.3f ms  p99 %.3f ms  mean %.3f ms\n",
+                static_cast<unsigned long long>(jitter.ticks), static_cast<unsigned long long>(jitter.overruns),
+                jitter.maxNs / 1e6, jitter.p99Ns / 1e6, jitter.meanNs / 1e6);
+    std::printf("samples %llu  malformed %llu  dropped %llu  batches %llu  units %d  journal records replayed %llu\n",
+                static_cast<unsigned long long>(ingest.receivedSamples()),
+                static_cast<unsigned long long>(ingest.malformedLines()),
+                static_cast<unsigned long long>(ingest.queue().droppedSamples()),
+                static_cast<unsigned long long>(ingest.deliveredBatches()), model->fleetSize(),
+                static_cast<unsigned long long>(model->journal()->replayedRecords()));
+    std::printf("schedule entries %d  holidays %d  fired %llu\n", model->scheduler()->size(), model->scheduler()->holidayCount(),
+                static_cast<unsigned long long>(model->scheduler()->firedEntries()));
+    if (modbus) {
+        std::printf("modbus requests %llu  exceptions %llu\n", static_cast<unsigned long long>(modbus->handledRequests()),
+                    static_cast<unsigned long long>(modbus->exceptionResponses()));
+    }
+    if (control) {
+        std::printf("control requests %llu  model hops %llu\n", static_cast<unsigned long long>(control->handledRequests()),
+                    static_cast<unsigned long long>(control->executedHops()));
+    }
+    return code;
+}
@@ -0,0 +1,348 @@
+#include "../includes/modbusprotocol.h"
+
+/**
+ * @file modbusprotocol.cpp
+ * @brief Реализация протокола Modbus-TCP.
+ *
+ * Этот файл содержит разбор кадров MBAP, заполнение регистров по снимку состояния,
+ * перевод записи регистров в команды модели и запись ответов.
+ */
+
+namespace {
+
+const int kMaxLength = 254; ///< Наибольшее значение поля длины MBAP (устройство + PDU)
+const int kMaxReadRegisters = 125; ///< Наибольшее количество регистров в чтении
+const int kMaxWriteRegisters = 123; ///< Наибольшее количество регистров в записи
+const int kMaxReadCoils = 2000; ///< Наибольшее количество катушек в чтении
+const int kTemperatureUnitCount = 3; ///< Единиц температуры (ClimateModel::TemperatureUnit)
+const int kPressureUnitCount = 2; ///< Единиц давления (ClimateModel::PressureUnit)
+const quint16 kCoilOn = 0xFF00; ///< Значение записи катушки «включено»
+const quint8 kExceptionFlag = 0x80; ///< Бит исключения в коде функции ответа
+
+/**
+ * @brief Читает 16-битное слово, старший байт первым.
+ * @param p Указатель на слово.
+ */
+inline quint16 word(const uchar *p) {
+    return static_cast<quint16>((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Дописывает 16-битное слово, старший байт первым.
+ * @param out Выходной буфер.
+ * @param value Слово.
+ */
+inline void appendWord(QByteArray &out, quint16 value) {
+    out.append(static_cast<char>(value >> 8));
+    out.append(static_cast<char>(value & 0xFF));
+}
+
+/**
+ * @brief Дописывает заголовок MBAP ответа.
+ * @param out Выходной буфер.
+ * @param request Запрос.
+ * @param pduSize Размер PDU ответа вместе с кодом функции.
+ */
+void appendHeader(QByteArray &out, const ModbusRequest &request, int pduSize) {
+    appendWord(out, request.transaction);
+    appendWord(out, 0);
+    appendWord(out, static_cast<quint16>(pduSize + 1));
+    out.append(static_cast<char>(request.unit));
+}
+
+/**
+ * @brief Переводит величину в регистр ×10 со знаком, ограничивая диапазоном регистра.
+ * @param value Величина.
+ */
+quint16 scaled(double value) {
+    return static_cast<quint16>(static_cast<qint16>(qBound<qint64>(-32768, qRound64(value * 10.0), 32767)));
+}
+
+/**
+ * @brief Переводит целое со знаком в регистр.
+ * @param value Значение.
+ */
+quint16 signedRegister(qint32 value) {
+    return static_cast<quint16>(static_cast<qint16>(qBound(-32768, value, 32767)));
+}
+
+/**
+ * @brief Переводит запись одного регистра хранения в команду модели.
+ * @param address Адрес регистра.
+ * @param value Значение регистра.
+ * @param out Вектор, в который добавляется команда.
+ * @return Код исключения.
+ */
+quint8 registerCommand(int address, quint16 value, QVector<ControlCommand> &out) {
+    const qint16 signedValue = static_cast<qint16>(value);
+    ControlCommand command;
+    switch (address) {
+        case ModbusProtocol::HoldingSetpoint:
+            command.op = ControlCommand::SetSetpoint;
+            command.value = signedValue / 10.0;
+            break;
+        case ModbusProtocol::HoldingHGate:
+            command.op = ControlCommand::SetGates;
+            command.hasFirst = true;
+            command.first = signedValue;
+            break;
+        case ModbusProtocol::HoldingVGate:
+            command.op = ControlCommand::SetGates;
+            command.hasSecond = true;
+            command.second = signedValue;
+            break;
+        case ModbusProtocol::HoldingPower:
+            if (value > 1) {
+                return ModbusProtocol::IllegalDataValue;
+            }
+            command.op = ControlCommand::SetPower;
+            command.first = value;
+            break;
+        case ModbusProtocol::HoldingTemperatureUnit:
+            if (value < 1 || value > kTemperatureUnitCount) {
+                return ModbusProtocol::IllegalDataValue;
+            }
+            command.op = ControlCommand::SetUnits;
+            command.hasFirst = true;
+            command.first = value;
+            break;
+        case ModbusProtocol::HoldingPressureUnit:
+            if (value < 1 || value > kPressureUnitCount) {
+                return ModbusProtocol::IllegalDataValue;
+            }
+            command.op = ControlCommand::SetUnits;
+            command.hasSecond = true;
+            command.second = value;
+            break;
+        case ModbusProtocol::HoldingCurrentUnit:
+            command.op = ControlCommand::SelectUnit;
+            command.first = value;
+            break;
+        default:
+            return ModbusProtocol::IllegalDataAddress;
+    }
+    out.append(command);
+    return ModbusProtocol::NoException;
+}
+
+} // namespace
+
+/**
+ * @brief Разбирает кадр в начале буфера без копирования.
+ *
+ * Заголовок MBAP: идентификатор транзакции, идентификатор протокола (0), длина остатка
+ * кадра и идентификатор устройства. Кадр с другим протоколом или невозможной длиной
+ * означает, что поток рассинхронизирован, и соединение следует закрыть.
+ * @param data Буфер.
+ * @param size Размер буфера.
+ * @param out Разобранный запрос.
+ * @return Размер кадра, 0 или -1.
+ */
+int ModbusProtocol::parseFrame(const char *data, qint64 size, ModbusRequest &out) {
+    if (size < kHeaderSize - 1) {
+        return 0;
+    }
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    const int length = word(p + 4);
+    if (word(p + 2) != 0 || length < 2 || length > kMaxLength) {
+        return -1;
+    }
+    const int frameSize = kHeaderSize - 1 + length;
+    if (size < frameSize) {
+        return 0;
+    }
+    out.transaction = word(p);
+    out.unit = p[6];
+    out.function = p[7];
+    out.data = p + kHeaderSize + 1;
+    out.size = length - 2;
+    return frameSize;
+}
+
+/**
+ * @brief Возвращает true, если функция меняет состояние.
+ * @param function Код функции.
+ */
+bool ModbusProtocol::isWrite(quint8 function) {
+    return function == WriteSingleCoil || function == WriteSingleRegister || function == WriteMultipleRegisters;
+}
+
+/**
+ * @brief Дописывает ответ на запрос чтения по снимку состояния.
+ * @param request Запрос.
+ * @param state Состояние текущего блока.
+ * @param out Выходной буфер.
+ * @return Код исключения.
+ */
+quint8 ModbusProtocol::appendReadResponse(const ModbusRequest &request, const ControlState &state, QByteArray &out) {
+    const bool coils = request.function == ReadCoils;
+    const int count = coils ? kCoilCount
+        : request.function == ReadInputRegisters ? InputRegisterCount
+        : request.function == ReadHoldingRegisters ? HoldingRegisterCount : 0;
+    quint8 code = NoException;
+    int address = 0;
+    int quantity = 0;
+    if (count == 0) {
+        code = IllegalFunction;
+    } else if (request.size != 4) {
+        code = IllegalDataValue;
+    } else {
+        address = word(request.data);
+        quantity = word(request.data + 2);
+        if (quantity < 1 || quantity > (coils ? kMaxReadCoils : kMaxReadRegisters)) {
+            code = IllegalDataValue;
+        } else if (address + quantity > count) {
+            code = IllegalDataAddress;
+        }
+    }
+    if (code != NoException) {
+        appendException(request, code, out);
+        return code;
+    }
+
+    if (coils) {
+        appendHeader(out, request, 3);
+        out.append(static_cast<char>(request.function));
+        out.append(static_cast<char>(1));
+        out.append(static_cast<char>(state.power ? 1 : 0));
+        return NoException;
+    }
+    quint16 registers[InputRegisterCount > HoldingRegisterCount ? InputRegisterCount : HoldingRegisterCount];
+    if (request.function == ReadInputRegisters) {
+        inputRegisters(state, registers);
+    } else {
+        holdingRegisters(state, registers);
+    }
+    appendHeader(out, request, 2 + 2 * quantity);
+    out.append(static_cast<char>(request.function));
+    out.append(static_cast<char>(2 * quantity));
+    for (int i = address; i < address + quantity; ++i) {
+        appendWord(out, registers[i]);
+    }
+    return NoException;
+}
+
+/**
+ * @brief Переводит запрос записи в команды модели.
+ *
+ * Значения, допустимость которых известна без модели (питание, единицы), проверяются
+ * здесь; уставку, жалюзи и номер блока проверяет модель при выполнении.
+ * @param request Запрос записи.
+ * @param out Вектор, в который добавляются команды.
+ * @return Код исключения.
+ */
+quint8 ModbusProtocol::writeCommands(const ModbusRequest &request, QVector<ControlCommand> &out) {
+    const int start = out.size();
+    quint8 code = NoException;
+    switch (request.function) {
+        case WriteSingleCoil: {
+            if (request.size != 4) {
+                return IllegalDataValue;
+            }
+            const quint16 value = word(request.data + 2);
+            if (value != kCoilOn && value != 0) {
+                return IllegalDataValue;
+            }
+            if (word(request.data) >= kCoilCount) {
+                return IllegalDataAddress;
+            }
+            ControlCommand command;
+            command.op = ControlCommand::SetPower;
+            command.first = value == kCoilOn ? 1 : 0;
+            out.append(command);
+            return NoException;
+        }
+        case WriteSingleRegister:
+            if (request.size != 4) {
+                return IllegalDataValue;
+            }
+            return registerCommand(word(request.data), word(request.data + 2), out);
+        case WriteMultipleRegisters: {
+            if (request.size < 5) {
+                return IllegalDataValue;
+            }
+            const int address = word(request.data);
+            const int quantity = word(request.data + 2);
+            const int bytes = request.data[4];
+            if (quantity < 1 || quantity > kMaxWriteRegisters || bytes != 2 * quantity || request.size != 5 + bytes) {
+                return IllegalDataValue;
+            }
+            if (address + quantity > HoldingRegisterCount) {
+                return IllegalDataAddress;
+            }
+            for (int i = 0; i < quantity && code == NoException; ++i) {
+                code = registerCommand(address + i, word(request.data + 5 + 2 * i), out);
+            }
+            break;
+        }
+        default:
+            return IllegalFunction;
+    }
+    if (code != NoException) {
+        out.resize(start);
+    }
+    return code;
+}
+
+/**
+ * @brief Дописывает ответ на выполненный запрос записи.
+ *
+ * Все поддерживаемые функции записи отвечают кодом функции и первыми четырьмя байтами
+ * запроса: адресом и значением (05, 06) или адресом и количеством (16).
+ * @param request Запрос записи.
+ * @param out Выходной буфер.
+ */
+void ModbusProtocol::appendWriteResponse(const ModbusRequest &request, QByteArray &out) {
+    appendHeader(out, request, 5);
+    out.append(static_cast<char>(request.function));
+    out.append(reinterpret_cast<const char *>(request.data), 4);
+}
+
+/**
+ * @brief Дописывает ответ-исключение.
+ * @param request Запрос.
+ * @param code Код исключения.
+ * @param out Выходной буфер.
+ */
+void ModbusProtocol::appendException(const ModbusRequest &request, quint8 code, QByteArray &out) {
+    appendHeader(out, request, 2);
+    out.append(static_cast<char>(request.function | kExceptionFlag));
+    out.append(static_cast<char>(code));
+}
+
+/**
+ * @brief Заполняет входные регистры по состоянию.
+ * @param state Состояние текущего блока.
+ * @param registers Массив регистров.
+ */
+void ModbusProtocol::inputRegisters(const ControlState &state, quint16 *registers) {
+    const quint32 pressure = static_cast<quint32>(qBound<qint64>(0, qRound64(state.pressure * 10.0), 0x7FFFFFFF));
+    registers[InputTemperature] = scaled(state.temperature);
+    registers[InputHumidity] = scaled(state.humidity);
+    registers[InputPressureHigh] = static_cast<quint16>(pressure >> 16);
+    registers[InputPressureLow] = static_cast<quint16>(pressure & 0xFFFF);
+    registers[InputSetpoint] = scaled(state.setpoint);
+    registers[InputPower] = static_cast<quint16>(state.power);
+    registers[InputHGate] = signedRegister(state.hGate);
+    registers[InputVGate] = signedRegister(state.vGate);
+    registers[InputTemperatureUnit] = static_cast<quint16>(state.temperatureUnit);
+    registers[InputPressureUnit] = static_cast<quint16>(state.pressureUnit);
+    registers[InputFanSpeed] = static_cast<quint16>(state.fanSpeed);
+    registers[InputCurrentUnit] = static_cast<quint16>(state.unit);
+    registers[InputFleetSize] = static_cast<quint16>(qMin(state.fleetSize, 0xFFFF));
+}
+
+/**
+ * @brief Заполняет регистры хранения по состоянию.
+ * @param state Состояние текущего блока.
+ * @param registers Массив регистров.
+ */
+void ModbusProtocol::holdingRegisters(const ControlState &state, quint16 *registers) {
+    registers[HoldingSetpoint] = scaled(state.setpoint);
+    registers[HoldingHGate] = signedRegister(state.hGate);
+    registers[HoldingVGate] = signedRegister(state.vGate);
+    registers[HoldingPower] = static_cast<quint16>(state.power);
+    registers[HoldingTemperatureUnit] = static_cast<quint16>(state.temperatureUnit);
+    registers[HoldingPressureUnit] = static_cast<quint16>(state.pressureUnit);
+    registers[HoldingCurrentUnit] = static_cast<quint16>(state.unit);
+}
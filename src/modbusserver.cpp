@@ -0,0 +1,245 @@
+#include "../includes/modbusserver.h"
+#include "../includes/controlserver.h"
+#include "../includes/modbusprotocol.h"
+#include <QHostAddress>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * @file modbusserver.cpp
+ * @brief Реализация сервера Modbus-TCP.
+ *
+ * Этот файл содержит реализацию сетевой части сервера (соединения, разбор кадров
+ * в буфере соединения, ответы) и передачу записи регистров в поток модели.
+ */
+
+namespace {
+
+const int kInitialBuffer = 4 * ModbusProtocol::kMaxFrameSize; ///< Начальный размер буфера соединения
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ModbusServerWorker.
+ * @param owner Сервер.
+ */
+ModbusServerWorker::ModbusServerWorker(ModbusServer *owner)
+    : owner(owner)
+{
+}
+
+/**
+ * @brief Начинает приём соединений на локальном адресе.
+ * @param port Порт TCP.
+ * @return Открытый порт или 0.
+ */
+quint16 ModbusServerWorker::listen(quint16 port) {
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &ModbusServerWorker::accept);
+    return server->listen(QHostAddress::LocalHost, port) ? server->serverPort() : 0;
+}
+
+/**
+ * @brief Принимает ожидающие соединения.
+ *
+ * Буфер чтения сокета ограничен ModbusServer::kMaxBuffered, поэтому клиент, не читающий
+ * ответы, упирается в буфер ядра, а не в память сервера.
+ */
+void ModbusServerWorker::accept() {
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        const quint64 id = nextConnection++;
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        socket->setReadBufferSize(ModbusServer::kMaxBuffered);
+        Connection &connection = connections[id];
+        connection.socket = socket;
+        connection.buffer.reserve(kInitialBuffer);
+        connect(socket, &QTcpSocket::readyRead, this, [=]() { readAvailable(id); });
+        connect(socket, &QTcpSocket::disconnected, this, [=]() {
+            connections.remove(id);
+            socket->deleteLater();
+        });
+        readAvailable(id);
+    }
+}
+
+/**
+ * @brief Дочитывает принятые байты в буфер соединения и обрабатывает кадры.
+ *
+ * Пока выполняется запись и в буфере больше ModbusServer::kMaxBuffered байт, чтение
+ * приостанавливается (возобновляется из complete()).
+ * @param id Номер соединения.
+ */
+void ModbusServerWorker::readAvailable(quint64 id) {
+    const auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection &connection = *it;
+    if (connection.socket->state() != QAbstractSocket::ConnectedState
+        || connection.buffer.size() - connection.begin >= ModbusServer::kMaxBuffered) {
+        return;
+    }
+    const qint64 available = connection.socket->bytesAvailable();
+    if (available <= 0) {
+        return;
+    }
+    const int used = connection.buffer.size();
+    connection.buffer.resize(used + static_cast<int>(available));
+    const qint64 read = connection.socket->read(connection.buffer.data() + used, available);
+    connection.buffer.resize(used + static_cast<int>(qMax<qint64>(0, read)));
+    process(id, connection);
+}
+
+/**
+ * @brief Отвечает на кадры соединения по порядку.
+ *
+ * Чтение отвечает сразу по снимку состояния. Встретив запись, переводит её в команды,
+ * заранее готовит оба возможных ответа (PDU указывает в буфер, который дальше может
+ * сдвинуться) и отправляет команды в поток модели; следующие кадры ждут её результата.
+ * Кадр, который не является Modbus-TCP, закрывает соединение.
+ * @param id Номер соединения.
+ * @param connection Соединение.
+ */
+void ModbusServerWorker::process(quint64 id, Connection &connection) {
+    QByteArray out;
+    quint64 answered = 0;
+    quint64 failed = 0;
+    bool broken = false;
+    while (!connection.inFlight) {
+        ModbusRequest request;
+        const int size = ModbusProtocol::parseFrame(connection.buffer.constData() + connection.begin,
+                                                    connection.buffer.size() - connection.begin, request);
+        if (size <= 0) {
+            broken = size < 0;
+            break;
+        }
+        connection.begin += size;
+        if (!ModbusProtocol::isWrite(request.function)) {
+            if (ModbusProtocol::appendReadResponse(request, owner->control->state(), out) != ModbusProtocol::NoException) {
+                ++failed;
+            }
+            ++answered;
+            continue;
+        }
+        QVector<ControlCommand> commands;
+        const quint8 code = ModbusProtocol::writeCommands(request, commands);
+        if (code != ModbusProtocol::NoException) {
+            ModbusProtocol::appendException(request, code, out);
+            ++failed;
+            ++answered;
+            continue;
+        }
+        connection.reply.resize(0);
+        ModbusProtocol::appendWriteResponse(request, connection.reply);
+        connection.failure.resize(0);
+        ModbusProtocol::appendException(request, ModbusProtocol::IllegalDataValue, connection.failure);
+        connection.inFlight = true;
+        ControlServer *control = owner->control;
+        QPointer<ModbusServerWorker> self(this); // Ответ отбрасывается, если close() уже удалил работника
+        QMetaObject::invokeMethod(control, [control, self, id, commands]() {
+            const QVector<ControlResult> results = control->execute(commands);
+            if (!self) {
+                return;
+            }
+            QMetaObject::invokeMethod(self.data(), [self, id, results]() { self->complete(id, results); }, Qt::QueuedConnection);
+        }, Qt::QueuedConnection);
+    }
+    owner->handled.fetch_add(answered, std::memory_order_relaxed);
+    owner->exceptions.fetch_add(failed, std::memory_order_relaxed);
+    if (!out.isEmpty()) {
+        connection.socket->write(out);
+    }
+    if (broken) {
+        connection.buffer.resize(0);
+        connection.begin = 0;
+        connection.socket->disconnectFromHost();
+        return;
+    }
+    if (connection.begin == connection.buffer.size()) {
+        connection.buffer.resize(0);
+        connection.begin = 0;
+    } else if (!connection.inFlight && connection.begin > 0) {
+        connection.buffer.remove(0, connection.begin);
+        connection.begin = 0;
+    }
+}
+
+/**
+ * @brief Принимает результаты записи и отвечает на неё.
+ * @param id Номер соединения.
+ * @param results Результаты команд записи.
+ */
+void ModbusServerWorker::complete(quint64 id, const QVector<ControlResult> &results) {
+    const auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection &connection = *it;
+    bool accepted = true;
+    for (const ControlResult &result : results) {
+        accepted = accepted && result.error == nullptr;
+    }
+    connection.socket->write(accepted ? connection.reply : connection.failure);
+    owner->handled.fetch_add(1, std::memory_order_relaxed);
+    if (!accepted) {
+        owner->exceptions.fetch_add(1, std::memory_order_relaxed);
+    }
+    connection.inFlight = false;
+    process(id, connection);
+    readAvailable(id);
+}
+
+/**
+ * @brief Конструктор класса ModbusServer.
+ * @param control Сервер управления.
+ * @param parent Родительский объект.
+ */
+ModbusServer::ModbusServer(ControlServer *control, QObject *parent)
+    : QObject(parent)
+    , control(control)
+{
+    serverThread.setObjectName("modbus server");
+}
+
+/**
+ * @brief Деструктор класса ModbusServer.
+ */
+ModbusServer::~ModbusServer() {
+    close();
+}
+
+/**
+ * @brief Открывает порт на локальном адресе и запускает поток сервера.
+ * @param port Порт TCP.
+ * @return true, если порт открыт.
+ */
+bool ModbusServer::listen(quint16 port) {
+    close();
+    worker = new ModbusServerWorker(this);
+    worker->moveToThread(&serverThread);
+    connect(&serverThread, &QThread::finished, worker, &QObject::deleteLater);
+    serverThread.start();
+
+    quint16 opened = 0;
+    ModbusServerWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target, port, &opened]() { opened = target->listen(port); }, Qt::BlockingQueuedConnection);
+    if (opened == 0) {
+        close();
+        return false;
+    }
+    this->port = opened;
+    return true;
+}
+
+/**
+ * @brief Закрывает порт и останавливает поток сервера.
+ */
+void ModbusServer::close() {
+    if (serverThread.isRunning()) {
+        serverThread.quit();
+        serverThread.wait();
+    }
+    worker = nullptr;
+    port = 0;
+}
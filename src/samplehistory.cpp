@@ -0,0 +1,105 @@
+#include "../includes/samplehistory.h"
+
+/**
+ * @file samplehistory.cpp
+ * @brief Реализация истории измерений.
+ *
+ * Этот файл содержит реализацию методов класса SampleHistory и прореживания minMaxDecimate().
+ */
+
+/**
+ * @brief Конструктор класса SampleHistory.
+ * @param capacity Ёмкость истории.
+ */
+SampleHistory::SampleHistory(int capacity)
+    : timestamps(capacity)
+{
+    for (RingBuffer<double> &buffer : values) {
+        buffer.reset(capacity);
+    }
+}
+
+/**
+ * @brief Добавляет измерение.
+ * @param timestampUs Метка времени в микросекундах.
+ * @param temperature Температура.
+ * @param humidity Влажность.
+ * @param pressure Давление.
+ */
+void SampleHistory::append(qint64 timestampUs, double temperature, double humidity, double pressure) {
+    timestamps.append(timestampUs);
+    values[Temperature].append(temperature);
+    values[Humidity].append(humidity);
+    values[Pressure].append(pressure);
+}
+
+/**
+ * @brief Очищает историю.
+ */
+void SampleHistory::clear() {
+    timestamps.clear();
+    for (RingBuffer<double> &buffer : values) {
+        buffer.clear();
+    }
+}
+
+/**
+ * @brief Возвращает номер первого измерения с меткой не меньше заданной.
+ *
+ * Метки времени не убывают, поэтому используется двоичный поиск.
+ * @param timestampUs Метка времени.
+ * @return Логический номер измерения.
+ */
+int SampleHistory::lowerBound(qint64 timestampUs) const {
+    int low = 0;
+    int high = timestamps.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (timestamps.at(mid) < timestampUs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Прореживает канал истории с сохранением экстремумов.
+ * @param history История измерений.
+ * @param channel Канал.
+ * @param fromUs Начало отрезка времени.
+ * @param toUs Конец отрезка времени.
+ * @param buckets Количество интервалов.
+ * @param out Результат.
+ */
+void minMaxDecimate(const SampleHistory &history, SampleHistory::Channel channel,
+                    qint64 fromUs, qint64 toUs, int buckets, QVector<MinMaxBucket> &out) {
+    out.resize(buckets);
+    for (MinMaxBucket &bucket : out) {
+        bucket.empty = true;
+    }
+    if (buckets <= 0 || toUs <= fromUs) {
+        return;
+    }
+
+    const double scale = double(buckets) / double(toUs - fromUs);
+    const int end = history.lowerBound(toUs);
+    for (int i = history.lowerBound(fromUs); i < end; ++i) {
+        int b = static_cast<int>((history.timestampAt(i) - fromUs) * scale);
+        if (b >= buckets) {
+            b = buckets - 1;
+        }
+        double value = history.valueAt(channel, i);
+        MinMaxBucket &bucket = out[b];
+        if (bucket.empty) {
+            bucket.min = value;
+            bucket.max = value;
+            bucket.empty = false;
+        } else if (value < bucket.min) {
+            bucket.min = value;
+        } else if (value > bucket.max) {
+            bucket.max = value;
+        }
+    }
+}
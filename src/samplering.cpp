@@ -0,0 +1,224 @@
+#include "../includes/samplering.h"
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+/**
+ * @file samplering.cpp
+ * @brief Реализация класса SampleRing.
+ *
+ * Этот файл содержит реализацию записи, вытеснения и чтения измерений
+ * кольцевой очереди без блокировок.
+ */
+
+namespace {
+
+const int kSpinsBeforeSleep = 64; ///< Попыток с уступкой процессора до перехода на сон при ожидании места
+const int kWaitSleepUs = 100; ///< Сон производителя при ожидании места, мкс
+
+static_assert(sizeof(SensorSample) % sizeof(quint64) == 0, "SensorSample must consist of whole 8-byte words");
+
+} // namespace
+
+/**
+ * @brief Конструктор класса SampleRing.
+ * @param capacity Ёмкость в измерениях (округляется вверх до степени двойки).
+ * @param policy Поведение при переполнении.
+ */
+SampleRing::SampleRing(int capacity, OverflowPolicy policy)
+    : overflowPolicy(policy)
+{
+    quint64 size = 2;
+    while (size < static_cast<quint64>(qMax(2, capacity))) {
+        size *= 2;
+    }
+    mask = size - 1;
+    slots.reset(new std::atomic<quint64>[size * kWords]);
+}
+
+/**
+ * @brief Записывает измерение в ячейку.
+ * @param position Позиция записи.
+ * @param sample Измерение.
+ */
+void SampleRing::writeSlot(quint64 position, const SensorSample &sample) {
+    quint64 words[kWords];
+    std::memcpy(words, &sample, sizeof(SensorSample));
+    std::atomic<quint64> *slot = &slots[(position & mask) * kWords];
+    for (int i = 0; i < kWords; ++i) {
+        slot[i].store(words[i], std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Читает измерение из ячейки.
+ * @param position Позиция чтения.
+ * @param sample Измерение.
+ */
+void SampleRing::readSlot(quint64 position, SensorSample &sample) const {
+    quint64 words[kWords];
+    const std::atomic<quint64> *slot = &slots[(position & mask) * kWords];
+    for (int i = 0; i < kWords; ++i) {
+        words[i] = slot[i].load(std::memory_order_relaxed);
+    }
+    std::memcpy(&sample, words, sizeof(SensorSample));
+}
+
+/**
+ * @brief Добавляет измерения.
+ *
+ * При политике DropOldest нехватка места покрывается сдвигом позиции чтения на недостающее
+ * количество; если пакет больше ёмкости, его начало вытесняется сразу. При политике Block
+ * записывается столько, сколько помещается, а на остаток производитель ждёт:
+ * сначала уступая процессор, затем засыпая на короткое время.
+ * @param samples Массив измерений.
+ * @param count Количество измерений.
+ * @return Количество записанных измерений.
+ */
+int SampleRing::push(const SensorSample *samples, int count) {
+    if (count <= 0 || closed.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    const quint64 cap = mask + 1;
+    quint64 t = tail.load(std::memory_order_relaxed);
+    int written = 0; // Принято из пакета, включая сразу вытесненное начало
+    int stored = 0; // Записано в ячейки
+    bool overflowed = false;
+
+    if (policy() == OverflowPolicy::DropOldest) {
+        if (static_cast<quint64>(count) > cap) {
+            const int skipped = count - static_cast<int>(cap); // Начало пакета всё равно было бы вытеснено
+            dropped.fetch_add(skipped, std::memory_order_relaxed);
+            samples += skipped;
+            written = skipped;
+            count = static_cast<int>(cap);
+            overflowed = true;
+        }
+
+        quint64 h = head.load(std::memory_order_acquire);
+        while (t - h + count > cap) {
+            const quint64 need = t - h + count - cap;
+            if (head.compare_exchange_weak(h, h + need, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                std::atomic_thread_fence(std::memory_order_release); // Сдвиг позиции виден раньше перезаписи ячеек
+                dropped.fetch_add(need, std::memory_order_relaxed);
+                overflowed = true;
+                break;
+            }
+            // Потребитель успел забрать измерения: h перечитана, место пересчитывается
+        }
+
+        for (int i = 0; i < count; ++i) {
+            writeSlot(t + i, samples[i]);
+        }
+        tail.store(t + count, std::memory_order_release);
+        written += count;
+        stored = count;
+    } else {
+        int spins = 0;
+        while (written < count) {
+            const quint64 h = head.load(std::memory_order_acquire);
+            const int room = static_cast<int>(qMin<quint64>(cap - (t - h), static_cast<quint64>(count - written)));
+            if (room == 0) {
+                if (closed.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                if (!overflowed) {
+                    overflowed = true;
+                    waits.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (++spins < kSpinsBeforeSleep) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(kWaitSleepUs));
+                }
+                continue;
+            }
+
+            for (int i = 0; i < room; ++i) {
+                writeSlot(t + i, samples[written + i]);
+            }
+            t += room;
+            written += room;
+            tail.store(t, std::memory_order_release);
+        }
+        stored = written;
+    }
+
+    if (overflowed) {
+        overflows.fetch_add(1, std::memory_order_relaxed);
+    }
+    pushed.fetch_add(stored, std::memory_order_relaxed);
+    return written;
+}
+
+/**
+ * @brief Забирает накопленные измерения.
+ *
+ * Прочитанные ячейки подтверждаются сдвигом позиции чтения сравнением с обменом.
+ * Если за время чтения производитель вытеснил часть измерений (позиция чтения ушла вперёд),
+ * вытесненные ячейки могли быть перезаписаны: они отбрасываются, а остальное прочитанное
+ * подтверждается, поэтому постоянно переполняемая очередь не лишает потребителя данных.
+ * Ячейка перезаписывается только после сдвига позиции чтения за неё, поэтому позиция,
+ * перечитанная после копирования, отделяет вытесненное от достоверного.
+ * @param out Вектор, в который добавляются измерения.
+ * @param maxCount Наибольшее количество забираемых измерений (-1 — все).
+ * @return Количество забранных измерений.
+ */
+int SampleRing::drain(QVector<SensorSample> &out, int maxCount) {
+    const int base = out.size();
+    for (;;) {
+        const quint64 h = head.load(std::memory_order_acquire);
+        const quint64 t = tail.load(std::memory_order_acquire);
+        quint64 available = qMin(t - h, mask + 1); // Больше ёмкости — позицию чтения уже сдвинули, подтверждение не пройдёт
+        if (maxCount >= 0) {
+            available = qMin(available, static_cast<quint64>(maxCount));
+        }
+        if (available == 0) {
+            return 0;
+        }
+
+        const int n = static_cast<int>(available);
+        out.resize(base + n);
+        SensorSample *dst = out.data() + base;
+        for (int i = 0; i < n; ++i) {
+            readSlot(h + i, dst[i]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        quint64 current = h;
+        while (current < h + n) {
+            if (head.compare_exchange_weak(current, h + n, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                const int lost = static_cast<int>(current - h);
+                if (lost > 0) {
+                    out.erase(out.begin() + base, out.begin() + base + lost);
+                }
+                return n - lost;
+            }
+        }
+        out.resize(base); // Вытеснено всё прочитанное: читаем заново с новой позиции
+    }
+}
+
+/**
+ * @brief Закрывает очередь.
+ */
+void SampleRing::close() {
+    closed.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Открывает очередь заново.
+ */
+void SampleRing::reopen() {
+    closed.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает количество измерений в очереди.
+ */
+int SampleRing::size() const {
+    const quint64 h = head.load(std::memory_order_acquire);
+    const quint64 t = tail.load(std::memory_order_acquire);
+    return static_cast<int>(qMin(t - h, mask + 1));
+}
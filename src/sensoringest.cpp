@@ -0,0 +1,492 @@
+#include "../includes/sensoringest.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QLocalSocket>
+#include <QSocketNotifier>
+#include <cstring>
+#include <utility>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file sensoringest.cpp
+ * @brief Реализация конвейера приёма данных датчиков.
+ *
+ * Этот файл содержит реализацию методов классов SensorSourceReader и SensorIngest,
+ * а также быстрый разбор текстовых строк измерений.
+ */
+
+namespace {
+
+const int kReadChunk = 64 * 1024; ///< Размер блока чтения из источника
+const int kMaxLineLength = 4096; ///< Наибольшая длина незавершённой строки; длиннее — строка некорректна
+const int kPollIntervalMs = 10; ///< Период дочитывания обычного файла
+const int kDefaultFrameMs = 16; ///< Период кадра по умолчанию (~60 Гц)
+
+/**
+ * @brief Точные степени десяти, представимые в double.
+ */
+const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+inline const char *skipSeparators(const char *p, const char *end) {
+    while (p < end && isSeparator(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief Разбирает целое число со знаком.
+ * @return Указатель на символ после числа или nullptr при ошибке.
+ */
+const char *parseInt64(const char *p, const char *end, qint64 &value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    const char *digits = p;
+    quint64 result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + static_cast<quint64>(*p - '0');
+        ++p;
+    }
+    if (p == digits) {
+        return nullptr;
+    }
+    value = negative ? -static_cast<qint64>(result) : static_cast<qint64>(result);
+    return p;
+}
+
+/**
+ * @brief Разбирает десятичное число с плавающей точкой.
+ *
+ * Для чисел не длиннее 19 значащих цифр с небольшим порядком используется быстрый путь
+ * (мантисса и степень десяти точно представимы, результат корректно округлён).
+ * Остальные числа разбираются через QByteArray::toDouble(), не зависящий от локали.
+ *
+ * @return Указатель на символ после числа или nullptr при ошибке.
+ */
+const char *parseDouble(const char *p, const char *end, double &value) {
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+            if (mantissa != 0) {
+                ++digits;
+            }
+        } else {
+            ++exponent;
+        }
+        any = true;
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+                if (mantissa != 0) {
+                    ++digits;
+                }
+                --exponent;
+            }
+            any = true;
+            ++p;
+        }
+    }
+    if (!any) {
+        return nullptr;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        qint64 e = 0;
+        const char *after = parseInt64(p + 1, end, e);
+        if (!after || e > 10000 || e < -10000) {
+            return nullptr;
+        }
+        exponent += static_cast<int>(e);
+        p = after;
+    }
+
+    if (mantissa < (quint64(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+        value = negative ? -result : result;
+        return p;
+    }
+
+    bool ok = false;
+    value = QByteArray(start, static_cast<int>(p - start)).toDouble(&ok);
+    return ok ? p : nullptr;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса SensorSourceReader.
+ * @param kind Тип источника.
+ * @param address Путь к файлу/каналу или имя сокета.
+ * @param sink Приёмник разобранных измерений.
+ */
+SensorSourceReader::SensorSourceReader(SourceKind kind, const QString &address, SensorIngest *sink)
+    : kind(kind), address(address), sink(sink)
+{
+    parsed.reserve(kReadChunk / 16);
+}
+
+/**
+ * @brief Открывает источник и подключает уведомления о готовности данных.
+ *
+ * Локальный сокет читается по сигналу readyRead. Каналы и стандартный ввод на UNIX
+ * читаются по QSocketNotifier; канал FIFO открывается на чтение и запись, чтобы
+ * открытие не блокировалось в ожидании писателя, а его закрытие не приводило к EOF.
+ * Обычный файл дочитывается по таймеру, как "tail -f".
+ */
+void SensorSourceReader::start() {
+    if (kind == SourceKind::LocalSocket) {
+        socket = new QLocalSocket(this);
+        connect(socket, &QLocalSocket::readyRead, this, &SensorSourceReader::readAvailable);
+        connect(socket, QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error), this, [=]() {
+            emit sourceError(socket->errorString());
+        });
+        socket->connectToServer(address, QIODevice::ReadOnly);
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    if (address == "-") {
+        fd = STDIN_FILENO;
+    } else {
+        struct stat st;
+        QByteArray path = QFile::encodeName(address);
+        if (::stat(path.constData(), &st) == 0 && !S_ISREG(st.st_mode)) {
+            fd = ::open(path.constData(), (S_ISFIFO(st.st_mode) ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+            ownsFd = true;
+        }
+    }
+    if (fd >= 0 || ownsFd) {
+        if (fd < 0) {
+            emit sourceError("Не удалось открыть источник: " + address);
+            return;
+        }
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &SensorSourceReader::readAvailable);
+        return;
+    }
+#endif
+
+    QFile *file = new QFile(address, this);
+    if (!file->open(QIODevice::ReadOnly)) {
+        emit sourceError(file->errorString());
+        return;
+    }
+    pollTimer = new QTimer(this);
+    connect(pollTimer, &QTimer::timeout, this, [=]() {
+        char buffer[kReadChunk];
+        qint64 n;
+        while ((n = file->read(buffer, sizeof(buffer))) > 0) {
+            consume(buffer, n);
+        }
+    });
+    pollTimer->start(kPollIntervalMs);
+}
+
+/**
+ * @brief Читает доступные данные из сокета или канала.
+ */
+void SensorSourceReader::readAvailable() {
+    char buffer[kReadChunk];
+    if (socket) {
+        qint64 n;
+        while ((n = socket->read(buffer, sizeof(buffer))) > 0) {
+            consume(buffer, n);
+        }
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    ssize_t n = ::read(fd, buffer, sizeof(buffer));
+    if (n > 0) {
+        consume(buffer, n);
+    } else if (n == 0) {
+        notifier->setEnabled(false); // Конец потока (например, закрыт стандартный ввод)
+    }
+#endif
+}
+
+/**
+ * @brief Разбирает очередной блок данных с учётом незавершённой строки.
+ *
+ * Незавершённая строка длиннее kMaxLineLength считается одной некорректной строкой:
+ * она отбрасывается, а данные до следующего перевода строки пропускаются, поэтому
+ * источник без переводов строк не заставляет копить его данные в памяти.
+ * @param data Данные.
+ * @param size Размер данных.
+ */
+void SensorSourceReader::consume(const char *data, qint64 size) {
+    if (discarding) {
+        const char *newline = static_cast<const char *>(std::memchr(data, '\n', static_cast<size_t>(size)));
+        if (!newline) {
+            return;
+        }
+        size -= newline + 1 - data;
+        data = newline + 1;
+        discarding = false;
+    }
+
+    quint64 bad = 0;
+    if (tail.isEmpty()) {
+        qint64 used = SensorIngest::parseChunk(data, size, parsed, &bad);
+        tail.append(data + used, static_cast<int>(size - used));
+    } else {
+        tail.append(data, static_cast<int>(size));
+        qint64 used = SensorIngest::parseChunk(tail.constData(), tail.size(), parsed, &bad);
+        tail.remove(0, static_cast<int>(used));
+    }
+    if (tail.size() > kMaxLineLength) {
+        ++bad;
+        tail.clear();
+        discarding = true;
+    }
+
+    if (bad) {
+        sink->countMalformed(bad);
+    }
+    if (!parsed.isEmpty()) {
+        sink->pushSamples(parsed.constData(), parsed.size());
+        parsed.clear();
+    }
+}
+
+/**
+ * @brief Деструктор класса SensorSourceReader. Закрывает собственный дескриптор.
+ */
+SensorSourceReader::~SensorSourceReader() {
+#ifdef Q_OS_UNIX
+    if (ownsFd && fd >= 0) {
+        ::close(fd);
+    }
+#endif
+}
+
+/**
+ * @brief Конструктор класса SensorIngest.
+ *
+ * Создаёт таймер кадра, по которому накопленные измерения выдаются пакетом.
+ * @param parent Родительский объект.
+ */
+SensorIngest::SensorIngest(QObject *parent)
+    : QObject(parent)
+{
+    delivering.reserve(4096);
+
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &SensorIngest::flush);
+    frameTimer->start(kDefaultFrameMs);
+}
+
+/**
+ * @brief Начинает чтение из файла или канала.
+ * @param path Путь к файлу или каналу, "-" — стандартный ввод.
+ */
+void SensorIngest::openFile(const QString &path) {
+    startReader(SensorSourceReader::SourceKind::File, path);
+}
+
+/**
+ * @brief Начинает чтение из локального сокета.
+ * @param serverName Имя сервера или путь к UNIX-сокету.
+ */
+void SensorIngest::openLocalSocket(const QString &serverName) {
+    startReader(SensorSourceReader::SourceKind::LocalSocket, serverName);
+}
+
+/**
+ * @brief Создаёт читателя в отдельном потоке и запускает его.
+ * @param kind Тип источника.
+ * @param address Адрес источника.
+ */
+void SensorIngest::startReader(SensorSourceReader::SourceKind kind, const QString &address) {
+    stop();
+    ring.reopen();
+
+    reader = new SensorSourceReader(kind, address, this);
+    reader->moveToThread(&readerThread);
+    connect(&readerThread, &QThread::started, reader, &SensorSourceReader::start);
+    connect(&readerThread, &QThread::finished, reader, &QObject::deleteLater);
+    connect(reader, &SensorSourceReader::sourceError, this, &SensorIngest::sourceError);
+    readerThread.start();
+}
+
+/**
+ * @brief Останавливает поток читателя и выдаёт остаток пакета.
+ *
+ * Очередь закрывается до остановки потока, чтобы читатель, ожидающий свободного места,
+ * вернулся в цикл событий.
+ */
+void SensorIngest::stop() {
+    if (readerThread.isRunning()) {
+        ring.close();
+        readerThread.quit();
+        readerThread.wait();
+    }
+    reader = nullptr;
+    flush();
+}
+
+/**
+ * @brief Задаёт период выдачи пакетов.
+ * @param ms Период в миллисекундах.
+ */
+void SensorIngest::setFrameInterval(int ms) {
+    frameTimer->start(ms);
+}
+
+/**
+ * @brief Добавляет измерения в очередь.
+ * @param samples Массив измерений.
+ * @param count Количество измерений.
+ */
+void SensorIngest::pushSamples(const SensorSample *samples, int count) {
+    ring.push(samples, count);
+    received.fetch_add(static_cast<quint64>(count), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Учитывает некорректные строки источника.
+ * @param count Количество строк.
+ */
+void SensorIngest::countMalformed(quint64 count) {
+    malformed.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Выдаёт накопленный за кадр пакет.
+ *
+ * Измерения забираются из очереди в буфер delivering, память которого переиспользуется
+ * от кадра к кадру; читатель при этом не останавливается.
+ */
+void SensorIngest::flush() {
+    if (ring.drain(delivering) == 0) {
+        return;
+    }
+
+    ++batches;
+    emit batchReady(delivering);
+    delivering.clear();
+}
+
+/**
+ * @brief Разбирает одну строку измерения.
+ * @param begin Начало строки.
+ * @param end Конец строки.
+ * @param sample Результат разбора.
+ * @return true, если строка содержит корректное измерение.
+ */
+bool SensorIngest::parseLine(const char *begin, const char *end, SensorSample &sample) {
+    const char *p = skipSeparators(begin, end);
+    p = parseInt64(p, end, sample.timestampUs);
+    if (!p) {
+        return false;
+    }
+    double *fields[] = { &sample.temperature, &sample.humidity, &sample.pressure };
+    for (double *field : fields) {
+        const char *next = skipSeparators(p, end);
+        if (next == p) {
+            return false;
+        }
+        p = parseDouble(next, end, *field);
+        if (!p) {
+            return false;
+        }
+    }
+    return skipSeparators(p, end) == end;
+}
+
+/**
+ * @brief Разбирает все завершённые строки в буфере.
+ * @param data Буфер с текстом.
+ * @param size Размер буфера.
+ * @param out Вектор, в который добавляются измерения.
+ * @param malformed Счётчик некорректных строк.
+ * @return Количество обработанных байт.
+ */
+qint64 SensorIngest::parseChunk(const char *data, qint64 size, QVector<SensorSample> &out, quint64 *malformed) {
+    const char *p = data;
+    const char *end = data + size;
+    SensorSample sample;
+
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol) {
+            break;
+        }
+        const char *first = skipSeparators(p, eol);
+        if (first != eol && *first != '#') {
+            if (parseLine(first, eol, sample)) {
+                out.append(sample);
+            } else if (malformed) {
+                ++*malformed;
+            }
+        }
+        p = eol + 1;
+    }
+    return p - data;
+}
+
+/**
+ * @brief Возвращает количество принятых измерений.
+ */
+quint64 SensorIngest::receivedSamples() const {
+    return received.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает количество некорректных строк.
+ */
+quint64 SensorIngest::malformedLines() const {
+    return malformed.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает количество выданных пакетов.
+ */
+quint64 SensorIngest::deliveredBatches() const {
+    return batches;
+}
+
+/**
+ * @brief Деструктор класса SensorIngest.
+ *
+ * Закрывает кольцо до остановки потока: иначе читатель, ждущий места в заполненном
+ * кольце, не вернётся в цикл событий и не увидит quit().
+ */
+SensorIngest::~SensorIngest() {
+    if (readerThread.isRunning()) {
+        ring.close();
+        readerThread.quit();
+        readerThread.wait();
+    }
+}
@@ -12,23 +12,26 @@
  * @brief Конструктор класса Settings.
  * 
  * Создаёт экземпляр окна настроек с элементами управления для выбора 
- * шкалы температуры, шкалы давления и темы оформления.
+ * шкалы температуры, шкалы давления, скорости вентилятора и темы оформления.
+ * Скорость вентилятора и тема применяются сразу после выбора.
  * 
  * @param parent Указатель на родительский объект.
  */
 Settings::Settings(QWidget *parent)
     : QDialog(parent)
 {
-    this->setFixedSize(300,300);
+    this->setFixedSize(300,360);
 
     mainLayout = new QVBoxLayout;
     tempLayout = new QVBoxLayout;
     presLayout = new QVBoxLayout;
+    fanLayout = new QHBoxLayout;
     themeLayout = new QHBoxLayout;
     confirmLayout = new QHBoxLayout;
 
     tempLabel = new QLabel("Шкала температуры:", this);
     presLabel = new QLabel("Шкала давления:", this);
+    fanLabel = new QLabel("Скорость вентилятора:", this);
 
     cels = new QRadioButton("Цельсия", this);
     far = new QRadioButton("Фаренгейта", this);
@@ -46,6 +49,15 @@ Settings::Settings(QWidget *parent)
     presGroup->addButton(pa, 1);
     presGroup->addButton(mmrtst, 2);
 
+    fanLow = new QRadioButton("Низкая", this);
+    fanMedium = new QRadioButton("Средняя", this);
+    fanHigh = new QRadioButton("Высокая", this);
+
+    fanGroup = new QButtonGroup(this);
+    fanGroup->addButton(fanLow, 1);
+    fanGroup->addButton(fanMedium, 2);
+    fanGroup->addButton(fanHigh, 3);
+
     white = new QPushButton("Светлая тема", this);
     black = new QPushButton("Тёмная тема", this);
 
@@ -60,6 +72,10 @@ Settings::Settings(QWidget *parent)
     presLayout->addWidget(pa);
     presLayout->addWidget(mmrtst);
 
+    fanLayout->addWidget(fanLow);
+    fanLayout->addWidget(fanMedium);
+    fanLayout->addWidget(fanHigh);
+
     themeLayout->addWidget(white);
     themeLayout->addWidget(black);
 
@@ -67,6 +83,8 @@ Settings::Settings(QWidget *parent)
 
     mainLayout->addLayout(tempLayout);
     mainLayout->addLayout(presLayout);
+    mainLayout->addWidget(fanLabel);
+    mainLayout->addLayout(fanLayout);
     mainLayout->addLayout(themeLayout);
     mainLayout->addLayout(confirmLayout);
 
@@ -78,6 +96,11 @@ Settings::Settings(QWidget *parent)
     connect(black, &QPushButton::clicked, this, [=](){
         emit darkThemeSelected();
     });
+    for (QAbstractButton *button : fanGroup->buttons()) {
+        connect(button, &QAbstractButton::clicked, this, [=](){
+            emit fanSpeedSelected(fanGroup->id(button));
+        });
+    }
     connect(confirmButton, &QPushButton::clicked, this, [=](){
         int tempId = tempGroup->checkedId();
         int presId = presGroup->checkedId();
@@ -132,6 +155,25 @@ void Settings::setActivePresUnit(int id) {
     }
 }
 
+/**
+ * @brief Устанавливает активную скорость вентилятора.
+ * 
+ * @param id Идентификатор скорости (1 - низкая, 2 - средняя, 3 - высокая).
+ */
+void Settings::setActiveFanSpeed(int id) {
+    switch (id) {
+        case 1:
+            fanLow->setChecked(true);
+            break;
+        case 3:
+            fanHigh->setChecked(true);
+            break;
+        default:
+            fanMedium->setChecked(true);
+            break;
+    }
+}
+
 /**
  * @brief Деструктор класса Settings.
  * 
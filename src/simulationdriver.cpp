@@ -0,0 +1,105 @@
+#include "../includes/simulationdriver.h"
+#include "../includes/unitconversion.h"
+#include <algorithm>
+
+/**
+ * @file simulationdriver.cpp
+ * @brief Реализация класса SimulationDriver.
+ *
+ * Этот файл содержит реализацию тактов симуляции комнат и передачи показаний в модель состояния.
+ */
+
+namespace {
+
+const int kCelsius = static_cast<int>(ClimateModel::TemperatureUnit::Celsius); ///< Единица температуры симулятора
+
+} // namespace
+
+/**
+ * @brief Конструктор класса SimulationDriver.
+ * @param model Модель состояния.
+ * @param parent Родительский объект.
+ */
+SimulationDriver::SimulationDriver(ClimateModel *model, QObject *parent)
+    : QObject(parent), model(model)
+{
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &SimulationDriver::tick);
+}
+
+/**
+ * @brief Запускает такты симуляции.
+ * @param intervalMs Период тактов, мс.
+ */
+void SimulationDriver::start(int intervalMs) {
+    clock.start();
+    timer.start(intervalMs);
+}
+
+/**
+ * @brief Останавливает такты симуляции.
+ */
+void SimulationDriver::stop() {
+    timer.stop();
+}
+
+/**
+ * @brief Выполняет такт на реальное время, прошедшее с прошлого такта, умноженное на ускорение.
+ */
+void SimulationDriver::tick() {
+    const double elapsed = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    advance(elapsed * speed);
+}
+
+/**
+ * @brief Выполняет такт на заданное модельное время.
+ * @param seconds Модельное время, с.
+ */
+void SimulationDriver::advance(double seconds) {
+    syncFleet();
+    if (sim.advance(seconds) == 0) {
+        return;
+    }
+
+    const int count = sim.size();
+    const UnitConversion::Affine toModel = UnitConversion::temperature(kCelsius, static_cast<int>(model->temperatureUnit()));
+    converted.resize(count);
+    std::copy(sim.temperatureData(), sim.temperatureData() + count, converted.begin());
+    UnitConversion::apply(toModel, converted.data(), count);
+
+    model->acceptFleetReadings(converted.constData(), sim.humidityData(), count);
+    const int current = model->currentUnit();
+    model->acceptReading(converted[current], sim.humidity(current), model->pressure());
+}
+
+/**
+ * @brief Согласует количество комнат с парком и передаёт симулятору управление блоков.
+ *
+ * Новые комнаты начинают с показаний своих блоков. Мощность текущего блока берётся
+ * из последнего опубликованного состояния регулятора без ожидания его потока.
+ */
+void SimulationDriver::syncFleet() {
+    const FleetStore &fleet = model->fleet();
+    const UnitConversion::Affine toCelsius = UnitConversion::temperature(static_cast<int>(model->temperatureUnit()), kCelsius);
+
+    const int old = sim.size();
+    if (old != fleet.size()) {
+        sim.resize(fleet.size(), 0.0, 0.0);
+        for (int room = old; room < fleet.size(); ++room) {
+            sim.setState(room, UnitConversion::apply(toCelsius, fleet.temperature(room)), fleet.humidity(room));
+        }
+    }
+
+    const double *setpoints = fleet.setpointData();
+    for (int room = 0; room < fleet.size(); ++room) {
+        sim.setControl(room, fleet.isOn(room), UnitConversion::apply(toCelsius, setpoints[room]),
+                       fleet.hGateDir(room), fleet.vGateDir(room));
+    }
+
+    const ClimateController *controller = model->controller();
+    if (controller->isRunning()) {
+        const int current = model->currentUnit();
+        sim.setControl(current, fleet.isOn(current), UnitConversion::apply(toCelsius, setpoints[current]),
+                       fleet.hGateDir(current), fleet.vGateDir(current), controller->state().output);
+    }
+}
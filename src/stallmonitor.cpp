@@ -0,0 +1,166 @@
+#include "../includes/stallmonitor.h"
+#include <QDebug>
+#include <chrono>
+
+/**
+ * @file stallmonitor.cpp
+ * @brief Реализация обнаружения зависаний цикла событий.
+ *
+ * Этот файл содержит реализацию пульса цикла событий и потока-сторожа.
+ */
+
+namespace {
+
+const char *const kLagProbe = "event loop lag"; ///< Название гистограммы опозданий пульса
+const char *const kIdle = "(outside traced handlers)"; ///< Название интервала зависания вне отмеченных обработчиков
+
+/**
+ * @brief Переводит строку области трассировки в QString (nullptr — пустая строка).
+ * @param text Строка области.
+ */
+QString scopeText(const char *text) {
+    return text ? QString::fromUtf8(text) : QString();
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса StallMonitor.
+ * @param parent Родительский объект.
+ */
+StallMonitor::StallMonitor(QObject *parent)
+    : QObject(parent)
+    , lag(LatencyProbes::histogram(kLagProbe))
+{
+    heartbeat.setTimerType(Qt::PreciseTimer);
+    connect(&heartbeat, &QTimer::timeout, this, &StallMonitor::beat);
+}
+
+/**
+ * @brief Деструктор класса StallMonitor.
+ */
+StallMonitor::~StallMonitor() {
+    stop();
+}
+
+/**
+ * @brief Запускает сторож для цикла событий текущего потока.
+ * @param threshold Порог зависания, мс.
+ */
+void StallMonitor::start(int threshold) {
+    stop();
+    thresholdMs = qMax(2 * kMinPeriodMs, threshold);
+    periodMs = qMax(kMinPeriodMs, thresholdMs / 4);
+    monitored = EventTrace::currentBuffer();
+    EventTrace::setTracking(true);
+    periodTicks.store(0, std::memory_order_relaxed);
+    previousBeat = EventTrace::now();
+    lastBeat.store(previousBeat, std::memory_order_release);
+    stopping = false;
+    thread = std::thread(&StallMonitor::run, this);
+    heartbeat.start(periodMs);
+}
+
+/**
+ * @brief Останавливает сторож.
+ */
+void StallMonitor::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    heartbeat.stop();
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopSignal.notify_all();
+    thread.join();
+    EventTrace::setTracking(false);
+}
+
+/**
+ * @brief Задаёт файл, в который после каждого зависания выгружается трассировка.
+ * @param path Путь к файлу (пусто — не выгружать).
+ */
+void StallMonitor::setCapturePath(const QString &path) {
+    capturePath = path;
+    if (!path.isEmpty()) {
+        EventTrace::setRecording(true);
+    }
+}
+
+/**
+ * @brief Отмечает пульс и добавляет опоздание таймера в гистограмму.
+ */
+void StallMonitor::beat() {
+    const quint64 now = EventTrace::now();
+    const quint64 period = periodTicks.load(std::memory_order_relaxed);
+    if (period != 0 && now > previousBeat + period) {
+        lag->record(now - previousBeat - period);
+    }
+    previousBeat = now;
+    lastBeat.store(now, std::memory_order_release);
+}
+
+/**
+ * @brief Тело потока-сторожа.
+ *
+ * Зависание начинается с последнего пульса перед ним и заканчивается первым пульсом после.
+ * Активность наблюдаемого потока читается в момент обнаружения, пока обработчик ещё выполняется.
+ */
+void StallMonitor::run() {
+    EventTrace::setThreadName("stall monitor");
+    const double nsPerTick = LatencyClock::nanosecondsPerTick();
+    const quint64 thresholdTicks = static_cast<quint64>(thresholdMs * 1e6 / nsPerTick);
+    periodTicks.store(static_cast<quint64>(periodMs * 1e6 / nsPerTick), std::memory_order_relaxed);
+
+    bool stalled = false;
+    quint64 stallStart = 0;
+    EventTrace::Activity captured;
+    quint64 capturedAt = 0;
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopSignal.wait_for(lock, std::chrono::milliseconds(periodMs), [this]() { return stopping; })) {
+        const quint64 beatTicks = lastBeat.load(std::memory_order_acquire);
+        const quint64 now = EventTrace::now();
+        if (!stalled) {
+            if (now > beatTicks && now - beatTicks > thresholdTicks) {
+                stalled = true;
+                stallStart = beatTicks;
+                captured = EventTrace::activity(monitored);
+                capturedAt = now;
+            }
+            continue;
+        }
+        if (beatTicks == stallStart) {
+            continue;
+        }
+        stalled = false;
+        const char *name = captured.scope ? captured.scope : kIdle;
+        EventTrace::record("stall", name, captured.event, stallStart, beatTicks);
+
+        StallRecord stall;
+        stall.durationMs = (beatTicks - stallStart) * nsPerTick / 1e6;
+        stall.event = scopeText(captured.event);
+        stall.receiver = scopeText(captured.receiver);
+        stall.scope = scopeText(captured.scope);
+        stall.eventElapsedMs = captured.event && capturedAt > captured.startTicks
+                                   ? (capturedAt - captured.startTicks) * nsPerTick / 1e6 : 0.0;
+        QMetaObject::invokeMethod(this, [this, stall]() { report(stall); }, Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Сохраняет зависание, сообщает о нём и выгружает трассировку (в наблюдаемом потоке).
+ * @param stall Зависание.
+ */
+void StallMonitor::report(const StallRecord &stall) {
+    ++detected;
+    if (records.size() >= kMaxRecords) {
+        records.removeFirst();
+    }
+    records.append(stall);
+    emit stallDetected(stall);
+    if (!capturePath.isEmpty() && !EventTrace::exportChrome(capturePath)) {
+        qWarning() << "Не удалось записать трассировку зависания в" << capturePath;
+    }
+}
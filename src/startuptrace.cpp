@@ -0,0 +1,91 @@
+#include "../includes/startuptrace.h"
+#include <QElapsedTimer>
+#include <cstring>
+
+/**
+ * @file startuptrace.cpp
+ * @brief Реализация класса StartupTrace.
+ *
+ * Этот файл содержит реализацию отметок этапов запуска и их отчёта.
+ */
+
+namespace {
+
+/**
+ * @brief Возвращает часы отсчёта от начала main().
+ */
+QElapsedTimer &startClock() {
+    static QElapsedTimer clock;
+    return clock;
+}
+
+/**
+ * @brief Возвращает список отмеченных этапов.
+ */
+QVector<StartupTrace::Phase> &phaseList() {
+    static QVector<StartupTrace::Phase> list;
+    return list;
+}
+
+} // namespace
+
+/**
+ * @brief Начинает отсчёт.
+ */
+void StartupTrace::start() {
+    phaseList().clear();
+    phaseList().reserve(16);
+    startClock().start();
+}
+
+/**
+ * @brief Отмечает окончание этапа. До вызова start() отсчёт начинается с первой отметки.
+ * @param name Название этапа.
+ */
+void StartupTrace::mark(const char *name) {
+    if (!startClock().isValid()) {
+        startClock().start();
+    }
+    phaseList().append(Phase{ name, startClock().nsecsElapsed() });
+}
+
+/**
+ * @brief Возвращает время от начала отсчёта, нс.
+ */
+qint64 StartupTrace::elapsedNs() {
+    return startClock().isValid() ? startClock().nsecsElapsed() : 0;
+}
+
+/**
+ * @brief Возвращает отмеченные этапы.
+ */
+const QVector<StartupTrace::Phase> &StartupTrace::phases() {
+    return phaseList();
+}
+
+/**
+ * @brief Возвращает время окончания этапа.
+ * @param name Название этапа.
+ */
+qint64 StartupTrace::phaseEndNs(const char *name) {
+    for (const Phase &phase : phaseList()) {
+        if (std::strcmp(phase.name, name) == 0) {
+            return phase.endNs;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Возвращает отчёт по этапам.
+ */
+QString StartupTrace::report() {
+    QString text;
+    qint64 previous = 0;
+    for (const Phase &phase : phaseList()) {
+        text += QString::asprintf("startup %-24s +%8.2f ms  at %8.2f ms\n", phase.name,
+                                  (phase.endNs - previous) / 1e6, phase.endNs / 1e6);
+        previous = phase.endNs;
+    }
+    return text;
+}
@@ -0,0 +1,312 @@
+#include "../includes/statebus.h"
+#include "../includes/climatemodel.h"
+#include <QTimer>
+#include <limits>
+
+/**
+ * @file statebus.cpp
+ * @brief Реализация шины изменений состояния.
+ *
+ * Этот файл содержит объединение изменений, их запись строкой и раздачу подписчикам
+ * с окнами объединения.
+ */
+
+/**
+ * @brief Переносит из другого изменения значения выбранных полей и добавляет их биты.
+ * @param other Более новое изменение.
+ * @param mask Биты переносимых полей.
+ */
+void StateDelta::merge(const StateDelta &other, quint32 mask) {
+    mask &= other.fields;
+    if (mask & ClimateModel::TemperatureChanged) {
+        temperature = other.temperature;
+    }
+    if (mask & ClimateModel::HumidityChanged) {
+        humidity = other.humidity;
+    }
+    if (mask & ClimateModel::PressureChanged) {
+        pressure = other.pressure;
+    }
+    if (mask & ClimateModel::HGateChanged) {
+        hGate = other.hGate;
+    }
+    if (mask & ClimateModel::VGateChanged) {
+        vGate = other.vGate;
+    }
+    if (mask & ClimateModel::PowerChanged) {
+        power = other.power;
+    }
+    if (mask & ClimateModel::UnitsChanged) {
+        temperatureUnit = other.temperatureUnit;
+        pressureUnit = other.pressureUnit;
+    }
+    if (mask & ClimateModel::ThemeChanged) {
+        theme = other.theme;
+    }
+    if (mask & ClimateModel::CurrentUnitChanged) {
+        unit = other.unit;
+        fleetSize = other.fleetSize;
+    }
+    if (mask & ClimateModel::SetpointChanged) {
+        setpoint = other.setpoint;
+    }
+    if (mask & ClimateModel::FanSpeedChanged) {
+        fanSpeed = other.fanSpeed;
+    }
+    fields |= mask;
+    sequence = other.sequence;
+}
+
+/**
+ * @brief Возвращает изменение в виде короткой строки.
+ */
+QString StateDelta::toString() const {
+    QString text = QString("#%1").arg(sequence);
+    if (fields & ClimateModel::CurrentUnitChanged) {
+        text += QString(" unit=%1/%2").arg(unit).arg(fleetSize);
+    }
+    if (fields & ClimateModel::TemperatureChanged) {
+        text += QString(" temperature=%1").arg(temperature, 0, 'f', 1);
+    }
+    if (fields & ClimateModel::HumidityChanged) {
+        text += QString(" humidity=%1").arg(humidity, 0, 'f', 1);
+    }
+    if (fields & ClimateModel::PressureChanged) {
+        text += QString(" pressure=%1").arg(pressure, 0, 'f', 1);
+    }
+    if (fields & ClimateModel::SetpointChanged) {
+        text += QString(" setpoint=%1").arg(setpoint, 0, 'f', 1);
+    }
+    if (fields & ClimateModel::PowerChanged) {
+        text += QString(" power=%1").arg(power);
+    }
+    if (fields & ClimateModel::HGateChanged) {
+        text += QString(" h=%1").arg(hGate);
+    }
+    if (fields & ClimateModel::VGateChanged) {
+        text += QString(" v=%1").arg(vGate);
+    }
+    if (fields & ClimateModel::UnitsChanged) {
+        text += QString(" units=%1,%2")
+                    .arg(ClimateModel::temperatureScale(static_cast<ClimateModel::TemperatureUnit>(temperatureUnit)),
+                         ClimateModel::pressureScale(static_cast<ClimateModel::PressureUnit>(pressureUnit)));
+    }
+    if (fields & ClimateModel::FanSpeedChanged) {
+        text += QString(" fan=%1").arg(fanSpeed);
+    }
+    if (fields & ClimateModel::ThemeChanged) {
+        text += QString(" theme=%1").arg(theme);
+    }
+    if (fields & ClimateModel::HistoryChanged) {
+        text += " history";
+    }
+    return text;
+}
+
+/**
+ * @brief Конструктор класса StateBus.
+ * @param parent Родительский объект.
+ */
+StateBus::StateBus(QObject *parent)
+    : QObject(parent)
+{
+    windowTimer = new QTimer(this);
+    windowTimer->setSingleShot(true);
+    windowTimer->setTimerType(Qt::PreciseTimer);
+    connect(windowTimer, &QTimer::timeout, this, [=]() {
+        scheduledAt = -1;
+        deliverDue(false);
+    });
+    clock.start();
+}
+
+/**
+ * @brief Подписывает обработчик на изменения выбранных полей.
+ *
+ * Подписка, сделанная во время раздачи, начинает получать изменения со следующего.
+ * @param fields Биты нужных полей.
+ * @param context Объект, при удалении которого подписка снимается.
+ * @param handler Обработчик.
+ * @param windowMs Окно объединения, мс.
+ * @return Номер подписки.
+ */
+int StateBus::subscribe(quint32 fields, QObject *context, Handler handler, int windowMs) {
+    Subscriber subscriber;
+    subscriber.id = nextId++;
+    subscriber.fields = fields;
+    subscriber.handler = std::move(handler);
+    subscriber.windowMs = qMax(0, windowMs);
+    const int id = subscriber.id;
+    if (dispatching != 0) {
+        joining.append(std::move(subscriber));
+    } else {
+        masks.append(fields);
+        subscribers.append(std::move(subscriber));
+    }
+    ++active;
+    if (context != nullptr) {
+        connect(context, &QObject::destroyed, this, [=]() { unsubscribe(id); });
+    }
+    return id;
+}
+
+/**
+ * @brief Снимает подписку.
+ *
+ * Во время раздачи подписка только помечается снятой: её обработчик может выполняться
+ * прямо сейчас, поэтому удаляется из массивов после раздачи.
+ * @param id Номер подписки.
+ */
+void StateBus::unsubscribe(int id) {
+    for (int i = 0; i < joining.size(); ++i) {
+        if (joining[i].id == id) {
+            joining.remove(i);
+            --active;
+            return;
+        }
+    }
+    for (int i = 0; i < subscribers.size(); ++i) {
+        if (subscribers[i].id == id) {
+            subscribers[i].id = 0;
+            masks[i] = 0;
+            removed = true;
+            --active;
+            if (dispatching == 0) {
+                compact();
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Возвращает объединение полей всех подписок.
+ */
+quint32 StateBus::subscribedFields() const {
+    quint32 fields = 0;
+    for (quint32 mask : masks) {
+        fields |= mask;
+    }
+    for (const Subscriber &subscriber : joining) {
+        fields |= subscriber.fields;
+    }
+    return fields;
+}
+
+/**
+ * @brief Раздаёт изменение подписчикам.
+ *
+ * Подписчик без окна получает копию изменения с маской, урезанной до его полей;
+ * подписчику с окном изменение добавляется к объединённому, а первое изменение окна
+ * заводит таймер доставки.
+ * @param delta Изменение.
+ */
+void StateBus::publish(const StateDelta &delta) {
+    StateDelta numbered = delta;
+    numbered.sequence = ++sequence;
+    ++dispatching;
+    const int count = masks.size();
+    qint64 now = -1;
+    for (int i = 0; i < count; ++i) {
+        const quint32 mask = masks[i] & numbered.fields;
+        if (mask == 0) {
+            continue;
+        }
+        Subscriber &subscriber = subscribers[i];
+        if (subscriber.windowMs == 0) {
+            StateDelta view = numbered;
+            view.fields = mask;
+            ++delivered;
+            subscriber.handler(view);
+            continue;
+        }
+        if (subscriber.pending.fields == 0) {
+            if (now < 0) {
+                now = clock.elapsed();
+            }
+            subscriber.deadline = now + subscriber.windowMs;
+            schedule(subscriber.deadline);
+        }
+        subscriber.pending.merge(numbered, mask);
+    }
+    if (--dispatching == 0 && (removed || !joining.isEmpty())) {
+        compact();
+    }
+}
+
+/**
+ * @brief Немедленно доставляет все объединённые изменения.
+ */
+void StateBus::flush() {
+    deliverDue(true);
+}
+
+/**
+ * @brief Доставляет объединённые изменения, окна которых истекли, и заводит таймер на следующее.
+ * @param all Доставить все объединённые изменения независимо от окон.
+ */
+void StateBus::deliverDue(bool all) {
+    ++dispatching;
+    const qint64 now = clock.elapsed();
+    qint64 next = std::numeric_limits<qint64>::max();
+    const int count = masks.size();
+    for (int i = 0; i < count; ++i) {
+        Subscriber &subscriber = subscribers[i];
+        if (masks[i] == 0 || subscriber.pending.fields == 0) {
+            continue;
+        }
+        if (!all && subscriber.deadline > now) {
+            next = qMin(next, subscriber.deadline);
+            continue;
+        }
+        const StateDelta merged = subscriber.pending;
+        subscriber.pending.fields = 0;
+        ++delivered;
+        subscriber.handler(merged);
+    }
+    if (--dispatching == 0 && (removed || !joining.isEmpty())) {
+        compact();
+    }
+    if (next != std::numeric_limits<qint64>::max()) {
+        schedule(next);
+    }
+}
+
+/**
+ * @brief Заводит таймер окон на срок, если он раньше уже заведённого.
+ * @param deadline Срок по clock, мс.
+ */
+void StateBus::schedule(qint64 deadline) {
+    if (scheduledAt >= 0 && scheduledAt <= deadline) {
+        return;
+    }
+    scheduledAt = deadline;
+    windowTimer->start(static_cast<int>(qMax<qint64>(0, deadline - clock.elapsed())));
+}
+
+/**
+ * @brief Удаляет снятые подписки и добавляет сделанные во время раздачи.
+ */
+void StateBus::compact() {
+    if (removed) {
+        int kept = 0;
+        for (int i = 0; i < subscribers.size(); ++i) {
+            if (subscribers[i].id == 0) {
+                continue;
+            }
+            if (kept != i) {
+                subscribers[kept] = std::move(subscribers[i]);
+                masks[kept] = masks[i];
+            }
+            ++kept;
+        }
+        subscribers.resize(kept);
+        masks.resize(kept);
+        removed = false;
+    }
+    for (Subscriber &subscriber : joining) {
+        masks.append(subscriber.fields);
+        subscribers.append(std::move(subscriber));
+    }
+    joining.clear();
+}
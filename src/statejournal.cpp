@@ -0,0 +1,323 @@
+#include "../includes/statejournal.h"
+#include <cstddef>
+#include <cstring>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+/**
+ * @file statejournal.cpp
+ * @brief Реализация журнала изменений состояния.
+ *
+ * Этот файл содержит реализацию группового коммита, восстановления и усечения журнала.
+ */
+
+namespace {
+
+const qint64 kRecordSize = sizeof(JournalRecord); ///< Размер записи журнала в байтах
+const int kChecksumWords = offsetof(JournalRecord, checksum) / sizeof(quint64); ///< Слова, покрытые контрольной суммой
+
+static_assert(sizeof(JournalRecord) == 48, "JournalRecord must stay 48 bytes");
+static_assert(offsetof(JournalRecord, checksum) % sizeof(quint64) == 0, "checksum must follow whole words");
+
+} // namespace
+
+/**
+ * @brief Конструктор класса StateJournal.
+ * @param parent Родительский объект.
+ */
+StateJournal::StateJournal(QObject *parent)
+    : QObject(parent)
+{
+    commitTimer.setSingleShot(true);
+    connect(&commitTimer, &QTimer::timeout, this, &StateJournal::commit);
+    connect(&compactTimer, &QTimer::timeout, this, [this]() {
+        // Плановое уплотнение: восстановление всегда начинается со свежего снимка
+        commit();
+        if (fileBytes > 0 && !compactionSignalled) {
+            compactionSignalled = true;
+            emit compactionRequested();
+        }
+    });
+    pending.reserve(opts.maxBatchRecords * kRecordSize);
+}
+
+/**
+ * @brief Деструктор. Записывает накопленные записи и закрывает файл.
+ */
+StateJournal::~StateJournal() {
+    close();
+}
+
+/**
+ * @brief Задаёт параметры группового коммита и уплотнения.
+ * @param options Параметры.
+ */
+void StateJournal::setOptions(const JournalOptions &options) {
+    commit();
+    opts = options;
+    if (opts.maxBatchRecords < 1) {
+        opts.maxBatchRecords = 1;
+    }
+    pending.reserve(opts.maxBatchRecords * kRecordSize);
+    if (compactTimer.isActive()) {
+        compactTimer.start(opts.compactIntervalMs);
+    }
+}
+
+/**
+ * @brief Открывает журнал и восстанавливает записи, не учтённые в снимке.
+ *
+ * Файл отображается в память и просматривается один раз: проверяются контрольная сумма
+ * и возрастание номеров. Первая неверная запись считается оборванной при сбое,
+ * и файл усекается до неё.
+ * @param path Путь к файлу журнала.
+ * @param snapshotSequence Номер последней записи, учтённой в снимке.
+ * @param handler Обработчик восстановленных записей (может быть пустым).
+ * @return true, если файл журнала открыт для записи.
+ */
+bool StateJournal::open(const QString &path, quint64 snapshotSequence, const ReplayHandler &handler) {
+    close();
+    replayed = 0;
+    nextSequence = snapshotSequence + 1;
+    fileBytes = 0;
+    compactionSignalled = false;
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    qint64 count = size / kRecordSize;
+    qint64 valid = 0;
+    if (count > 0) {
+        QByteArray fallback; // Чтение целиком, если отображение в память недоступно
+        const uchar *data = file.map(0, count * kRecordSize);
+        if (!data) {
+            fallback = file.read(count * kRecordSize);
+            data = reinterpret_cast<const uchar *>(fallback.constData());
+            count = fallback.size() / kRecordSize;
+        }
+
+        quint64 previous = 0;
+        JournalRecord record;
+        for (qint64 i = 0; i < count; ++i) {
+            memcpy(&record, data + i * kRecordSize, kRecordSize);
+            if (record.checksum != recordChecksum(record) || record.sequence <= previous) {
+                break;
+            }
+            previous = record.sequence;
+            if (record.sequence > snapshotSequence) {
+                if (handler) {
+                    handler(record);
+                }
+                ++replayed;
+            }
+            valid += kRecordSize;
+        }
+
+        if (fallback.isNull()) {
+            file.unmap(const_cast<uchar *>(data));
+        }
+        if (previous >= nextSequence) {
+            nextSequence = previous + 1;
+        }
+    }
+
+    if (valid != size) {
+        file.resize(valid); // Отрезается оборванный хвост
+    }
+    file.seek(valid);
+    fileBytes = valid;
+    commitsSinceSync = 0;
+
+    if (opts.compactIntervalMs > 0) {
+        compactTimer.start(opts.compactIntervalMs);
+    }
+    checkCompaction();
+    return true;
+}
+
+/**
+ * @brief Записывает накопленные записи и закрывает файл.
+ */
+void StateJournal::close() {
+    compactTimer.stop();
+    if (!file.isOpen()) {
+        pending.resize(0);
+        return;
+    }
+    commit();
+    if (commitsSinceSync > 0) {
+        sync();
+    }
+    file.close();
+}
+
+/**
+ * @brief Добавляет запись в журнал.
+ * @param type Тип записи.
+ * @param unit Номер блока.
+ * @param a Первое значение.
+ * @param b Второе значение.
+ * @param c Третье значение.
+ * @return Номер записи.
+ */
+quint64 StateJournal::append(RecordType type, quint32 unit, double a, double b, double c) {
+    JournalRecord record;
+    record.sequence = nextSequence++;
+    record.unit = unit;
+    record.type = type;
+    record.reserved = 0;
+    record.values[0] = a;
+    record.values[1] = b;
+    record.values[2] = c;
+    record.checksum = recordChecksum(record);
+    record.padding = 0;
+
+    pending.append(reinterpret_cast<const char *>(&record), kRecordSize);
+    if (pending.size() >= opts.maxBatchRecords * kRecordSize) {
+        commit();
+    } else if (type != Reading && !pendingChanges) {
+        // Изменение не ждёт окна измерений, накопленного до него
+        pendingChanges = true;
+        if (!commitTimer.isActive() || commitTimer.remainingTime() > opts.groupCommitMs) {
+            commitTimer.start(opts.groupCommitMs);
+        }
+    } else if (!commitTimer.isActive()) {
+        commitTimer.start(pendingChanges ? opts.groupCommitMs : opts.readingCommitMs);
+    }
+    return record.sequence;
+}
+
+/**
+ * @brief Записывает накопленные записи одной операцией.
+ *
+ * При ошибке записи файл усекается до последней целой группы, а группа отбрасывается.
+ * @return true, если запись прошла успешно.
+ */
+bool StateJournal::commit() {
+    commitTimer.stop();
+    pendingChanges = false;
+    if (pending.isEmpty()) {
+        return true;
+    }
+    if (!file.isOpen()) {
+        pending.resize(0);
+        return false;
+    }
+
+    const qint64 written = file.write(pending);
+    if (written != pending.size()) {
+        emit journalError(file.errorString());
+        file.resize(fileBytes);
+        file.seek(fileBytes);
+        pending.resize(0);
+        return false;
+    }
+    fileBytes += written;
+    pending.resize(0);
+    ++commits;
+
+    if (opts.syncEveryCommits > 0 && ++commitsSinceSync >= opts.syncEveryCommits) {
+        sync();
+    }
+    checkCompaction();
+    return true;
+}
+
+/**
+ * @brief Принудительно синхронизирует файл журнала с диском.
+ * @return true, если синхронизация прошла успешно.
+ */
+bool StateJournal::sync() {
+    if (!file.isOpen()) {
+        return false;
+    }
+#if defined(Q_OS_WIN)
+    const bool ok = _commit(file.handle()) == 0;
+#elif defined(Q_OS_UNIX)
+    const bool ok = ::fsync(file.handle()) == 0;
+#else
+    const bool ok = file.flush();
+#endif
+    commitsSinceSync = 0;
+    ++syncs;
+    if (!ok) {
+        emit journalError(QStringLiteral("fsync failed"));
+    }
+    return ok;
+}
+
+/**
+ * @brief Очищает журнал после записи снимка.
+ *
+ * Ожидающие записи отбрасываются: они уже учтены в снимке.
+ * @return true, если файл усечён.
+ */
+bool StateJournal::truncate() {
+    commitTimer.stop();
+    pendingChanges = false;
+    pending.resize(0);
+    compactionSignalled = false;
+    if (!file.isOpen()) {
+        return false;
+    }
+    if (!file.resize(0)) {
+        emit journalError(file.errorString());
+        return false;
+    }
+    file.seek(0);
+    fileBytes = 0;
+    return sync();
+}
+
+/**
+ * @brief Сообщает размер последнего записанного снимка для порога уплотнения.
+ * @param bytes Размер снимка в байтах.
+ */
+void StateJournal::setSnapshotSize(qint64 bytes) {
+    snapshotBytes = bytes;
+}
+
+/**
+ * @brief Выдаёт сигнал уплотнения, если журнал превысил порог.
+ *
+ * Порог пропорционален размеру снимка, поэтому перезапись снимка обходится
+ * не дороже 1 / compactSnapshotRatio байта на байт журнала.
+ */
+void StateJournal::checkCompaction() {
+    if (compactionSignalled || fileBytes == 0) {
+        return;
+    }
+    const qint64 threshold = qMax(opts.compactMinBytes, qint64(snapshotBytes * opts.compactSnapshotRatio));
+    if (fileBytes >= threshold) {
+        compactionSignalled = true;
+        emit compactionRequested();
+    }
+}
+
+/**
+ * @brief Вычисляет контрольную сумму записи.
+ *
+ * Хеш FNV-1a по 64-битным словам с перемешиванием старших бит: он дешевле побайтового
+ * CRC и не замедляет восстановление длинного журнала.
+ * @param record Запись.
+ * @return Контрольная сумма.
+ */
+quint32 StateJournal::recordChecksum(const JournalRecord &record) {
+    quint64 words[kChecksumWords];
+    memcpy(words, &record, sizeof(words));
+
+    quint64 hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < kChecksumWords; ++i) {
+        hash ^= words[i];
+        hash *= 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    return static_cast<quint32>(hash ^ (hash >> 32));
+}
@@ -0,0 +1,504 @@
+#include "../includes/statesnapshot.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDomDocument>
+#include <QDomElement>
+#include <cstring>
+
+/**
+ * @file statesnapshot.cpp
+ * @brief Реализация двоичного снимка состояния.
+ *
+ * Этот файл содержит реализацию записи, чтения и импорта снимка состояния приложения.
+ */
+
+namespace {
+
+const char kMagic[8] = { 'A', 'C', 'M', 'S', 'N', 'A', 'P', '\0' }; ///< Сигнатура файла снимка
+const quint32 kByteOrderMark = 0x01020304; ///< Метка порядка байт
+const quint32 kMaxSections = 64; ///< Предельное количество секций
+
+/**
+ * @brief Заголовок файла снимка.
+ */
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 sectionCount;
+    quint32 reserved;
+    quint64 fileSize;
+};
+
+/**
+ * @brief Запись каталога секций.
+ */
+struct SectionEntry
+{
+    quint32 id;
+    quint32 reserved;
+    quint64 offset;
+    quint64 size;
+};
+
+/**
+ * @brief Секция скалярных настроек.
+ */
+struct SettingsRecord
+{
+    double temperature;
+    double humidity;
+    double pressure;
+    qint32 temperatureUnit;
+    qint32 pressureUnit;
+    qint32 theme;
+    qint32 currentUnit;
+};
+
+/**
+ * @brief Заголовок блока в секции архива; за ним следует поток бит, выровненный по 8 байт.
+ */
+struct ArchiveBlockRecord
+{
+    qint64 firstTimestampUs;
+    qint64 lastTimestampUs;
+    qint64 count;
+    quint64 bytes;
+};
+
+const quint64 kFleetBytesPerUnit = 3 * sizeof(double) + 2 * sizeof(qint8) + sizeof(quint8);
+const quint64 kHistoryBytesPerSample = sizeof(qint64) + 3 * sizeof(double);
+const quint64 kScheduleHeaderBytes = 2 * sizeof(quint64); ///< Заголовок секции расписания: количество записей и замен
+const quint64 kArchiveBlockHeaderBits = 4 * 64; ///< Первое измерение блока: метка и три значения целиком
+
+inline quint64 align8(quint64 value) {
+    return (value + 7) & ~quint64(7);
+}
+
+/**
+ * @brief Находит секцию в каталоге.
+ * @return Указатель на запись каталога или nullptr.
+ */
+const SectionEntry *findSection(const SectionEntry *entries, quint32 count, quint32 id) {
+    for (quint32 i = 0; i < count; ++i) {
+        if (entries[i].id == id) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Возвращает идентификатор единицы температуры по обозначению из XML.
+ */
+qint32 temperatureUnitByScale(const QString &scale) {
+    if (scale == "F") {
+        return 2;
+    } else if (scale == "K") {
+        return 3;
+    }
+    return 1;
+}
+
+/**
+ * @brief Возвращает идентификатор единицы давления по обозначению из XML.
+ */
+qint32 pressureUnitByScale(const QString &scale) {
+    return scale == "mm.h.g." ? 2 : 1;
+}
+
+} // namespace
+
+/**
+ * @brief Записывает снимок атомарно.
+ *
+ * Весь файл собирается в одном буфере и записывается одной операцией через QSaveFile,
+ * который пишет во временный файл и переименовывает его при commit().
+ * @param path Путь к файлу снимка.
+ * @param settings Скалярные настройки.
+ * @param fleet Состояние парка.
+ * @param history История измерений.
+ * @param schedule Расписание (nullptr — пустое).
+ * @param archive Сжатый архив измерений (nullptr — пустой).
+ * @return true, если снимок записан.
+ */
+bool StateSnapshot::write(const QString &path, const SnapshotSettings &settings,
+                          const FleetStore &fleet, const SampleHistory &history,
+                          const ScheduleData *schedule, const HistoryArchive *archive) {
+    const quint64 units = static_cast<quint64>(fleet.size());
+    const quint64 samples = static_cast<quint64>(history.size());
+    const quint64 scheduleEntries = schedule ? static_cast<quint64>(schedule->entries.size()) : 0;
+    const quint64 holidays = schedule ? static_cast<quint64>(schedule->holidays.size()) : 0;
+    const quint64 archiveBlocks = archive ? static_cast<quint64>(archive->blockCount()) : 0;
+    quint64 archiveBytes = sizeof(quint64);
+    for (quint64 i = 0; i < archiveBlocks; ++i) {
+        archiveBytes += sizeof(ArchiveBlockRecord) + align8(static_cast<quint64>(archive->block(static_cast<int>(i)).bits.size()));
+    }
+
+    SectionEntry entries[8] = {
+        { SettingsSection, 0, 0, sizeof(SettingsRecord) },
+        { FleetSection, 0, 0, sizeof(quint64) + units * kFleetBytesPerUnit },
+        { HistorySection, 0, 0, sizeof(quint64) + samples * kHistoryBytesPerSample },
+        { JournalSection, 0, 0, sizeof(quint64) },
+        { SetpointSection, 0, 0, sizeof(quint64) + units * sizeof(double) },
+        { FanSection, 0, 0, sizeof(qint32) },
+        { ScheduleSection, 0, 0, kScheduleHeaderBytes + scheduleEntries * sizeof(ScheduleEntry)
+                                     + holidays * sizeof(HolidayOverride) },
+        { ArchiveSection, 0, 0, archiveBytes }
+    };
+    const quint32 sectionCount = sizeof(entries) / sizeof(entries[0]);
+
+    quint64 offset = align8(sizeof(FileHeader) + sizeof(entries));
+    for (SectionEntry &entry : entries) {
+        entry.offset = offset;
+        offset = align8(offset + entry.size);
+    }
+
+    QByteArray buffer(static_cast<int>(offset), '\0');
+    char *base = buffer.data();
+
+    FileHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.sectionCount = sectionCount;
+    header.reserved = 0;
+    header.fileSize = offset;
+    memcpy(base, &header, sizeof(header));
+    memcpy(base + sizeof(header), entries, sizeof(entries));
+
+    SettingsRecord record;
+    record.temperature = settings.temperature;
+    record.humidity = settings.humidity;
+    record.pressure = settings.pressure;
+    record.temperatureUnit = settings.temperatureUnit;
+    record.pressureUnit = settings.pressureUnit;
+    record.theme = settings.theme;
+    record.currentUnit = settings.currentUnit;
+    memcpy(base + entries[0].offset, &record, sizeof(record));
+
+    char *p = base + entries[1].offset;
+    memcpy(p, &units, sizeof(units));
+    p += sizeof(units);
+    memcpy(p, fleet.temperatureData(), units * sizeof(double));
+    p += units * sizeof(double);
+    memcpy(p, fleet.humidityData(), units * sizeof(double));
+    p += units * sizeof(double);
+    memcpy(p, fleet.pressureData(), units * sizeof(double));
+    p += units * sizeof(double);
+    memcpy(p, fleet.hGateDirData(), units * sizeof(qint8));
+    p += units * sizeof(qint8);
+    memcpy(p, fleet.vGateDirData(), units * sizeof(qint8));
+    p += units * sizeof(qint8);
+    memcpy(p, fleet.flagsData(), units * sizeof(quint8));
+
+    p = base + entries[2].offset;
+    memcpy(p, &samples, sizeof(samples));
+    p += sizeof(samples);
+    char *timestamps = p;
+    char *channels[SampleHistory::ChannelCount];
+    for (int channel = 0; channel < SampleHistory::ChannelCount; ++channel) {
+        channels[channel] = p + samples * sizeof(qint64) + channel * samples * sizeof(double);
+    }
+    for (int i = 0; i < history.size(); ++i) {
+        qint64 ts = history.timestampAt(i);
+        memcpy(timestamps + i * sizeof(qint64), &ts, sizeof(ts));
+        for (int channel = 0; channel < SampleHistory::ChannelCount; ++channel) {
+            double value = history.valueAt(static_cast<SampleHistory::Channel>(channel), i);
+            memcpy(channels[channel] + i * sizeof(double), &value, sizeof(value));
+        }
+    }
+
+    memcpy(base + entries[3].offset, &settings.journalSequence, sizeof(quint64));
+
+    p = base + entries[4].offset;
+    memcpy(p, &units, sizeof(units));
+    memcpy(p + sizeof(units), fleet.setpointData(), units * sizeof(double));
+
+    memcpy(base + entries[5].offset, &settings.fanSpeed, sizeof(qint32));
+
+    p = base + entries[6].offset;
+    memcpy(p, &scheduleEntries, sizeof(scheduleEntries));
+    memcpy(p + sizeof(quint64), &holidays, sizeof(holidays));
+    p += kScheduleHeaderBytes;
+    if (scheduleEntries != 0) {
+        memcpy(p, schedule->entries.constData(), scheduleEntries * sizeof(ScheduleEntry));
+        p += scheduleEntries * sizeof(ScheduleEntry);
+    }
+    if (holidays != 0) {
+        memcpy(p, schedule->holidays.constData(), holidays * sizeof(HolidayOverride));
+    }
+
+    p = base + entries[7].offset;
+    memcpy(p, &archiveBlocks, sizeof(archiveBlocks));
+    p += sizeof(quint64);
+    for (quint64 i = 0; i < archiveBlocks; ++i) {
+        const HistoryArchive::Block &block = archive->block(static_cast<int>(i));
+        ArchiveBlockRecord blockRecord;
+        blockRecord.firstTimestampUs = block.firstTimestampUs;
+        blockRecord.lastTimestampUs = block.lastTimestampUs;
+        blockRecord.count = block.count;
+        blockRecord.bytes = static_cast<quint64>(block.bits.size());
+        memcpy(p, &blockRecord, sizeof(blockRecord));
+        p += sizeof(blockRecord);
+        memcpy(p, block.bits.constData(), blockRecord.bytes);
+        p += align8(blockRecord.bytes);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(buffer) != buffer.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+/**
+ * @brief Читает снимок через отображение файла в память.
+ *
+ * Проверяются сигнатура, версия, порядок байт, размер файла и границы всех секций;
+ * выходные параметры изменяются только после успешной проверки.
+ * @param path Путь к файлу снимка.
+ * @param settings Скалярные настройки.
+ * @param fleet Состояние парка.
+ * @param history История измерений (может быть nullptr).
+ * @param schedule Расписание (может быть nullptr). Снимки без секции расписания дают пустое.
+ * @param archive Блоки сжатого архива (может быть nullptr). Снимки без секции архива дают пустой.
+ * @return true, если снимок прочитан.
+ */
+bool StateSnapshot::read(const QString &path, SnapshotSettings &settings,
+                         FleetStore &fleet, SampleHistory *history, ScheduleData *schedule,
+                         QVector<HistoryArchive::Block> *archive) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const quint64 size = static_cast<quint64>(file.size());
+    if (size < sizeof(FileHeader)) {
+        return false;
+    }
+    const uchar *map = file.map(0, static_cast<qint64>(size));
+    if (!map) {
+        return false;
+    }
+    const char *base = reinterpret_cast<const char *>(map);
+
+    bool ok = false;
+    do {
+        FileHeader header;
+        memcpy(&header, base, sizeof(header));
+        if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.byteOrder != kByteOrderMark
+            || header.version == 0 || header.version > kVersion || header.fileSize != size
+            || header.sectionCount > kMaxSections
+            || sizeof(FileHeader) + header.sectionCount * sizeof(SectionEntry) > size) {
+            break;
+        }
+
+        SectionEntry entries[kMaxSections];
+        memcpy(entries, base + sizeof(FileHeader), header.sectionCount * sizeof(SectionEntry));
+        bool bounds = true;
+        for (quint32 i = 0; i < header.sectionCount; ++i) {
+            if (entries[i].offset > size || entries[i].size > size - entries[i].offset) {
+                bounds = false;
+            }
+        }
+        if (!bounds) {
+            break;
+        }
+
+        const SectionEntry *settingsEntry = findSection(entries, header.sectionCount, SettingsSection);
+        const SectionEntry *fleetEntry = findSection(entries, header.sectionCount, FleetSection);
+        const SectionEntry *historyEntry = findSection(entries, header.sectionCount, HistorySection);
+        const SectionEntry *journalEntry = findSection(entries, header.sectionCount, JournalSection);
+        const SectionEntry *setpointEntry = findSection(entries, header.sectionCount, SetpointSection);
+        const SectionEntry *fanEntry = findSection(entries, header.sectionCount, FanSection);
+        const SectionEntry *scheduleEntry = findSection(entries, header.sectionCount, ScheduleSection);
+        const SectionEntry *archiveEntry = findSection(entries, header.sectionCount, ArchiveSection);
+        if (!settingsEntry || settingsEntry->size < sizeof(SettingsRecord)
+            || !fleetEntry || fleetEntry->size < sizeof(quint64)) {
+            break;
+        }
+
+        quint64 units;
+        memcpy(&units, base + fleetEntry->offset, sizeof(units));
+        if (units > (fleetEntry->size - sizeof(quint64)) / kFleetBytesPerUnit || units > 0x7fffffff) {
+            break;
+        }
+
+        quint64 samples = 0;
+        if (history && historyEntry) {
+            if (historyEntry->size < sizeof(quint64)) {
+                break;
+            }
+            memcpy(&samples, base + historyEntry->offset, sizeof(samples));
+            if (samples > (historyEntry->size - sizeof(quint64)) / kHistoryBytesPerSample) {
+                break;
+            }
+        }
+
+        quint64 scheduleEntries = 0;
+        quint64 holidays = 0;
+        if (schedule && scheduleEntry) {
+            if (scheduleEntry->size < kScheduleHeaderBytes) {
+                break;
+            }
+            memcpy(&scheduleEntries, base + scheduleEntry->offset, sizeof(quint64));
+            memcpy(&holidays, base + scheduleEntry->offset + sizeof(quint64), sizeof(quint64));
+            const quint64 room = scheduleEntry->size - kScheduleHeaderBytes;
+            if (scheduleEntries > room / sizeof(ScheduleEntry) || scheduleEntries > 0x7fffffff
+                || holidays > (room - scheduleEntries * sizeof(ScheduleEntry)) / sizeof(HolidayOverride)) {
+                break;
+            }
+        }
+
+        // Блоки архива разбираются до изменения выходных параметров: у каждого проверяются
+        // границы потока бит, порядок меток и количество измерений, которое поток может вместить
+        QVector<HistoryArchive::Block> archived;
+        if (archive && archiveEntry) {
+            if (archiveEntry->size < sizeof(quint64)) {
+                break;
+            }
+            quint64 blockCount;
+            memcpy(&blockCount, base + archiveEntry->offset, sizeof(blockCount));
+            quint64 pos = sizeof(quint64);
+            bool valid = blockCount <= (archiveEntry->size - pos) / sizeof(ArchiveBlockRecord);
+            qint64 previousUs = 0;
+            for (quint64 i = 0; valid && i < blockCount; ++i) {
+                ArchiveBlockRecord blockRecord;
+                memcpy(&blockRecord, base + archiveEntry->offset + pos, sizeof(blockRecord));
+                pos += sizeof(blockRecord);
+                if (blockRecord.bytes > archiveEntry->size - pos || blockRecord.bytes > 0x7fffffff
+                    || blockRecord.count < 1 || static_cast<quint64>(blockRecord.count) > 1 + blockRecord.bytes * 8
+                    || blockRecord.bytes * 8 < kArchiveBlockHeaderBits
+                    || blockRecord.lastTimestampUs < blockRecord.firstTimestampUs
+                    || (i != 0 && blockRecord.firstTimestampUs < previousUs)) {
+                    valid = false;
+                    break;
+                }
+                HistoryArchive::Block block;
+                block.firstTimestampUs = blockRecord.firstTimestampUs;
+                block.lastTimestampUs = blockRecord.lastTimestampUs;
+                block.count = static_cast<int>(blockRecord.count);
+                block.bits = QByteArray(base + archiveEntry->offset + pos, static_cast<int>(blockRecord.bytes));
+                archived.append(block);
+                previousUs = blockRecord.lastTimestampUs;
+                pos += qMin(align8(blockRecord.bytes), archiveEntry->size - pos);
+            }
+            if (!valid) {
+                break;
+            }
+        }
+
+        SettingsRecord record;
+        memcpy(&record, base + settingsEntry->offset, sizeof(record));
+        settings.temperature = record.temperature;
+        settings.humidity = record.humidity;
+        settings.pressure = record.pressure;
+        settings.temperatureUnit = record.temperatureUnit;
+        settings.pressureUnit = record.pressureUnit;
+        settings.theme = record.theme;
+        settings.currentUnit = record.currentUnit;
+        settings.journalSequence = 0;
+        settings.fanSpeed = 2; // Снимки прежних версий — средняя скорость
+        if (fanEntry && fanEntry->size >= sizeof(qint32)) {
+            memcpy(&settings.fanSpeed, base + fanEntry->offset, sizeof(qint32));
+        }
+        if (journalEntry && journalEntry->size >= sizeof(quint64)) {
+            memcpy(&settings.journalSequence, base + journalEntry->offset, sizeof(quint64));
+        }
+
+        const char *p = base + fleetEntry->offset + sizeof(quint64);
+        const double *temperatures = reinterpret_cast<const double *>(p);
+        const double *humidities = temperatures + units;
+        const double *pressures = humidities + units;
+        const qint8 *hDirs = reinterpret_cast<const qint8 *>(pressures + units);
+        const qint8 *vDirs = hDirs + units;
+        const quint8 *flags = reinterpret_cast<const quint8 *>(vDirs + units);
+        fleet.assign(static_cast<int>(units), temperatures, humidities, pressures, hDirs, vDirs, flags);
+
+        // Снимки без колонки уставок (прежние версии) оставляют уставку равной температуре
+        if (setpointEntry && setpointEntry->size >= sizeof(quint64) + units * sizeof(double)) {
+            quint64 setpointUnits;
+            memcpy(&setpointUnits, base + setpointEntry->offset, sizeof(setpointUnits));
+            if (setpointUnits == units) {
+                memcpy(fleet.setpointData(), base + setpointEntry->offset + sizeof(quint64), units * sizeof(double));
+            }
+        }
+
+        if (history) {
+            history->clear();
+            const char *h = base + (historyEntry ? historyEntry->offset + sizeof(quint64) : 0);
+            const qint64 *timestamps = reinterpret_cast<const qint64 *>(h);
+            const double *t = reinterpret_cast<const double *>(timestamps + samples);
+            const double *hum = t + samples;
+            const double *pres = hum + samples;
+            quint64 first = samples > quint64(history->capacity()) ? samples - history->capacity() : 0;
+            for (quint64 i = first; i < samples; ++i) {
+                history->append(timestamps[i], t[i], hum[i], pres[i]);
+            }
+        }
+
+        if (schedule) {
+            schedule->entries.resize(static_cast<int>(scheduleEntries));
+            schedule->holidays.resize(static_cast<int>(holidays));
+            const char *records = base + (scheduleEntry ? scheduleEntry->offset + kScheduleHeaderBytes : 0);
+            memcpy(schedule->entries.data(), records, scheduleEntries * sizeof(ScheduleEntry));
+            memcpy(schedule->holidays.data(), records + scheduleEntries * sizeof(ScheduleEntry), holidays * sizeof(HolidayOverride));
+        }
+
+        if (archive) {
+            *archive = archived;
+        }
+        ok = true;
+    } while (false);
+
+    file.unmap(const_cast<uchar *>(map));
+    return ok;
+}
+
+/**
+ * @brief Импортирует настройки из XML-файла прежнего формата.
+ * @param path Путь к XML-файлу.
+ * @param settings Скалярные настройки.
+ * @param fleet Состояние парка.
+ * @return true, если файл прочитан.
+ */
+bool StateSnapshot::importXml(const QString &path, SnapshotSettings &settings, FleetStore &fleet) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDomDocument doc;
+    if (!doc.setContent(&file)) {
+        return false;
+    }
+    file.close();
+
+    QDomElement root = doc.documentElement();
+
+    QDomElement tempElem = root.firstChildElement("Temperature");
+    settings.temperature = tempElem.attribute("value").toDouble();
+    settings.temperatureUnit = temperatureUnitByScale(tempElem.attribute("scale"));
+
+    QDomElement humElem = root.firstChildElement("Humidity");
+    settings.humidity = humElem.attribute("value").toDouble();
+
+    QDomElement presElem = root.firstChildElement("Pressure");
+    settings.pressure = presElem.attribute("value").toDouble();
+    settings.pressureUnit = pressureUnitByScale(presElem.attribute("scale"));
+
+    QDomElement themeElem = root.firstChildElement("Theme");
+    settings.theme = themeElem.attribute("value") == "Dark" ? 2 : 1;
+    settings.currentUnit = 0;
+    settings.journalSequence = 0;
+
+    fleet.resize(0, 0.0, 0.0, 0.0);
+    fleet.resize(1, settings.temperature, settings.humidity, settings.pressure);
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "../includes/themeengine.h"
+#include <QApplication>
+#include <QStyle>
+#include <QVariant>
+
+/**
+ * @file themeengine.cpp
+ * @brief Реализация класса ThemeEngine.
+ *
+ * Этот файл содержит палитры тем и построение таблицы стилей уровня приложения.
+ */
+
+namespace {
+
+const char *const kLockedProperty = "locked"; ///< Динамическое свойство блокировки
+
+/**
+ * @brief Возвращает цвет в записи rgba() для таблицы стилей.
+ */
+QString cssColor(const QColor &color) {
+    return QString("rgba(%1, %2, %3, %4)").arg(color.red()).arg(color.green()).arg(color.blue()).arg(color.alpha());
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ThemeEngine.
+ * @param scope objectName корневого виджета, к которому применяются правила.
+ */
+ThemeEngine::ThemeEngine(const QString &scope)
+    : scope(scope), current(paletteFor(1))
+{
+}
+
+/**
+ * @brief Возвращает палитру темы.
+ * @param themeId Идентификатор темы (1 — светлая, 2 — тёмная).
+ * @return Палитра; для неизвестного идентификатора — палитра светлой темы.
+ */
+ThemePalette ThemeEngine::paletteFor(int themeId) {
+    ThemePalette palette;
+    if (themeId == 2) {
+        palette.background = Qt::black;
+        palette.foreground = Qt::white;
+    } else {
+        palette.background = Qt::white;
+        palette.foreground = Qt::black;
+    }
+    palette.locked = QColor(169, 169, 169, 150);
+    palette.temperatureFill = Qt::red;
+    palette.humidityFill = QColor("#8AC8FF");
+    palette.pressureFill = Qt::gray;
+    palette.arrow = Qt::red;
+    palette.arrowGuide = Qt::gray;
+    palette.arc = Qt::blue;
+    return palette;
+}
+
+/**
+ * @brief Возвращает таблицу стилей темы, строя её при первом обращении.
+ * @param themeId Идентификатор темы.
+ */
+const QString &ThemeEngine::styleSheet(int themeId) {
+    auto it = sheets.find(themeId);
+    if (it == sheets.end()) {
+        it = sheets.insert(themeId, buildStyleSheet(paletteFor(themeId)));
+    }
+    return it.value();
+}
+
+/**
+ * @brief Применяет тему ко всему приложению.
+ * @param themeId Идентификатор темы.
+ */
+void ThemeEngine::apply(int themeId) {
+    if (themeId == applied) {
+        return;
+    }
+    qApp->setStyleSheet(styleSheet(themeId));
+    current = paletteFor(themeId);
+    applied = themeId;
+}
+
+/**
+ * @brief Помечает виджет заблокированным или разблокированным.
+ * @param widget Виджет.
+ * @param locked Новое состояние.
+ */
+void ThemeEngine::setLocked(QWidget *widget, bool locked) {
+    if (widget->property(kLockedProperty).toBool() == locked) {
+        return;
+    }
+    widget->setProperty(kLockedProperty, locked);
+    // Правила с селектором по свойству пересчитываются только при переполировке
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+    widget->update();
+}
+
+/**
+ * @brief Строит таблицу стилей по палитре.
+ *
+ * Фон и цвет текста наследуются всеми потомками корневого виджета, как прежде
+ * при установке стиля на центральный виджет окна.
+ * @param palette Палитра темы.
+ * @return Таблица стилей.
+ */
+QString ThemeEngine::buildStyleSheet(const ThemePalette &palette) const {
+    const QString root = "#" + scope;
+    const QString fg = cssColor(palette.foreground);
+    const QString bg = cssColor(palette.background);
+
+    QString sheet;
+    sheet += QString("%1, %1 QWidget { background: %2; color: %3; }\n").arg(root, bg, fg);
+    sheet += QString("%1 QPushButton { border: 1px solid %2; }\n").arg(root, fg);
+    sheet += QString("%1 QPushButton[%2=\"true\"] { background-color: %3; border: 1px solid %4; }\n")
+                 .arg(root, kLockedProperty, cssColor(palette.locked), fg);
+    sheet += QString("%1 QLabel { color: %2; }\n").arg(root, fg);
+    sheet += QString("%1 QGraphicsView { border: 0px; }\n").arg(root);
+    return sheet;
+}
@@ -0,0 +1,306 @@
+#include "../includes/thermalsimulator.h"
+#include <QThread>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file thermalsimulator.cpp
+ * @brief Реализация класса ThermalSimulator.
+ *
+ * Этот файл содержит реализацию теплового симулятора комнат и пула потоков,
+ * между которыми делится диапазон комнат.
+ */
+
+namespace {
+
+const int kMinParallelRooms = 4096; ///< Меньше комнат считается в вызывающем потоке: запуск потоков дороже шага
+const int kBlockRooms = 1024; ///< Комнат в блоке, который проходит все шаги, оставаясь в кэше (≈ 48 КиБ)
+const int kPartAlignment = 8; ///< Границы частей кратны строке кэша (8 значений double)
+const double kThermostatGain = 1.0; ///< Мощность встроенного термостата на градус превышения уставки (полная — при 1 °C)
+const double kSupplyTemperature = 12.0; ///< Температура воздуха после испарителя, °C
+const double kCoilHumidity = 40.0; ///< Влажность воздуха после испарителя, %
+
+} // namespace
+
+/**
+ * @brief Конструктор класса ThermalSimulator.
+ * @param threads Количество потоков (0 — по числу ядер).
+ */
+ThermalSimulator::ThermalSimulator(int threads) {
+    setThreadCount(threads);
+}
+
+/**
+ * @brief Деструктор класса ThermalSimulator.
+ */
+ThermalSimulator::~ThermalSimulator() {
+    stopWorkers();
+}
+
+/**
+ * @brief Изменяет количество комнат.
+ * @param count Количество комнат.
+ * @param temperature Начальная температура новых комнат, °C.
+ * @param humidity Начальная влажность новых комнат, %.
+ */
+void ThermalSimulator::resize(int count, double temperature, double humidity) {
+    const int old = size();
+    count = qMax(0, count);
+    temperatures.resize(count);
+    humidities.resize(count);
+    params.resize(count);
+    setpoints.resize(count);
+    hGates.resize(count);
+    vGates.resize(count);
+    powered.resize(count);
+    capacities.resize(count);
+    outdoor.resize(count);
+    leak.resize(count);
+    cooling.resize(count);
+    command.resize(count);
+    humidityTarget.resize(count);
+    humidityLeak.resize(count);
+    drying.resize(count);
+
+    for (int room = old; room < count; ++room) {
+        temperatures[room] = temperature;
+        humidities[room] = humidity;
+        params[room] = ThermalRoomParams();
+        setpoints[room] = temperature;
+        hGates[room] = 0;
+        vGates[room] = 0;
+        powered[room] = 0;
+        capacities[room] = -1.0;
+        updateCoefficients(room);
+    }
+}
+
+/**
+ * @brief Задаёт тепловые параметры комнаты.
+ * @param room Номер комнаты.
+ * @param roomParams Параметры.
+ */
+void ThermalSimulator::setRoomParams(int room, const ThermalRoomParams &roomParams) {
+    params[room] = roomParams;
+    updateCoefficients(room);
+}
+
+/**
+ * @brief Задаёт управление блоком комнаты.
+ * @param room Номер комнаты.
+ * @param on Питание блока.
+ * @param setpoint Уставка температуры встроенного термостата, °C.
+ * @param hGateDir Угол горизонтальных жалюзи.
+ * @param vGateDir Угол вертикальных жалюзи.
+ * @param capacity Мощность охлаждения от внешнего регулятора (отрицательная — встроенный термостат).
+ */
+void ThermalSimulator::setControl(int room, bool on, double setpoint, int hGateDir, int vGateDir, double capacity) {
+    capacity = capacity < 0.0 ? -1.0 : qMin(capacity, 1.0);
+    if (powered[room] == quint8(on) && setpoints[room] == setpoint && capacities[room] == capacity
+        && hGates[room] == hGateDir && vGates[room] == vGateDir) {
+        return;
+    }
+    powered[room] = on;
+    capacities[room] = capacity;
+    setpoints[room] = setpoint;
+    hGates[room] = static_cast<qint8>(hGateDir);
+    vGates[room] = static_cast<qint8>(vGateDir);
+    updateCoefficients(room);
+}
+
+/**
+ * @brief Задаёт температуру и влажность комнаты.
+ * @param room Номер комнаты.
+ * @param temperature Температура, °C.
+ * @param humidity Влажность, %.
+ */
+void ThermalSimulator::setState(int room, double temperature, double humidity) {
+    temperatures[room] = temperature;
+    humidities[room] = humidity;
+}
+
+/**
+ * @brief Возвращает долю воздушного потока, перемешивающего объём комнаты.
+ * @param hGateDir Угол горизонтальных жалюзи (0..90).
+ * @param vGateDir Угол вертикальных жалюзи (-45..45).
+ */
+double ThermalSimulator::airflowEfficiency(int hGateDir, int vGateDir) {
+    return 0.4 + 0.6 * std::cos(qDegreesToRadians(double(hGateDir))) * std::cos(qDegreesToRadians(double(vGateDir)));
+}
+
+/**
+ * @brief Пересчитывает коэффициенты шага комнаты.
+ *
+ * У выключенного блока доля охлаждения нулевая, поэтому мощность на шаге не важна.
+ * @param room Номер комнаты.
+ */
+void ThermalSimulator::updateCoefficients(int room) {
+    const ThermalRoomParams &p = params[room];
+    const double efficiency = powered[room] ? airflowEfficiency(hGates[room], vGates[room]) : 0.0;
+
+    outdoor[room] = p.outdoorTemperature;
+    leak[room] = kStepSeconds / p.thermalTimeConstant;
+    cooling[room] = efficiency * kStepSeconds / p.coolingTimeConstant;
+    command[room] = capacities[room];
+    humidityTarget[room] = p.outdoorHumidity;
+    humidityLeak[room] = kStepSeconds / p.humidityTimeConstant;
+    drying[room] = efficiency * kStepSeconds / p.dryingTimeConstant;
+}
+
+/**
+ * @brief Продвигает модельное время.
+ * @param seconds Модельное время, с.
+ * @return Количество выполненных шагов.
+ */
+int ThermalSimulator::advance(double seconds) {
+    pendingSeconds += qMax(0.0, seconds);
+    const int steps = static_cast<int>(pendingSeconds / kStepSeconds);
+    pendingSeconds -= steps * kStepSeconds;
+    step(steps);
+    return steps;
+}
+
+/**
+ * @brief Выполняет заданное количество шагов.
+ *
+ * Вызывающий поток обрабатывает первую часть комнат сам и ждёт остальные части.
+ * @param steps Количество шагов.
+ */
+void ThermalSimulator::step(int steps) {
+    if (steps <= 0 || size() == 0) {
+        return;
+    }
+    if (workers.empty() || size() < kMinParallelRooms) {
+        run(-1, steps);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stepsToRun = steps;
+        pending = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+    run(0, steps);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return pending == 0; });
+}
+
+/**
+ * @brief Выполняет шаги на части комнат.
+ *
+ * Часть проходится блоками: блок проходит все шаги, пока его массивы в кэше.
+ * Внутренний цикл не содержит ветвлений (выбор мощности — условное присваивание) и векторизуется.
+ * @param part Номер части (-1 — все комнаты).
+ * @param steps Количество шагов.
+ */
+void ThermalSimulator::run(int part, int steps) {
+    const int count = size();
+    int begin = 0;
+    int end = count;
+    if (part >= 0) {
+        const int parts = threadCount();
+        int chunk = (count + parts - 1) / parts;
+        chunk = (chunk + kPartAlignment - 1) / kPartAlignment * kPartAlignment;
+        begin = qMin(count, part * chunk);
+        end = qMin(count, begin + chunk);
+    }
+
+    double *__restrict t = temperatures.data();
+    double *__restrict h = humidities.data();
+    const double *__restrict tOut = outdoor.constData();
+    const double *__restrict tLeak = leak.constData();
+    const double *__restrict cool = cooling.constData();
+    const double *__restrict cmd = command.constData();
+    const double *__restrict sp = setpoints.constData();
+    const double *__restrict hOut = humidityTarget.constData();
+    const double *__restrict hLeak = humidityLeak.constData();
+    const double *__restrict dry = drying.constData();
+
+    for (int blockBegin = begin; blockBegin < end; blockBegin += kBlockRooms) {
+        const int blockEnd = qMin(end, blockBegin + kBlockRooms);
+        for (int s = 0; s < steps; ++s) {
+            for (int i = blockBegin; i < blockEnd; ++i) {
+                const double thermostat = std::min(std::max((t[i] - sp[i]) * kThermostatGain, 0.0), 1.0);
+                const double power = cmd[i] < 0.0 ? thermostat : cmd[i];
+                const double temperature = t[i] + (tOut[i] - t[i]) * tLeak[i] + (kSupplyTemperature - t[i]) * cool[i] * power;
+                const double humidity = h[i] + (hOut[i] - h[i]) * hLeak[i] - (h[i] - kCoilHumidity) * dry[i] * power;
+                t[i] = temperature;
+                h[i] = std::min(std::max(humidity, 0.0), 100.0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Цикл рабочего потока: ждёт задание, выполняет свою часть и сообщает о завершении.
+ * @param part Номер части.
+ */
+void ThermalSimulator::workerLoop(int part) {
+    quint64 seen = 0;
+    for (;;) {
+        int steps;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            steps = stepsToRun;
+        }
+
+        run(part, steps);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Задаёт количество потоков.
+ * @param threads Количество потоков (0 — по числу ядер).
+ */
+void ThermalSimulator::setThreadCount(int threads) {
+    if (threads <= 0) {
+        threads = qMax(1, QThread::idealThreadCount());
+    }
+    if (threads == threadCount()) {
+        return;
+    }
+    stopWorkers();
+    startWorkers(threads - 1);
+}
+
+/**
+ * @brief Запускает рабочие потоки.
+ * @param count Количество рабочих потоков (без вызывающего).
+ */
+void ThermalSimulator::startWorkers(int count) {
+    stopping = false;
+    generation = 0;
+    workers.reserve(count);
+    for (int part = 1; part <= count; ++part) {
+        workers.emplace_back(&ThermalSimulator::workerLoop, this, part);
+    }
+}
+
+/**
+ * @brief Останавливает рабочие потоки.
+ */
+void ThermalSimulator::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
@@ -0,0 +1,242 @@
+#include "../includes/timerwheel.h"
+#include <QtAlgorithms>
+
+/**
+ * @file timerwheel.cpp
+ * @brief Реализация иерархического колеса таймеров.
+ *
+ * Этот файл содержит постановку и отмену таймеров, каскад старших уровней
+ * и продвижение колеса по тактам.
+ */
+
+namespace {
+
+const qint64 kMaxDelta = (Q_INT64_C(1) << (TimerWheel::kLevelBits * TimerWheel::kLevels)) - 1; ///< Наибольшее расстояние, которое охватывает колесо, тактов
+const qint64 kSlotMask = TimerWheel::kSlots - 1; ///< Маска номера ячейки
+
+} // namespace
+
+/**
+ * @brief Конструктор класса TimerWheel.
+ * @param now Текущий такт (уже обработанный).
+ */
+TimerWheel::TimerWheel(qint64 now) {
+    reset(now);
+}
+
+/**
+ * @brief Удаляет все таймеры и переводит колесо на такт.
+ *
+ * Узлы сохраняются со сменой поколения, поэтому дескрипторы удалённых таймеров
+ * не совпадут с дескрипторами новых.
+ * @param now Текущий такт.
+ */
+void TimerWheel::reset(qint64 now) {
+    for (int &head : heads) {
+        head = -1;
+    }
+    for (quint64 &bits : occupied) {
+        bits = 0;
+    }
+    freeList = -1;
+    for (int i = nodes.size() - 1; i >= 0; --i) {
+        Node &node = nodes[i];
+        if (node.slot >= 0) {
+            ++node.generation;
+            node.slot = -1;
+        }
+        node.prev = -1;
+        node.next = freeList;
+        freeList = i;
+    }
+    pending = 0;
+    nextTick = now + 1;
+}
+
+/**
+ * @brief Ставит таймер.
+ * @param tick Такт срабатывания.
+ * @param payload Значение, возвращаемое при срабатывании.
+ * @return Дескриптор таймера.
+ */
+TimerWheel::Handle TimerWheel::schedule(qint64 tick, quint32 payload) {
+    int index = freeList;
+    if (index >= 0) {
+        freeList = nodes[index].next;
+    } else {
+        index = nodes.size();
+        nodes.append(Node());
+    }
+    Node &node = nodes[index];
+    node.expires = qMax(tick, nextTick);
+    node.payload = payload;
+    link(index);
+    ++pending;
+    return (static_cast<Handle>(node.generation) << 32) | static_cast<quint32>(index + 1);
+}
+
+/**
+ * @brief Отменяет таймер.
+ * @param handle Дескриптор.
+ * @return true, если таймер ещё не сработал и отменён.
+ */
+bool TimerWheel::cancel(Handle handle) {
+    const int index = static_cast<int>(handle & 0xFFFFFFFFu) - 1;
+    if (index < 0 || index >= nodes.size()) {
+        return false;
+    }
+    const Node &node = nodes[index];
+    if (node.slot < 0 || node.generation != static_cast<quint32>(handle >> 32)) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+/**
+ * @brief Продвигает колесо до первого такта со срабатываниями, но не дальше limit.
+ *
+ * На такте, кратном 256, сначала раскладываются по младшим уровням ячейки старших,
+ * срок которых наступил, затем забирается вся ячейка нулевого уровня: все её таймеры
+ * срабатывают на этом такте. Пустые ячейки нулевого уровня пропускаются до ближайшей
+ * непустой или до конца оборота, пустое колесо переходит к limit сразу.
+ * @param limit Наибольший такт.
+ * @param out Вектор, в который добавляются сработавшие таймеры.
+ * @return Количество сработавших таймеров.
+ */
+int TimerWheel::expire(qint64 limit, QVector<Fired> &out) {
+    while (nextTick <= limit) {
+        if (pending == 0) {
+            nextTick = limit + 1;
+            break;
+        }
+        const qint64 tick = nextTick;
+        const int index = static_cast<int>(tick & kSlotMask);
+        if (index == 0) {
+            for (int level = 1; level < kLevels; ++level) {
+                cascade(level);
+                if (((tick >> (kLevelBits * level)) & kSlotMask) != 0) {
+                    break;
+                }
+            }
+        }
+        int current = heads[index];
+        if (current < 0) {
+            nextTick = qMin(limit + 1, tick - index + firstOccupied(index + 1));
+            continue;
+        }
+        heads[index] = -1;
+        occupied[index >> 6] &= ~(Q_UINT64_C(1) << (index & 63));
+        ++nextTick;
+        int fired = 0;
+        while (current >= 0) {
+            const Node &node = nodes[current];
+            const int following = node.next;
+            out.append({ (static_cast<Handle>(node.generation) << 32) | static_cast<quint32>(current + 1), node.payload });
+            release(current);
+            current = following;
+            ++fired;
+        }
+        if (fired != 0) {
+            return fired;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Вставляет узел в ячейку по расстоянию до срока срабатывания.
+ * @param index Номер узла.
+ */
+void TimerWheel::link(int index) {
+    Node &node = nodes[index];
+    const qint64 delta = node.expires - nextTick;
+    int slot;
+    if (delta < kSlots) {
+        slot = static_cast<int>(node.expires & kSlotMask);
+    } else {
+        const qint64 expires = delta > kMaxDelta ? nextTick + kMaxDelta : node.expires;
+        int level = 1;
+        while (level < kLevels - 1 && delta >= (Q_INT64_C(1) << (kLevelBits * (level + 1)))) {
+            ++level;
+        }
+        slot = level * kSlots + static_cast<int>((expires >> (kLevelBits * level)) & kSlotMask);
+    }
+    node.slot = slot;
+    node.prev = -1;
+    node.next = heads[slot];
+    if (node.next >= 0) {
+        nodes[node.next].prev = index;
+    }
+    heads[slot] = index;
+    if (slot < kSlots) {
+        occupied[slot >> 6] |= Q_UINT64_C(1) << (slot & 63);
+    }
+}
+
+/**
+ * @brief Удаляет узел из его ячейки.
+ * @param index Номер узла.
+ */
+void TimerWheel::unlink(int index) {
+    const Node &node = nodes[index];
+    if (node.prev >= 0) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.slot] = node.next;
+        if (node.next < 0 && node.slot < kSlots) {
+            occupied[node.slot >> 6] &= ~(Q_UINT64_C(1) << (node.slot & 63));
+        }
+    }
+    if (node.next >= 0) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+/**
+ * @brief Возвращает узел, уже удалённый из ячейки, в свободный список.
+ * @param index Номер узла.
+ */
+void TimerWheel::release(int index) {
+    Node &node = nodes[index];
+    ++node.generation;
+    node.slot = -1;
+    node.prev = -1;
+    node.next = freeList;
+    freeList = index;
+    --pending;
+}
+
+/**
+ * @brief Раскладывает текущую ячейку уровня по младшим уровням.
+ * @param level Уровень (1..kLevels-1).
+ */
+void TimerWheel::cascade(int level) {
+    const int slot = level * kSlots + static_cast<int>((nextTick >> (kLevelBits * level)) & kSlotMask);
+    int current = heads[slot];
+    heads[slot] = -1;
+    while (current >= 0) {
+        const int following = nodes[current].next;
+        link(current);
+        current = following;
+    }
+}
+
+/**
+ * @brief Возвращает первую непустую ячейку нулевого уровня не раньше заданной.
+ * @param from Номер ячейки (может быть kSlots).
+ * @return Номер ячейки или kSlots, если до конца оборота ячейки пусты.
+ */
+int TimerWheel::firstOccupied(int from) const {
+    for (int word = from >> 6; word < kSlots / 64; ++word) {
+        quint64 bits = occupied[word];
+        if (word == from >> 6) {
+            bits &= ~Q_UINT64_C(0) << (from & 63);
+        }
+        if (bits != 0) {
+            return word * 64 + static_cast<int>(qCountTrailingZeroBits(bits));
+        }
+    }
+    return kSlots;
+}
@@ -0,0 +1,216 @@
+#include "../includes/tracereplayer.h"
+#include <cstring>
+
+/**
+ * @file tracereplayer.cpp
+ * @brief Реализация класса TraceReplayer.
+ *
+ * Этот файл содержит реализацию выдачи событий записи в модель состояния
+ * по времени записи или без пауз.
+ */
+
+namespace {
+
+const int kTickMs = 5; ///< Период таймера при воспроизведении по времени записи, мс
+const int kChunkEvents = 4096; ///< Событий за порцию при воспроизведении без пауз
+const int kMaxBatch = 4096; ///< Наибольший пакет измерений, передаваемый модели
+
+} // namespace
+
+/**
+ * @brief Конструктор класса TraceReplayer.
+ * @param model Модель состояния.
+ * @param parent Родительский объект.
+ */
+TraceReplayer::TraceReplayer(ClimateModel *model, QObject *parent)
+    : QObject(parent), model(model)
+{
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &TraceReplayer::tick);
+    batch.reserve(kMaxBatch);
+}
+
+/**
+ * @brief Открывает файл записи.
+ * @param path Путь к файлу.
+ * @return true, если файл прочитан и заголовок корректен.
+ */
+bool TraceReplayer::open(const QString &path) {
+    stop();
+    return reader.open(path);
+}
+
+/**
+ * @brief Открывает запись из буфера в памяти.
+ * @param data Содержимое файла записи.
+ * @return true, если заголовок корректен.
+ */
+bool TraceReplayer::openData(const QByteArray &data) {
+    stop();
+    return reader.openData(data);
+}
+
+/**
+ * @brief Запускает воспроизведение по таймеру.
+ * @param factor Ускорение относительно записи (0 — без пауз).
+ */
+void TraceReplayer::start(double factor) {
+    speed = qMax(0.0, factor);
+    begin();
+    timer.start(speed > 0.0 ? kTickMs : 0);
+}
+
+/**
+ * @brief Останавливает воспроизведение.
+ */
+void TraceReplayer::stop() {
+    timer.stop();
+}
+
+/**
+ * @brief Воспроизводит запись от начала до конца без пауз.
+ * @return Количество воспроизведённых событий.
+ */
+quint64 TraceReplayer::runToEnd() {
+    stop();
+    speed = 0.0;
+    begin();
+    while (step(0, kChunkEvents)) {
+    }
+    finish();
+    return events;
+}
+
+/**
+ * @brief Возвращает запись к началу и задаёт модели начальное состояние.
+ *
+ * Единицы измерения задаются первыми: остальные значения заголовка записаны в них.
+ */
+void TraceReplayer::begin() {
+    reader.rewind();
+    hasPending = false;
+    batch.clear();
+    events = 0;
+    samples = 0;
+    elapsed = 0;
+
+    const TraceInitialState &initial = reader.initialState();
+    model->setUnits(initial.temperatureUnit, initial.pressureUnit);
+    model->setFleetSize(initial.fleetSize);
+    model->selectUnit(initial.currentUnit);
+    model->setPower(initial.on != 0);
+    model->setGates(initial.hGateDir, initial.vGateDir);
+    model->setSetpoint(initial.setpoint);
+    clock.start();
+}
+
+/**
+ * @brief Выдаёт порцию событий по таймеру.
+ */
+void TraceReplayer::tick() {
+    const qint64 untilUs = speed > 0.0 ? static_cast<qint64>(clock.nsecsElapsed() / 1000 * speed) : 0;
+    if (!step(untilUs, speed > 0.0 ? -1 : kChunkEvents)) {
+        finish();
+    }
+}
+
+/**
+ * @brief Выдаёт события, время которых наступило.
+ * @param untilUs Время записи, до которого выдаются события (при воспроизведении без пауз не учитывается).
+ * @param maxEvents Наибольшее количество событий (-1 — без ограничения).
+ * @return false, если запись закончилась.
+ */
+bool TraceReplayer::step(qint64 untilUs, int maxEvents) {
+    for (int n = 0; maxEvents < 0 || n < maxEvents; ++n) {
+        if (!hasPending && !reader.next(pending)) {
+            flushBatch();
+            return false;
+        }
+        hasPending = true;
+        if (speed > 0.0 && pending.timeUs > untilUs) {
+            break;
+        }
+        apply(pending);
+        hasPending = false;
+    }
+    flushBatch();
+    return true;
+}
+
+/**
+ * @brief Передаёт событие модели.
+ *
+ * Измерения копятся в пакет; перед действием пакет передаётся модели, чтобы
+ * действие видело те же показания, что и при записи.
+ * @param event Событие.
+ */
+void TraceReplayer::apply(const TraceEvent &event) {
+    ++events;
+    if (event.type == InputTraceWriter::Sample) {
+        ++samples;
+        batch.append(event.sample);
+        if (batch.size() >= kMaxBatch) {
+            flushBatch();
+        }
+        return;
+    }
+
+    flushBatch();
+    switch (event.type) {
+        case InputTraceWriter::Power:
+            model->setPower(event.a != 0);
+            break;
+        case InputTraceWriter::TemperatureUp:
+            model->temperatureUp();
+            break;
+        case InputTraceWriter::TemperatureDown:
+            model->temperatureDown();
+            break;
+        case InputTraceWriter::Setpoint: {
+            const quint64 bits = static_cast<quint32>(event.a) | (quint64(static_cast<quint32>(event.b)) << 32);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            model->setSetpoint(value);
+            break;
+        }
+        case InputTraceWriter::HGate:
+            model->moveHGate(event.a);
+            break;
+        case InputTraceWriter::VGate:
+            model->moveVGate(event.a);
+            break;
+        case InputTraceWriter::Gates:
+            model->setGates(event.a, event.b);
+            break;
+        case InputTraceWriter::Units:
+            model->setUnits(event.a, event.b);
+            break;
+        case InputTraceWriter::SelectUnit:
+            model->selectUnit(event.a);
+            break;
+        case InputTraceWriter::FleetSize:
+            model->setFleetSize(event.a);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Передаёт модели накопленные измерения.
+ */
+void TraceReplayer::flushBatch() {
+    if (!batch.isEmpty()) {
+        model->acceptBatch(batch);
+        batch.clear();
+    }
+}
+
+/**
+ * @brief Завершает воспроизведение.
+ */
+void TraceReplayer::finish() {
+    timer.stop();
+    elapsed = clock.nsecsElapsed();
+    emit finished();
+}
@@ -0,0 +1,144 @@
+#include "../includes/trendchart.h"
+#include <QPainter>
+#include <QPen>
+
+/**
+ * @file trendchart.cpp
+ * @brief Реализация класса TrendChartItem.
+ *
+ * Этот файл содержит реализацию отрисовки графика истории измерений.
+ */
+
+namespace {
+
+const qint64 kMinSpanUs = 60LL * 1000000; ///< Минимальная длительность отображаемого отрезка (1 минута)
+
+} // namespace
+
+/**
+ * @brief Конструктор класса TrendChartItem.
+ * @param history История измерений.
+ * @param width Ширина графика в пикселях.
+ * @param height Высота графика в пикселях.
+ * @param parent Родительский элемент.
+ */
+TrendChartItem::TrendChartItem(const SampleHistory *history, int width, int height, QGraphicsItem *parent)
+    : QGraphicsItem(parent), history(history), width(width), height(height),
+      maxSpanUs(24LL * 60 * 60 * 1000000), frameColor(Qt::black)
+{
+    for (int channel = 0; channel < SampleHistory::ChannelCount; ++channel) {
+        rangeMin[channel] = 0.0;
+        rangeMax[channel] = 1.0;
+        colors[channel] = Qt::black;
+    }
+    buckets.reserve(width);
+    lines.reserve(width * 2);
+}
+
+/**
+ * @brief Возвращает границы элемента.
+ */
+QRectF TrendChartItem::boundingRect() const {
+    return QRectF(-0.5, -0.5, width + 1, height + 1);
+}
+
+/**
+ * @brief Рисует рамку и прореженные линии каналов.
+ *
+ * Для каждого столбца пикселей рисуется вертикальный отрезок от минимума до максимума
+ * и соединительный отрезок от середины предыдущего столбца.
+ */
+void TrendChartItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->setPen(QPen(frameColor, 1));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(QRectF(0, 0, width, height));
+
+    if (history->size() == 0) {
+        return;
+    }
+
+    qint64 toUs = history->lastTimestamp() + 1;
+    qint64 fromUs = qMax(history->firstTimestamp(), toUs - maxSpanUs);
+    if (toUs - fromUs < kMinSpanUs) {
+        fromUs = toUs - kMinSpanUs;
+    }
+
+    for (int channel = 0; channel < SampleHistory::ChannelCount; ++channel) {
+        minMaxDecimate(*history, static_cast<SampleHistory::Channel>(channel), fromUs, toUs, width, buckets);
+
+        const double min = rangeMin[channel];
+        const double scale = height / (rangeMax[channel] - min);
+        auto toY = [&](double value) {
+            return qBound(0.0, height - (value - min) * scale, double(height));
+        };
+
+        lines.clear();
+        bool hasPrevious = false;
+        QPointF previous;
+        for (int x = 0; x < width; ++x) {
+            const MinMaxBucket &bucket = buckets.at(x);
+            if (bucket.empty) {
+                continue;
+            }
+            double yLow = toY(bucket.min);
+            double yHigh = toY(bucket.max);
+            if (yLow - yHigh < 1.0) {
+                yHigh = yLow - 1.0; // Отрезок не короче пикселя, чтобы столбец был виден
+            }
+            lines.append(QLineF(x + 0.5, yLow, x + 0.5, yHigh));
+
+            QPointF middle(x + 0.5, (yLow + yHigh) / 2);
+            if (hasPrevious) {
+                lines.append(QLineF(previous, middle));
+            }
+            previous = middle;
+            hasPrevious = true;
+        }
+
+        painter->setPen(QPen(colors[channel], 1));
+        painter->drawLines(lines);
+    }
+}
+
+/**
+ * @brief Задаёт диапазон отображения канала.
+ * @param channel Канал.
+ * @param min Значение у нижнего края графика.
+ * @param max Значение у верхнего края графика.
+ */
+void TrendChartItem::setRange(SampleHistory::Channel channel, double min, double max) {
+    rangeMin[channel] = min;
+    rangeMax[channel] = max;
+    update();
+}
+
+/**
+ * @brief Задаёт цвет линии канала.
+ * @param channel Канал.
+ * @param color Цвет.
+ */
+void TrendChartItem::setChannelColor(SampleHistory::Channel channel, const QColor &color) {
+    colors[channel] = color;
+    update();
+}
+
+/**
+ * @brief Задаёт цвет рамки графика.
+ * @param color Цвет.
+ */
+void TrendChartItem::setFrameColor(const QColor &color) {
+    frameColor = color;
+    update();
+}
+
+/**
+ * @brief Задаёт максимальную длительность отображаемого отрезка.
+ * @param spanUs Длительность в микросекундах.
+ */
+void TrendChartItem::setMaxSpan(qint64 spanUs) {
+    maxSpanUs = spanUs;
+    update();
+}
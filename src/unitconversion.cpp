@@ -0,0 +1,138 @@
+#include "../includes/unitconversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNITCONVERSION_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UNITCONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * @file unitconversion.cpp
+ * @brief Реализация ядра пересчёта единиц измерения.
+ *
+ * Этот файл содержит таблицы преобразований и векторный и скалярный циклы пересчёта массивов.
+ */
+
+namespace {
+
+const UnitConversion::Affine kIdentity = { 0.0, 1.0, 0.0 };
+
+/**
+ * @brief Преобразования температуры: строка — исходная единица, столбец — целевая (C, F, K).
+ */
+const UnitConversion::Affine kTemperatureTable[3][3] = {
+    { kIdentity,                      { 0.0, 9.0 / 5.0, 32.0 },       { 0.0, 1.0, 273.15 } },
+    { { -32.0, 5.0 / 9.0, 0.0 },      kIdentity,                      { -32.0, 5.0 / 9.0, 273.15 } },
+    { { -273.15, 1.0, 0.0 },          { -273.15, 9.0 / 5.0, 32.0 },   kIdentity }
+};
+
+const double kPascalPerMmhg = 133.3224; ///< Паскалей в одном миллиметре ртутного столба
+
+/**
+ * @brief Преобразования давления: строка — исходная единица, столбец — целевая (Па, мм рт. ст.).
+ */
+const UnitConversion::Affine kPressureTable[2][2] = {
+    { kIdentity,                          { 0.0, 1.0 / kPascalPerMmhg, 0.0 } },
+    { { 0.0, kPascalPerMmhg, 0.0 },       kIdentity }
+};
+
+} // namespace
+
+/**
+ * @brief Возвращает преобразование между единицами температуры.
+ * @param from Исходная единица.
+ * @param to Целевая единица.
+ * @return Преобразование из таблицы.
+ */
+UnitConversion::Affine UnitConversion::temperature(int from, int to) {
+    if (from < 1 || from > 3 || to < 1 || to > 3) {
+        return kIdentity;
+    }
+    return kTemperatureTable[from - 1][to - 1];
+}
+
+/**
+ * @brief Возвращает преобразование между единицами давления.
+ * @param from Исходная единица.
+ * @param to Целевая единица.
+ * @return Преобразование из таблицы.
+ */
+UnitConversion::Affine UnitConversion::pressure(int from, int to) {
+    if (from < 1 || from > 2 || to < 1 || to > 2) {
+        return kIdentity;
+    }
+    return kPressureTable[from - 1][to - 1];
+}
+
+/**
+ * @brief Пересчитывает массив на месте скалярным циклом.
+ * @param affine Преобразование.
+ * @param data Массив значений.
+ * @param count Количество значений.
+ */
+void UnitConversion::applyScalar(const Affine &affine, double *data, qint64 count) {
+    const double pre = affine.pre;
+    const double scale = affine.scale;
+    const double post = affine.post;
+    for (qint64 i = 0; i < count; ++i) {
+        data[i] = (data[i] + pre) * scale + post;
+    }
+}
+
+/**
+ * @brief Пересчитывает массив на месте векторными инструкциями.
+ *
+ * Основной цикл обрабатывает по четыре значения (два вектора по два double),
+ * остаток — скалярным циклом. Загрузка и сохранение не требуют выравнивания.
+ * @param affine Преобразование.
+ * @param data Массив значений.
+ * @param count Количество значений.
+ */
+void UnitConversion::apply(const Affine &affine, double *data, qint64 count) {
+    if (isIdentity(affine)) {
+        return;
+    }
+    qint64 i = 0;
+#if defined(UNITCONVERSION_SSE2)
+    const __m128d pre = _mm_set1_pd(affine.pre);
+    const __m128d scale = _mm_set1_pd(affine.scale);
+    const __m128d post = _mm_set1_pd(affine.post);
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(data + i);
+        __m128d b = _mm_loadu_pd(data + i + 2);
+        a = _mm_add_pd(_mm_mul_pd(_mm_add_pd(a, pre), scale), post);
+        b = _mm_add_pd(_mm_mul_pd(_mm_add_pd(b, pre), scale), post);
+        _mm_storeu_pd(data + i, a);
+        _mm_storeu_pd(data + i + 2, b);
+    }
+#elif defined(UNITCONVERSION_NEON)
+    const float64x2_t pre = vdupq_n_f64(affine.pre);
+    const float64x2_t scale = vdupq_n_f64(affine.scale);
+    const float64x2_t post = vdupq_n_f64(affine.post);
+    for (; i + 4 <= count; i += 4) {
+        float64x2_t a = vld1q_f64(data + i);
+        float64x2_t b = vld1q_f64(data + i + 2);
+        // Отдельные умножение и сложение (без FMA), как в скалярном пути
+        a = vaddq_f64(vmulq_f64(vaddq_f64(a, pre), scale), post);
+        b = vaddq_f64(vmulq_f64(vaddq_f64(b, pre), scale), post);
+        vst1q_f64(data + i, a);
+        vst1q_f64(data + i + 2, b);
+    }
+#endif
+    applyScalar(affine, data + i, count - i);
+}
+
+/**
+ * @brief Возвращает название набора инструкций, используемого apply().
+ */
+const char *UnitConversion::backend() {
+#if defined(UNITCONVERSION_SSE2)
+    return "sse2";
+#elif defined(UNITCONVERSION_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,65 @@
+#include "../includes/updatescheduler.h"
+#include "../includes/frameclock.h"
+
+/**
+ * @file updatescheduler.cpp
+ * @brief Реализация класса UpdateScheduler.
+ *
+ * Этот файл содержит реализацию планировщика обновлений сцены.
+ */
+
+/**
+ * @brief Конструктор класса UpdateScheduler.
+ * @param clock Часы кадров.
+ * @param parent Родительский объект.
+ */
+UpdateScheduler::UpdateScheduler(FrameClock *clock, QObject *parent)
+    : QObject(parent), clock(clock)
+{
+    connect(clock, &FrameClock::frame, this, &UpdateScheduler::onFrame);
+}
+
+/**
+ * @brief Помечает поля изменёнными и запрашивает кадр.
+ * @param fields Биты полей.
+ */
+void UpdateScheduler::markDirty(quint32 fields) {
+    if (fields == 0) {
+        return;
+    }
+    ++requested;
+    if (dirty != 0) {
+        ++coalesced; // Кадр уже запрошен, изменение войдёт в него
+    }
+    dirty |= fields;
+    clock->requestFrame();
+}
+
+/**
+ * @brief Немедленно применяет ожидающие изменения.
+ */
+void UpdateScheduler::flushNow() {
+    const quint32 fields = dirty;
+    if (fields == 0) {
+        return;
+    }
+    dirty = 0;
+    ++applied;
+    emit updatesReady(fields);
+}
+
+/**
+ * @brief Сбрасывает счётчики.
+ */
+void UpdateScheduler::resetCounters() {
+    requested = 0;
+    coalesced = 0;
+    applied = 0;
+}
+
+/**
+ * @brief Применяет изменения в кадре часов.
+ */
+void UpdateScheduler::onFrame() {
+    flushNow();
+}
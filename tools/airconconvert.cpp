@@ -0,0 +1,219 @@
+/**
+ * @file airconconvert.cpp
+ * @brief Утилита пересчёта единиц измерения в журналах измерений.
+ *
+ * Читает журнал измерений в формате конвейера приёма данных
+ * ("<метка_мкс>,<температура>,<влажность>,<давление>", строки с '#' игнорируются),
+ * пересчитывает температуру и давление ядром UnitConversion и записывает CSV.
+ *
+ * Пример: AirConConvert --temperature C:F --pressure Pa:mmHg readings.csv converted.csv
+ */
+
+#include "../includes/sensoringest.h"
+#include "../includes/unitconversion.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QLocale>
+#include <QVector>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const qint64 kChunkBytes = 4 * 1024 * 1024; ///< Объём текста, разбираемый за один проход
+
+/**
+ * @brief Возвращает идентификатор единицы температуры по обозначению (C, F, K) или 0.
+ */
+int temperatureUnitId(const QString &scale) {
+    const QString s = scale.trimmed().toUpper();
+    if (s == "C") {
+        return 1;
+    } else if (s == "F") {
+        return 2;
+    } else if (s == "K") {
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief Возвращает идентификатор единицы давления по обозначению (Pa, mmHg) или 0.
+ */
+int pressureUnitId(const QString &scale) {
+    const QString s = scale.trimmed().toLower();
+    if (s == "pa") {
+        return 1;
+    } else if (s == "mmhg") {
+        return 2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Разбирает пару единиц вида "from:to".
+ * @return true, если обе единицы известны.
+ */
+bool parsePair(const QString &value, int (*unitId)(const QString &), int &from, int &to) {
+    const QStringList parts = value.split(':');
+    if (parts.size() != 2) {
+        return false;
+    }
+    from = unitId(parts.at(0));
+    to = unitId(parts.at(1));
+    return from != 0 && to != 0;
+}
+
+/**
+ * @brief Пересчитывает пакет измерений и дописывает его в выходной буфер.
+ */
+void convertBatch(QVector<SensorSample> &samples, const UnitConversion::Affine &tConv,
+                  const UnitConversion::Affine &pConv, QVector<double> &column, QByteArray &out) {
+    const int count = samples.size();
+    column.resize(count);
+
+    // Колонки собираются в непрерывный массив, чтобы ядро обрабатывало их векторно
+    for (int i = 0; i < count; ++i) {
+        column[i] = samples[i].temperature;
+    }
+    UnitConversion::apply(tConv, column.data(), count);
+    for (int i = 0; i < count; ++i) {
+        samples[i].temperature = column[i];
+        column[i] = samples[i].pressure;
+    }
+    UnitConversion::apply(pConv, column.data(), count);
+
+    for (int i = 0; i < count; ++i) {
+        const SensorSample &sample = samples[i];
+        out += QByteArray::number(sample.timestampUs);
+        out += ',';
+        out += QByteArray::number(sample.temperature, 'g', QLocale::FloatingPointShortest);
+        out += ',';
+        out += QByteArray::number(sample.humidity, 'g', QLocale::FloatingPointShortest);
+        out += ',';
+        out += QByteArray::number(column[i], 'g', QLocale::FloatingPointShortest);
+        out += '\n';
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Главная функция утилиты пересчёта.
+ *
+ * @param argc Количество аргументов командной строки.
+ * @param argv Массив аргументов командной строки.
+ * @return int Код завершения: 0 — успех, 1 — ошибка параметров или ввода-вывода.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Пересчёт единиц измерения в журналах измерений.");
+    parser.addHelpOption();
+    QCommandLineOption temperatureOption("temperature", "Пересчёт температуры, например C:F (C, F, K).", "from:to");
+    QCommandLineOption pressureOption("pressure", "Пересчёт давления, например Pa:mmHg (Pa, mmHg).", "from:to");
+    parser.addOption(temperatureOption);
+    parser.addOption(pressureOption);
+    parser.addPositionalArgument("input", "Входной журнал.");
+    parser.addPositionalArgument("output", "Выходной CSV-файл (по умолчанию стандартный вывод).", "[output]");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    UnitConversion::Affine tConv = UnitConversion::temperature(1, 1);
+    UnitConversion::Affine pConv = UnitConversion::pressure(1, 1);
+    int from = 0;
+    int to = 0;
+    if (parser.isSet(temperatureOption)) {
+        if (!parsePair(parser.value(temperatureOption), temperatureUnitId, from, to)) {
+            std::fprintf(stderr, "Неизвестные единицы температуры: %s\n", qPrintable(parser.value(temperatureOption)));
+            return 1;
+        }
+        tConv = UnitConversion::temperature(from, to);
+    }
+    if (parser.isSet(pressureOption)) {
+        if (!parsePair(parser.value(pressureOption), pressureUnitId, from, to)) {
+            std::fprintf(stderr, "Неизвестные единицы давления: %s\n", qPrintable(parser.value(pressureOption)));
+            return 1;
+        }
+        pConv = UnitConversion::pressure(from, to);
+    }
+
+    QFile input(args.at(0));
+    if (!input.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Не удалось открыть %s: %s\n", qPrintable(args.at(0)), qPrintable(input.errorString()));
+        return 1;
+    }
+    QFile output;
+    bool opened = false;
+    if (args.size() > 1) {
+        output.setFileName(args.at(1));
+        opened = output.open(QIODevice::WriteOnly);
+    } else {
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!opened) {
+        std::fprintf(stderr, "Не удалось открыть выходной файл: %s\n", qPrintable(output.errorString()));
+        return 1;
+    }
+
+    const qint64 size = input.size();
+    QByteArray whole;
+    const char *data = size > 0 ? reinterpret_cast<const char *>(input.map(0, size)) : nullptr;
+    if (!data && size > 0) {
+        whole = input.readAll();
+        data = whole.constData();
+    }
+
+    QVector<SensorSample> samples;
+    QVector<double> column;
+    QByteArray out;
+    QByteArray tail;
+    quint64 malformed = 0;
+    quint64 converted = 0;
+
+    qint64 offset = 0;
+    while (offset < size) {
+        qint64 length = qMin(kChunkBytes, size - offset);
+        samples.resize(0);
+        qint64 consumed = SensorIngest::parseChunk(data + offset, length, samples, &malformed);
+        if (consumed == 0) {
+            if (offset + length < size) {
+                // Строка длиннее блока: блок расширяется до конца строки
+                const void *eol = memchr(data + offset + length, '\n', static_cast<size_t>(size - offset - length));
+                length = eol ? static_cast<const char *>(eol) - (data + offset) + 1 : size - offset;
+            }
+            if (offset + length == size && data[size - 1] != '\n') {
+                // Последняя строка без перевода строки
+                tail = QByteArray(data + offset, static_cast<int>(length)) + '\n';
+                consumed = SensorIngest::parseChunk(tail.constData(), tail.size(), samples, &malformed) > 0 ? length : 0;
+            } else {
+                consumed = SensorIngest::parseChunk(data + offset, length, samples, &malformed);
+            }
+            if (consumed == 0) {
+                break;
+            }
+        }
+        offset += consumed;
+
+        convertBatch(samples, tConv, pConv, column, out);
+        converted += samples.size();
+        if (output.write(out) != out.size()) {
+            std::fprintf(stderr, "Ошибка записи: %s\n", qPrintable(output.errorString()));
+            return 1;
+        }
+        out.resize(0);
+    }
+
+    std::fprintf(stderr, "Пересчитано измерений: %llu, пропущено строк: %llu (%s)\n",
+                 static_cast<unsigned long long>(converted), static_cast<unsigned long long>(malformed),
+                 UnitConversion::backend());
+    return 0;
+}